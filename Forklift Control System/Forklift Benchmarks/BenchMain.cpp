@@ -0,0 +1,295 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FleetScheduler.h"
+#include "LiftControl.h"
+#include "LiftFleet.h"
+#include "LoadDynamics.h"
+#include "MastFleet.h"
+#include "PackedFleet.h"
+#include "PlantKernels.h"
+#include "Rng.h"
+#include "TableController.h"
+
+// Scan hot-path benchmarks. Items are scans (one lift, one scan) throughout,
+// so every row is comparable as ns per lift-scan.
+
+namespace {
+
+const double kDt = 0.02;
+
+// Same staggered operator pattern as the CLI's fleet mode.
+void driveOperator(Inputs& in, std::uint64_t lift, std::uint64_t scan) {
+    const std::uint64_t phase = (scan + lift * 37) % 400;
+    in.cmdUp = phase < 120;
+    in.cmdDown = phase >= 200 && phase < 335;
+    in.cmdHold = false;
+    in.resetFault = phase == 399;
+}
+
+// Inputs that keep an update()-only controller in one state.
+Inputs inputsFor(LiftState s) {
+    Inputs in{};
+    in.bottomLimit = false;
+    switch (s) {
+    case LiftState::Holding:  in.bottomLimit = true; break;
+    case LiftState::Lifting:  in.cmdUp = true; break;
+    case LiftState::Lowering: in.cmdDown = true; break;
+    case LiftState::Faulted:  in.estop = true; break;
+    case LiftState::Positioning: in.cmdGoTo = true; in.targetPosition = 0.9; break;
+    }
+    return in;
+}
+
+// Random inputs hitting every fault and the reset gate (as in --diff-check).
+struct StormInput {
+    Inputs in;
+    double velocity;
+};
+
+std::vector<StormInput> faultStorm(std::size_t n) {
+    SplitMix64 rng{ 42 };
+    std::vector<StormInput> v(n);
+    for (StormInput& s : v) {
+        s.in.cmdUp = rng.chance(0.4);
+        s.in.cmdDown = rng.chance(0.4);
+        s.in.estop = rng.chance(0.05);
+        s.in.resetFault = rng.chance(0.3);
+        s.in.topLimit = rng.chance(0.1);
+        s.in.bottomLimit = rng.chance(0.1);
+        s.in.loadKg = rng.uniform(0.8, 1.1) * 1200.0;
+        s.velocity = rng.uniform(-0.02, 0.02);
+    }
+    return v;
+}
+
+template <class Controller>
+void addStormBenchmark(BenchmarkRegistry& reg, const char* name) {
+    reg.add(name, 1, [](std::uint64_t iters) {
+        const std::vector<StormInput> storm = faultStorm(4096);
+        Controller ctrl{};
+        LiftPlant plant{};
+        for (std::uint64_t i = 0; i < iters; ++i) {
+            const StormInput& s = storm[i & 4095];
+            plant.velocity = s.velocity;
+            const Outputs out = ctrl.update(kDt, s.in, plant);
+            doNotOptimize(out);
+        }
+    });
+}
+
+void addComponentBenchmarks(BenchmarkRegistry& reg) {
+    reg.add("FaultManager::latch/storm", 1, [](std::uint64_t iters) {
+        std::array<FaultCode, 1024> codes{};
+        SplitMix64 rng{ 7 };
+        const FaultCode all[] = { FaultCode::None, FaultCode::LimitViolation, FaultCode::Overload,
+                                  FaultCode::EmergencyStop };
+        for (FaultCode& c : codes) c = all[rng.next() & 3];
+
+        FaultManager fm{};
+        for (std::uint64_t i = 0; i < iters; ++i) {
+            fm.latch(codes[i & 1023]);
+            if ((i & 7) == 7) fm.clear();
+            doNotOptimize(fm);
+        }
+    });
+
+    reg.add("LiftPlant::step", 1, [](std::uint64_t iters) {
+        LiftPlant plant{};
+        plant.targetVel = 0.35;
+        for (std::uint64_t i = 0; i < iters; ++i) {
+            plant.step(kDt);
+            if (plant.position >= 1.0) plant.targetVel = -0.30;
+            if (plant.position <= 0.0) plant.targetVel = 0.35;
+            doNotOptimize(plant);
+        }
+    });
+
+    for (LiftState s : { LiftState::Holding, LiftState::Lifting, LiftState::Lowering, LiftState::Faulted,
+                         LiftState::Positioning }) {
+        reg.add(std::string("LiftController::update/") + stateToString(s), 1, [s](std::uint64_t iters) {
+            LiftController ctrl{};
+            LiftPlant plant{};
+            plant.position = 0.5;
+            Inputs in = inputsFor(s);
+            for (std::uint64_t i = 0; i < iters; ++i) {
+                doNotOptimize(in);
+                const Outputs out = ctrl.update(kDt, in, plant);
+                doNotOptimize(out);
+            }
+        });
+    }
+
+    addStormBenchmark<LiftController>(reg, "LiftController::update/fault-storm");
+    addStormBenchmark<RuntimeLiftController>(reg, "RuntimeLiftController::update/fault-storm");
+    addStormBenchmark<TableLiftController>(reg, "TableLiftController::update/fault-storm");
+    addStormBenchmark<RuntimeTableLiftController>(reg, "RuntimeTableLiftController::update/fault-storm");
+}
+
+template <class Controller>
+void fullScan(std::uint64_t iters) {
+    Controller ctrl{};
+    LiftPlant plant{};
+    Inputs in{};
+    for (std::uint64_t i = 0; i < iters; ++i) {
+        driveOperator(in, 0, i);
+        const Outputs out = scanLift(kDt, in, ctrl, plant);
+        doNotOptimize(out);
+    }
+}
+
+void addScanBenchmarks(BenchmarkRegistry& reg) {
+    reg.add("scanLift/reference", 1, fullScan<LiftController>);
+    reg.add("scanLift/runtime", 1, fullScan<RuntimeLiftController>);
+    reg.add("scanLift/table", 1, fullScan<TableLiftController>);
+
+    // Whole-fleet scans: operator input + controlScan per lift + batched plant step.
+    std::vector<PlantKernel> kernels{ PlantKernel::Scalar };
+    if (activePlantKernel() != PlantKernel::Scalar) kernels.push_back(activePlantKernel());
+    for (PlantKernel k : kernels) {
+        for (std::uint64_t n : { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull }) {
+            const std::string name = std::string("LiftFleet::scan/") + plantKernelToString(k) + "/" + std::to_string(n);
+            reg.add(name, n, [k, n](std::uint64_t iters) {
+                setPlantKernel(k);
+                LiftFleet fleet(n);
+                for (std::uint64_t s = 0; s < iters; ++s) {
+                    for (std::uint64_t i = 0; i < n; ++i) driveOperator(fleet.inputs[i], i, s);
+                    fleet.scan(kDt);
+                    clobberMemory();
+                }
+            });
+        }
+    }
+
+    // Same fleet in the packed layout (32 bytes per lift, AoS scalar plant step)
+    // against the best SoA kernel, up to sizes that spill past the last-level cache.
+    for (std::uint64_t n : { 1ull, 100ull, 10000ull, 100000ull, 1000000ull }) {
+        reg.add("PackedFleet::scan/" + std::to_string(n), n, [n](std::uint64_t iters) {
+            PackedFleet fleet(n);
+            Inputs in{};
+            for (std::uint64_t s = 0; s < iters; ++s) {
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    driveOperator(in, i, s);
+                    fleet.setCommands(i, in);
+                }
+                fleet.scan(kDt);
+                clobberMemory();
+            }
+        });
+    }
+    const PlantKernel best = kernels.back();
+    reg.add(std::string("LiftFleet::scan/") + plantKernelToString(best) + "/1000000", 1000000, [best](std::uint64_t iters) {
+        setPlantKernel(best);
+        LiftFleet fleet(1000000);
+        for (std::uint64_t s = 0; s < iters; ++s) {
+            for (std::uint64_t i = 0; i < fleet.size(); ++i) driveOperator(fleet.inputs[i], i, s);
+            fleet.scan(kDt);
+            clobberMemory();
+        }
+    });
+
+    // Mixed fleet: every other lift gets a heavier, slower mast (runtime tunables per lift).
+    for (std::uint64_t n : { 1000ull, 100000ull }) {
+        reg.add("LiftFleet::scan/mixed-mast/" + std::to_string(n), n, [best, n](std::uint64_t iters) {
+            setPlantKernel(best);
+            LiftFleet fleet(n);
+            RuntimeMastConfig heavy{};
+            heavy.maxLoadKg = 2500.0;
+            heavy.liftSpeed = 0.20;
+            heavy.lowerSpeed = 0.25;
+            for (std::uint64_t i = 1; i < n; i += 2) fleet.setMast(i, heavy);
+            for (std::uint64_t s = 0; s < iters; ++s) {
+                for (std::uint64_t i = 0; i < n; ++i) driveOperator(fleet.inputs[i], i, s);
+                fleet.scan(kDt);
+                clobberMemory();
+            }
+        });
+    }
+
+    // Load-dependent dynamics: every lift looks its truck model up each scan (mixed models)
+    reg.add("LiftFleet::scan/dynamics/100000", 100000, [best](std::uint64_t iters) {
+        setPlantKernel(best);
+        static const TruckDynamics trucks = builtinTruckDynamics();
+        LiftFleet fleet(100000);
+        fleet.setDynamics(&trucks);
+        for (std::uint64_t i = 0; i < fleet.size(); ++i) {
+            fleet.setTruckModel(i, static_cast<std::uint8_t>(i % trucks.count));
+            fleet.inputs[i].loadKg = 0.5 * trucks.tables[i % trucks.count].maxLoadKg();
+        }
+        for (std::uint64_t s = 0; s < iters; ++s) {
+            for (std::uint64_t i = 0; i < fleet.size(); ++i) driveOperator(fleet.inputs[i], i, s);
+            fleet.scan(kDt);
+            clobberMemory();
+        }
+    });
+
+    // Four-axis masts: tilt, side-shift and reach cycling alongside the lift, all axes in one plant pass
+    reg.add("MastFleet::scan/100000", 100000, [best](std::uint64_t iters) {
+        setPlantKernel(best);
+        MastFleet fleet(100000);
+        for (std::uint64_t s = 0; s < iters; ++s) {
+            for (std::uint64_t i = 0; i < fleet.size(); ++i) {
+                MastInputs& in = fleet.inputs[i];
+                driveOperator(in.lift, i, s);
+                const std::uint64_t phase = (s + i * 37) % 400;
+                for (AxisInputs& a : in.aux) {
+                    a.cmdPlus = phase >= 120 && phase < 150;
+                    a.cmdMinus = phase >= 160 && phase < 190;
+                }
+            }
+            fleet.scan(kDt);
+            clobberMemory();
+        }
+    });
+
+    // The same fleet on pinned worker threads (FleetScheduler), one row per thread count
+    for (unsigned t : { 1u, 2u, 4u }) {
+        reg.add("FleetScheduler::scan/" + std::to_string(t) + "/100000", 100000, [best, t](std::uint64_t iters) {
+            setPlantKernel(best);
+            LiftFleet fleet(100000);
+            FleetSchedulerOptions opt{};
+            opt.threads = t;
+            FleetScheduler scheduler(fleet, opt);
+            for (std::uint64_t s = 0; s < iters; ++s) {
+                for (std::uint64_t i = 0; i < fleet.size(); ++i) driveOperator(fleet.inputs[i], i, s);
+                scheduler.scan(kDt);
+                clobberMemory();
+            }
+        });
+    }
+}
+
+void printUsage() {
+    std::printf(
+        "Usage: Forklift Benchmarks [--filter <substring>] [--min-time <s>] [--repetitions <n>]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkOptions opt{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--filter" && i + 1 < argc) opt.filter = argv[++i];
+        else if (a == "--min-time" && i + 1 < argc) opt.minTime = std::atof(argv[++i]);
+        else if (a == "--repetitions" && i + 1 < argc) opt.repetitions = std::atoi(argv[++i]);
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    BenchmarkRegistry reg;
+    addComponentBenchmarks(reg);
+    addScanBenchmarks(reg);
+
+    std::printf("plant kernel: %s, %d repetitions of >= %.2fs, median shown\n",
+                plantKernelToString(activePlantKernel()), opt.repetitions, opt.minTime);
+    reg.run(opt);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "PerfCounters.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsFor(const std::function<void(std::uint64_t)>& fn, std::uint64_t iterations) {
+    const auto t0 = Clock::now();
+    fn(iterations);
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Smallest power-of-growth iteration count whose run takes at least minTime.
+std::uint64_t calibrate(const std::function<void(std::uint64_t)>& fn, double minTime) {
+    std::uint64_t iterations = 1;
+    for (;;) {
+        const double s = secondsFor(fn, iterations);
+        if (s >= minTime || iterations >= (1ull << 40)) return iterations;
+        const double grow = s > 0.0 ? std::clamp(minTime / s * 1.4, 2.0, 100.0) : 100.0;
+        iterations = static_cast<std::uint64_t>(iterations * grow);
+    }
+}
+
+} // namespace
+
+void BenchmarkRegistry::add(std::string name, std::uint64_t itemsPerIteration, Fn fn) {
+    entries_.push_back({ std::move(name), itemsPerIteration, std::move(fn) });
+}
+
+std::vector<BenchmarkResult> BenchmarkRegistry::run(const BenchmarkOptions& opt) const {
+    PerfCounters counters;
+    std::printf("%-48s %12s %12s %12s %14s\n", "Benchmark", "ns/item",
+                counters.cycleSource()[0] == 'c' ? "cycles/item" : "tsc/item", "instr/item", "iterations");
+    std::printf("%s\n", std::string(102, '-').c_str());
+
+    std::vector<BenchmarkResult> results;
+    for (const Entry& e : entries_) {
+        if (!opt.filter.empty() && e.name.find(opt.filter) == std::string::npos) continue;
+
+        const std::uint64_t iterations = calibrate(e.fn, opt.minTime);
+        const double items = static_cast<double>(iterations) * e.items;
+
+        std::vector<BenchmarkResult> reps;
+        for (int r = 0; r < std::max(1, opt.repetitions); ++r) {
+            counters.start();
+            const auto t0 = Clock::now();
+            e.fn(iterations);
+            const auto t1 = Clock::now();
+            counters.stop();
+
+            BenchmarkResult br{};
+            br.name = e.name;
+            br.iterations = iterations;
+            br.nsPerItem = std::chrono::duration<double, std::nano>(t1 - t0).count() / items;
+            br.cyclesPerItem = counters.cycles() / items;
+            br.instructionsPerItem = counters.hasInstructions() ? counters.instructions() / items : -1.0;
+            reps.push_back(br);
+        }
+        std::sort(reps.begin(), reps.end(),
+                  [](const BenchmarkResult& a, const BenchmarkResult& b) { return a.nsPerItem < b.nsPerItem; });
+        const BenchmarkResult& med = reps[reps.size() / 2];
+
+        if (med.instructionsPerItem >= 0.0) {
+            std::printf("%-48s %12.2f %12.2f %12.2f %14llu\n", med.name.c_str(), med.nsPerItem,
+                        med.cyclesPerItem, med.instructionsPerItem, static_cast<unsigned long long>(iterations));
+        }
+        else {
+            std::printf("%-48s %12.2f %12.2f %12s %14llu\n", med.name.c_str(), med.nsPerItem,
+                        med.cyclesPerItem, "-", static_cast<unsigned long long>(iterations));
+        }
+        std::fflush(stdout);
+        results.push_back(med);
+    }
+    return results;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Small microbenchmark harness in the style of Google Benchmark.
+//
+// A benchmark is a function that runs `iterations` times whatever it
+// measures; `itemsPerIteration` says how many scans (or lift-scans) one
+// iteration is. The harness grows the iteration count until a run lasts
+// minTime, repeats it, and reports the median run per item: wall ns,
+// cycles and (where available) retired instructions.
+
+// Keep `value` alive and opaque to the optimizer.
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+// Force pending stores to be treated as observable.
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+struct BenchmarkOptions {
+    double minTime = 0.1;        // seconds per repetition
+    int repetitions = 5;
+    std::string filter;          // run benchmarks whose name contains this
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double nsPerItem = 0.0;
+    double cyclesPerItem = 0.0;
+    double instructionsPerItem = -1.0;   // < 0: not available
+};
+
+class BenchmarkRegistry {
+public:
+    using Fn = std::function<void(std::uint64_t iterations)>;
+
+    void add(std::string name, std::uint64_t itemsPerIteration, Fn fn);
+
+    // Runs matching benchmarks in registration order, printing one row each.
+    std::vector<BenchmarkResult> run(const BenchmarkOptions& opt) const;
+
+private:
+    struct Entry {
+        std::string name;
+        std::uint64_t items;
+        Fn fn;
+    };
+    std::vector<Entry> entries_;
+};
@@ -0,0 +1,91 @@
+#include "PerfCounters.h"
+
+#include <chrono>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+std::uint64_t readTsc() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // No TSC: nanoseconds stand in for cycles.
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+#if defined(__linux__)
+int openCounter(std::uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group < 0 ? 1 : 0;   // the group leader starts disabled
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+std::uint64_t readCounter(int fd) {
+    std::uint64_t v = 0;
+    if (::read(fd, &v, sizeof(v)) != static_cast<ssize_t>(sizeof(v))) return 0;
+    return v;
+}
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+    cycleFd_ = openCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (cycleFd_ >= 0) instrFd_ = openCounter(PERF_COUNT_HW_INSTRUCTIONS, cycleFd_);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    if (instrFd_ >= 0) ::close(instrFd_);
+    if (cycleFd_ >= 0) ::close(cycleFd_);
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    if (cycleFd_ >= 0) {
+        ::ioctl(cycleFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(cycleFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return;
+    }
+#endif
+    tscStart_ = readTsc();
+}
+
+void PerfCounters::stop() {
+#if defined(__linux__)
+    if (cycleFd_ >= 0) {
+        ::ioctl(cycleFd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        cycles_ = readCounter(cycleFd_);
+        instructions_ = instrFd_ >= 0 ? readCounter(instrFd_) : 0;
+        return;
+    }
+#endif
+    cycles_ = readTsc() - tscStart_;
+    instructions_ = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+// Cycle and instruction counts around a measured region.
+//
+// Linux: hardware counters via perf_event_open (core cycles and retired
+// instructions for this thread). Elsewhere, or when the kernel refuses
+// (containers, perf_event_paranoid), cycles fall back to the TSC and
+// instructions are unavailable.
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+    void stop();
+
+    std::uint64_t cycles() const { return cycles_; }
+    std::uint64_t instructions() const { return instructions_; }
+
+    bool hasInstructions() const { return instrFd_ >= 0; }
+    const char* cycleSource() const { return cycleFd_ >= 0 ? "core" : "tsc"; }
+
+private:
+    int cycleFd_ = -1;
+    int instrFd_ = -1;
+    std::uint64_t tscStart_ = 0;
+    std::uint64_t cycles_ = 0;
+    std::uint64_t instructions_ = 0;
+};
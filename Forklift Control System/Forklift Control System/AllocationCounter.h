@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// Program-wide heap allocation count, for --api-check.
+//
+// AllocationCounter.cpp replaces the global operator new and delete, so it
+// belongs to the CLI executable only, never to the library: a host that
+// links forklift_core keeps its own allocator.
+
+std::uint64_t heapAllocationCount();
@@ -0,0 +1,213 @@
+#include "ApiCheck.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "ForkliftApi.h"
+#include "LiftFleet.h"
+#include "Rng.h"
+
+namespace {
+
+const double kDt = 0.02;
+const std::uint64_t kSeed = 0xF0C4u;
+const std::uint64_t kBatchScans = 50;
+
+// Staggered up / down cycles like the fleet mode, plus random holds, E-stops,
+// overload spikes and reset pulses so every fault path runs.
+forklift_inputs operatorInputs(std::uint32_t lift, std::uint64_t scan) {
+    SplitMix64 rng{ streamKey(kSeed, (std::uint64_t{ lift } << 32) ^ scan) };
+    const std::uint64_t phase = (scan + std::uint64_t{ lift } * 37) % 400;
+    forklift_inputs in{};
+    in.cmd_up = phase < 120 || rng.chance(0.02);
+    in.cmd_down = (phase >= 200 && phase < 335) || rng.chance(0.02);
+    in.cmd_hold = rng.chance(0.01);
+    in.estop = rng.chance(0.002);
+    in.reset_fault = phase == 399 || rng.chance(0.01);
+    in.load_kg = rng.chance(0.005) ? 1.1 * DefaultMast::maxLoadKg : 0.4 * DefaultMast::maxLoadKg;
+    return in;
+}
+
+// What forklift_read_outputs() must report for lift i of a directly scanned fleet
+forklift_outputs expectedOutputs(const LiftFleet& f, std::size_t i) {
+    forklift_outputs e{};
+    e.motor_enable = f.outputs[i].motorEnable;
+    e.motor_dir = static_cast<std::int8_t>(f.outputs[i].motorDir);
+    e.brake_engaged = f.outputs[i].brakeEngaged;
+    e.fault_lamp = f.outputs[i].faultLamp;
+    e.top_limit = f.inputs[i].topLimit;
+    e.bottom_limit = f.inputs[i].bottomLimit;
+    e.state = static_cast<std::uint8_t>(f.state[i]);
+    e.fault = static_cast<std::uint8_t>(f.latched[i]);
+    e.position = f.position[i];
+    e.velocity = f.velocity[i];
+    e.target_velocity = f.targetVel[i];
+    return e;
+}
+
+// The struct has no padding, so this is a bit-for-bit comparison, doubles included
+bool sameOutputs(const forklift_outputs& a, const forklift_outputs& b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+struct Pool {
+    forklift_pool* pool = nullptr;
+    std::vector<forklift_outputs> out;
+
+    Pool() = default;
+    ~Pool() { forklift_pool_destroy(pool); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    bool create(std::uint32_t lifts, forklift_controller controller, std::uint32_t threads) {
+        forklift_pool_config config{};
+        config.lifts = lifts;
+        config.controller = controller;
+        config.threads = threads;
+        config.dt = kDt;
+        out.resize(lifts);
+        return forklift_pool_create(&config, &pool) == FORKLIFT_OK;
+    }
+};
+
+std::uint64_t countBadCallsAccepted(forklift_pool* pool, std::uint32_t lifts) {
+    std::uint64_t accepted = 0;
+    forklift_inputs in{};
+    forklift_outputs out{};
+    forklift_pool* none = nullptr;
+
+    forklift_pool_config noLifts{};
+    noLifts.dt = kDt;
+    forklift_pool_config noDt{};
+    noDt.lifts = 1;
+    forklift_pool_config badController{};
+    badController.lifts = 1;
+    badController.dt = kDt;
+    badController.controller = 7;
+    for (const forklift_pool_config& config : { noLifts, noDt, badController }) {
+        if (forklift_pool_create(&config, &none) != FORKLIFT_ERROR_INVALID_ARGUMENT) accepted++;
+        forklift_pool_destroy(none);
+    }
+
+    if (forklift_submit_inputs(pool, lifts, 1, &in) != FORKLIFT_ERROR_OUT_OF_RANGE) accepted++;
+    if (forklift_submit_inputs(pool, 0, 1, nullptr) != FORKLIFT_ERROR_INVALID_ARGUMENT) accepted++;
+    if (forklift_read_outputs(pool, 0xFFFFFFFFu, 2, &out) != FORKLIFT_ERROR_OUT_OF_RANGE) accepted++;
+    if (forklift_read_outputs(nullptr, 0, 1, &out) != FORKLIFT_ERROR_INVALID_ARGUMENT) accepted++;
+    if (forklift_scan(nullptr, 1) != FORKLIFT_ERROR_INVALID_ARGUMENT) accepted++;
+    return accepted;
+}
+
+} // namespace
+
+ApiCheckReport checkForkliftApi(std::uint32_t lifts, std::uint64_t scans, std::uint64_t (*allocationCount)()) {
+    ApiCheckReport r{};
+    r.lifts = lifts;
+    r.scans = scans;
+    if (lifts == 0) {
+        r.error = "needs at least one lift";
+        return r;
+    }
+
+    // ---- Everything is allocated up front ----
+    Pool reference, table, threaded, batch, single;
+    if (!reference.create(lifts, FORKLIFT_CONTROLLER_REFERENCE, 1) || !table.create(lifts, FORKLIFT_CONTROLLER_TABLE, 1) ||
+        !threaded.create(lifts, FORKLIFT_CONTROLLER_REFERENCE, 3) || !batch.create(lifts, FORKLIFT_CONTROLLER_REFERENCE, 1) ||
+        !single.create(lifts, FORKLIFT_CONTROLLER_REFERENCE, 1)) {
+        r.error = "forklift_pool_create failed";
+        return r;
+    }
+    Pool* const compared[] = { &reference, &table, &threaded };
+    LiftFleet direct(lifts);
+    if (kCountersEnabled) direct.enablePerLiftCounters();   // like the pools: no thread aggregate to allocate
+    std::vector<forklift_inputs> in(lifts);
+    const std::uint64_t allocationsBefore = allocationCount ? allocationCount() : 0;
+
+    // ---- Pools against the directly scanned fleet, every scan ----
+    for (std::uint64_t s = 0; s < scans; ++s) {
+        for (std::uint32_t i = 0; i < lifts; ++i) {
+            in[i] = operatorInputs(i, s);
+            Inputs& d = direct.inputs[i];
+            d.cmdUp = in[i].cmd_up;
+            d.cmdDown = in[i].cmd_down;
+            d.cmdHold = in[i].cmd_hold;
+            d.estop = in[i].estop;
+            d.resetFault = in[i].reset_fault;
+            d.loadKg = in[i].load_kg;
+        }
+        direct.scan(kDt);
+
+        bool same = true;
+        for (Pool* p : compared) {
+            forklift_submit_inputs(p->pool, 0, lifts, in.data());
+            forklift_scan(p->pool, 1);
+            forklift_read_outputs(p->pool, 0, lifts, p->out.data());
+            for (std::uint32_t i = 0; i < lifts; ++i) same &= sameOutputs(p->out[i], expectedOutputs(direct, i));
+        }
+        if (!same && r.mismatches++ == 0) r.firstMismatchScan = s;
+    }
+
+    // ---- scan(n) against n single scans; inputs (and any reset pulse) only at the start ----
+    for (std::uint64_t s = 0; s < scans; s += kBatchScans) {
+        for (std::uint32_t i = 0; i < lifts; ++i) in[i] = operatorInputs(i, scans + s);
+        forklift_submit_inputs(batch.pool, 0, lifts, in.data());
+        forklift_scan(batch.pool, kBatchScans);
+
+        forklift_submit_inputs(single.pool, 0, lifts, in.data());
+        for (std::uint32_t i = 0; i < lifts; ++i) in[i].reset_fault = 0;
+        for (std::uint64_t k = 0; k < kBatchScans; ++k) {
+            forklift_scan(single.pool, 1);
+            if (k == 0) forklift_submit_inputs(single.pool, 0, lifts, in.data());
+        }
+
+        forklift_read_outputs(batch.pool, 0, lifts, batch.out.data());
+        forklift_read_outputs(single.pool, 0, lifts, single.out.data());
+        for (std::uint32_t i = 0; i < lifts; ++i) r.batchMismatches += !sameOutputs(batch.out[i], single.out[i]);
+    }
+
+    r.badCallsAccepted = countBadCallsAccepted(reference.pool, lifts);
+
+    // ---- Throughput: a host loop calling in every scan, and one long scan(n) ----
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point t0 = Clock::now();
+    for (std::uint64_t s = 0; s < scans; ++s) {
+        forklift_submit_inputs(reference.pool, 0, lifts, in.data());
+        forklift_scan(reference.pool, 1);
+        forklift_read_outputs(reference.pool, 0, lifts, reference.out.data());
+    }
+    const Clock::time_point t1 = Clock::now();
+    forklift_scan(reference.pool, scans);
+    const Clock::time_point t2 = Clock::now();
+
+    if (allocationCount) {
+        r.allocationsMeasured = true;
+        r.allocations = allocationCount() - allocationsBefore;
+    }
+    const double liftScans = static_cast<double>(lifts) * static_cast<double>(scans);
+    const double callSecs = std::chrono::duration<double>(t1 - t0).count();
+    const double batchSecs = std::chrono::duration<double>(t2 - t1).count();
+    r.callLiftScansPerSecond = callSecs > 0.0 ? liftScans / callSecs : 0.0;
+    r.batchLiftScansPerSecond = batchSecs > 0.0 ? liftScans / batchSecs : 0.0;
+    return r;
+}
+
+void printApiCheckReport(std::ostream& os, const ApiCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "api-check: " << r.error << "\n";
+        return;
+    }
+    os << "api-check: version=" << forklift_api_version() << " lifts=" << r.lifts << " scans=" << r.scans << "\n"
+        << "  pools vs direct fleet: mismatches=" << r.mismatches;
+    if (r.mismatches > 0) os << " first=" << r.firstMismatchScan;
+    os << "\n"
+        << "  scan(n) vs n x scan(1): mismatches=" << r.batchMismatches << "\n"
+        << "  bad calls accepted=" << r.badCallsAccepted << "\n"
+        << "  heap allocations after create: ";
+    if (r.allocationsMeasured) os << r.allocations << "\n";
+    else os << "not measured\n";
+    os << std::fixed << std::setprecision(0)
+        << "  lift-scans/s: submit+scan+read=" << r.callLiftScansPerSecond
+        << " scan(n)=" << r.batchLiftScansPerSecond << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Drives the C ABI in ForkliftApi.h as an embedding host would. Three pools
+// (reference, table, three-thread scheduler) take the same random inputs
+// through forklift_submit_inputs() and must match a LiftFleet scanned
+// directly bit for bit; forklift_scan(n) must equal n single scans, and bad
+// calls must be rejected. Allocations are counted when the host can.
+
+struct ApiCheckReport {
+    std::uint32_t lifts = 0;
+    std::uint64_t scans = 0;
+    std::uint64_t mismatches = 0;          // pool outputs differ from the direct fleet (must be 0)
+    std::uint64_t firstMismatchScan = 0;   // valid if mismatches > 0
+    std::uint64_t batchMismatches = 0;     // scan(n) differs from n x scan(1) (must be 0)
+    std::uint64_t badCallsAccepted = 0;    // invalid calls that returned FORKLIFT_OK (must be 0)
+    bool allocationsMeasured = false;
+    std::uint64_t allocations = 0;         // during submit/scan/read (must be 0)
+    double callLiftScansPerSecond = 0.0;   // submit + scan(1) + read every scan
+    double batchLiftScansPerSecond = 0.0;  // one scan(n) call
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && mismatches == 0 && batchMismatches == 0 && badCallsAccepted == 0 &&
+               allocations == 0;
+    }
+};
+
+// allocationCount, if given, returns the program's running count of heap allocations.
+ApiCheckReport checkForkliftApi(std::uint32_t lifts, std::uint64_t scans, std::uint64_t (*allocationCount)());
+
+void printApiCheckReport(std::ostream& os, const ApiCheckReport& r);
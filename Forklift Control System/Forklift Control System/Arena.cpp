@@ -0,0 +1,129 @@
+#include "Arena.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+std::size_t roundUp(std::size_t n, std::size_t to) { return (n + to - 1) / to * to; }
+
+} // namespace
+
+const char* arenaPagesToString(ArenaPages p) {
+    switch (p) {
+    case ArenaPages::Normal: return "normal";
+    case ArenaPages::Transparent: return "transparent-huge";
+    case ArenaPages::Huge: return "huge";
+    }
+    return "unknown";
+}
+
+void* Arena::allocateBytes(std::size_t bytes) {
+    const std::size_t size = roundUp(bytes > 0 ? bytes : 1, kAlign);
+    if (size > capacity_ - used_) return nullptr;
+    void* p = base_ + used_;
+    used_ += size;
+    if (used_ > highWater_) highWater_ = used_;
+    return p;
+}
+
+#if defined(_WIN32)
+
+bool Arena::reserve(std::size_t bytes, bool hugePages, std::string& error) {
+    release();
+    if (bytes == 0) {
+        error = "arena size must be > 0";
+        return false;
+    }
+
+    // Large pages need SeLockMemoryPrivilege; without it the call fails and we fall back
+    void* p = nullptr;
+    std::size_t size = roundUp(bytes, 64 * 1024);
+    if (hugePages) {
+        const std::size_t large = GetLargePageMinimum();
+        if (large > 0) {
+            const std::size_t largeSize = roundUp(bytes, large);
+            p = VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p) {
+                size = largeSize;
+                pages_ = ArenaPages::Huge;
+            }
+        }
+    }
+    if (!p) {
+        p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        pages_ = ArenaPages::Normal;
+    }
+    if (!p) {
+        error = "cannot reserve an arena of " + std::to_string(bytes) + " bytes";
+        return false;
+    }
+    base_ = static_cast<unsigned char*>(p);
+    capacity_ = size;
+    return true;
+}
+
+void Arena::release() {
+    if (base_) VirtualFree(base_, 0, MEM_RELEASE);
+    base_ = nullptr;
+    capacity_ = used_ = highWater_ = 0;
+    pages_ = ArenaPages::Normal;
+}
+
+#else
+
+bool Arena::reserve(std::size_t bytes, bool hugePages, std::string& error) {
+    release();
+    if (bytes == 0) {
+        error = "arena size must be > 0";
+        return false;
+    }
+
+    const std::size_t kHugePage = 2 * 1024 * 1024;
+    void* p = MAP_FAILED;
+    std::size_t size = roundUp(bytes, 4096);
+#if defined(MAP_HUGETLB)
+    // Only succeeds if the administrator reserved huge pages (vm.nr_hugepages)
+    if (hugePages) {
+        const std::size_t hugeSize = roundUp(bytes, kHugePage);
+        p = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            size = hugeSize;
+            pages_ = ArenaPages::Huge;
+        }
+    }
+#endif
+    if (p == MAP_FAILED) {
+        if (hugePages) size = roundUp(bytes, kHugePage);
+        p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        pages_ = ArenaPages::Normal;
+#if defined(MADV_HUGEPAGE)
+        if (p != MAP_FAILED && hugePages && madvise(p, size, MADV_HUGEPAGE) == 0) pages_ = ArenaPages::Transparent;
+#endif
+    }
+    if (p == MAP_FAILED) {
+        error = "cannot reserve an arena of " + std::to_string(bytes) + " bytes";
+        return false;
+    }
+    base_ = static_cast<unsigned char*>(p);
+    capacity_ = size;
+    return true;
+}
+
+void Arena::release() {
+    if (base_) munmap(base_, capacity_);
+    base_ = nullptr;
+    capacity_ = used_ = highWater_ = 0;
+    pages_ = ArenaPages::Normal;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+
+// Bump allocator over one contiguous region mapped once up front.
+//
+// allocate() carves cache-line-aligned blocks off the front and never
+// frees them one by one; rewind() to a mark() or reset() hands everything
+// after it back in O(1). Nothing is destroyed on the way, so only
+// trivially destructible types go in. The region is reserved with
+// reserve(): huge pages if the OS has them to give (MAP_HUGETLB, Windows
+// large pages), otherwise normal pages with a transparent-huge-page hint on
+// Linux. Pages are committed on first touch and stay committed across
+// rewinds, so a rewound arena is already warm.
+
+enum class ArenaPages : std::uint8_t {
+    Normal,
+    Transparent,    // normal mapping with madvise(MADV_HUGEPAGE)
+    Huge,           // explicit huge / large pages
+};
+
+const char* arenaPagesToString(ArenaPages p);
+
+class Arena {
+public:
+    static constexpr std::size_t kAlign = 64;
+
+    Arena() = default;
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Map a region of at least bytes; hugePages asks for huge pages first.
+    bool reserve(std::size_t bytes, bool hugePages, std::string& error);
+    void release();
+
+    // n default-constructed Ts, or nullptr if the region is full
+    template <class T>
+    T* allocate(std::size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>, "rewind() runs no destructors");
+        static_assert(alignof(T) <= kAlign, "arena blocks are cache-line aligned");
+        void* p = allocateBytes(n * sizeof(T));
+        if (!p) return nullptr;
+        T* t = static_cast<T*>(p);
+        for (std::size_t i = 0; i < n; ++i) new (t + i) T{};
+        return t;
+    }
+
+    // Raw block of bytes rounded up to kAlign, or nullptr if the region is full
+    void* allocateBytes(std::size_t bytes);
+
+    std::size_t mark() const { return used_; }
+    void rewind(std::size_t mark) { used_ = mark < used_ ? mark : used_; }
+    void reset() { used_ = 0; }
+
+    unsigned char* data() const { return base_; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t used() const { return used_; }
+    std::size_t highWater() const { return highWater_; }
+    ArenaPages pages() const { return pages_; }
+
+private:
+    unsigned char* base_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    std::size_t highWater_ = 0;
+    ArenaPages pages_ = ArenaPages::Normal;
+};
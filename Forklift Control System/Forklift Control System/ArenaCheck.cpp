@@ -0,0 +1,139 @@
+#include "ArenaCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "ArenaFleet.h"
+#include "EventFleet.h"
+#include "ScanCounters.h"
+
+namespace {
+
+const double kDt = 0.02;
+const std::uint64_t kSeed = 0xA7E4u;
+const std::size_t kScenarios = 3;
+const std::size_t kHistoryScans = 64;
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) { return std::memcmp(&a, &b, sizeof(TraceRecord)) == 0; }
+
+struct Scenario {
+    std::vector<Script> scripts;
+    std::size_t events = 0;
+    std::vector<TraceRecord> expected;   // dense EventFleet after all scans
+};
+
+} // namespace
+
+ArenaCheckReport checkArenaFleet(std::size_t runs, std::size_t lifts, std::int64_t scans,
+                                 std::uint64_t (*allocationCount)()) {
+    ArenaCheckReport r;
+    r.runs = runs;
+    r.lifts = lifts;
+    r.scans = scans;
+    r.historyScans = kHistoryScans;
+    if (runs == 0 || lifts == 0 || scans <= 0) {
+        r.error = "runs, lifts and scans must be > 0";
+        return r;
+    }
+
+    // ---- Scenarios and their reference results, all on the heap and outside the measurement ----
+    std::vector<Scenario> scenarios(kScenarios);
+    std::size_t maxEvents = 0;
+    for (std::size_t k = 0; k < kScenarios; ++k) {
+        Scenario& sc = scenarios[k];
+        for (std::size_t i = 0; i < lifts; ++i) {
+            sc.scripts.push_back(makeShiftScript(kSeed + k, i, scans));
+            sc.events += sc.scripts.back().events.size();
+        }
+        maxEvents = std::max(maxEvents, sc.events);
+
+        EventFleet dense(sc.scripts, kDt);
+        dense.parking = false;
+        dense.advanceTo(scans);
+        for (std::size_t i = 0; i < lifts; ++i) sc.expected.push_back(dense.record(i));
+    }
+
+    ArenaFleetSetup setup;
+    setup.lifts = lifts;
+    setup.historyScans = kHistoryScans;
+    Arena arena;
+    if (!arena.reserve(ArenaFleet::arenaBytes(setup, maxEvents), true, r.error)) return r;
+    r.pages = arena.pages();
+    r.arenaBytes = arena.capacity();
+    ArenaFleet fleet(arena);
+
+    // The thread's counter aggregate is created on first use, not per run
+    if constexpr (kCountersEnabled) (void)threadCounters();
+
+    // ---- Runs: rewind, rebuild, scan, compare ----
+    using Clock = std::chrono::steady_clock;
+    Clock::duration arenaSetup{};
+    const std::uint64_t allocationsBefore = allocationCount ? allocationCount() : 0;
+    for (std::size_t run = 0; run < runs; ++run) {
+        const Scenario& sc = scenarios[run % kScenarios];
+        setup.scripts = sc.scripts.data();
+
+        const Clock::time_point t0 = Clock::now();
+        const bool ok = fleet.reset(setup, r.error);
+        if (run > 0 || runs == 1) arenaSetup += Clock::now() - t0;
+        if (!ok) return r;
+        if (run < kScenarios) r.highWater = arena.highWater();
+        else r.highWaterMoved |= arena.highWater() != r.highWater;
+
+        for (std::int64_t s = 0; s < scans; ++s) fleet.scan(kDt);
+
+        for (std::size_t i = 0; i < lifts; ++i) {
+            const TraceRecord last = fleet.record(i);
+            r.mismatches += !sameRecord(last, sc.expected[i]);
+            const TraceRecord* newest = fleet.historyAt(scans - 1, i);
+            r.historyMismatches += !newest || !sameRecord(*newest, last);
+            r.historyMismatches += fleet.historyAt(scans - 1 - static_cast<std::int64_t>(kHistoryScans), i) != nullptr;
+        }
+    }
+    if (allocationCount) {
+        r.allocationsMeasured = true;
+        r.allocations = allocationCount() - allocationsBefore;
+    }
+
+    // ---- The same setup from the heap: scripts copied into a new EventFleet, a vector ring ----
+    Clock::duration heapSetup{};
+    for (std::size_t run = 0; run < runs; ++run) {
+        const Clock::time_point t0 = Clock::now();
+        {
+            EventFleet heap(scenarios[run % kScenarios].scripts, kDt);
+            std::vector<TraceRecord> ring(lifts * kHistoryScans);
+            if (heap.size() != lifts || ring.empty()) ++r.mismatches;
+        }
+        if (run > 0 || runs == 1) heapSetup += Clock::now() - t0;
+    }
+
+    // Mean over the warm runs: the first reset also faults the arena's pages in
+    const double timed = static_cast<double>(runs > 1 ? runs - 1 : 1);
+    r.arenaSetupSeconds = std::chrono::duration<double>(arenaSetup).count() / timed;
+    r.heapSetupSeconds = std::chrono::duration<double>(heapSetup).count() / timed;
+    return r;
+}
+
+void printArenaCheckReport(std::ostream& os, const ArenaCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "arena-check: " << r.error << "\n";
+        return;
+    }
+    os << "arena-check: runs=" << r.runs << " lifts=" << r.lifts << " scans=" << r.scans
+        << " history=" << r.historyScans << "\n"
+        << "  arena: " << r.arenaBytes << " bytes, " << arenaPagesToString(r.pages) << " pages, high water "
+        << r.highWater << (r.highWaterMoved ? " (MOVED after the first pass)" : " (stable)") << "\n"
+        << "  final state vs dense event fleet: mismatches=" << r.mismatches << "\n"
+        << "  telemetry ring: mismatches=" << r.historyMismatches << "\n"
+        << "  heap allocations during reset + scan: ";
+    if (r.allocationsMeasured) os << r.allocations << "\n";
+    else os << "not measured\n";
+    os << std::fixed << std::setprecision(1)
+        << "  setup us: arena reset=" << r.arenaSetupSeconds * 1e6 << " heap build=" << r.heapSetupSeconds * 1e6
+        << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
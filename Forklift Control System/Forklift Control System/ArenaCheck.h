@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "Arena.h"
+
+// Runs a scenario campaign on one rewound ArenaFleet. Each run's final
+// state must match the dense EventFleet loop bit for bit, the telemetry
+// ring must hold only the latest scans, and the high-water mark must stay
+// put after the first pass. Setup is timed against the heap-backed fleet.
+
+struct ArenaCheckReport {
+    std::size_t runs = 0;
+    std::size_t lifts = 0;
+    std::int64_t scans = 0;
+    std::size_t historyScans = 0;
+    ArenaPages pages = ArenaPages::Normal;
+    std::size_t arenaBytes = 0;            // reserved
+    std::size_t highWater = 0;
+    bool highWaterMoved = false;           // changed after the first pass over the scenarios (must be false)
+    std::uint64_t mismatches = 0;          // lifts whose final record differs from the dense loop (must be 0)
+    std::uint64_t historyMismatches = 0;   // ring slots wrong or present when they should be gone (must be 0)
+    bool allocationsMeasured = false;
+    std::uint64_t allocations = 0;         // during reset + scan (must be 0)
+    double arenaSetupSeconds = 0.0;        // mean reset()
+    double heapSetupSeconds = 0.0;         // mean EventFleet + ring construction and teardown
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && !highWaterMoved && mismatches == 0 && historyMismatches == 0 && allocations == 0;
+    }
+};
+
+// allocationCount, if given, returns the program's running count of heap allocations.
+ArenaCheckReport checkArenaFleet(std::size_t runs, std::size_t lifts, std::int64_t scans,
+                                 std::uint64_t (*allocationCount)());
+
+void printArenaCheckReport(std::ostream& os, const ArenaCheckReport& r);
@@ -0,0 +1,144 @@
+#include "ArenaFleet.h"
+
+#include "Console.h"
+#include "FleetPasses.h"
+#include "PlantKernels.h"
+
+namespace {
+
+template <class T>
+std::size_t blockBytes(std::size_t n) {
+    return n == 0 ? 0 : (n * sizeof(T) + Arena::kAlign - 1) / Arena::kAlign * Arena::kAlign;
+}
+
+// n default-initialized Ts from the arena; an empty array for n == 0
+template <class T>
+bool carve(Arena& arena, ArenaArray<T>& a, std::size_t n) {
+    a.ptr = n > 0 ? arena.allocate<T>(n) : nullptr;
+    a.count = a.ptr ? n : 0;
+    return n == 0 || a.ptr != nullptr;
+}
+
+template <class T>
+void fill(ArenaArray<T>& a, const T& value) {
+    for (T& x : a) x = value;
+}
+
+std::size_t countEvents(const ArenaFleetSetup& setup) {
+    std::size_t n = 0;
+    if (setup.scripts) {
+        for (std::size_t i = 0; i < setup.lifts; ++i) n += setup.scripts[i].events.size();
+    }
+    return n;
+}
+
+} // namespace
+
+std::size_t ArenaFleet::arenaBytes(const ArenaFleetSetup& setup, std::size_t events) {
+    const std::size_t n = setup.lifts;
+    const bool scripted = setup.scripts != nullptr;
+    return 3 * blockBytes<double>(n) + blockBytes<LiftState>(n) + blockBytes<FaultCode>(n) + blockBytes<std::uint16_t>(n) +
+           blockBytes<Inputs>(n) + blockBytes<Outputs>(n) + blockBytes<std::uint32_t>(kCountersEnabled ? n : 0) +
+           blockBytes<ScriptEvent>(events) + blockBytes<std::uint32_t>(scripted ? n + 1 : 0) +
+           blockBytes<std::uint32_t>(scripted ? n : 0) + blockBytes<TraceRecord>(n * setup.historyScans);
+}
+
+bool ArenaFleet::reset(const ArenaFleetSetup& setup, std::string& error) {
+    clear();
+
+    const std::size_t n = setup.lifts;
+    const bool scripted = setup.scripts != nullptr;
+    const std::size_t totalEvents = countEvents(setup);
+    const bool carved = carve(arena_, position, n) && carve(arena_, velocity, n) && carve(arena_, targetVel, n) &&
+                        carve(arena_, state, n) && carve(arena_, latched, n) && carve(arena_, inputKey, n) &&
+                        carve(arena_, inputs, n) && carve(arena_, outputs, n) && carve(arena_, dwell, kCountersEnabled ? n : 0) &&
+                        carve(arena_, events, totalEvents) && carve(arena_, eventBegin, scripted ? n + 1 : 0) &&
+                        carve(arena_, nextEvent, scripted ? n : 0) && carve(arena_, history, n * setup.historyScans);
+    if (!carved) {
+        error = "arena too small: the scenario needs " + std::to_string(arenaBytes(setup, totalEvents)) +
+                " bytes, the arena has " + std::to_string(arena_.capacity() - base_);
+        clear();
+        return false;
+    }
+
+    // ---- Struct-initializer defaults (Inputs, Outputs and the rest are value-initialized by carve) ----
+    const LiftPlant plantInit{};
+    const LiftController ctrlInit{};
+    fill(position, plantInit.position);
+    fill(velocity, plantInit.velocity);
+    fill(targetVel, plantInit.targetVel);
+    fill(state, ctrlInit.state);
+    fill(latched, ctrlInit.faults.latched);
+    fill(inputKey, ctrlInit.inputKey);
+    tableController = setup.tableController;
+    historyScans = setup.historyScans;
+
+    if (scripted) {
+        std::uint32_t at = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            eventBegin[i] = at;
+            for (const ScriptEvent& e : setup.scripts[i].events) events[at++] = e;
+        }
+        eventBegin[n] = at;
+    }
+    return true;
+}
+
+void ArenaFleet::scan(double dt) {
+    const std::size_t n = size();
+    if (!eventBegin.empty()) {
+        for (std::size_t i = 0; i < n; ++i) {
+            inputs[i].resetFault = false;
+            std::uint32_t& e = nextEvent[i];
+            while (e < eventBegin[i + 1] - eventBegin[i] && events[eventBegin[i] + e].scan <= now) {
+                applyCommand(events[eventBegin[i] + e].cmd, inputs[i]);
+                ++e;
+            }
+        }
+    }
+
+    controlFleetRange(*this, 0, n, dt);
+    stepPlants(position.data(), velocity.data(), targetVel.data(), n, dt);
+
+    if (historyScans > 0) {
+        TraceRecord* slot = history.data() + static_cast<std::size_t>(now % static_cast<std::int64_t>(historyScans)) * n;
+        for (std::size_t i = 0; i < n; ++i) slot[i] = record(i);
+    }
+    ++now;
+}
+
+TraceRecord ArenaFleet::record(std::size_t lift) const {
+    LiftPlant plant{};
+    plant.position = position[lift];
+    plant.velocity = velocity[lift];
+    plant.targetVel = targetVel[lift];
+    return makeTraceRecord(inputs[lift], outputs[lift], plant, state[lift], latched[lift]);
+}
+
+const TraceRecord* ArenaFleet::historyAt(std::int64_t s, std::size_t lift) const {
+    const std::int64_t depth = static_cast<std::int64_t>(historyScans);
+    if (s < 0 || s >= now || s < now - depth || lift >= size()) return nullptr;
+    return &history[static_cast<std::size_t>(s % depth) * size() + lift];
+}
+
+void ArenaFleet::clear() {
+    arena_.rewind(base_);
+    position = {};
+    velocity = {};
+    targetVel = {};
+    state = {};
+    latched = {};
+    inputKey = {};
+    inputs = {};
+    outputs = {};
+    mast = {};
+    dwell = {};
+    liftCounters = {};
+    tableController = false;
+    events = {};
+    eventBegin = {};
+    nextEvent = {};
+    history = {};
+    historyScans = 0;
+    now = 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Arena.h"
+#include "LiftControl.h"
+#include "Script.h"
+#include "TraceFormat.h"
+
+// Scenario fleet whose every per-lift array lives in one Arena.
+//
+// The same structure-of-arrays layout and scan passes as LiftFleet, plus the
+// per-lift scenario scripts (copied in back to back) and a telemetry ring
+// of the last historyScans trace records of every lift. reset() rewinds the
+// arena to where the fleet began and carves everything again, each element
+// set to its struct-initializer default (bottomLimit = true, brakeEngaged
+// = true, Holding, no fault, ...), so a Monte Carlo or replay campaign runs
+// scenario after scenario out of the same warm pages with no malloc or free
+// per object. Scripted lifts scan the headless way: the reset pulse drops,
+// the scan's script events apply, then the scan runs.
+
+// Pointer and length into an Arena; valid until the next reset()
+template <class T>
+struct ArenaArray {
+    T* ptr = nullptr;
+    std::size_t count = 0;
+
+    T& operator[](std::size_t i) const { return ptr[i]; }
+    T* data() const { return ptr; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+};
+
+struct ArenaFleetSetup {
+    std::size_t lifts = 0;
+    std::size_t historyScans = 0;      // telemetry ring depth per lift; 0 = no ring
+    bool tableController = false;
+    const Script* scripts = nullptr;   // one per lift, or nullptr: the caller drives inputs[]
+};
+
+struct ArenaFleet {
+    // Same members as LiftFleet, so both run FleetPasses.h
+    ArenaArray<double> position;
+    ArenaArray<double> velocity;
+    ArenaArray<double> targetVel;
+    ArenaArray<LiftState> state;
+    ArenaArray<FaultCode> latched;
+    ArenaArray<std::uint16_t> inputKey;
+    ArenaArray<Inputs> inputs;
+    ArenaArray<Outputs> outputs;
+    ArenaArray<RuntimeMastConfig> mast;     // always empty: DefaultMast for every lift
+    ArenaArray<std::uint32_t> dwell;        // FORKLIFT_COUNTERS builds
+    ArenaArray<LiftCounters> liftCounters;  // always empty: lifts count into the thread aggregate
+    bool tableController = false;
+
+    // Scripts: lift i's events are events[eventBegin[i], eventBegin[i + 1])
+    ArenaArray<ScriptEvent> events;
+    ArenaArray<std::uint32_t> eventBegin;
+    ArenaArray<std::uint32_t> nextEvent;
+
+    // Telemetry ring, scan-major: the record of lift i after scan s is at
+    // history[(s % historyScans) * size() + i]
+    ArenaArray<TraceRecord> history;
+    std::size_t historyScans = 0;
+
+    std::int64_t now = 0;                   // scans run since reset()
+
+    // Uses arena from its current mark() on; anything allocated after that belongs to the fleet.
+    explicit ArenaFleet(Arena& arena) : arena_(arena), base_(arena.mark()) {}
+
+    ArenaFleet(const ArenaFleet&) = delete;
+    ArenaFleet& operator=(const ArenaFleet&) = delete;
+
+    // Arena bytes reset() needs for setup with `events` script events in total
+    static std::size_t arenaBytes(const ArenaFleetSetup& setup, std::size_t events);
+
+    // Rewind and rebuild for a new scenario. False if the arena is too small.
+    bool reset(const ArenaFleetSetup& setup, std::string& error);
+
+    std::size_t size() const { return position.size(); }
+
+    void scan(double dt);
+
+    // Lift state after the last scan, in trace form
+    TraceRecord record(std::size_t lift) const;
+
+    // Record of a lift after scan s, or nullptr if s has left the ring (or never ran)
+    const TraceRecord* historyAt(std::int64_t s, std::size_t lift) const;
+
+private:
+    void clear();
+
+    Arena& arena_;
+    const std::size_t base_;
+};
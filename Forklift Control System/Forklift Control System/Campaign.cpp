@@ -0,0 +1,329 @@
+#include "Campaign.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "LiftControl.h"
+#include "Rng.h"
+#include "WorkStealingPool.h"
+
+namespace {
+
+enum class LoadProfile { Constant, Step, Ramp };
+enum class StuckSwitch { None, Top, Bottom };
+
+// Everything about one scenario except the per-scan operator draws.
+struct Scenario {
+    LoadProfile load = LoadProfile::Constant;
+    double loadStart = 0.0;
+    double loadEnd = 0.0;
+    std::int64_t loadStepScan = 0;
+
+    std::int64_t estopOn = -1;     // -1 = never
+    std::int64_t estopOff = -1;
+
+    StuckSwitch stuck = StuckSwitch::None;
+    bool stuckValue = false;
+    std::int64_t stuckFrom = 0;
+
+    double startPosition = 0.0;
+};
+
+double drawLoad(SplitMix64& rng, double maxLoadKg) {
+    if (rng.chance(0.1)) return maxLoadKg; // exactly at the limit: must not trip
+    return rng.uniform(0.85, 1.15) * maxLoadKg;
+}
+
+Scenario drawScenario(SplitMix64& rng, std::int64_t scans, double maxLoadKg) {
+    Scenario s{};
+    const double profile = rng.uniform();
+    s.load = profile < 0.4 ? LoadProfile::Constant : profile < 0.7 ? LoadProfile::Step : LoadProfile::Ramp;
+    s.loadStart = drawLoad(rng, maxLoadKg);
+    s.loadEnd = drawLoad(rng, maxLoadKg);
+    s.loadStepScan = static_cast<std::int64_t>(rng.uniform() * scans);
+
+    if (rng.chance(0.5)) {
+        s.estopOn = static_cast<std::int64_t>(rng.uniform() * scans);
+        s.estopOff = s.estopOn + 1 + static_cast<std::int64_t>(rng.uniform() * 200);
+    }
+
+    if (rng.chance(0.25)) {
+        s.stuck = rng.chance(0.5) ? StuckSwitch::Top : StuckSwitch::Bottom;
+        s.stuckValue = rng.chance(0.5);
+        s.stuckFrom = static_cast<std::int64_t>(rng.uniform() * scans);
+    }
+
+    s.startPosition = rng.chance(0.5) ? rng.uniform() : 0.0;
+    return s;
+}
+
+double loadAt(const Scenario& s, std::int64_t scan, std::int64_t scans) {
+    switch (s.load) {
+    case LoadProfile::Constant: return s.loadStart;
+    case LoadProfile::Step:     return scan < s.loadStepScan ? s.loadStart : s.loadEnd;
+    case LoadProfile::Ramp:     return s.loadStart + (s.loadEnd - s.loadStart) * scan / scans;
+    }
+    return s.loadStart;
+}
+
+// LiftController that sees a stuck limit switch. scanLift derives the
+// limits from the plant first; this overrides the failed switch before
+// the real update() runs and keeps the view it passed on for the checks.
+struct InjectingController : LiftController {
+    StuckSwitch stuck = StuckSwitch::None;
+    bool stuckValue = false;
+    Inputs seen{};
+
+    Outputs update(double dt, const Inputs& in, LiftPlant& plant) {
+        seen = in;
+        if (stuck == StuckSwitch::Top) seen.topLimit = stuckValue;
+        if (stuck == StuckSwitch::Bottom) seen.bottomLimit = stuckValue;
+        return LiftController::update(dt, seen, plant);
+    }
+};
+
+int faultIndex(FaultCode f) {
+    switch (f) {
+    case FaultCode::None:           return 0;
+    case FaultCode::LimitViolation: return 1;
+    case FaultCode::Overload:       return 2;
+    case FaultCode::EmergencyStop:  return 3;
+    }
+    return 0;
+}
+
+FaultCode higher(FaultCode a, FaultCode b) {
+    return faultPriority(b) > faultPriority(a) ? b : a;
+}
+
+// Phase 1 written out from the spec: the highest fault raised by this scan.
+FaultCode raisedFault(const Inputs& in, LiftState before, double maxLoadKg) {
+    FaultCode f = FaultCode::None;
+    if (in.estop) f = higher(f, FaultCode::EmergencyStop);
+    if (in.loadKg > maxLoadKg) f = higher(f, FaultCode::Overload);
+    const bool limitFault = (in.topLimit && in.bottomLimit) ||
+                            (before == LiftState::Lifting && in.topLimit) ||
+                            (before == LiftState::Lowering && in.bottomLimit) ||
+                            (in.cmdUp && in.topLimit) || (in.cmdDown && in.bottomLimit);
+    if (limitFault) f = higher(f, FaultCode::LimitViolation);
+    return f;
+}
+
+struct ScanCheck {
+    std::uint64_t scenario;
+    CampaignStats& st;
+    bool failed[kCampaignChecks] = {};
+    bool hazard[kCampaignHazards] = {};
+
+    void fail(CampaignCheck c) { failed[static_cast<int>(c)] = true; }
+    void flag(CampaignHazard h) { hazard[static_cast<int>(h)] = true; }
+
+    // Count each check/hazard once per scenario
+    void commit() {
+        for (int c = 0; c < kCampaignChecks; ++c) {
+            if (!failed[c]) continue;
+            st.checkFailures[c]++;
+            st.firstFailure[c] = std::min(st.firstFailure[c], scenario);
+        }
+        for (int h = 0; h < kCampaignHazards; ++h) {
+            if (!hazard[h]) continue;
+            st.hazards[h]++;
+            st.firstHazard[h] = std::min(st.firstHazard[h], scenario);
+        }
+    }
+};
+
+void runScenario(std::uint64_t index, const CampaignOptions& opt, CampaignStats& st) {
+    SplitMix64 rng{ streamKey(opt.seed, index) };
+
+    InjectingController ctrl{};
+    LiftPlant plant{};
+    Inputs in{};
+
+    const std::int64_t scans = opt.scansPerScenario;
+    const Scenario sc = drawScenario(rng, scans, ctrl.maxLoadKg);
+    plant.position = sc.startPosition;
+
+    ScanCheck chk{ index, st };
+    std::int64_t segmentEnd = 0;
+
+    for (std::int64_t scan = 0; scan < scans; ++scan) {
+        // ---- Operator: command segments of random length, reset pulses ----
+        if (scan >= segmentEnd) {
+            const double u = rng.uniform();
+            in.cmdUp = u < 0.30 || (u >= 0.75 && u < 0.90);
+            in.cmdDown = (u >= 0.30 && u < 0.60) || (u >= 0.75 && u < 0.90);
+            in.cmdHold = u >= 0.60 && u < 0.75;
+            segmentEnd = scan + 10 + static_cast<std::int64_t>(rng.uniform() * 140);
+        }
+        in.resetFault = rng.chance(0.04);
+        in.estop = scan >= sc.estopOn && scan < sc.estopOff;
+        in.loadKg = loadAt(sc, scan, scans);
+        ctrl.stuck = scan >= sc.stuckFrom ? sc.stuck : StuckSwitch::None;
+        ctrl.stuckValue = sc.stuckValue;
+
+        const FaultCode before = ctrl.faults.latched;
+        const LiftState stateBefore = ctrl.state;
+        const double velBefore = plant.velocity;
+        const double posBefore = plant.position;
+
+        const Outputs out = scanLift(opt.dt, in, ctrl, plant);
+        const Inputs& seen = ctrl.seen;
+        const FaultCode after = ctrl.faults.latched;
+
+        // ---- Reset bookkeeping ----
+        const bool gateOpen = seen.resetFault && !seen.estop && std::abs(velBefore) < ctrl.safeStopSpeedEps;
+        const FaultCode raised = raisedFault(seen, stateBefore, ctrl.maxLoadKg);
+        const FaultCode latchedBeforeReset = higher(before, raised);
+        if (seen.resetFault && latchedBeforeReset != FaultCode::None) {
+            st.resetRequests++;
+            if (gateOpen) st.resetsAccepted++;
+            else if (seen.estop) st.resetsBlockedEstop++;
+            else st.resetsBlockedMoving++;
+        }
+        if (after != before) st.latchEvents[faultIndex(after)]++;
+        if (before != FaultCode::None && faultPriority(after) > faultPriority(before)) st.escalations++;
+
+        // ---- Controller contract ----
+        const FaultCode expected = gateOpen ? FaultCode::None : latchedBeforeReset;
+        if (after != expected) chk.fail(CampaignCheck::LatchPriority);
+        if (before != FaultCode::None && after == FaultCode::None && !gateOpen) chk.fail(CampaignCheck::ResetGate);
+
+        const bool safe = !out.motorEnable && out.motorDir == 0 && out.brakeEngaged && plant.targetVel == 0.0;
+        if (seen.estop && !(safe && ctrl.state == LiftState::Faulted && after == FaultCode::EmergencyStop)) {
+            chk.fail(CampaignCheck::EstopSafe);
+        }
+        const bool faulted = ctrl.state == LiftState::Faulted;
+        if (faulted != (after != FaultCode::None) || (faulted && !(safe && out.faultLamp)) ||
+            (!faulted && out.faultLamp)) {
+            chk.fail(CampaignCheck::FaultedSafe);
+        }
+        if (seen.cmdUp && seen.cmdDown && out.motorEnable) chk.fail(CampaignCheck::ConflictHolds);
+        if ((out.motorDir > 0 && seen.topLimit) || (out.motorDir < 0 && seen.bottomLimit)) {
+            chk.fail(CampaignCheck::LimitRespected);
+        }
+
+        // ---- Physical outcome ----
+        if ((out.motorDir > 0 && posBefore >= 0.9999) || (out.motorDir < 0 && posBefore <= 0.0001)) {
+            chk.flag(CampaignHazard::EndStopDrive);
+        }
+        if (out.motorEnable && seen.loadKg > ctrl.maxLoadKg) chk.flag(CampaignHazard::OverloadMotion);
+    }
+
+    st.scenarios++;
+    st.scans += static_cast<std::uint64_t>(scans);
+    if (ctrl.state == LiftState::Faulted) st.endedFaulted++;
+    chk.commit();
+}
+
+// One accumulator per worker, on its own cache lines.
+struct alignas(64) WorkerStats {
+    CampaignStats stats;
+};
+
+} // namespace
+
+const char* campaignCheckToString(CampaignCheck c) {
+    switch (c) {
+    case CampaignCheck::LatchPriority:  return "LatchPriority";
+    case CampaignCheck::ResetGate:      return "ResetGate";
+    case CampaignCheck::EstopSafe:      return "EstopSafe";
+    case CampaignCheck::FaultedSafe:    return "FaultedSafe";
+    case CampaignCheck::ConflictHolds:  return "ConflictHolds";
+    case CampaignCheck::LimitRespected: return "LimitRespected";
+    default:                            return "Unknown";
+    }
+}
+
+const char* campaignHazardToString(CampaignHazard h) {
+    switch (h) {
+    case CampaignHazard::EndStopDrive:   return "EndStopDrive";
+    case CampaignHazard::OverloadMotion: return "OverloadMotion";
+    default:                             return "Unknown";
+    }
+}
+
+CampaignStats::CampaignStats() {
+    std::fill(std::begin(firstFailure), std::end(firstFailure), kNoScenario);
+    std::fill(std::begin(firstHazard), std::end(firstHazard), kNoScenario);
+}
+
+void CampaignStats::merge(const CampaignStats& o) {
+    scenarios += o.scenarios;
+    scans += o.scans;
+    for (int i = 0; i < 4; ++i) latchEvents[i] += o.latchEvents[i];
+    escalations += o.escalations;
+    resetRequests += o.resetRequests;
+    resetsAccepted += o.resetsAccepted;
+    resetsBlockedEstop += o.resetsBlockedEstop;
+    resetsBlockedMoving += o.resetsBlockedMoving;
+    endedFaulted += o.endedFaulted;
+    for (int c = 0; c < kCampaignChecks; ++c) {
+        checkFailures[c] += o.checkFailures[c];
+        firstFailure[c] = std::min(firstFailure[c], o.firstFailure[c]);
+    }
+    for (int h = 0; h < kCampaignHazards; ++h) {
+        hazards[h] += o.hazards[h];
+        firstHazard[h] = std::min(firstHazard[h], o.firstHazard[h]);
+    }
+}
+
+std::uint64_t CampaignStats::totalFailures() const {
+    std::uint64_t n = 0;
+    for (std::uint64_t f : checkFailures) n += f;
+    return n;
+}
+
+CampaignReport runCampaign(const CampaignOptions& opt) {
+    WorkStealingPool pool(opt.threads);
+    std::vector<WorkerStats> perWorker(pool.threads());
+
+    const auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(opt.scenarios, 256, [&](unsigned worker, std::uint64_t begin, std::uint64_t end) {
+        CampaignStats& st = perWorker[worker].stats;
+        for (std::uint64_t i = begin; i < end; ++i) runScenario(i, opt, st);
+    });
+    const auto t1 = std::chrono::steady_clock::now();
+
+    CampaignReport r{};
+    for (const WorkerStats& w : perWorker) r.stats.merge(w.stats);
+    r.threads = pool.threads();
+    r.steals = pool.steals();
+    r.wallSeconds = std::chrono::duration<double>(t1 - t0).count();
+    return r;
+}
+
+void printCampaignReport(std::ostream& os, const CampaignReport& r, const CampaignOptions& opt) {
+    const CampaignStats& s = r.stats;
+    os << "campaign: seed=" << opt.seed << " scenarios=" << s.scenarios
+        << " scans/scenario=" << opt.scansPerScenario << " scans=" << s.scans << "\n";
+    os << "  latched: LimitViolation=" << s.latchEvents[1] << " Overload=" << s.latchEvents[2]
+        << " EmergencyStop=" << s.latchEvents[3] << " cleared=" << s.latchEvents[0]
+        << " escalations=" << s.escalations << "\n";
+    os << "  resets: requested=" << s.resetRequests << " accepted=" << s.resetsAccepted
+        << " blocked(estop)=" << s.resetsBlockedEstop << " blocked(moving)=" << s.resetsBlockedMoving
+        << " endedFaulted=" << s.endedFaulted << "\n";
+
+    os << "  checks (scenarios failing):\n";
+    for (int c = 0; c < kCampaignChecks; ++c) {
+        os << "    " << campaignCheckToString(static_cast<CampaignCheck>(c)) << "=" << s.checkFailures[c];
+        if (s.checkFailures[c] > 0) os << " first=" << s.firstFailure[c];
+        os << "\n";
+    }
+    os << "  hazards (scenarios affected):\n";
+    for (int h = 0; h < kCampaignHazards; ++h) {
+        os << "    " << campaignHazardToString(static_cast<CampaignHazard>(h)) << "=" << s.hazards[h];
+        if (s.hazards[h] > 0) os << " first=" << s.firstHazard[h];
+        os << "\n";
+    }
+
+    os << std::fixed << std::setprecision(3)
+        << "timing: threads=" << r.threads << " steals=" << r.steals << " time=" << r.wallSeconds << "s"
+        << " scenarios/s=" << (r.wallSeconds > 0.0 ? s.scenarios / r.wallSeconds : 0.0)
+        << " scans/s=" << (r.wallSeconds > 0.0 ? s.scans / r.wallSeconds : 0.0)
+        << "\n";
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+// Monte Carlo fault-injection campaign.
+//
+// Runs many independent, seeded scenarios through the real scan path
+// (scanLift with a LiftController) and checks the controller's safety
+// contract after every scan. Scenarios vary:
+//   - load profile around maxLoadKg (constant, step, ramp; sometimes exactly at the limit)
+//   - E-stop press time and hold length
+//   - operator segments, including cmdUp and cmdDown held together
+//   - reset pulses
+//   - a limit switch stuck active or inactive from some scan on
+//
+// Scenario i draws only from its own stream (streamKey(seed, i)) and all
+// results are integer sums and minimums, so the report is the same for
+// any thread count.
+
+enum class CampaignCheck : int {
+    LatchPriority,   // latched == max(previous, raised this scan), or None after an accepted reset
+    ResetGate,       // a latch only clears on reset && !estop && |v| < safeStopSpeedEps
+    EstopSafe,       // E-stop => Faulted on EmergencyStop, motor off, brake on
+    FaultedSafe,     // Faulted <=> fault latched; Faulted => motor off, brake on, lamp on
+    ConflictHolds,   // cmdUp && cmdDown => motor off
+    LimitRespected,  // never drive toward an active limit switch
+    Count,
+};
+
+// Physical outcomes the controller cannot see (counted, not failures).
+enum class CampaignHazard : int {
+    EndStopDrive,    // motor driven into an end stop whose switch is stuck inactive
+    OverloadMotion,  // motor enabled while load > maxLoadKg
+    Count,
+};
+
+const char* campaignCheckToString(CampaignCheck c);
+const char* campaignHazardToString(CampaignHazard h);
+
+inline constexpr int kCampaignChecks = static_cast<int>(CampaignCheck::Count);
+inline constexpr int kCampaignHazards = static_cast<int>(CampaignHazard::Count);
+inline constexpr std::uint64_t kNoScenario = std::numeric_limits<std::uint64_t>::max();
+
+struct CampaignOptions {
+    std::uint64_t scenarios = 100000;
+    std::uint64_t seed = 1;
+    unsigned threads = 0;                 // 0 = one per hardware thread
+    std::uint32_t scansPerScenario = 500; // 10 s at 20 ms
+    double dt = 0.02;
+};
+
+struct CampaignStats {
+    std::uint64_t scenarios = 0;
+    std::uint64_t scans = 0;
+
+    std::uint64_t latchEvents[4] = {};    // latched fault changed to None/LimitViolation/Overload/EmergencyStop
+    std::uint64_t escalations = 0;        // latch replaced by a higher-priority fault
+    std::uint64_t resetRequests = 0;      // reset pulse while a fault was latched
+    std::uint64_t resetsAccepted = 0;
+    std::uint64_t resetsBlockedEstop = 0;
+    std::uint64_t resetsBlockedMoving = 0;
+    std::uint64_t endedFaulted = 0;       // scenarios whose last scan was Faulted
+
+    std::uint64_t checkFailures[kCampaignChecks] = {};
+    std::uint64_t firstFailure[kCampaignChecks];   // scenario index, kNoScenario if none
+    std::uint64_t hazards[kCampaignHazards] = {};
+    std::uint64_t firstHazard[kCampaignHazards];
+
+    CampaignStats();
+
+    // Order-independent: sums counters, keeps the lowest scenario indices.
+    void merge(const CampaignStats& o);
+
+    std::uint64_t totalFailures() const;
+};
+
+struct CampaignReport {
+    CampaignStats stats;
+    unsigned threads = 0;
+    std::uint64_t steals = 0;
+    double wallSeconds = 0.0;
+};
+
+CampaignReport runCampaign(const CampaignOptions& opt);
+
+// Deterministic part (stats) first, then one timing line.
+void printCampaignReport(std::ostream& os, const CampaignReport& r, const CampaignOptions& opt);
@@ -0,0 +1,1085 @@
+#include "ColumnarExport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "LiftFleet.h"
+#include "MappedFile.h"
+#include "PackedFleet.h"
+#include "ScanCounters.h"
+
+namespace {
+
+// ---- Schema ----
+
+// Parquet physical types and encodings (parquet.thrift)
+enum : int { kBoolean = 0, kInt32 = 1, kInt64 = 2, kByteArray = 6 };
+enum : int { kPlain = 0, kRle = 3, kDeltaBinaryPacked = 5, kRleDictionary = 8 };
+
+enum class ColumnEncoding { Delta, Dictionary, Boolean };
+
+struct ColumnSpec {
+    const char* name;
+    int physical;
+    int scale;                 // DECIMAL(18, scale); -1 = plain integer
+    ColumnEncoding encoding;
+};
+
+// Same order as kColumns
+enum Col : std::size_t {
+    ColScan, ColLift, ColPosition, ColVelocity, ColTargetVel, ColLoadKg, ColState, ColFault,
+    ColCmdUp, ColCmdDown, ColCmdHold, ColEstop, ColResetFault, ColTopLimit, ColBottomLimit, ColCmdGoTo,
+    ColMotorEnable, ColBrakeEngaged, ColFaultLamp, ColMotorDir, kColumnCount
+};
+
+const ColumnSpec kColumns[] = {
+    { "scan", kInt64, -1, ColumnEncoding::Delta },
+    { "lift", kInt32, -1, ColumnEncoding::Delta },
+    { "position", kInt64, 9, ColumnEncoding::Delta },
+    { "velocity", kInt64, 9, ColumnEncoding::Delta },
+    { "target_vel", kInt64, 9, ColumnEncoding::Delta },
+    { "load_kg", kInt64, 3, ColumnEncoding::Delta },
+    { "state", kByteArray, -1, ColumnEncoding::Dictionary },
+    { "fault", kByteArray, -1, ColumnEncoding::Dictionary },
+    { "cmd_up", kBoolean, -1, ColumnEncoding::Boolean },
+    { "cmd_down", kBoolean, -1, ColumnEncoding::Boolean },
+    { "cmd_hold", kBoolean, -1, ColumnEncoding::Boolean },
+    { "estop", kBoolean, -1, ColumnEncoding::Boolean },
+    { "reset_fault", kBoolean, -1, ColumnEncoding::Boolean },
+    { "top_limit", kBoolean, -1, ColumnEncoding::Boolean },
+    { "bottom_limit", kBoolean, -1, ColumnEncoding::Boolean },
+    { "cmd_go_to", kBoolean, -1, ColumnEncoding::Boolean },
+    { "motor_enable", kBoolean, -1, ColumnEncoding::Boolean },
+    { "brake_engaged", kBoolean, -1, ColumnEncoding::Boolean },
+    { "fault_lamp", kBoolean, -1, ColumnEncoding::Boolean },
+    { "motor_dir", kInt32, -1, ColumnEncoding::Delta },
+};
+static_assert(sizeof(kColumns) / sizeof(kColumns[0]) == kColumnCount, "one spec per column");
+
+const int kDecimalPrecision = 18;
+const int kFaultSlots = 4;
+
+// Dictionary index = LiftState value / faultSlot(); bit width of the indices
+int dictionarySize(std::size_t c) { return c == ColState ? kLiftStates : kFaultSlots; }
+int dictionaryBitWidth(std::size_t c) { return c == ColState ? 3 : 2; }
+const char* dictionaryEntry(std::size_t c, int index) {
+    return c == ColState ? stateToString(static_cast<LiftState>(index))
+                         : faultToString(static_cast<FaultCode>(index * 10));
+}
+
+std::int64_t toDecimal(double v, int scale) { return std::llround(v * (scale == 9 ? 1e9 : 1e3)); }
+double fromDecimal(std::int64_t v, int scale) { return static_cast<double>(v) / (scale == 9 ? 1e9 : 1e3); }
+
+// (input or output bits, mask) of a boolean column
+bool boolBit(std::size_t c, bool& output, std::uint8_t& mask) {
+    static const std::uint8_t kMasks[] = {
+        kInCmdUp, kInCmdDown, kInCmdHold, kInEstop, kInResetFault, kInTopLimit, kInBottomLimit, kInCmdGoTo,
+        kOutMotorEnable, kOutBrakeEngaged, kOutFaultLamp,
+    };
+    if (c < ColCmdUp || c > ColFaultLamp) return false;
+    output = c >= ColMotorEnable;
+    mask = kMasks[c - ColCmdUp];
+    return true;
+}
+
+template <class F>
+void fillColumn(const std::vector<ExportRow>& rows, std::vector<std::int64_t>& v, F value) {
+    for (std::size_t i = 0; i < rows.size(); ++i) v[i] = value(rows[i]);
+}
+
+// Column c of every row, one loop per column rather than a switch per value
+void columnValues(std::size_t c, const std::vector<ExportRow>& rows, std::vector<std::int64_t>& v) {
+    switch (c) {
+    case ColScan: return fillColumn(rows, v, [](const ExportRow& x) { return static_cast<std::int64_t>(x.scan); });
+    case ColLift: return fillColumn(rows, v, [](const ExportRow& x) { return static_cast<std::int64_t>(x.lift); });
+    case ColPosition: return fillColumn(rows, v, [](const ExportRow& x) { return toDecimal(x.record.position, 9); });
+    case ColVelocity: return fillColumn(rows, v, [](const ExportRow& x) { return toDecimal(x.record.velocity, 9); });
+    case ColTargetVel: return fillColumn(rows, v, [](const ExportRow& x) { return toDecimal(x.record.targetVel, 9); });
+    case ColLoadKg: return fillColumn(rows, v, [](const ExportRow& x) { return toDecimal(x.record.loadKg, 3); });
+    case ColState: return fillColumn(rows, v, [](const ExportRow& x) { return static_cast<std::int64_t>(x.record.state); });
+    case ColFault:
+        return fillColumn(rows, v, [](const ExportRow& x) {
+            return static_cast<std::int64_t>(faultSlot(static_cast<FaultCode>(x.record.fault)));
+        });
+    case ColMotorDir:
+        return fillColumn(rows, v, [](const ExportRow& x) -> std::int64_t {
+            return (x.record.outputBits & kOutDirUp) ? 1 : (x.record.outputBits & kOutDirDown) ? -1 : 0;
+        });
+    default: break;
+    }
+    bool output = false;
+    std::uint8_t mask = 0;
+    boolBit(c, output, mask);
+    if (output) fillColumn(rows, v, [mask](const ExportRow& x) { return static_cast<std::int64_t>((x.record.outputBits & mask) != 0); });
+    else fillColumn(rows, v, [mask](const ExportRow& x) { return static_cast<std::int64_t>((x.record.inputBits & mask) != 0); });
+}
+
+void setColumnValue(std::size_t c, ExportRow& row, std::int64_t v) {
+    TraceRecord& r = row.record;
+    switch (c) {
+    case ColScan: row.scan = static_cast<std::uint64_t>(v); return;
+    case ColLift: row.lift = static_cast<std::uint32_t>(v); return;
+    case ColPosition: r.position = fromDecimal(v, 9); return;
+    case ColVelocity: r.velocity = fromDecimal(v, 9); return;
+    case ColTargetVel: r.targetVel = fromDecimal(v, 9); return;
+    case ColLoadKg: r.loadKg = fromDecimal(v, 3); return;
+    case ColState: r.state = static_cast<std::uint8_t>(v); return;
+    case ColFault: r.fault = static_cast<std::uint8_t>(v * 10); return;
+    case ColMotorDir:
+        if (v > 0) r.outputBits |= kOutDirUp;
+        if (v < 0) r.outputBits |= kOutDirDown;
+        return;
+    default: break;
+    }
+    bool output = false;
+    std::uint8_t mask = 0;
+    boolBit(c, output, mask);
+    if (v) (output ? r.outputBits : r.inputBits) |= mask;
+}
+
+// ---- Encoders ----
+
+void putUleb(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+void putZigzag(std::vector<std::uint8_t>& out, std::int64_t v) {
+    putUleb(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+void putLe(std::vector<std::uint8_t>& out, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+// LSB-first bit packing, as Parquet's bit-packed runs and plain booleans use it
+struct BitPacker {
+    std::vector<std::uint8_t>& out;
+    std::uint64_t pending = 0;
+    int bits = 0;   // in pending, fewer than 8 between calls
+
+    void put(std::uint64_t v, int width) {
+        if (width > 56) {
+            put(v & 0xFFFFFFFFu, 32);
+            put(v >> 32, width - 32);
+            return;
+        }
+        pending |= (v & ((std::uint64_t{ 1 } << width) - 1)) << bits;
+        bits += width;
+        for (; bits >= 8; bits -= 8) {
+            out.push_back(static_cast<std::uint8_t>(pending));
+            pending >>= 8;
+        }
+    }
+
+    // Pads the last byte with zeros
+    void finish() {
+        if (bits > 0) out.push_back(static_cast<std::uint8_t>(pending));
+        pending = 0;
+        bits = 0;
+    }
+};
+
+int bitWidth(std::uint64_t v) {
+    int w = 0;
+    while (v) { ++w; v >>= 1; }
+    return w;
+}
+
+// DELTA_BINARY_PACKED: blocks of 128 deltas in 4 miniblocks of 32. Wrapping
+// arithmetic, as the format specifies, so any int64 sequence round-trips.
+const std::size_t kDeltaBlock = 128;
+const std::size_t kDeltaMiniblocks = 4;
+const std::size_t kDeltaMiniblock = kDeltaBlock / kDeltaMiniblocks;
+
+// One miniblock of width-bit values, LSB first: exactly 4 * width bytes
+void packMiniblock(const std::uint64_t* v, int width, std::vector<std::uint8_t>& out) {
+    const std::size_t at = out.size();
+    out.resize(at + kDeltaMiniblock / 8 * static_cast<std::size_t>(width));
+    std::uint8_t* dst = out.data() + at;
+    if (width > 56) {
+        // Wide deltas (a jump in a wrapped sequence): the general path
+        std::vector<std::uint8_t> bytes;
+        BitPacker bits{ bytes };
+        for (std::size_t k = 0; k < kDeltaMiniblock; ++k) bits.put(v[k], width);
+        bits.finish();
+        std::memcpy(dst, bytes.data(), bytes.size());
+        return;
+    }
+    std::uint64_t pending = 0;
+    int bits = 0;
+    for (std::size_t k = 0; k < kDeltaMiniblock; ++k) {
+        pending |= v[k] << bits;
+        bits += width;
+        for (; bits >= 8; bits -= 8) {
+            *dst++ = static_cast<std::uint8_t>(pending);
+            pending >>= 8;
+        }
+    }
+}
+
+void encodeDelta(const std::vector<std::int64_t>& v, std::vector<std::uint8_t>& out) {
+    putUleb(out, kDeltaBlock);
+    putUleb(out, kDeltaMiniblocks);
+    putUleb(out, v.size());
+    putZigzag(out, v.empty() ? 0 : v[0]);
+
+    std::uint64_t deltas[kDeltaBlock];
+    for (std::size_t i = 1; i < v.size(); i += kDeltaBlock) {
+        const std::size_t n = std::min(kDeltaBlock, v.size() - i);
+        std::int64_t minDelta = std::numeric_limits<std::int64_t>::max();
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint64_t d = static_cast<std::uint64_t>(v[i + k]) - static_cast<std::uint64_t>(v[i + k - 1]);
+            deltas[k] = d;
+            minDelta = std::min(minDelta, static_cast<std::int64_t>(d));
+        }
+        for (std::size_t k = 0; k < kDeltaBlock; ++k)
+            deltas[k] = k < n ? deltas[k] - static_cast<std::uint64_t>(minDelta) : 0;
+
+        putZigzag(out, minDelta);
+        int widths[kDeltaMiniblocks] = {};
+        for (std::size_t m = 0; m * kDeltaMiniblock < n; ++m) {
+            std::uint64_t bits = 0;
+            for (std::size_t k = 0; k < kDeltaMiniblock; ++k) bits |= deltas[m * kDeltaMiniblock + k];
+            widths[m] = bitWidth(bits);
+        }
+        for (int w : widths) out.push_back(static_cast<std::uint8_t>(w));
+
+        // Miniblocks past the last value are not stored; the last one is padded
+        for (std::size_t m = 0; m * kDeltaMiniblock < n; ++m) packMiniblock(deltas + m * kDeltaMiniblock, widths[m], out);
+    }
+}
+
+// RLE_DICTIONARY data: the index bit width, then RLE runs (the indices come
+// in long runs of one state once the rows are sorted by lift)
+void encodeDictionaryIndices(const std::vector<std::int64_t>& v, int width, std::vector<std::uint8_t>& out) {
+    out.push_back(static_cast<std::uint8_t>(width));
+    for (std::size_t i = 0; i < v.size();) {
+        std::size_t j = i + 1;
+        while (j < v.size() && v[j] == v[i]) ++j;
+        putUleb(out, static_cast<std::uint64_t>(j - i) << 1);
+        out.push_back(static_cast<std::uint8_t>(v[i]));
+        i = j;
+    }
+}
+
+void encodeBooleans(const std::vector<std::int64_t>& v, std::vector<std::uint8_t>& out) {
+    BitPacker bits{ out };
+    for (std::int64_t b : v) bits.put(b != 0, 1);
+    bits.finish();
+}
+
+// Thrift compact protocol, just the parts the footer and page headers use
+class CompactWriter {
+public:
+    enum : int { kTrue = 1, kFalse = 2, kI32 = 5, kI64 = 6, kBinary = 8, kList = 9, kStruct = 12 };
+
+    explicit CompactWriter(std::vector<std::uint8_t>& out) : out_(out) {}
+
+    void i32(int id, std::int32_t v) { field(id, kI32); putZigzag(out_, v); }
+    void i64(int id, std::int64_t v) { field(id, kI64); putZigzag(out_, v); }
+    void binary(int id, const void* p, std::size_t n) {
+        field(id, kBinary);
+        putUleb(out_, n);
+        const std::uint8_t* b = static_cast<const std::uint8_t*>(p);
+        out_.insert(out_.end(), b, b + n);
+    }
+    void string(int id, const std::string& s) { binary(id, s.data(), s.size()); }
+
+    void beginStruct(int id) { field(id, kStruct); beginElement(); }
+    void beginElement() { stack_.push_back(last_); last_ = 0; }   // a struct in a list
+    void endStruct() {
+        out_.push_back(0);
+        last_ = stack_.back();
+        stack_.pop_back();
+    }
+
+    void beginList(int id, int elementType, std::size_t n) {
+        field(id, kList);
+        if (n < 15) out_.push_back(static_cast<std::uint8_t>((n << 4) | elementType));
+        else { out_.push_back(static_cast<std::uint8_t>(0xF0 | elementType)); putUleb(out_, n); }
+    }
+    void listI32(std::int32_t v) { putZigzag(out_, v); }
+    void listString(const char* s) {
+        const std::size_t n = std::strlen(s);
+        putUleb(out_, n);
+        out_.insert(out_.end(), s, s + n);
+    }
+
+private:
+    void field(int id, int type) {
+        if (id > last_ && id - last_ <= 15) out_.push_back(static_cast<std::uint8_t>(((id - last_) << 4) | type));
+        else { out_.push_back(static_cast<std::uint8_t>(type)); putZigzag(out_, id); }
+        last_ = id;
+    }
+
+    std::vector<std::uint8_t>& out_;
+    int last_ = 0;
+    std::vector<int> stack_;
+};
+
+void pageHeader(std::vector<std::uint8_t>& out, bool dictionary, std::size_t bytes, std::size_t values, int encoding) {
+    out.clear();
+    CompactWriter w(out);
+    w.beginElement();
+    w.i32(1, dictionary ? 2 : 0);                  // DICTIONARY_PAGE / DATA_PAGE
+    w.i32(2, static_cast<std::int32_t>(bytes));    // uncompressed
+    w.i32(3, static_cast<std::int32_t>(bytes));    // compressed (no codec)
+    w.beginStruct(dictionary ? 7 : 5);
+    w.i32(1, static_cast<std::int32_t>(values));
+    w.i32(2, encoding);
+    if (!dictionary) {
+        w.i32(3, kRle);                            // definition / repetition levels: none, all required
+        w.i32(4, kRle);
+    }
+    w.endStruct();
+    w.endStruct();
+}
+
+} // namespace
+
+// ---- ParquetTraceWriter ----
+
+ParquetTraceWriter::~ParquetTraceWriter() {
+    if (file_) close();
+}
+
+bool ParquetTraceWriter::open(const std::string& path, std::uint32_t lifts, double dt, std::string& error) {
+    if (file_) close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        error = "cannot create " + path;
+        return false;
+    }
+    ok_ = true;
+    lifts_ = lifts;
+    dt_ = dt;
+    offset_ = 0;
+    rows_ = 0;
+    groups_.clear();
+    static const std::vector<std::uint8_t> kMagic = { 'P', 'A', 'R', '1' };
+    if (!write(kMagic)) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool ParquetTraceWriter::write(const std::vector<std::uint8_t>& bytes) {
+    ok_ = ok_ && std::fwrite(bytes.data(), 1, bytes.size(), file_) == bytes.size();
+    offset_ += bytes.size();
+    return ok_;
+}
+
+void ParquetTraceWriter::sortRows(std::vector<ExportRow>& rows) {
+    // Rows from a scan loop come scan by scan, lifts in order: a stable
+    // counting sort by lift puts them in (lift, scan) order in O(n).
+    std::uint32_t maxLift = 0;
+    bool byScan = true;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        maxLift = std::max(maxLift, rows[i].lift);
+        byScan = byScan && (i == 0 || rows[i - 1].scan <= rows[i].scan);
+    }
+    if (!byScan || maxLift >= rows.size()) {
+        std::sort(rows.begin(), rows.end(), [](const ExportRow& a, const ExportRow& b) {
+            return a.lift != b.lift ? a.lift < b.lift : a.scan < b.scan;
+        });
+        return;
+    }
+    liftStart_.assign(static_cast<std::size_t>(maxLift) + 2, 0);
+    for (const ExportRow& row : rows) liftStart_[row.lift + 1]++;
+    for (std::size_t k = 1; k < liftStart_.size(); ++k) liftStart_[k] += liftStart_[k - 1];
+    sorted_.resize(rows.size());
+    for (const ExportRow& row : rows) sorted_[liftStart_[row.lift]++] = row;
+    rows.swap(sorted_);
+}
+
+bool ParquetTraceWriter::writeRowGroup(std::vector<ExportRow>& rows) {
+    if (!file_ || !ok_) return false;
+    if (rows.empty()) return true;
+    sortRows(rows);
+
+    RowGroupMeta group;
+    group.rows = rows.size();
+    values_.resize(rows.size());
+    for (std::size_t c = 0; c < kColumnCount; ++c) {
+        const ColumnSpec& spec = kColumns[c];
+        ColumnChunkMeta chunk;
+        const std::uint64_t start = offset_;
+        columnValues(c, rows, values_);
+
+        if (spec.encoding == ColumnEncoding::Dictionary) {
+            // Every entry, so the index is the enum value whatever this group holds
+            page_.clear();
+            for (int k = 0; k < dictionarySize(c); ++k) {
+                const char* s = dictionaryEntry(c, k);
+                const std::size_t n = std::strlen(s);
+                putLe(page_, n, 4);
+                page_.insert(page_.end(), s, s + n);
+            }
+            pageHeader(header_, true, page_.size(), static_cast<std::size_t>(dictionarySize(c)), kPlain);
+            chunk.dictionaryOffset = offset_;
+            write(header_);
+            write(page_);
+        }
+
+        page_.clear();
+        int encoding = kPlain;
+        switch (spec.encoding) {
+        case ColumnEncoding::Delta:
+            encodeDelta(values_, page_);
+            encoding = kDeltaBinaryPacked;
+            chunk.hasStatistics = true;
+            chunk.min = *std::min_element(values_.begin(), values_.end());
+            chunk.max = *std::max_element(values_.begin(), values_.end());
+            break;
+        case ColumnEncoding::Dictionary:
+            encodeDictionaryIndices(values_, dictionaryBitWidth(c), page_);
+            encoding = kRleDictionary;
+            break;
+        case ColumnEncoding::Boolean:
+            encodeBooleans(values_, page_);
+            break;
+        }
+        pageHeader(header_, false, page_.size(), rows.size(), encoding);
+        chunk.dataOffset = offset_;
+        write(header_);
+        write(page_);
+
+        chunk.bytes = offset_ - start;
+        group.bytes += chunk.bytes;
+        group.columns.push_back(chunk);
+    }
+    if (!ok_) return false;
+    rows_ += rows.size();
+    groups_.push_back(std::move(group));
+    return true;
+}
+
+bool ParquetTraceWriter::close() {
+    if (!file_) return false;
+
+    std::vector<std::uint8_t>& footer = header_;
+    footer.clear();
+    CompactWriter w(footer);
+    w.beginElement();   // FileMetaData
+    w.i32(1, 1);        // version
+
+    w.beginList(2, CompactWriter::kStruct, kColumnCount + 1);
+    w.beginElement();
+    w.string(4, "schema");
+    w.i32(5, static_cast<std::int32_t>(kColumnCount));
+    w.endStruct();
+    for (const ColumnSpec& spec : kColumns) {
+        w.beginElement();
+        w.i32(1, spec.physical);
+        w.i32(3, 0);    // REQUIRED
+        w.string(4, spec.name);
+        if (spec.physical == kByteArray) {
+            w.i32(6, 0);                    // converted type UTF8
+            w.beginStruct(10);              // logical type STRING
+            w.beginStruct(1);
+            w.endStruct();
+            w.endStruct();
+        } else if (spec.scale >= 0) {
+            w.i32(6, 5);                    // converted type DECIMAL
+            w.i32(7, spec.scale);
+            w.i32(8, kDecimalPrecision);
+            w.beginStruct(10);              // logical type DECIMAL
+            w.beginStruct(5);
+            w.i32(1, spec.scale);
+            w.i32(2, kDecimalPrecision);
+            w.endStruct();
+            w.endStruct();
+        }
+        w.endStruct();
+    }
+
+    w.i64(3, static_cast<std::int64_t>(rows_));
+
+    w.beginList(4, CompactWriter::kStruct, groups_.size());
+    for (const RowGroupMeta& g : groups_) {
+        w.beginElement();
+        w.beginList(1, CompactWriter::kStruct, g.columns.size());
+        for (std::size_t c = 0; c < g.columns.size(); ++c) {
+            const ColumnSpec& spec = kColumns[c];
+            const ColumnChunkMeta& m = g.columns[c];
+            w.beginElement();   // ColumnChunk
+            w.i64(2, static_cast<std::int64_t>(m.dictionaryOffset ? m.dictionaryOffset : m.dataOffset));
+            w.beginStruct(3);   // ColumnMetaData
+            w.i32(1, spec.physical);
+            const bool dictionary = spec.encoding == ColumnEncoding::Dictionary;
+            w.beginList(2, CompactWriter::kI32, dictionary ? 2 : 1);
+            if (dictionary) {
+                w.listI32(kPlain);
+                w.listI32(kRleDictionary);
+            } else {
+                w.listI32(spec.encoding == ColumnEncoding::Delta ? kDeltaBinaryPacked : kPlain);
+            }
+            w.beginList(3, CompactWriter::kBinary, 1);
+            w.listString(spec.name);
+            w.i32(4, 0);        // UNCOMPRESSED
+            w.i64(5, static_cast<std::int64_t>(g.rows));
+            w.i64(6, static_cast<std::int64_t>(m.bytes));
+            w.i64(7, static_cast<std::int64_t>(m.bytes));
+            w.i64(9, static_cast<std::int64_t>(m.dataOffset));
+            if (m.dictionaryOffset) w.i64(11, static_cast<std::int64_t>(m.dictionaryOffset));
+            if (m.hasStatistics) {
+                // Plain encoded, as an INT32 or INT64 is stored
+                const int width = spec.physical == kInt32 ? 4 : 8;
+                std::vector<std::uint8_t> lo, hi;
+                putLe(lo, static_cast<std::uint64_t>(m.min), width);
+                putLe(hi, static_cast<std::uint64_t>(m.max), width);
+                w.beginStruct(12);
+                w.i64(3, 0);    // null count
+                w.binary(5, hi.data(), hi.size());
+                w.binary(6, lo.data(), lo.size());
+                w.endStruct();
+            }
+            w.endStruct();
+            w.endStruct();
+        }
+        w.i64(2, static_cast<std::int64_t>(g.bytes));
+        w.i64(3, static_cast<std::int64_t>(g.rows));
+        w.endStruct();
+    }
+
+    const std::string liftsValue = std::to_string(lifts_);
+    const std::string dtValue = std::to_string(dt_);
+    w.beginList(5, CompactWriter::kStruct, 2);
+    w.beginElement();
+    w.string(1, "forklift.lifts");
+    w.string(2, liftsValue);
+    w.endStruct();
+    w.beginElement();
+    w.string(1, "forklift.dt");
+    w.string(2, dtValue);
+    w.endStruct();
+
+    w.string(6, "Forklift Control System");
+
+    // Column orders: signed, by type, so readers can trust min_value / max_value
+    w.beginList(7, CompactWriter::kStruct, kColumnCount);
+    for (std::size_t c = 0; c < kColumnCount; ++c) {
+        w.beginElement();
+        w.beginStruct(1);
+        w.endStruct();
+        w.endStruct();
+    }
+    w.endStruct();
+
+    const std::uint64_t footerBytes = footer.size();
+    putLe(footer, footerBytes, 4);
+    footer.push_back('P');
+    footer.push_back('A');
+    footer.push_back('R');
+    footer.push_back('1');
+    write(footer);
+
+    ok_ = (std::fclose(file_) == 0) && ok_;
+    file_ = nullptr;
+    return ok_;
+}
+
+// ---- Reader ----
+
+namespace {
+
+class CompactReader {
+public:
+    CompactReader(const std::uint8_t* p, const std::uint8_t* end) : p_(p), end_(end) {}
+
+    bool ok() const { return ok_; }
+    const std::uint8_t* position() const { return p_; }
+
+    std::uint64_t uleb() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p_ >= end_) break;
+            const std::uint8_t b = *p_++;
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok_ = false;
+        return 0;
+    }
+    std::int64_t zigzag() {
+        const std::uint64_t v = uleb();
+        return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+    std::string binary() {
+        const std::uint64_t n = uleb();
+        if (n > static_cast<std::uint64_t>(end_ - p_)) { ok_ = false; return {}; }
+        std::string s(reinterpret_cast<const char*>(p_), static_cast<std::size_t>(n));
+        p_ += n;
+        return s;
+    }
+
+    void beginStruct() { stack_.push_back(last_); last_ = 0; }
+    void endStruct() { last_ = stack_.back(); stack_.pop_back(); }
+
+    // Next field of the current struct; false at its stop byte
+    bool field(int& id, int& type) {
+        if (!ok_ || p_ >= end_) { ok_ = false; return false; }
+        const std::uint8_t b = *p_++;
+        if (b == 0) return false;
+        type = b & 0x0F;
+        id = (b >> 4) ? last_ + (b >> 4) : static_cast<int>(zigzag());
+        last_ = id;
+        return ok_;
+    }
+
+    std::size_t list(int& elementType) {
+        if (p_ >= end_) { ok_ = false; return 0; }
+        const std::uint8_t b = *p_++;
+        elementType = b & 0x0F;
+        const std::size_t n = (b >> 4) == 15 ? static_cast<std::size_t>(uleb()) : (b >> 4);
+        if (n > static_cast<std::size_t>(end_ - p_)) ok_ = false;   // every element is at least a byte
+        return ok_ ? n : 0;
+    }
+
+    // A field's value (inList: an element's, where booleans take a byte)
+    void skip(int type, bool inList = false) {
+        switch (type) {
+        case 1: case 2: if (inList) bytes(1); return;
+        case 3: bytes(1); return;
+        case 4: case 5: case 6: uleb(); return;
+        case 7: bytes(8); return;
+        case 8: binary(); return;
+        case 9: case 10: {
+            int element = 0;
+            const std::size_t n = list(element);
+            for (std::size_t i = 0; i < n && ok_; ++i) skip(element, true);
+            return;
+        }
+        case 11: {
+            const std::uint64_t n = uleb();
+            if (n == 0) return;
+            if (p_ >= end_) { ok_ = false; return; }
+            const std::uint8_t kv = *p_++;
+            for (std::uint64_t i = 0; i < n && ok_; ++i) { skip(kv >> 4, true); skip(kv & 0x0F, true); }
+            return;
+        }
+        case 12: {
+            beginStruct();
+            int id = 0, t = 0;
+            while (field(id, t)) skip(t);
+            endStruct();
+            return;
+        }
+        default: ok_ = false; return;
+        }
+    }
+
+private:
+    void bytes(std::size_t n) {
+        if (n > static_cast<std::size_t>(end_ - p_)) ok_ = false;
+        else p_ += n;
+    }
+
+    const std::uint8_t* p_;
+    const std::uint8_t* end_;
+    bool ok_ = true;
+    int last_ = 0;
+    std::vector<int> stack_;
+};
+
+struct ChunkInfo {
+    std::uint64_t dictionaryOffset = 0;
+    std::uint64_t dataOffset = 0;
+};
+
+struct RowGroupInfo {
+    std::uint64_t rows = 0;
+    std::vector<ChunkInfo> columns;
+};
+
+struct BitUnpacker {
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    int used = 0;   // bits consumed of *p
+
+    bool get(int width, std::uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < width;) {
+            if (p >= end) return false;
+            const int take = std::min(width - shift, 8 - used);
+            v |= static_cast<std::uint64_t>((*p >> used) & ((1u << take) - 1)) << shift;
+            shift += take;
+            used += take;
+            if (used == 8) { ++p; used = 0; }
+        }
+        return true;
+    }
+};
+
+bool decodeDelta(const std::uint8_t* p, const std::uint8_t* end, std::size_t count, std::vector<std::int64_t>& v) {
+    CompactReader r(p, end);
+    const std::uint64_t block = r.uleb();
+    const std::uint64_t miniblocks = r.uleb();
+    const std::uint64_t total = r.uleb();
+    std::int64_t last = r.zigzag();
+    if (!r.ok() || total != count || miniblocks == 0 || block % miniblocks != 0 || (block / miniblocks) % 8 != 0)
+        return false;
+    const std::size_t perMiniblock = static_cast<std::size_t>(block / miniblocks);
+    v.clear();
+    if (count == 0) return true;
+    v.push_back(last);
+
+    p = r.position();
+    while (v.size() < count) {
+        CompactReader h(p, end);
+        const std::uint64_t minDelta = static_cast<std::uint64_t>(h.zigzag());
+        p = h.position();
+        if (!h.ok() || static_cast<std::uint64_t>(end - p) < miniblocks) return false;
+        const std::uint8_t* widths = p;
+        p += miniblocks;
+        for (std::uint64_t m = 0; m < miniblocks && v.size() < count; ++m) {
+            if (widths[m] > 64) return false;
+            BitUnpacker bits{ p, end };
+            for (std::size_t k = 0; k < perMiniblock; ++k) {
+                std::uint64_t d = 0;
+                if (!bits.get(widths[m], d)) return false;
+                if (v.size() < count) {
+                    last = static_cast<std::int64_t>(static_cast<std::uint64_t>(last) + minDelta + d);
+                    v.push_back(last);
+                }
+            }
+            p = bits.p;
+        }
+    }
+    return true;
+}
+
+// RLE / bit-packed hybrid, as written by any encoder
+bool decodeDictionaryIndices(const std::uint8_t* p, const std::uint8_t* end, std::size_t count,
+                             std::vector<std::int64_t>& v) {
+    if (p >= end) return count == 0;
+    const int width = *p++;
+    if (width > 32) return false;
+    const int valueBytes = (width + 7) / 8;
+    v.clear();
+    while (v.size() < count) {
+        CompactReader r(p, end);
+        const std::uint64_t header = r.uleb();
+        p = r.position();
+        if (!r.ok()) return false;
+        if (header & 1) {
+            BitUnpacker bits{ p, end };
+            for (std::uint64_t k = 0; k < (header >> 1) * 8; ++k) {
+                std::uint64_t x = 0;
+                if (!bits.get(width, x)) return false;
+                if (v.size() < count) v.push_back(static_cast<std::int64_t>(x));
+            }
+            p = bits.p;
+        } else {
+            if (end - p < valueBytes) return false;
+            std::uint64_t x = 0;
+            for (int b = 0; b < valueBytes; ++b) x |= static_cast<std::uint64_t>(p[b]) << (8 * b);
+            p += valueBytes;
+            const std::uint64_t run = header >> 1;
+            if (run > count - v.size()) return false;
+            v.insert(v.end(), static_cast<std::size_t>(run), static_cast<std::int64_t>(x));
+            if (run == 0) return false;
+        }
+    }
+    return true;
+}
+
+bool decodeBooleans(const std::uint8_t* p, const std::uint8_t* end, std::size_t count, std::vector<std::int64_t>& v) {
+    if (static_cast<std::size_t>(end - p) < (count + 7) / 8) return false;
+    v.resize(count);
+    for (std::size_t i = 0; i < count; ++i) v[i] = (p[i / 8] >> (i % 8)) & 1;
+    return true;
+}
+
+struct PageInfo {
+    int type = -1;
+    std::size_t bytes = 0;
+    std::size_t values = 0;
+    int encoding = -1;
+    const std::uint8_t* payload = nullptr;
+};
+
+bool readPage(const std::uint8_t* p, const std::uint8_t* end, PageInfo& page) {
+    CompactReader r(p, end);
+    r.beginStruct();
+    int id = 0, type = 0;
+    while (r.field(id, type)) {
+        if (id == 1) page.type = static_cast<int>(r.zigzag());
+        else if (id == 3) page.bytes = static_cast<std::size_t>(r.zigzag());
+        else if ((id == 5 || id == 7) && type == CompactWriter::kStruct) {
+            r.beginStruct();
+            int hid = 0, htype = 0;
+            while (r.field(hid, htype)) {
+                if (hid == 1) page.values = static_cast<std::size_t>(r.zigzag());
+                else if (hid == 2) page.encoding = static_cast<int>(r.zigzag());
+                else r.skip(htype);
+            }
+            r.endStruct();
+        } else r.skip(type);
+    }
+    page.payload = r.position();
+    return r.ok() && page.bytes <= static_cast<std::size_t>(end - page.payload);
+}
+
+// Dictionary index -> stored dictionary-column value; -1 = not one of ours
+bool readDictionary(std::size_t c, const PageInfo& page, const std::uint8_t* end, std::vector<int>& map) {
+    map.clear();
+    const std::uint8_t* p = page.payload;
+    for (std::size_t k = 0; k < page.values; ++k) {
+        if (end - p < 4) return false;
+        const std::uint32_t n = static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+                                (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+        p += 4;
+        if (static_cast<std::size_t>(end - p) < n) return false;
+        const std::string s(reinterpret_cast<const char*>(p), n);
+        p += n;
+        int value = -1;
+        for (int e = 0; e < dictionarySize(c); ++e)
+            if (s == dictionaryEntry(c, e)) value = e;
+        map.push_back(value);
+    }
+    return true;
+}
+
+} // namespace
+
+bool readParquetTrace(const std::string& path, std::vector<ExportRow>& rows, std::string& error) {
+    rows.clear();
+    MappedFile file;
+    if (!file.open(path, error)) return false;
+    const std::uint8_t* data = file.data();
+    const std::size_t size = file.size();
+    if (size < 12 || std::memcmp(data, "PAR1", 4) != 0 || std::memcmp(data + size - 4, "PAR1", 4) != 0) {
+        error = "not a Parquet file";
+        return false;
+    }
+    const std::size_t footerBytes = static_cast<std::size_t>(data[size - 8]) | (static_cast<std::size_t>(data[size - 7]) << 8) |
+                                    (static_cast<std::size_t>(data[size - 6]) << 16) |
+                                    (static_cast<std::size_t>(data[size - 5]) << 24);
+    if (footerBytes > size - 12) {
+        error = "corrupt Parquet footer length";
+        return false;
+    }
+
+    // ---- Footer: column names and the offsets of every column chunk ----
+    std::vector<std::string> names;
+    std::vector<RowGroupInfo> groups;
+    CompactReader r(data + size - 8 - footerBytes, data + size - 8);
+    r.beginStruct();
+    int id = 0, type = 0;
+    while (r.field(id, type)) {
+        int element = 0;
+        if (id == 2 && type == CompactWriter::kList) {
+            const std::size_t n = r.list(element);
+            for (std::size_t i = 0; i < n && r.ok(); ++i) {
+                r.beginStruct();
+                std::string name;
+                int sid = 0, stype = 0;
+                while (r.field(sid, stype)) {
+                    if (sid == 4) name = r.binary();
+                    else r.skip(stype);
+                }
+                r.endStruct();
+                names.push_back(name);
+            }
+        } else if (id == 4 && type == CompactWriter::kList) {
+            const std::size_t n = r.list(element);
+            for (std::size_t i = 0; i < n && r.ok(); ++i) {
+                RowGroupInfo g;
+                r.beginStruct();
+                int gid = 0, gtype = 0;
+                while (r.field(gid, gtype)) {
+                    if (gid == 3) g.rows = static_cast<std::uint64_t>(r.zigzag());
+                    else if (gid == 1 && gtype == CompactWriter::kList) {
+                        const std::size_t columns = r.list(element);
+                        for (std::size_t k = 0; k < columns && r.ok(); ++k) {
+                            ChunkInfo chunk;
+                            r.beginStruct();
+                            int cid = 0, ctype = 0;
+                            while (r.field(cid, ctype)) {
+                                if (cid != 3 || ctype != CompactWriter::kStruct) { r.skip(ctype); continue; }
+                                r.beginStruct();
+                                int mid = 0, mtype = 0;
+                                while (r.field(mid, mtype)) {
+                                    if (mid == 9) chunk.dataOffset = static_cast<std::uint64_t>(r.zigzag());
+                                    else if (mid == 11) chunk.dictionaryOffset = static_cast<std::uint64_t>(r.zigzag());
+                                    else r.skip(mtype);
+                                }
+                                r.endStruct();
+                            }
+                            r.endStruct();
+                            g.columns.push_back(chunk);
+                        }
+                    } else r.skip(gtype);
+                }
+                r.endStruct();
+                groups.push_back(g);
+            }
+        } else r.skip(type);
+    }
+    if (!r.ok()) {
+        error = "corrupt Parquet footer";
+        return false;
+    }
+    if (names.size() != kColumnCount + 1) {
+        error = "not a forklift export (" + std::to_string(names.size()) + " schema elements)";
+        return false;
+    }
+    for (std::size_t c = 0; c < kColumnCount; ++c) {
+        if (names[c + 1] != kColumns[c].name) {
+            error = "not a forklift export (column " + names[c + 1] + ")";
+            return false;
+        }
+    }
+
+    // ---- Column chunks ----
+    const std::uint8_t* end = data + size;
+    std::vector<std::int64_t> values;
+    std::vector<int> dictionary;
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        const RowGroupInfo& group = groups[g];
+        const std::size_t first = rows.size();
+        const std::size_t count = static_cast<std::size_t>(group.rows);
+        if (group.columns.size() != kColumnCount || count > size) {
+            error = "row group " + std::to_string(g) + ": bad column chunks";
+            return false;
+        }
+        rows.resize(first + count);
+        for (std::size_t c = 0; c < kColumnCount; ++c) {
+            const ColumnSpec& spec = kColumns[c];
+            const ChunkInfo& chunk = group.columns[c];
+            std::string where = "row group ";
+            where += std::to_string(g);
+            where += ", column ";
+            where += spec.name;
+
+            PageInfo page;
+            if (spec.encoding == ColumnEncoding::Dictionary) {
+                if (chunk.dictionaryOffset >= size || !readPage(data + chunk.dictionaryOffset, end, page) ||
+                    page.type != 2 || !readDictionary(c, page, page.payload + page.bytes, dictionary)) {
+                    error = where + ": bad dictionary page";
+                    return false;
+                }
+                page = PageInfo{};
+            }
+            if (chunk.dataOffset >= size || !readPage(data + chunk.dataOffset, end, page) || page.type != 0 ||
+                page.values != count) {
+                error = where + ": bad data page";
+                return false;
+            }
+            const std::uint8_t* pageEnd = page.payload + page.bytes;
+            bool ok = false;
+            switch (spec.encoding) {
+            case ColumnEncoding::Delta:
+                ok = page.encoding == kDeltaBinaryPacked && decodeDelta(page.payload, pageEnd, count, values);
+                break;
+            case ColumnEncoding::Dictionary:
+                ok = page.encoding == kRleDictionary && decodeDictionaryIndices(page.payload, pageEnd, count, values);
+                for (std::size_t i = 0; ok && i < count; ++i) {
+                    const std::int64_t k = values[i];
+                    ok = k >= 0 && k < static_cast<std::int64_t>(dictionary.size()) && dictionary[static_cast<std::size_t>(k)] >= 0;
+                    if (ok) values[i] = dictionary[static_cast<std::size_t>(k)];
+                }
+                break;
+            case ColumnEncoding::Boolean:
+                ok = page.encoding == kPlain && decodeBooleans(page.payload, pageEnd, count, values);
+                break;
+            }
+            if (!ok) {
+                error = where + ": cannot decode the data page";
+                return false;
+            }
+            for (std::size_t i = 0; i < count; ++i) setColumnValue(c, rows[first + i], values[i]);
+        }
+    }
+    return true;
+}
+
+// ---- ColumnarSink ----
+
+ColumnarSink::ColumnarSink(ParquetTraceWriter& writer, const Options& opt)
+    : writer_(writer), opt_(opt) {
+    if (opt_.rowGroupRows == 0) opt_.rowGroupRows = 1;
+}
+
+ColumnarSink::~ColumnarSink() {
+    stop();
+}
+
+void ColumnarSink::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this] { run(); });
+}
+
+void ColumnarSink::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+}
+
+void ColumnarSink::submitFleet(std::uint64_t scan, const LiftFleet& fleet) {
+    LiftPlant p{};
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        p.position = fleet.position[i];
+        p.velocity = fleet.velocity[i];
+        p.targetVel = fleet.targetVel[i];
+        submit(scan, static_cast<std::uint32_t>(i),
+               makeTraceRecord(fleet.inputs[i], fleet.outputs[i], p, fleet.state[i], fleet.latched[i]));
+    }
+}
+
+void ColumnarSink::submitFleet(std::uint64_t scan, const PackedFleet& fleet) {
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        const PackedLift& h = fleet.hot[i];
+        TraceRecord r{};
+        r.position = h.position;
+        r.velocity = h.velocity;
+        r.targetVel = h.targetVel;
+        r.loadKg = fleet.cold[i].loadKg;
+        r.inputBits = static_cast<std::uint8_t>(h.inputBits & ~kInOverload);
+        r.outputBits = h.outputBits;
+        r.state = static_cast<std::uint8_t>(h.state);
+        r.fault = static_cast<std::uint8_t>(h.latched);
+        submit(scan, static_cast<std::uint32_t>(i), r);
+    }
+}
+
+bool ColumnarSink::flush(std::vector<ExportRow>& group) {
+    if (group.empty()) return true;
+    const std::size_t n = group.size();
+    const bool ok = !failed() && writer_.writeRowGroup(group);
+    if (ok) written_.fetch_add(n, std::memory_order_relaxed);
+    else failed_.store(true, std::memory_order_relaxed);
+    group.clear();
+    return ok;
+}
+
+void ColumnarSink::run() {
+    std::vector<ExportRow> group;
+    group.reserve(opt_.rowGroupRows);
+    for (;;) {
+        // Read the flag before draining so nothing submitted before stop() is missed.
+        const bool keepRunning = running_.load(std::memory_order_acquire);
+
+        bool popped = false;
+        ExportRow row;
+        while (ring_.pop(row)) {
+            popped = true;
+            group.push_back(row);
+            if (group.size() == opt_.rowGroupRows) flush(group);
+        }
+
+        if (!keepRunning) {
+            flush(group);
+            return;
+        }
+        if (!popped) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
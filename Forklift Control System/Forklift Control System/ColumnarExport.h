@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SpscRing.h"
+#include "TelemetrySink.h"
+#include "TraceFormat.h"
+
+struct LiftFleet;
+struct PackedFleet;
+
+// Columnar export of scan-level data as Parquet, for Spark, DuckDB and the like.
+//
+// One row per lift per scan. Columns, all required:
+//
+//     scan, lift                       INT64 / INT32, delta encoded
+//     position, velocity, target_vel   DECIMAL(18, 9) in INT64, delta encoded
+//     load_kg                          DECIMAL(18, 3) in INT64, delta encoded
+//     state, fault                     STRING, dictionary encoded
+//     cmd_up ... bottom_limit,         BOOLEAN, bit packed
+//     cmd_go_to, motor_enable, brake_engaged, fault_lamp
+//     motor_dir                        INT32 (-1, 0, +1), delta encoded
+//
+// Rows are sorted by (lift, scan) within a row group, so each lift's
+// positions form one smooth run. DELTA_BINARY_PACKED stores the deltas
+// after subtracting the smallest one, so a lift cruising or at rest costs
+// a few bits per value, and a long run of one state costs a single
+// dictionary run. Pages are not compressed. The decimals hold the doubles
+// rounded to 1e-9 (load to 1 g); exact replays keep using the binary trace.
+//
+// ColumnarSink streams rows out like TelemetrySink streams status lines:
+// the scan loop copies each row into an SPSC ring, and a writer thread
+// collects row groups and encodes and writes them, so the scan loop never
+// encodes or touches the file.
+
+struct ExportRow {
+    std::uint64_t scan = 0;
+    std::uint32_t lift = 0;
+    TraceRecord record{};
+};
+
+class ParquetTraceWriter {
+public:
+    ParquetTraceWriter() = default;
+    ~ParquetTraceWriter();
+
+    ParquetTraceWriter(const ParquetTraceWriter&) = delete;
+    ParquetTraceWriter& operator=(const ParquetTraceWriter&) = delete;
+
+    // lifts and dt go into the file's key-value metadata
+    bool open(const std::string& path, std::uint32_t lifts, double dt, std::string& error);
+    bool isOpen() const { return file_ != nullptr; }
+
+    // One row group of rows in any order; sorts them. False on a write error.
+    bool writeRowGroup(std::vector<ExportRow>& rows);
+
+    // Writes the footer. Returns false on any write error so far.
+    bool close();
+
+    std::uint64_t rows() const { return rows_; }
+    std::size_t rowGroups() const { return groups_.size(); }
+    std::uint64_t bytesWritten() const { return offset_; }
+
+private:
+    // Column metadata of a written row group (footer input)
+    struct ColumnChunkMeta {
+        std::uint64_t dictionaryOffset = 0;    // 0 = no dictionary page
+        std::uint64_t dataOffset = 0;
+        std::uint64_t bytes = 0;               // every page with its header
+        bool hasStatistics = false;            // integer columns: min and max value
+        std::int64_t min = 0;
+        std::int64_t max = 0;
+    };
+
+    struct RowGroupMeta {
+        std::uint64_t rows = 0;
+        std::uint64_t bytes = 0;
+        std::vector<ColumnChunkMeta> columns;
+    };
+
+    bool write(const std::vector<std::uint8_t>& bytes);
+    void sortRows(std::vector<ExportRow>& rows);
+
+    std::FILE* file_ = nullptr;
+    bool ok_ = true;
+    std::uint32_t lifts_ = 0;
+    double dt_ = 0.0;
+    std::uint64_t offset_ = 0;
+    std::uint64_t rows_ = 0;
+    std::vector<RowGroupMeta> groups_;
+
+    // Sorting and encoding scratch, reused across row groups
+    std::vector<ExportRow> sorted_;
+    std::vector<std::size_t> liftStart_;
+    std::vector<std::int64_t> values_;
+    std::vector<std::uint8_t> page_;
+    std::vector<std::uint8_t> header_;
+};
+
+// Reads back a file written by ParquetTraceWriter (that subset of Parquet
+// only), rows in file order, decimals converted back to doubles.
+bool readParquetTrace(const std::string& path, std::vector<ExportRow>& rows, std::string& error);
+
+class ColumnarSink {
+public:
+    using Overflow = TelemetrySink::Overflow;
+
+    struct Options {
+        std::size_t rowGroupRows = 1 << 16;
+        Overflow overflow = Overflow::Wait;
+    };
+
+    // Large (the ring holds kRingRows rows): allocate on the heap.
+    static constexpr std::size_t kRingRows = 1 << 16;
+
+    ColumnarSink(ParquetTraceWriter& writer, const Options& opt);
+    ~ColumnarSink();
+
+    ColumnarSink(const ColumnarSink&) = delete;
+    ColumnarSink& operator=(const ColumnarSink&) = delete;
+
+    void start();
+
+    // Writes every queued row (the last row group may be short), then stops
+    // the writer thread. The caller closes the writer.
+    void stop();
+
+    // Producer side (one thread): a copy into the ring.
+    void submit(std::uint64_t scan, std::uint32_t lift, const TraceRecord& record) {
+        const ExportRow row{ scan, lift, record };
+        if (ring_.push(row)) return;
+        if (opt_.overflow == Overflow::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        while (!ring_.push(row)) std::this_thread::yield();
+    }
+
+    // Every lift of a fleet after LiftFleet::scan() / PackedFleet::scan()
+    void submitFleet(std::uint64_t scan, const LiftFleet& fleet);
+    void submitFleet(std::uint64_t scan, const PackedFleet& fleet);
+
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    bool flush(std::vector<ExportRow>& group);
+
+    ParquetTraceWriter& writer_;
+    Options opt_;
+    std::thread thread_;
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> failed_{ false };
+    std::atomic<std::uint64_t> written_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
+    SpscRing<ExportRow, kRingRows> ring_;
+};
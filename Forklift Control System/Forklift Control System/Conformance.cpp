@@ -0,0 +1,124 @@
+#include "Conformance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+#include "FixedPoint.h"
+#include "LiftControl.h"
+#include "Rng.h"
+
+namespace {
+
+// Operator session shared by both lifts: commands are held for a random
+// segment, and every new segment starts with a one-scan reset pulse.
+struct SessionOperator {
+    SplitMix64 rng;
+    std::uint64_t segmentEnd = 0;
+    Inputs cmd{};
+
+    // Commands and load for this scan; limits are left to the plant.
+    const Inputs& next(std::uint64_t scan) {
+        cmd.resetFault = false;
+        if (scan >= segmentEnd) {
+            segmentEnd = scan + 10 + rng.next() % 400;
+            const double c = rng.uniform();
+            cmd.cmdUp = c < 0.35;
+            cmd.cmdDown = c >= 0.35 && c < 0.70;
+            cmd.cmdHold = c >= 0.95;
+            cmd.estop = rng.chance(0.02);
+            cmd.resetFault = true;
+            cmd.loadKg = rng.chance(0.03) ? DefaultMast::maxLoadKg * 1.1 : rng.uniform(0.0, DefaultMast::maxLoadKg);
+        }
+        return cmd;
+    }
+};
+
+void applyCommands(Inputs& in, const Inputs& cmd) {
+    in.cmdUp = cmd.cmdUp;
+    in.cmdDown = cmd.cmdDown;
+    in.cmdHold = cmd.cmdHold;
+    in.estop = cmd.estop;
+    in.resetFault = cmd.resetFault;
+    in.loadKg = cmd.loadKg;
+}
+
+template <class Real>
+ConformanceResult runOne(const char* name, const ConformanceOptions& opt) {
+    ConformanceResult r{};
+    r.numeric = name;
+    r.scans = opt.scans;
+
+    SessionOperator op{ SplitMix64{ opt.seed } };
+    Inputs refIn{}, in{};
+    LiftController refCtrl{}, ctrl{};
+    LiftPlant refPlant{};
+    BasicLiftPlant<Real> plant{};
+    const Real dt = Real(opt.dt);
+    std::uint64_t limitSkew = 0;
+
+    for (std::uint64_t s = 0; s < opt.scans; ++s) {
+        const Inputs& cmd = op.next(s);
+        applyCommands(refIn, cmd);
+        applyCommands(in, cmd);
+
+        const LiftState before = refCtrl.state;
+        const FaultCode latchedBefore = refCtrl.faults.latched;
+        scanLift(opt.dt, refIn, refCtrl, refPlant);
+        scanLift(dt, in, ctrl, plant);
+        if (refCtrl.state != before) r.stateChanges++;
+        if (refCtrl.faults.latched != latchedBefore && refCtrl.faults.hasFault()) r.faultLatches++;
+
+        // Limits were derived from the plants at the top of this scan.
+        const bool limitsDiffer = refIn.topLimit != in.topLimit || refIn.bottomLimit != in.bottomLimit;
+        limitSkew = limitsDiffer ? limitSkew + 1 : 0;
+        r.maxLimitSkewScans = std::max(r.maxLimitSkewScans, limitSkew);
+
+        const double p = static_cast<double>(plant.position);
+        const double ep = std::abs(refPlant.position - p);
+        const double ev = std::abs(refPlant.velocity - static_cast<double>(plant.velocity));
+        if (ep > r.maxPositionError) { r.maxPositionError = ep; r.maxPositionErrorScan = s; }
+        const bool inTravel = refPlant.position > 0.0 && refPlant.position < 1.0 && p > 0.0 && p < 1.0;
+        if (!inTravel) r.maxEndStopVelocityError = std::max(r.maxEndStopVelocityError, ev);
+        else if (ev > r.maxVelocityError) { r.maxVelocityError = ev; r.maxVelocityErrorScan = s; }
+
+        if (refCtrl.state != ctrl.state || refCtrl.faults.latched != ctrl.faults.latched) {
+            if (limitsDiffer) r.limitRaces++;
+            else if (r.unexplained++ == 0) r.firstUnexplainedScan = s;
+
+            // Resynchronize so one divergence doesn't cascade.
+            ctrl.state = refCtrl.state;
+            ctrl.faults = refCtrl.faults;
+            plant.position = Real(refPlant.position);
+            plant.velocity = Real(refPlant.velocity);
+            plant.targetVel = Real(refPlant.targetVel);
+        }
+    }
+    return r;
+}
+
+} // namespace
+
+std::vector<ConformanceResult> runConformance(const ConformanceOptions& opt) {
+    return { runOne<float>("float", opt), runOne<Fixed16>("Q16.16", opt) };
+}
+
+void printConformanceReport(std::ostream& os, const std::vector<ConformanceResult>& results,
+                            const ConformanceOptions& opt) {
+    os << "conformance: seed=" << opt.seed << " scans=" << opt.scans << " dt=" << opt.dt
+        << " reference=double\n";
+    for (const ConformanceResult& r : results) {
+        os << "  " << r.numeric << (r.conforms() ? ": conforms" : ": DOES NOT CONFORM")
+            << " (reference: stateChanges=" << r.stateChanges << " faultLatches=" << r.faultLatches << ")\n";
+        os << std::scientific << std::setprecision(3)
+            << "    max |position error|=" << r.maxPositionError << " (scan " << r.maxPositionErrorScan << ")\n"
+            << "    max |velocity error|=" << r.maxVelocityError << " in travel (scan " << r.maxVelocityErrorScan << "), "
+            << r.maxEndStopVelocityError << " at the end stops\n"
+            << std::defaultfloat;
+        os << "    state/fault: limit switch skew=" << r.maxLimitSkewScans << " scans"
+            << " limit races=" << r.limitRaces << " unexplained=" << r.unexplained;
+        if (r.unexplained > 0) os << " first=" << r.firstUnexplainedScan;
+        os << "\n";
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Numeric conformance of the float and Q16.16 (Fixed16) plant against the
+// double reference.
+//
+// One long seeded operator session (random up/down/hold segments, reset
+// pulses, E-stops and overloads) drives a double lift and a lift in the
+// other number type with the same commands and load. Each lift derives its
+// own limit switches from its own plant, as on the target. After every
+// scan the state and latched fault must match the reference, and the
+// report bounds the |position| and |velocity| differences.
+//
+// Rounding can move the scan on which a lift reaches a limit switch. If an
+// operator command changes on that same scan, the two lifts legitimately
+// take different paths (one latches LimitViolation, the other does not).
+// Such a scan is counted as a limit race and the lift is resynchronized to
+// the reference, so one race doesn't cascade. A lift conforms when every
+// state or fault difference is a limit race. (A lift that stops between
+// the double and the rounded limit threshold reads a different switch for
+// as long as it stands there, so the skew is reported, not judged.)
+
+struct ConformanceOptions {
+    std::uint64_t scans = 10000000;    // about 55 h at 20 ms
+    std::uint64_t seed = 1;
+    double dt = 0.02;
+};
+
+struct ConformanceResult {
+    const char* numeric = "";
+    std::uint64_t scans = 0;
+    std::uint64_t stateChanges = 0;         // seen by the reference
+    std::uint64_t faultLatches = 0;
+
+    double maxPositionError = 0.0;
+    std::uint64_t maxPositionErrorScan = 0;
+    double maxVelocityError = 0.0;          // both lifts between the end stops
+    std::uint64_t maxVelocityErrorScan = 0;
+    double maxEndStopVelocityError = 0.0;   // one lift stopped by an end stop a scan earlier
+
+    std::uint64_t maxLimitSkewScans = 0;    // longest run of scans with different limit switches
+    std::uint64_t limitRaces = 0;           // state or fault differed right at a limit disagreement
+    std::uint64_t unexplained = 0;          // state or fault differed otherwise
+    std::uint64_t firstUnexplainedScan = 0;
+
+    bool conforms() const { return unexplained == 0; }
+};
+
+// One result per numeric type (float, Q16.16).
+std::vector<ConformanceResult> runConformance(const ConformanceOptions& opt);
+
+void printConformanceReport(std::ostream& os, const std::vector<ConformanceResult>& results,
+                            const ConformanceOptions& opt);
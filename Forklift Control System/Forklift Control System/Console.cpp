@@ -0,0 +1,81 @@
+#include "Console.h"
+
+#include <iomanip>
+#include <ostream>
+
+ParseStatus parseCommand(const std::string& line, Command& cmd) {
+    cmd = Command{};
+    if (line == "q") cmd.verb = CommandVerb::Quit;
+    else if (line == "u") cmd.verb = CommandVerb::Up;
+    else if (line == "d") cmd.verb = CommandVerb::Down;
+    else if (line == "h") cmd.verb = CommandVerb::Hold;
+    else if (line == "s") cmd.verb = CommandVerb::Stop;
+    else if (line == "e") cmd.verb = CommandVerb::ToggleEstop;
+    else if (line == "r") cmd.verb = CommandVerb::Reset;
+    else if (line == "t") cmd.verb = CommandVerb::Timing;
+    else if (line == "p") cmd.verb = CommandVerb::Snapshot;
+    else if (line.size() >= 2 && line[0] == 'l') {
+        cmd.verb = CommandVerb::SetLoad;
+        try { cmd.value = std::stod(line.substr(1)); }
+        catch (...) { return ParseStatus::BadLoad; }
+    }
+    else if (line.size() >= 2 && line[0] == 'g') {
+        cmd.verb = CommandVerb::GoTo;
+        try { cmd.value = std::stod(line.substr(1)); }
+        catch (...) { return ParseStatus::BadPosition; }
+    }
+    else if (line == "help") cmd.verb = CommandVerb::Help;
+    else return ParseStatus::Unknown;
+    return ParseStatus::Ok;
+}
+
+void applyCommand(const Command& cmd, Inputs& in) {
+    switch (cmd.verb) {
+    case CommandVerb::Up:          in.cmdUp = true;  in.cmdDown = false; in.cmdHold = false; in.cmdGoTo = false; break;
+    case CommandVerb::Down:        in.cmdDown = true; in.cmdUp = false;  in.cmdHold = false; in.cmdGoTo = false; break;
+    case CommandVerb::Hold:        in.cmdHold = true; in.cmdUp = false;  in.cmdDown = false; in.cmdGoTo = false; break;
+    case CommandVerb::Stop:        in.cmdUp = in.cmdDown = in.cmdHold = in.cmdGoTo = false; break;
+    case CommandVerb::ToggleEstop: in.estop = !in.estop; break;
+    case CommandVerb::Reset:       in.resetFault = true; break; // ctrl.update sees it this cycle
+    case CommandVerb::SetLoad:     in.loadKg = cmd.value; break;
+    case CommandVerb::GoTo:
+        in.cmdGoTo = true;
+        in.cmdUp = in.cmdDown = in.cmdHold = false;
+        in.targetPosition = clampTargetPosition(cmd.value);
+        break;
+    case CommandVerb::Timing:
+    case CommandVerb::Snapshot:
+    case CommandVerb::Quit:
+    case CommandVerb::Help:
+        break;
+    }
+}
+
+void printHelp(std::ostream& os) {
+    os <<
+        "Commands:\n"
+        "  u  = command up\n"
+        "  d  = command down\n"
+        "  h  = hold\n"
+        "  s  = stop commands (clear u/d/h/g)\n"
+        "  e  = toggle emergency stop\n"
+        "  r  = reset fault (only if stopped + estop released)\n"
+        "  l <kg> = set load kg (e.g. l 900)\n"
+        "  g <pos> = go to position 0..1 and stop there (e.g. g 0.6)\n"
+        "  t  = scan timing stats\n"
+        "  p  = latest scan snapshot (inputs, outputs, plant)\n"
+        "  q  = quit\n";
+}
+
+void printStatus(std::ostream& os, const LiftPlant& plant, LiftState state, FaultCode fault, const Inputs& in) {
+    os << std::fixed << std::setprecision(3)
+        << "pos=" << plant.position
+        << " vel=" << plant.velocity
+        << " state=" << stateToString(state)
+        << " fault=" << faultToString(fault)
+        << " top=" << in.topLimit
+        << " bot=" << in.bottomLimit
+        << " load=" << in.loadKg
+        << " estop=" << in.estop
+        << "\n";
+}
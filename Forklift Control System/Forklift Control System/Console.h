@@ -0,0 +1,46 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+#include "LiftControl.h"
+
+// Operator command vocabulary shared by the interactive console and the
+// scripted/headless run modes (see printHelp()).
+
+enum class CommandVerb {
+    Up,           // u
+    Down,         // d
+    Hold,         // h
+    Stop,         // s
+    ToggleEstop,  // e
+    Reset,        // r
+    SetLoad,      // l <kg>
+    GoTo,         // g <position>
+    Timing,       // t
+    Snapshot,     // p
+    Quit,         // q
+    Help,         // help
+};
+
+struct Command {
+    CommandVerb verb = CommandVerb::Stop;
+    double value = 0.0;        // load kg for SetLoad, target position for GoTo
+};
+
+enum class ParseStatus {
+    Ok,
+    BadLoad,                   // "l" with an unparsable number
+    BadPosition,               // "g" with an unparsable number
+    Unknown,
+};
+
+ParseStatus parseCommand(const std::string& line, Command& cmd);
+
+// Apply an operator command to the scan inputs. Timing/Quit/Help are left to the caller.
+void applyCommand(const Command& cmd, Inputs& in);
+
+void printHelp(std::ostream& os);
+
+// One status line: "pos=... vel=... state=... fault=... top=... bot=... load=... estop=..."
+void printStatus(std::ostream& os, const LiftPlant& plant, LiftState state, FaultCode fault, const Inputs& in);
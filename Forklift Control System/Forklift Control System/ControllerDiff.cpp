@@ -0,0 +1,112 @@
+#include "ControllerDiff.h"
+
+#include <ostream>
+
+#include "LiftControl.h"
+#include "Rng.h"
+#include "TableController.h"
+
+namespace {
+
+Inputs randomInputs(SplitMix64& rng, double maxLoadKg) {
+    Inputs in{};
+    in.cmdUp = rng.chance(0.4);
+    in.cmdDown = rng.chance(0.4);
+    in.cmdHold = rng.chance(0.1);
+    in.cmdGoTo = rng.chance(0.2);
+    in.estop = rng.chance(0.01);
+    in.resetFault = rng.chance(0.3);
+    in.topLimit = rng.chance(0.05);
+    in.bottomLimit = rng.chance(0.05);
+    in.loadKg = rng.uniform(0.5, 1.02) * maxLoadKg;
+    in.targetPosition = rng.uniform(0.0, 1.0);
+    return in;
+}
+
+bool sameOutputs(const Outputs& a, const Outputs& b) {
+    return a.motorEnable == b.motorEnable && a.motorDir == b.motorDir &&
+           a.brakeEngaged == b.brakeEngaged && a.faultLamp == b.faultLamp;
+}
+
+// One controller under test, scanned next to the reference.
+template <class Controller>
+struct Candidate {
+    Controller ctrl{};
+    LiftPlant plant{};
+
+    // true if it agrees with the reference after this scan
+    bool scan(double dt, const Inputs& in, double pos, double vel, const LiftController& ref,
+              const Outputs& refOut, const LiftPlant& refPlant) {
+        plant.position = pos;
+        plant.velocity = vel;
+        const Outputs out = ctrl.update(dt, in, plant);
+        if (sameOutputs(out, refOut) && ctrl.state == ref.state &&
+            ctrl.faults.latched == ref.faults.latched && plant.targetVel == refPlant.targetVel) {
+            return true;
+        }
+        // Resynchronize so one divergence doesn't cascade.
+        ctrl.state = ref.state;
+        ctrl.faults = ref.faults;
+        ctrl.inputKey = kNoInputKey;
+        return false;
+    }
+};
+
+} // namespace
+
+ControllerDiffReport diffControllers(std::uint64_t seed, std::uint64_t scans) {
+    ControllerDiffReport r{};
+    SplitMix64 rng{ seed };
+
+    LiftController ref{};                  // evaluated in full every scan
+    LiftPlant refPlant{};
+    Candidate<LiftController> cached{};
+    Candidate<TableLiftController> table{};
+    Candidate<RuntimeLiftController> runtime{};
+    Candidate<RuntimeTableLiftController> runtimeTable{};
+
+    const double dt = 0.02;
+    Inputs in{};
+    for (std::uint64_t scan = 0; scan < scans; ++scan) {
+        // Inputs hold for runs of scans, as a fleet's mostly do, so the
+        // candidates' change detection hits; the plant moves regardless.
+        if (scan == 0 || !rng.chance(0.8)) in = randomInputs(rng, ref.maxLoadKg);
+
+        // Same plant for all; velocity mostly near the reset gate, position
+        // mostly on or near a go-to target.
+        const double vel = rng.chance(0.5) ? rng.uniform(-0.02, 0.02) : rng.uniform(-0.4, 0.4);
+        const double pos = rng.chance(0.5) ? clampTargetPosition(in.targetPosition) + rng.uniform(-0.001, 0.001)
+                                           : rng.uniform(0.0, 1.0);
+        if (!kCountersEnabled && cached.ctrl.inputKey != kNoInputKey &&
+            cached.ctrl.inputKey == packInputKey(in, in.loadKg > ref.maxLoadKg, ref.state, ref.faults.latched) &&
+            !(in.resetFault && ref.faults.hasFault())) {
+            r.keyHits++;
+        }
+        refPlant.position = pos;
+        refPlant.velocity = vel;
+        ref.inputKey = kNoInputKey;
+        const Outputs a = ref.update(dt, in, refPlant);
+
+        r.scans++;
+        r.statesSeen[static_cast<int>(ref.state)]++;
+
+        const bool cachedOk = cached.scan(dt, in, pos, vel, ref, a, refPlant);
+        const bool tableOk = table.scan(dt, in, pos, vel, ref, a, refPlant);
+        const bool runtimeOk = runtime.scan(dt, in, pos, vel, ref, a, refPlant);
+        const bool runtimeTableOk = runtimeTable.scan(dt, in, pos, vel, ref, a, refPlant);
+        if (!(cachedOk && tableOk && runtimeOk && runtimeTableOk)) {
+            if (r.mismatches == 0) r.firstMismatchScan = scan;
+            r.mismatches++;
+        }
+    }
+    return r;
+}
+
+void printControllerDiffReport(std::ostream& os, const ControllerDiffReport& r) {
+    os << "scans=" << r.scans << " key-hits=" << r.keyHits << " mismatches=" << r.mismatches;
+    if (r.mismatches > 0) os << " first=" << r.firstMismatchScan;
+    os << "\n";
+    for (int s = 0; s < kLiftStates; ++s) {
+        os << "  " << stateToString(static_cast<LiftState>(s)) << "=" << r.statesSeen[s] << "\n";
+    }
+}
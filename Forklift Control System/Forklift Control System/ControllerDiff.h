@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+#include "LiftControl.h"
+
+// Differential harness: drive the reference LiftController, evaluated in
+// full every scan, and a LiftController, the table-driven
+// TableLiftController and both runtime-configured variants
+// (RuntimeMastConfig at default values) that keep their input keys, with
+// identical random Inputs, and compare outputs, state, latched fault and
+// commanded velocity after every scan.
+//
+// Inputs are drawn independently of the plant (limit switches included, even
+// the "both active" combination a real plant never produces) and the plant
+// velocity is randomized around the reset threshold, so every branch of
+// phases 1-4 gets exercised. Inputs repeat for runs of scans, so the
+// candidates skip phases 1 and 3 on most of them.
+
+struct ControllerDiffReport {
+    std::uint64_t scans = 0;
+    std::uint64_t keyHits = 0;             // scans the keyed LiftController skipped phases 1 and 3 on
+    std::uint64_t mismatches = 0;
+    std::uint64_t firstMismatchScan = 0;   // valid if mismatches > 0
+    std::uint64_t statesSeen[kLiftStates] = {};    // per LiftState, from the reference
+};
+
+ControllerDiffReport diffControllers(std::uint64_t seed, std::uint64_t scans);
+
+void printControllerDiffReport(std::ostream& os, const ControllerDiffReport& r);
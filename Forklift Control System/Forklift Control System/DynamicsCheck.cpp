@@ -0,0 +1,221 @@
+#include "DynamicsCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#include "FleetScheduler.h"
+#include "LiftFleet.h"
+#include "LoadDynamics.h"
+#include "Rng.h"
+#include "TraceFormat.h"
+
+namespace {
+
+const double kDt = 0.02;
+const std::uint64_t kSeed = 0xD1A7u;
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) { return std::memcmp(&a, &b, sizeof(TraceRecord)) == 0; }
+
+TraceRecord fleetRecord(const LiftFleet& f, std::size_t i) {
+    LiftPlant p{};
+    p.position = f.position[i];
+    p.velocity = f.velocity[i];
+    p.targetVel = f.targetVel[i];
+    return makeTraceRecord(f.inputs[i], f.outputs[i], p, f.state[i], f.latched[i]);
+}
+
+// Fleet-mode cycles with a load that changes every cycle, from empty to a
+// little over the truck's rated load, and random E-stops and resets.
+Inputs operatorInputs(std::size_t lift, std::int64_t scan, double ratedLoadKg) {
+    const std::uint64_t s = static_cast<std::uint64_t>(scan);
+    SplitMix64 rng{ streamKey(kSeed, (std::uint64_t{ lift } << 32) ^ s) };
+    SplitMix64 cycle{ streamKey(kSeed + 1, (std::uint64_t{ lift } << 32) ^ ((s + lift * 37) / 400)) };
+    const std::uint64_t phase = (s + lift * 37) % 400;
+    Inputs in{};
+    in.cmdUp = phase < 120;
+    in.cmdDown = phase >= 200 && phase < 335;
+    in.estop = rng.chance(0.001);
+    in.resetFault = phase == 399 || rng.chance(0.005);
+    in.loadKg = cycle.uniform(0.0, 1.1) * ratedLoadKg;
+    return in;
+}
+
+// Scans until the lift reaches goal from its current position, driven by cmd
+double timeMove(const DynamicsTable& table, double loadKg, bool up, LiftPlant& plant) {
+    RuntimeLiftController ctrl{};
+    Inputs in{};
+    in.loadKg = loadKg;
+    in.cmdUp = up;
+    in.cmdDown = !up;
+    std::int64_t scans = 0;
+    while (scans < 100000 && (up ? plant.position < 0.9 : plant.position > 0.0001)) {
+        scanLoadedLift(kDt, in, ctrl, plant, table);
+        ++scans;
+    }
+    return static_cast<double>(scans) * kDt;
+}
+
+// Worst |table - direct| over a field's range, sampled off the grid points
+double tableError(const TruckModel& model, const DynamicsTable& table) {
+    SplitMix64 rng{ streamKey(kSeed + 2, 0) };
+    const int kPoints = 4000;
+    const double maxLoad = DynamicsTable::kLoadRange * model.ratedLoadKg;
+    double range[4] = {};
+    double worst[4] = {};
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int k = 0; k < kPoints; ++k) {
+            const double load = rng.uniform(0.0, maxLoad);
+            const double h = rng.uniform();
+            const DynamicsSample e = DynamicsTable::evaluate(model, load, h);
+            const double exact[4] = { e.liftSpeed, e.lowerSpeed, e.accel, e.creep };
+            if (pass == 0) {
+                for (int f = 0; f < 4; ++f) range[f] = std::max(range[f], std::abs(exact[f]));
+                continue;
+            }
+            const DynamicsSample t = table.sample(load, h);
+            const double looked[4] = { t.liftSpeed, t.lowerSpeed, t.accel, t.creep };
+            for (int f = 0; f < 4; ++f) {
+                if (range[f] > 0.0) worst[f] = std::max(worst[f], std::abs(looked[f] - exact[f]) / range[f]);
+            }
+        }
+    }
+    return *std::max_element(worst, worst + 4);
+}
+
+} // namespace
+
+DynamicsCheckReport checkLoadDynamics(std::size_t lifts, std::int64_t scans) {
+    DynamicsCheckReport r;
+    r.lifts = lifts;
+    r.scans = scans;
+    if (lifts == 0 || scans <= 0) {
+        r.error = "lifts and scans must be > 0";
+        return r;
+    }
+
+    const TruckDynamics dynamics = builtinTruckDynamics();
+    r.tableBytes = sizeof(dynamics.tables);
+    const int fixedModel = dynamics.find(fixedTruckModel().name);
+
+    // ---- Fixed model: the same trace as no dynamics at all ----
+    {
+        LiftFleet plain(lifts);
+        LiftFleet fixed(lifts);
+        fixed.setDynamics(&dynamics);
+        for (std::size_t i = 0; i < lifts; ++i) fixed.setTruckModel(i, static_cast<std::uint8_t>(fixedModel));
+        for (std::int64_t s = 0; s < scans; ++s) {
+            for (std::size_t i = 0; i < lifts; ++i) plain.inputs[i] = fixed.inputs[i] = operatorInputs(i, s, 1000.0);
+            plain.scan(kDt);
+            fixed.scan(kDt);
+            for (std::size_t i = 0; i < lifts; ++i) r.fixedMismatches += !sameRecord(fleetRecord(plain, i), fleetRecord(fixed, i));
+        }
+    }
+
+    // ---- Mixed models: fleet and scheduler against lone lifts ----
+    {
+        LiftFleet fleet(lifts);
+        LiftFleet threaded(lifts);
+        fleet.setDynamics(&dynamics);
+        threaded.setDynamics(&dynamics);
+        std::vector<RuntimeLiftController> ctrls(lifts);
+        std::vector<LiftPlant> plants(lifts);
+        std::vector<Inputs> ins(lifts);
+        std::vector<Outputs> outs(lifts);
+        for (std::size_t i = 0; i < lifts; ++i) {
+            const std::uint8_t model = static_cast<std::uint8_t>(i % dynamics.count);
+            fleet.setTruckModel(i, model);
+            threaded.setTruckModel(i, model);
+        }
+        FleetSchedulerOptions opt{};
+        opt.threads = 3;
+        opt.chunkLifts = 8;
+        opt.pin = false;
+        FleetScheduler scheduler(threaded, opt);
+
+        for (std::int64_t s = 0; s < scans; ++s) {
+            for (std::size_t i = 0; i < lifts; ++i) {
+                const DynamicsTable& table = dynamics.tables[i % dynamics.count];
+                ins[i] = fleet.inputs[i] = threaded.inputs[i] = operatorInputs(i, s, table.maxLoadKg());
+                outs[i] = scanLoadedLift(kDt, ins[i], ctrls[i], plants[i], table);
+            }
+            fleet.scan(kDt);
+            scheduler.scan(kDt);
+            for (std::size_t i = 0; i < lifts; ++i) {
+                const TraceRecord lone = makeTraceRecord(ins[i], outs[i], plants[i], ctrls[i].state, ctrls[i].faults.latched);
+                r.fleetMismatches += !sameRecord(fleetRecord(fleet, i), lone);
+                r.threadedMismatches += !sameRecord(fleetRecord(threaded, i), lone);
+            }
+        }
+    }
+
+    // ---- Per model: table accuracy and cycle times ----
+    const TruckModel* models[] = { &counterbalanceTruckModel(), &heavyTruckModel(), &reachTruckModel() };
+    for (const TruckModel* m : models) {
+        const DynamicsTable& table = dynamics.tables[static_cast<std::size_t>(dynamics.find(m->name))];
+        TruckCycle c;
+        c.model = m->name;
+        c.maxTableError = tableError(*m, table);
+        LiftPlant empty{};
+        c.emptyRaiseSeconds = timeMove(table, 0.0, true, empty);
+        LiftPlant rated{};
+        c.ratedRaiseSeconds = timeMove(table, m->ratedLoadKg, true, rated);
+        c.ratedLowerSeconds = timeMove(table, m->ratedLoadKg, false, rated);
+        r.cycleOrderFailures += !(c.ratedRaiseSeconds > c.emptyRaiseSeconds);
+        r.maxTableError = std::max(r.maxTableError, c.maxTableError);
+        r.cycles.push_back(c);
+    }
+
+    // ---- Lookup against direct evaluation ----
+    using Clock = std::chrono::steady_clock;
+    const TruckModel& model = counterbalanceTruckModel();
+    const DynamicsTable& table = dynamics.tables[static_cast<std::size_t>(dynamics.find(model.name))];
+    const std::size_t kPoints = 4096;
+    const int kRounds = 250;
+    std::vector<double> loads(kPoints);
+    std::vector<double> heights(kPoints);
+    SplitMix64 rng{ streamKey(kSeed + 3, 0) };
+    for (std::size_t k = 0; k < kPoints; ++k) {
+        loads[k] = rng.uniform(0.0, model.ratedLoadKg);
+        heights[k] = rng.uniform();
+    }
+    double sink = 0.0;
+    const Clock::time_point t0 = Clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (std::size_t k = 0; k < kPoints; ++k) sink += table.sample(loads[k], heights[k]).liftSpeed;
+    }
+    const Clock::time_point t1 = Clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (std::size_t k = 0; k < kPoints; ++k) sink += DynamicsTable::evaluate(model, loads[k], heights[k]).liftSpeed;
+    }
+    const Clock::time_point t2 = Clock::now();
+    const double kCalls = double(kPoints) * kRounds;
+    r.sampleNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / kCalls;
+    r.evaluateNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kCalls;
+    if (!(sink > 0.0)) r.error = "lookup timing produced no speeds";
+    return r;
+}
+
+void printDynamicsCheckReport(std::ostream& os, const DynamicsCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "dynamics-check: " << r.error << "\n";
+        return;
+    }
+    os << "dynamics-check: lifts=" << r.lifts << " scans=" << r.scans << " tables=" << r.tableBytes << " bytes\n"
+        << "  fixed model vs no dynamics: mismatches=" << r.fixedMismatches << "\n"
+        << "  mixed models vs scanLoadedLift: mismatches=" << r.fleetMismatches
+        << " threaded=" << r.threadedMismatches << "\n";
+    os << std::fixed;
+    for (const TruckCycle& c : r.cycles) {
+        os << "  " << c.model << ": raise empty=" << std::setprecision(2) << c.emptyRaiseSeconds
+            << "s rated=" << c.ratedRaiseSeconds << "s, lower rated=" << c.ratedLowerSeconds
+            << "s, table error=" << std::setprecision(3) << c.maxTableError * 100.0 << "%\n";
+    }
+    os << "  cycle order failures=" << r.cycleOrderFailures << "\n"
+        << std::setprecision(1)
+        << "  ns per lookup: table=" << r.sampleNs << " model=" << r.evaluateNs << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Checks LoadDynamics.h: the fixed truck model runs like no dynamics, mixed
+// fleets (serial and on a FleetScheduler) match scanLoadedLift() per lift,
+// every table tracks its model, and heavier loads cycle slower.
+
+struct TruckCycle {
+    std::string model;
+    double emptyRaiseSeconds = 0.0;   // bottom to 90 % height
+    double ratedRaiseSeconds = 0.0;
+    double ratedLowerSeconds = 0.0;   // 90 % height to the bottom
+    double maxTableError = 0.0;       // worst |table - model| over the field's range, as a fraction
+};
+
+struct DynamicsCheckReport {
+    std::size_t lifts = 0;
+    std::int64_t scans = 0;
+    std::size_t tableBytes = 0;            // all built-in tables together
+    std::uint64_t fixedMismatches = 0;     // fixed-model fleet vs no dynamics (must be 0)
+    std::uint64_t fleetMismatches = 0;     // mixed-model fleet vs scanLoadedLift() (must be 0)
+    std::uint64_t threadedMismatches = 0;  // the same on a FleetScheduler (must be 0)
+    std::vector<TruckCycle> cycles;        // built-in models other than fixed
+    std::uint64_t cycleOrderFailures = 0;  // rated load not slower than empty (must be 0)
+    double maxTableError = 0.0;            // worst over all models (must be below kMaxTableError)
+    double sampleNs = 0.0;                 // DynamicsTable::sample
+    double evaluateNs = 0.0;               // DynamicsTable::evaluate
+    std::string error;
+
+    static constexpr double kMaxTableError = 0.05;
+
+    bool passed() const {
+        return error.empty() && fixedMismatches == 0 && fleetMismatches == 0 && threadedMismatches == 0 &&
+               cycleOrderFailures == 0 && maxTableError < kMaxTableError;
+    }
+};
+
+DynamicsCheckReport checkLoadDynamics(std::size_t lifts, std::int64_t scans);
+
+void printDynamicsCheckReport(std::ostream& os, const DynamicsCheckReport& r);
@@ -0,0 +1,122 @@
+#include "EventFleet.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Console.h"
+#include "Rng.h"
+
+namespace {
+
+// One headless scan for one lift (see runHeadless).
+void scanOnce(EventLift& l, const Script& script, std::int64_t scan, double dt) {
+    // ---- Reset is a pulse: default false each cycle ----
+    l.in.resetFault = false;
+
+    // ---- Scripted input for this scan ----
+    while (l.nextEvent < script.events.size() && script.events[l.nextEvent].scan <= scan) {
+        applyCommand(script.events[l.nextEvent].cmd, l.in);
+        ++l.nextEvent;
+    }
+
+    l.out = scanLift(dt, l.in, l.ctrl, l.plant);
+}
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) {
+    return std::memcmp(&a, &b, sizeof(TraceRecord)) == 0;
+}
+
+// true if another scan with no script event would leave the lift unchanged.
+// Only worth asking once the plant is at rest.
+bool atFixpoint(const EventLift& l, double dt) {
+    EventLift trial = l;
+    trial.in.resetFault = false;
+    trial.out = scanLift(dt, trial.in, trial.ctrl, trial.plant);
+    return sameRecord(makeTraceRecord(l.in, l.out, l.plant, l.ctrl.state, l.ctrl.faults.latched),
+                      makeTraceRecord(trial.in, trial.out, trial.plant, trial.ctrl.state, trial.ctrl.faults.latched));
+}
+
+void advanceLift(EventLift& l, const Script& script, std::int64_t from, std::int64_t to, double dt,
+                 bool parking, EventFleetStats& stats) {
+    std::int64_t scan = from;
+    while (scan < to) {
+        if (l.parked) {
+            const std::int64_t wake = l.nextEvent < script.events.size() ? script.events[l.nextEvent].scan : to;
+            const std::int64_t until = std::min(std::max(wake, scan), to);
+            stats.parkedScans += static_cast<std::uint64_t>(until - scan);
+            scan = until;
+            if (scan == to) break;
+            l.parked = false;
+        }
+
+        scanOnce(l, script, scan, dt);
+        ++scan;
+        stats.simulatedScans++;
+
+        if (parking && l.plant.velocity == 0.0 && l.plant.targetVel == 0.0) {
+            stats.trialScans++;
+            if (atFixpoint(l, dt)) {
+                l.parked = true;
+                stats.parks++;
+            }
+        }
+    }
+}
+
+} // namespace
+
+EventFleet::EventFleet(std::vector<Script> liftScripts, double scanDt)
+    : scripts(std::move(liftScripts)), lifts(scripts.size()), dt(scanDt) {}
+
+void EventFleet::advanceTo(std::int64_t scan) {
+    if (scan <= now) return;
+    for (std::size_t i = 0; i < lifts.size(); ++i) {
+        advanceLift(lifts[i], scripts[i], now, scan, dt, parking, stats);
+    }
+    now = scan;
+}
+
+TraceRecord EventFleet::record(std::size_t lift) const {
+    const EventLift& l = lifts[lift];
+    return makeTraceRecord(l.in, l.out, l.plant, l.ctrl.state, l.ctrl.faults.latched);
+}
+
+Script makeShiftScript(std::uint64_t seed, std::size_t lift, std::int64_t scans) {
+    SplitMix64 rng{ streamKey(seed, lift) };
+    Script script{};
+    auto add = [&](std::int64_t scan, CommandVerb verb, double value = 0.0) {
+        if (scan < scans) script.events.push_back({ scan, Command{ verb, value } });
+    };
+
+    std::int64_t t = static_cast<std::int64_t>(rng.next() % 3000);
+    while (t < scans) {
+        // A job: reset, set the load, raise, wait, lower, stop.
+        add(t, CommandVerb::Reset);
+        add(t, CommandVerb::SetLoad, rng.chance(0.05) ? 1300.0 : rng.uniform(100.0, 1150.0));
+        t += 1;
+        // Raise short of the top (full travel takes ~145 scans), then lower
+        // about as far; lowering is slower, and a little extra time
+        // sometimes drives into the bottom limit, which faults until the
+        // next job's reset.
+        const std::int64_t raise = 20 + static_cast<std::int64_t>(rng.next() % 100);
+        add(t, CommandVerb::Up);
+        t += raise;
+        add(t, CommandVerb::Stop);
+        t += 100 + static_cast<std::int64_t>(rng.next() % 1400);
+        add(t, CommandVerb::Down);
+        t += raise * 7 / 6 - 4 + static_cast<std::int64_t>(rng.next() % 8);
+        add(t, CommandVerb::Stop);
+
+        if (rng.chance(0.02)) {
+            const std::int64_t at = t + static_cast<std::int64_t>(rng.next() % 500);
+            add(at, CommandVerb::ToggleEstop);
+            add(at + 50 + static_cast<std::int64_t>(rng.next() % 200), CommandVerb::ToggleEstop);
+        }
+
+        // Idle for 10 s .. 10 min before the next job
+        t += 500 + static_cast<std::int64_t>(rng.next() % 29500);
+    }
+    std::stable_sort(script.events.begin(), script.events.end(),
+                     [](const ScriptEvent& a, const ScriptEvent& b) { return a.scan < b.scan; });
+    return script;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LiftControl.h"
+#include "Script.h"
+#include "TraceFormat.h"
+
+// Fleet of scripted lifts, simulated only while something can change.
+//
+// Each lift follows its own command script with the headless scan sequence
+// (reset pulse, script events for the scan, scanLift). After a scan, a lift
+// whose plant is at rest gets one trial scan on a copy; if that reproduces
+// the lift's inputs, outputs, plant, state and fault bit for bit, the lift
+// is at a fixpoint and every further scan would repeat it. It is parked and
+// jumps straight to the scan of its next script event. Idle lifts holding
+// at rest and faulted lifts waiting for a reset both park, so the cost
+// follows operator activity instead of lifts x scans, and the fleet ends
+// in exactly the state the dense loop (parking off) produces.
+//
+// Lifts are independent, so advanceTo() runs each lift through the whole
+// interval in turn.
+
+struct EventLift {
+    LiftController ctrl{};
+    LiftPlant plant{};
+    Inputs in{};
+    Outputs out{};
+    std::size_t nextEvent = 0;   // index into the lift's script
+    bool parked = false;
+};
+
+struct EventFleetStats {
+    std::uint64_t simulatedScans = 0;   // lift-scans actually run
+    std::uint64_t trialScans = 0;       // fixpoint checks
+    std::uint64_t parkedScans = 0;      // lift-scans skipped while parked
+    std::uint64_t parks = 0;
+};
+
+struct EventFleet {
+    std::vector<Script> scripts;        // one per lift, events sorted by scan
+    std::vector<EventLift> lifts;
+    double dt = 0.02;
+    bool parking = true;                // false = the dense loop, for comparison
+    std::int64_t now = 0;               // every lift has run scans [0, now)
+    EventFleetStats stats;
+
+    EventFleet(std::vector<Script> liftScripts, double scanDt);
+
+    std::size_t size() const { return lifts.size(); }
+
+    void advanceTo(std::int64_t scan);
+
+    // Lift state after its last scan, in trace form
+    TraceRecord record(std::size_t lift) const;
+};
+
+// A synthetic shift for one lift: mostly idle, with occasional
+// load/raise/wait/lower jobs, reset pulses, some overloads and bottom-limit
+// hits (which fault and wait for the next job's reset) and rare E-stops.
+// Same (seed, lift) -> same script.
+Script makeShiftScript(std::uint64_t seed, std::size_t lift, std::int64_t scans);
@@ -0,0 +1,160 @@
+#include "ExportCheck.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "ColumnarExport.h"
+#include "LiftFleet.h"
+#include "Rng.h"
+#include "TelemetrySink.h"
+#include "TraceReader.h"
+#include "TraceRecorder.h"
+
+namespace {
+
+const double kDt = 0.02;
+
+// Up / stop / down / stop with a reset pulse, staggered per lift, and a
+// pallet of 0 to 1300 kg every cycle: the lifts going over 1200 kg fault.
+void driveLift(Inputs& in, std::size_t lift, std::int64_t scan) {
+    const std::int64_t t = scan + static_cast<std::int64_t>(lift) * 37;
+    const std::int64_t phase = t % 400;
+    in.cmdUp = phase < 120;
+    in.cmdDown = phase >= 200 && phase < 335;
+    in.cmdHold = false;
+    in.resetFault = phase == 399;
+    const std::uint64_t pallet = splitMix64((static_cast<std::uint64_t>(lift) << 32) ^ static_cast<std::uint64_t>(t / 400));
+    in.loadKg = 12.5 * static_cast<double>(pallet % 105);
+}
+
+bool sameDecimal(double a, double b, double scale) { return std::llround(a * scale) == std::llround(b * scale); }
+
+bool sameRow(const TraceRecord& a, const TraceRecord& b) {
+    return sameDecimal(a.position, b.position, 1e9) && sameDecimal(a.velocity, b.velocity, 1e9) &&
+           sameDecimal(a.targetVel, b.targetVel, 1e9) && sameDecimal(a.loadKg, b.loadKg, 1e3) &&
+           a.inputBits == b.inputBits && a.outputBits == b.outputBits && a.state == b.state && a.fault == b.fault;
+}
+
+} // namespace
+
+ExportCheckReport checkColumnarExport(std::size_t lifts, std::int64_t scans) {
+    ExportCheckReport r;
+    r.lifts = lifts;
+    r.scans = scans;
+    if (lifts == 0 || scans <= 0) {
+        r.error = "lifts and scans must be > 0";
+        return r;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    {
+        LiftFleet fleet(lifts);
+        const Clock::time_point t0 = Clock::now();
+        for (std::int64_t s = 0; s < scans; ++s) {
+            for (std::size_t i = 0; i < lifts; ++i) driveLift(fleet.inputs[i], i, s);
+            fleet.scan(kDt);
+        }
+        r.plainSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string parquetPath = (dir / "forklift-export-check.parquet").string();
+    const std::string tracePath = (dir / "forklift-export-check.trace").string();
+
+    ParquetTraceWriter writer;
+    if (!writer.open(parquetPath, static_cast<std::uint32_t>(lifts), kDt, r.error)) return r;
+    TraceRecorder recorder;
+    if (!recorder.open(tracePath, static_cast<std::uint32_t>(lifts), kDt)) {
+        r.error = "cannot open " + tracePath;
+        return r;
+    }
+    recorder.reserve(static_cast<std::uint64_t>(scans) * lifts);
+
+    // The run itself: the sink on its writer thread, the trace and the status line sizes off the clock
+    {
+        LiftFleet fleet(lifts);
+        const std::unique_ptr<ColumnarSink> sink = std::make_unique<ColumnarSink>(writer, ColumnarSink::Options{});
+        sink->start();
+        char line[kMaxStatusLine];
+        Clock::duration exported{};
+        for (std::int64_t s = 0; s < scans; ++s) {
+            const Clock::time_point t0 = Clock::now();
+            for (std::size_t i = 0; i < lifts; ++i) driveLift(fleet.inputs[i], i, s);
+            fleet.scan(kDt);
+            sink->submitFleet(static_cast<std::uint64_t>(s), fleet);
+            exported += Clock::now() - t0;
+
+            recorder.recordFleet(fleet);
+            for (std::size_t i = 0; i < lifts; ++i) {
+                LiftPlant p{};
+                p.position = fleet.position[i];
+                p.velocity = fleet.velocity[i];
+                const StatusSample sample = makeStatusSample(static_cast<std::uint64_t>(s), static_cast<std::uint32_t>(i),
+                                                             p, fleet.state[i], fleet.latched[i], fleet.inputs[i]);
+                r.textBytes += formatStatusLine(line, sample, true);
+            }
+        }
+        sink->stop();
+        r.exportSeconds = std::chrono::duration<double>(exported).count();
+        r.rows = static_cast<std::uint64_t>(scans) * lifts;
+        r.dropped = sink->dropped();
+        if (sink->failed()) r.error = "Parquet write failed";
+    }
+    r.rowGroups = writer.rowGroups();
+    const bool written = writer.close();
+    r.parquetBytes = writer.bytesWritten();
+    const bool recorded = recorder.close();
+    r.traceBytes = recorder.bytesWritten();
+    if (r.error.empty() && (!written || !recorded)) r.error = written ? "trace write failed" : "Parquet write failed";
+
+    // ---- Read back and compare with the trace ----
+    std::vector<ExportRow> rows;
+    TraceReader trace;
+    if (r.error.empty() && readParquetTrace(parquetPath, rows, r.error) && trace.open(tracePath, r.error)) {
+        std::vector<const TraceRecord*> records;
+        records.reserve(static_cast<std::size_t>(trace.recordCount()));
+        for (const TraceChunk& c : trace.chunks()) {
+            for (std::uint32_t k = 0; k < c.recordCount; ++k) records.push_back(c.records + k);
+        }
+        std::vector<bool> seen(records.size(), false);
+        r.rowsRead = rows.size();
+        for (const ExportRow& row : rows) {
+            const std::uint64_t n = row.scan * lifts + row.lift;
+            if (row.lift >= lifts || n >= records.size() || seen[n] || !sameRow(row.record, *records[n])) {
+                r.mismatches++;
+                continue;
+            }
+            seen[n] = true;
+        }
+        for (bool b : seen) r.mismatches += !b;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(parquetPath, ec);
+    std::filesystem::remove(tracePath, ec);
+    return r;
+}
+
+void printExportCheckReport(std::ostream& os, const ExportCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "export-check: " << r.error << "\n";
+        return;
+    }
+    const double rows = r.rows > 0 ? static_cast<double>(r.rows) : 1.0;
+    os << "export-check: lifts=" << r.lifts << " scans=" << r.scans << " rows=" << r.rows
+        << " row groups=" << r.rowGroups << "\n"
+        << "  read back: rows=" << r.rowsRead << " mismatches=" << r.mismatches << " dropped=" << r.dropped << "\n"
+        << std::fixed << std::setprecision(2)
+        << "  bytes/row: parquet=" << static_cast<double>(r.parquetBytes) / rows
+        << " trace=" << static_cast<double>(r.traceBytes) / rows
+        << " status lines=" << static_cast<double>(r.textBytes) / rows << "\n"
+        << std::setprecision(1)
+        << "  scan loop ns/lift-scan: plain=" << r.plainSeconds * 1e9 / rows
+        << " with export=" << r.exportSeconds * 1e9 / rows << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Records one fleet run to a trace and, through a ColumnarSink, to Parquet,
+// then reads the file back: every (scan, lift) row once, equal to its trace
+// record after decimal rounding, and smaller than the trace on disk.
+
+struct ExportCheckReport {
+    std::size_t lifts = 0;
+    std::int64_t scans = 0;
+    std::uint64_t rows = 0;              // submitted
+    std::uint64_t rowsRead = 0;
+    std::size_t rowGroups = 0;
+    std::uint64_t mismatches = 0;        // rows that differ from the trace, or are missing or repeated (must be 0)
+    std::uint64_t dropped = 0;           // by the sink (must be 0)
+    std::uint64_t parquetBytes = 0;
+    std::uint64_t traceBytes = 0;
+    std::uint64_t textBytes = 0;         // formatStatusLine(), every row
+    double plainSeconds = 0.0;           // scan loop alone
+    double exportSeconds = 0.0;          // scan loop submitting every row
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && mismatches == 0 && dropped == 0 && rowsRead == rows && parquetBytes < traceBytes;
+    }
+};
+
+ExportCheckReport checkColumnarExport(std::size_t lifts, std::int64_t scans);
+
+void printExportCheckReport(std::ostream& os, const ExportCheckReport& r);
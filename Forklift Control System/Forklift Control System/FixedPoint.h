@@ -0,0 +1,52 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+// Q16.16 signed fixed point: value = raw / 65536.
+//
+// Range is about +/-32768 with a resolution of 1.5e-5, which covers the
+// lift's position (0..1), velocities and dt. Arithmetic is integer only,
+// for controllers without an FPU. Conversions from double round to
+// nearest (half away from zero); products round to nearest. Nothing
+// saturates, so keep intermediate values inside the range.
+
+struct Fixed16 {
+    static constexpr int kFracBits = 16;
+    static constexpr std::int32_t kOne = 1 << kFracBits;
+
+    std::int32_t raw = 0;
+
+    constexpr Fixed16() = default;
+    explicit constexpr Fixed16(double v)
+        : raw(static_cast<std::int32_t>(v * kOne + (v < 0.0 ? -0.5 : 0.5))) {}
+
+    static constexpr Fixed16 fromRaw(std::int32_t r) {
+        Fixed16 f;
+        f.raw = r;
+        return f;
+    }
+
+    explicit constexpr operator double() const { return static_cast<double>(raw) / kOne; }
+
+    constexpr Fixed16 operator-() const { return fromRaw(-raw); }
+    constexpr Fixed16 operator+() const { return *this; }
+
+    friend constexpr Fixed16 operator+(Fixed16 a, Fixed16 b) { return fromRaw(a.raw + b.raw); }
+    friend constexpr Fixed16 operator-(Fixed16 a, Fixed16 b) { return fromRaw(a.raw - b.raw); }
+    friend constexpr Fixed16 operator*(Fixed16 a, Fixed16 b) {
+        const std::int64_t p = static_cast<std::int64_t>(a.raw) * b.raw;
+        return fromRaw(static_cast<std::int32_t>((p + (std::int64_t{ 1 } << (kFracBits - 1))) >> kFracBits));
+    }
+
+    constexpr Fixed16& operator+=(Fixed16 b) { raw += b.raw; return *this; }
+    constexpr Fixed16& operator-=(Fixed16 b) { raw -= b.raw; return *this; }
+
+    friend constexpr bool operator==(Fixed16 a, Fixed16 b) = default;
+    friend constexpr auto operator<=>(Fixed16 a, Fixed16 b) = default;
+};
+
+constexpr Fixed16 abs(Fixed16 f) { return f.raw < 0 ? -f : f; }
+
+static_assert(static_cast<double>(Fixed16(0.35)) - 0.35 < 1.0 / Fixed16::kOne, "conversion rounds to nearest");
+static_assert(Fixed16(0.5) * Fixed16(0.5) == Fixed16(0.25), "products are exact when representable");
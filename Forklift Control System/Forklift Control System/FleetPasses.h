@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "LiftControl.h"
+#include "LoadDynamics.h"
+#include "TableController.h"
+
+// Per-lift control pass shared by the structure-of-arrays fleets
+// (LiftFleet, ArenaFleet). Fleet has the LiftFleet members, indexable and
+// with empty(): position, velocity, targetVel, state, latched, inputKey,
+// inputs, outputs, mast, dwell, liftCounters, plus tableController.
+
+// Limits, controller, brake override for lifts [begin, end).
+// One scratch controller/plant, loaded and stored per lift: state, latch
+// and input key round-trip; a runtime-configured controller also loads
+// the lift's tunables.
+template <class Controller, class Fleet>
+void controlPass(Fleet& f, std::size_t begin, std::size_t end, double dt) {
+    Controller ctrl{};
+    LiftPlant plant{};
+    constexpr bool perLiftMast = std::is_base_of_v<RuntimeMastConfig, Controller>;
+    LiftCounters* const aggregate = kCountersEnabled && f.liftCounters.empty() ? &threadCounters() : nullptr;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        if constexpr (perLiftMast) static_cast<RuntimeMastConfig&>(ctrl) = f.mast[i];
+        plant.position = f.position[i];
+        plant.velocity = f.velocity[i];
+        plant.targetVel = f.targetVel[i];
+        ctrl.state = f.state[i];
+        ctrl.faults.latched = f.latched[i];
+        ctrl.inputKey = f.inputKey[i];
+        if constexpr (kCountersEnabled) selectScanCounters(aggregate ? aggregate : &f.liftCounters[i], &f.dwell[i]);
+
+        f.outputs[i] = controlScan(dt, f.inputs[i], ctrl, plant);
+
+        f.targetVel[i] = plant.targetVel;
+        f.state[i] = ctrl.state;
+        f.latched[i] = ctrl.faults.latched;
+        f.inputKey[i] = ctrl.inputKey;
+    }
+    selectScanCounters(nullptr, nullptr);
+}
+
+// controlPass() with the controller the fleet is configured for
+template <class Fleet>
+void controlFleetRange(Fleet& f, std::size_t begin, std::size_t end, double dt) {
+    if (begin >= end) return;
+    if (!f.mast.empty()) {
+        if (f.tableController) controlPass<RuntimeTableLiftController>(f, begin, end, dt);
+        else controlPass<RuntimeLiftController>(f, begin, end, dt);
+    }
+    else {
+        if (f.tableController) controlPass<TableLiftController>(f, begin, end, dt);
+        else controlPass<LiftController>(f, begin, end, dt);
+    }
+}
+
+// controlPass() with table-driven dynamics (LoadDynamics.h): Fleet also has
+// dynamics, truckModel, accel and creep. Lifts always run a runtime-tunable
+// controller, as the truck model sets maxLoadKg and the speeds every scan;
+// a per-lift mast still supplies safeStopSpeedEps.
+template <class Controller, class Fleet>
+void controlLoadedPass(Fleet& f, std::size_t begin, std::size_t end, double dt) {
+    Controller ctrl{};
+    LiftPlant plant{};
+    DynamicsSample d;
+    LiftCounters* const aggregate = kCountersEnabled && f.liftCounters.empty() ? &threadCounters() : nullptr;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        if (!f.mast.empty()) static_cast<RuntimeMastConfig&>(ctrl) = f.mast[i];
+        const DynamicsTable& table = f.dynamics->tables[f.truckModel.empty() ? 0 : f.truckModel[i]];
+        plant.position = f.position[i];
+        plant.velocity = f.velocity[i];
+        plant.targetVel = f.targetVel[i];
+        ctrl.state = f.state[i];
+        ctrl.faults.latched = f.latched[i];
+        ctrl.inputKey = f.inputKey[i];
+        if constexpr (kCountersEnabled) selectScanCounters(aggregate ? aggregate : &f.liftCounters[i], &f.dwell[i]);
+
+        f.outputs[i] = controlLoadedScan(dt, f.inputs[i], ctrl, plant, table, d);
+
+        f.targetVel[i] = plant.targetVel;
+        f.state[i] = ctrl.state;
+        f.latched[i] = ctrl.faults.latched;
+        f.inputKey[i] = ctrl.inputKey;
+        f.accel[i] = d.accel;
+        f.creep[i] = d.creep;
+    }
+    selectScanCounters(nullptr, nullptr);
+}
+
+template <class Fleet>
+void controlLoadedFleetRange(Fleet& f, std::size_t begin, std::size_t end, double dt) {
+    if (begin >= end) return;
+    if (f.tableController) controlLoadedPass<RuntimeTableLiftController>(f, begin, end, dt);
+    else controlLoadedPass<RuntimeLiftController>(f, begin, end, dt);
+}
@@ -0,0 +1,254 @@
+#include "FleetScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t nsSince(Clock::time_point t0, Clock::time_point t1) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+}
+
+unsigned resolveThreads(unsigned threads) {
+    if (threads > 0) return threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+unsigned coreFor(unsigned worker) { return worker % std::max(1u, std::thread::hardware_concurrency()); }
+
+// Pin the calling thread to one core. If saved is given, it receives the
+// previous affinity for restoreAffinity(). False where pinning is unsupported.
+bool pinThisThread(unsigned core, std::vector<unsigned char>* saved) {
+#if defined(_WIN32)
+    if (core >= 8 * sizeof(DWORD_PTR)) return false;
+    const DWORD_PTR previous = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1 } << core);
+    if (previous == 0) return false;
+    if (saved) {
+        saved->resize(sizeof(previous));
+        std::memcpy(saved->data(), &previous, sizeof(previous));
+    }
+    return true;
+#elif defined(__linux__)
+    cpu_set_t previous;
+    if (saved && pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) != 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) return false;
+    if (saved) {
+        saved->resize(sizeof(previous));
+        std::memcpy(saved->data(), &previous, sizeof(previous));
+    }
+    return true;
+#else
+    (void)core;
+    (void)saved;
+    return false;
+#endif
+}
+
+void restoreAffinity(const std::vector<unsigned char>& saved) {
+    if (saved.empty()) return;
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    std::memcpy(&mask, saved.data(), sizeof(mask));
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(__linux__)
+    cpu_set_t set;
+    std::memcpy(&set, saved.data(), sizeof(set));
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+} // namespace
+
+const char* scanPhaseToString(ScanPhase p) {
+    switch (p) {
+    case ScanPhase::Control: return "control";
+    case ScanPhase::Plant: return "plant";
+    }
+    return "unknown";
+}
+
+double FleetSchedulerStats::imbalance(ScanPhase p) const {
+    const int i = static_cast<int>(p);
+    std::uint64_t busy = 0;
+    for (const FleetWorkerStats& w : workers) busy += w.busyNs[i];
+    if (busy == 0 || workers.empty()) return 0.0;
+    const double mean = static_cast<double>(busy) / workers.size();
+    return criticalNs[i] / mean - 1.0;
+}
+
+std::size_t FleetScheduler::defaultChunkLifts(std::size_t cacheBytes) {
+    // Per-lift scan state: the three plant doubles, state and latch, scan I/O
+    const std::size_t perLift = 3 * sizeof(double) + sizeof(LiftState) + sizeof(FaultCode) +
+                                sizeof(Inputs) + sizeof(Outputs) + (kCountersEnabled ? sizeof(std::uint32_t) : 0);
+    return std::max<std::size_t>(cacheBytes / perLift / 8 * 8, 8);
+}
+
+FleetScheduler::FleetScheduler(LiftFleet& fleet, const FleetSchedulerOptions& opt)
+    : fleet_(fleet), workers_(resolveThreads(opt.threads)), barrier_(resolveThreads(opt.threads)) {
+    const std::size_t lifts = fleet.size();
+    const std::size_t n = workers_.size();
+
+    // Whole chunks per worker; smaller chunks if there would not be one per worker
+    chunkLifts_ = opt.chunkLifts > 0 ? (opt.chunkLifts + 7) / 8 * 8 : defaultChunkLifts();
+    if ((lifts + chunkLifts_ - 1) / chunkLifts_ < n) chunkLifts_ = std::max<std::size_t>(((lifts + n - 1) / n + 7) / 8 * 8, 8);
+    chunks_ = (lifts + chunkLifts_ - 1) / chunkLifts_;
+    for (std::size_t w = 0; w < n; ++w) {
+        workers_[w].begin = std::min(lifts, chunks_ * w / n * chunkLifts_);
+        workers_[w].end = std::min(lifts, chunks_ * (w + 1) / n * chunkLifts_);
+    }
+
+    if (opt.pin && n > 1) workers_[0].pinned.store(pinThisThread(coreFor(0), &callerAffinity_), std::memory_order_relaxed);
+    // Workers hold off the barrier until all of them are up, so a failed start
+    // can stop the ones already running without a full party at the barrier.
+    try {
+        threads_.reserve(n - 1);
+        for (unsigned w = 1; w < n; ++w) {
+            threads_.emplace_back([this, w, pin = opt.pin] {
+                if (pin) workers_[w].pinned.store(pinThisThread(coreFor(w), nullptr), std::memory_order_relaxed);
+                start_.wait(WorkerStart::Pending, std::memory_order_acquire);
+                if (start_.load(std::memory_order_acquire) == WorkerStart::Abort) return;
+                workerLoop(w);
+            });
+        }
+    }
+    catch (...) {
+        start_.store(WorkerStart::Abort, std::memory_order_release);
+        start_.notify_all();
+        for (std::thread& t : threads_) t.join();
+        restoreAffinity(callerAffinity_);
+        throw;
+    }
+    start_.store(WorkerStart::Run, std::memory_order_release);
+    start_.notify_all();
+}
+
+FleetScheduler::~FleetScheduler() {
+    stop_ = true;
+    barrier_.arriveAndWait();
+    for (std::thread& t : threads_) t.join();
+    restoreAffinity(callerAffinity_);
+}
+
+void FleetScheduler::workerLoop(unsigned worker) {
+    for (;;) {
+        barrier_.arriveAndWait(); // scan start
+        if (stop_) return;
+        runPhases(worker);
+    }
+}
+
+void FleetScheduler::runPhases(unsigned worker) {
+    Worker& w = workers_[worker];
+    w.waitNs[1] += w.endWaitNs;
+    w.endWaitNs = 0;
+
+    // ---- Control: limits, controller, brake override ----
+    const Clock::time_point t0 = Clock::now();
+    fleet_.controlRange(w.begin, w.end, dt_);
+    const Clock::time_point t1 = Clock::now();
+    barrier_.arriveAndWait();
+    const Clock::time_point t2 = Clock::now();
+
+    // ---- Plant step ----
+    fleet_.stepRange(w.begin, w.end, dt_);
+    const Clock::time_point t3 = Clock::now();
+
+    w.lastBusyNs[0] = nsSince(t0, t1);
+    w.lastBusyNs[1] = nsSince(t2, t3);
+    w.busyNs[0] += w.lastBusyNs[0];
+    w.busyNs[1] += w.lastBusyNs[1];
+    w.waitNs[0] += nsSince(t1, t2);
+
+    barrier_.arriveAndWait(); // scan end
+    w.endWaitNs = nsSince(t3, Clock::now());
+}
+
+void FleetScheduler::scan(double dt) {
+    const Clock::time_point t0 = Clock::now();
+    dt_ = dt;
+    barrier_.arriveAndWait(); // releases the workers
+    runPhases(0);
+
+    // Every worker's timings for this scan were written before the last barrier.
+    // The next scan's first barrier orders them before the workers overwrite them.
+    for (int p = 0; p < kScanPhases; ++p) {
+        std::uint64_t slowest = 0;
+        for (const Worker& w : workers_) slowest = std::max(slowest, w.lastBusyNs[p]);
+        criticalNs_[p] += slowest;
+    }
+    scans_++;
+    scanNs_ += nsSince(t0, Clock::now());
+}
+
+FleetSchedulerStats FleetScheduler::stats() const {
+    FleetSchedulerStats s{};
+    s.scans = scans_;
+    s.chunkLifts = chunkLifts_;
+    s.chunks = chunks_;
+    s.scanNs = scanNs_;
+    for (int p = 0; p < kScanPhases; ++p) s.criticalNs[p] = criticalNs_[p];
+    for (const Worker& w : workers_) {
+        FleetWorkerStats ws{};
+        ws.firstLift = w.begin;
+        ws.lifts = w.end - w.begin;
+        ws.pinned = w.pinned.load(std::memory_order_relaxed);
+        for (int p = 0; p < kScanPhases; ++p) {
+            ws.busyNs[p] = w.busyNs[p];
+            ws.waitNs[p] = w.waitNs[p];
+        }
+        s.workers.push_back(ws);
+    }
+    return s;
+}
+
+void printFleetSchedulerStats(std::ostream& os, const FleetSchedulerStats& s) {
+    const double scans = s.scans > 0 ? static_cast<double>(s.scans) : 1.0;
+    const auto us = [scans](std::uint64_t ns) { return ns / scans / 1000.0; };
+    const std::size_t pinned = std::count_if(s.workers.begin(), s.workers.end(),
+                                             [](const FleetWorkerStats& w) { return w.pinned; });
+
+    os << std::fixed << std::setprecision(1)
+        << "scheduler: threads=" << s.workers.size() << " pinned=" << pinned
+        << " chunks=" << s.chunks << " chunk-lifts=" << s.chunkLifts
+        << " scans=" << s.scans << " scan_us(mean)=" << us(s.scanNs) << "\n";
+    for (int p = 0; p < kScanPhases; ++p) {
+        std::uint64_t busy = 0, wait = 0;
+        for (const FleetWorkerStats& w : s.workers) {
+            busy += w.busyNs[p];
+            wait += w.waitNs[p];
+        }
+        const double n = s.workers.empty() ? 1.0 : static_cast<double>(s.workers.size());
+        os << "  phase " << scanPhaseToString(static_cast<ScanPhase>(p))
+            << ": critical_us=" << us(s.criticalNs[p])
+            << " busy_us(mean)=" << us(busy) / n
+            << " barrier_us(mean)=" << us(wait) / n
+            << " imbalance=" << 100.0 * s.imbalance(static_cast<ScanPhase>(p)) << "%\n";
+    }
+    for (std::size_t i = 0; i < s.workers.size(); ++i) {
+        const FleetWorkerStats& w = s.workers[i];
+        os << "  worker " << i << ": lifts=" << w.firstLift << "+" << w.lifts << (w.pinned ? " pinned" : "")
+            << " control_us=" << us(w.busyNs[0]) << " plant_us=" << us(w.busyNs[1])
+            << " barrier_us=" << us(w.waitNs[0] + w.waitNs[1]) << "\n";
+    }
+}
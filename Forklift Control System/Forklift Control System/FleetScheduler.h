@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <thread>
+#include <vector>
+
+#include "LiftFleet.h"
+#include "PhaseBarrier.h"
+
+// Multi-threaded scan of one LiftFleet.
+//
+// The fleet is cut into chunks of chunkLifts lifts, sized so a chunk's scan
+// state fits in a core's L2 cache and a multiple of 8 lifts so every
+// worker's plant kernel runs whole vectors. Each worker owns a contiguous
+// run of chunks for the scheduler's lifetime, so its lifts stay in its
+// core's caches from scan to scan. Worker 0 is the thread that
+// calls scan(); the others are started once and, if pin is set, pinned to
+// their own cores. A scan runs the same sequence as LiftFleet::scan() as
+// two phases separated by a PhaseBarrier:
+//
+//     control   limits, controller update, brake override (controlRange)
+//     plant     batched plant step (stepRange)
+//
+// Lifts don't interact and every lift goes through the same code as in the
+// single-threaded loop, so the result is bit-identical for any thread or
+// chunk count.
+//
+// If a worker thread cannot be started, the constructor stops and joins the
+// ones already running and rethrows the std::system_error (or bad_alloc).
+
+struct FleetSchedulerOptions {
+    unsigned threads = 0;              // 0 = one per hardware thread
+    std::size_t chunkLifts = 0;        // 0 = sized from the per-lift footprint
+    bool pin = true;                   // pin worker i to core i
+};
+
+enum class ScanPhase { Control, Plant };
+inline constexpr int kScanPhases = 2;
+
+const char* scanPhaseToString(ScanPhase p);
+
+struct FleetWorkerStats {
+    std::size_t firstLift = 0;
+    std::size_t lifts = 0;
+    bool pinned = false;
+    std::uint64_t busyNs[kScanPhases] = {};     // time in the phase's work
+    std::uint64_t waitNs[kScanPhases] = {};     // time in the barrier after it
+};
+
+struct FleetSchedulerStats {
+    std::uint64_t scans = 0;
+    std::size_t chunkLifts = 0;
+    std::size_t chunks = 0;
+    std::vector<FleetWorkerStats> workers;
+
+    // Sum over scans of the slowest worker's busy time: the phase's critical path
+    std::uint64_t criticalNs[kScanPhases] = {};
+    std::uint64_t scanNs = 0;          // wall time inside scan()
+
+    // Critical path over mean busy time, minus one: 0 = perfectly balanced
+    double imbalance(ScanPhase p) const;
+};
+
+class FleetScheduler {
+public:
+    FleetScheduler(LiftFleet& fleet, const FleetSchedulerOptions& opt);
+    ~FleetScheduler();
+
+    FleetScheduler(const FleetScheduler&) = delete;
+    FleetScheduler& operator=(const FleetScheduler&) = delete;
+
+    // One scan of every lift; returns once all phases are done.
+    void scan(double dt);
+
+    unsigned threads() const { return static_cast<unsigned>(workers_.size()); }
+    FleetSchedulerStats stats() const;
+
+    // Lifts per chunk for a per-core cache budget of cacheBytes (a multiple of 8 lifts)
+    static std::size_t defaultChunkLifts(std::size_t cacheBytes = 512 * 1024);
+
+private:
+    // Timings are written only by their own worker, before the scan's last
+    // barrier, so worker 0 reads them once scan() is past it.
+    struct alignas(64) Worker {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        std::atomic<bool> pinned{ false };
+        std::uint64_t lastBusyNs[kScanPhases] = {};
+        std::uint64_t busyNs[kScanPhases] = {};
+        std::uint64_t waitNs[kScanPhases] = {};
+        std::uint64_t endWaitNs = 0;       // last scan's final barrier; folded in on the next scan
+    };
+
+    void runPhases(unsigned worker);
+    void workerLoop(unsigned worker);
+
+    LiftFleet& fleet_;
+    std::vector<Worker> workers_;
+    std::vector<std::thread> threads_;
+    PhaseBarrier barrier_;
+    double dt_ = 0.0;
+    bool stop_ = false;
+    // Workers wait for Run (every thread is up) before their first barrier
+    enum class WorkerStart : std::uint8_t { Pending, Run, Abort };
+    std::atomic<WorkerStart> start_{ WorkerStart::Pending };
+    std::size_t chunkLifts_ = 0;
+    std::size_t chunks_ = 0;
+    std::uint64_t scans_ = 0;
+    std::uint64_t criticalNs_[kScanPhases] = {};
+    std::uint64_t scanNs_ = 0;
+    std::vector<unsigned char> callerAffinity_;   // the calling thread's mask before pinning, if pinned
+};
+
+// "scheduler: threads=... chunks=..." plus per-phase critical path, imbalance and per-worker lines
+void printFleetSchedulerStats(std::ostream& os, const FleetSchedulerStats& s);
@@ -0,0 +1,148 @@
+#include "ForkliftApi.h"
+
+#include <memory>
+
+#include "FleetScheduler.h"
+#include "LiftFleet.h"
+
+static_assert(sizeof(forklift_inputs) == 16, "forklift_inputs is part of the ABI");
+static_assert(sizeof(forklift_outputs) == 32, "forklift_outputs is part of the ABI");
+static_assert(FORKLIFT_STATE_FAULTED == static_cast<int>(LiftState::Faulted), "state values follow LiftState");
+static_assert(FORKLIFT_STATE_POSITIONING == static_cast<int>(LiftState::Positioning), "state values follow LiftState");
+static_assert(FORKLIFT_FAULT_EMERGENCY_STOP == static_cast<int>(FaultCode::EmergencyStop), "fault values follow FaultCode");
+
+struct forklift_pool {
+    LiftFleet fleet;
+    std::unique_ptr<FleetScheduler> scheduler;   // threads > 1
+    double dt = 0.0;
+    std::uint64_t scans = 0;
+    bool resetPending = false;                   // some lift has reset_fault set for the next scan
+};
+
+namespace {
+
+bool validRange(const forklift_pool* pool, std::uint32_t first, std::uint32_t count) {
+    return std::uint64_t{ first } + count <= pool->fleet.size();
+}
+
+} // namespace
+
+extern "C" {
+
+std::uint32_t forklift_api_version(void) { return FORKLIFT_API_VERSION; }
+
+const char* forklift_status_string(forklift_status status) {
+    switch (status) {
+    case FORKLIFT_OK: return "ok";
+    case FORKLIFT_ERROR_INVALID_ARGUMENT: return "invalid argument";
+    case FORKLIFT_ERROR_OUT_OF_RANGE: return "lift range out of range";
+    case FORKLIFT_ERROR_OUT_OF_MEMORY: return "out of memory";
+    }
+    return "unknown status";
+}
+
+forklift_status forklift_pool_create(const forklift_pool_config* config, forklift_pool** pool) {
+    if (!config || !pool) return FORKLIFT_ERROR_INVALID_ARGUMENT;
+    *pool = nullptr;
+    if (config->lifts == 0 || !(config->dt > 0.0) || config->reserved != 0 ||
+        config->controller > FORKLIFT_CONTROLLER_TABLE) {
+        return FORKLIFT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Nothing may escape through the C ABI: allocation and thread start-up
+    // failures both come back as out of memory.
+    try {
+        std::unique_ptr<forklift_pool> p(new forklift_pool);
+        p->fleet.resize(config->lifts);
+        p->fleet.tableController = config->controller == FORKLIFT_CONTROLLER_TABLE;
+        // Counter builds: per-lift counters, so scans never touch (and first allocate) the thread aggregate
+        if (kCountersEnabled) p->fleet.enablePerLiftCounters();
+        p->dt = config->dt;
+        if (config->threads > 1) {
+            // The host owns its threads' placement, so the caller is never pinned here
+            FleetSchedulerOptions opt{};
+            opt.threads = config->threads;
+            opt.pin = false;
+            p->scheduler = std::make_unique<FleetScheduler>(p->fleet, opt);
+        }
+        *pool = p.release();
+        return FORKLIFT_OK;
+    }
+    catch (...) {
+        return FORKLIFT_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+void forklift_pool_destroy(forklift_pool* pool) { delete pool; }
+
+std::uint32_t forklift_pool_lifts(const forklift_pool* pool) {
+    return pool ? static_cast<std::uint32_t>(pool->fleet.size()) : 0;
+}
+
+std::uint64_t forklift_pool_scans(const forklift_pool* pool) { return pool ? pool->scans : 0; }
+
+forklift_status forklift_submit_inputs(forklift_pool* pool, std::uint32_t first, std::uint32_t count,
+                                       const forklift_inputs* inputs) {
+    if (!pool || (!inputs && count > 0)) return FORKLIFT_ERROR_INVALID_ARGUMENT;
+    if (!validRange(pool, first, count)) return FORKLIFT_ERROR_OUT_OF_RANGE;
+
+    // Limit switches stay as the last scan derived them
+    Inputs* in = pool->fleet.inputs.data() + first;
+    bool reset = false;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const forklift_inputs& src = inputs[i];
+        in[i].cmdUp = src.cmd_up != 0;
+        in[i].cmdDown = src.cmd_down != 0;
+        in[i].cmdHold = src.cmd_hold != 0;
+        in[i].estop = src.estop != 0;
+        in[i].resetFault = src.reset_fault != 0;
+        in[i].loadKg = src.load_kg;
+        reset |= in[i].resetFault;
+    }
+    pool->resetPending |= reset;
+    return FORKLIFT_OK;
+}
+
+forklift_status forklift_scan(forklift_pool* pool, std::uint64_t n) {
+    if (!pool) return FORKLIFT_ERROR_INVALID_ARGUMENT;
+    LiftFleet& fleet = pool->fleet;
+    for (std::uint64_t s = 0; s < n; ++s) {
+        if (pool->scheduler) pool->scheduler->scan(pool->dt);
+        else fleet.scan(pool->dt);
+
+        // reset_fault is a pulse: drop it after the scan that saw it
+        if (pool->resetPending) {
+            for (Inputs& in : fleet.inputs) in.resetFault = false;
+            pool->resetPending = false;
+        }
+    }
+    pool->scans += n;
+    return FORKLIFT_OK;
+}
+
+forklift_status forklift_read_outputs(const forklift_pool* pool, std::uint32_t first, std::uint32_t count,
+                                      forklift_outputs* outputs) {
+    if (!pool || (!outputs && count > 0)) return FORKLIFT_ERROR_INVALID_ARGUMENT;
+    if (!validRange(pool, first, count)) return FORKLIFT_ERROR_OUT_OF_RANGE;
+
+    const LiftFleet& f = pool->fleet;
+    for (std::uint32_t k = 0; k < count; ++k) {
+        const std::size_t i = std::size_t{ first } + k;
+        const Outputs& out = f.outputs[i];
+        forklift_outputs& dst = outputs[k];
+        dst.motor_enable = out.motorEnable;
+        dst.motor_dir = static_cast<std::int8_t>(out.motorDir);
+        dst.brake_engaged = out.brakeEngaged;
+        dst.fault_lamp = out.faultLamp;
+        dst.top_limit = f.inputs[i].topLimit;
+        dst.bottom_limit = f.inputs[i].bottomLimit;
+        dst.state = static_cast<std::uint8_t>(f.state[i]);
+        dst.fault = static_cast<std::uint8_t>(f.latched[i]);
+        dst.position = f.position[i];
+        dst.velocity = f.velocity[i];
+        dst.target_velocity = f.targetVel[i];
+    }
+    return FORKLIFT_OK;
+}
+
+} // extern "C"
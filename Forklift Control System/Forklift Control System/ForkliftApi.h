@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// C ABI for embedding the lift controller in another simulator.
+//
+// A pool is a fleet of lifts (one or more) with its own scan clock. The
+// caller writes operator inputs with forklift_submit_inputs(), advances
+// every lift by n PLC scans with forklift_scan(), and copies the results
+// out with forklift_read_outputs(); all three work on a contiguous range of
+// lifts and caller-provided arrays, so one call covers the whole fleet.
+// Each scan is the same limits -> controller -> brake -> plant sequence as
+// every other run mode, and lift i behaves bit-for-bit like a lone lift
+// fed the same inputs.
+//
+// Every allocation happens in forklift_pool_create(); submit, scan and read
+// never allocate, lock or do I/O, and no call throws. The structs below are
+// plain C with fixed-size fields, for ctypes/cffi or Rust FFI bindings.
+// FORKLIFT_API_VERSION changes whenever a struct layout or signature does.
+
+#if defined(_WIN32) && defined(FORKLIFT_API_SHARED)
+#if defined(FORKLIFT_API_BUILD)
+#define FORKLIFT_API __declspec(dllexport)
+#else
+#define FORKLIFT_API __declspec(dllimport)
+#endif
+#elif defined(FORKLIFT_API_SHARED) && defined(__GNUC__)
+#define FORKLIFT_API __attribute__((visibility("default")))
+#else
+#define FORKLIFT_API
+#endif
+
+#define FORKLIFT_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum forklift_status {
+    FORKLIFT_OK = 0,
+    FORKLIFT_ERROR_INVALID_ARGUMENT = 1,   // null pointer or bad config value
+    FORKLIFT_ERROR_OUT_OF_RANGE = 2,       // lift range past the end of the pool
+    FORKLIFT_ERROR_OUT_OF_MEMORY = 3,      // forklift_pool_create only
+} forklift_status;
+
+typedef enum forklift_controller {
+    FORKLIFT_CONTROLLER_REFERENCE = 0,     // LiftController
+    FORKLIFT_CONTROLLER_TABLE = 1,         // TableLiftController, same behavior
+} forklift_controller;
+
+// Values of forklift_outputs.state and .fault match LiftState and FaultCode
+enum {
+    FORKLIFT_STATE_HOLDING = 0,
+    FORKLIFT_STATE_LIFTING = 1,
+    FORKLIFT_STATE_LOWERING = 2,
+    FORKLIFT_STATE_FAULTED = 3,
+    FORKLIFT_STATE_POSITIONING = 4,        // go-to command; not available through forklift_inputs yet
+};
+
+enum {
+    FORKLIFT_FAULT_NONE = 0,
+    FORKLIFT_FAULT_LIMIT_VIOLATION = 10,
+    FORKLIFT_FAULT_OVERLOAD = 20,
+    FORKLIFT_FAULT_EMERGENCY_STOP = 30,
+};
+
+typedef struct forklift_pool_config {
+    uint32_t lifts;                        // > 0
+    uint32_t controller;                   // forklift_controller
+    uint32_t threads;                      // 0 or 1 = scan on the calling thread; n = FleetScheduler with n workers
+    uint32_t reserved;                     // 0
+    double dt;                             // scan period in seconds, > 0 (the simulator uses 0.02)
+} forklift_pool_config;
+
+// Operator inputs of one lift (16 bytes). Limit switches are not inputs:
+// every scan derives them from the plant position.
+typedef struct forklift_inputs {
+    uint8_t cmd_up;
+    uint8_t cmd_down;
+    uint8_t cmd_hold;
+    uint8_t estop;
+    uint8_t reset_fault;                   // a pulse: seen by the next scan only
+    uint8_t reserved[3];
+    double load_kg;
+} forklift_inputs;
+
+// State of one lift after the last scan (32 bytes)
+typedef struct forklift_outputs {
+    uint8_t motor_enable;
+    int8_t motor_dir;                      // +1 up, -1 down, 0 none
+    uint8_t brake_engaged;
+    uint8_t fault_lamp;
+    uint8_t top_limit;
+    uint8_t bottom_limit;
+    uint8_t state;                         // FORKLIFT_STATE_*
+    uint8_t fault;                         // FORKLIFT_FAULT_*, the latched fault
+    double position;                       // normalized 0..1 (0 = bottom, 1 = top)
+    double velocity;                       // normalized travel per second
+    double target_velocity;                // normalized travel per second, as commanded by the last scan
+} forklift_outputs;
+
+typedef struct forklift_pool forklift_pool;
+
+FORKLIFT_API uint32_t forklift_api_version(void);
+FORKLIFT_API const char* forklift_status_string(forklift_status status);
+
+// Lifts start at rest at the bottom, Holding, no fault, all inputs false.
+FORKLIFT_API forklift_status forklift_pool_create(const forklift_pool_config* config, forklift_pool** pool);
+FORKLIFT_API void forklift_pool_destroy(forklift_pool* pool);
+
+FORKLIFT_API uint32_t forklift_pool_lifts(const forklift_pool* pool);
+FORKLIFT_API uint64_t forklift_pool_scans(const forklift_pool* pool);   // scans run since create
+
+// Set the inputs of lifts [first, first + count). They stay in force for
+// every following scan until submitted again, except reset_fault.
+FORKLIFT_API forklift_status forklift_submit_inputs(forklift_pool* pool, uint32_t first, uint32_t count,
+                                                     const forklift_inputs* inputs);
+
+// Run n scans of every lift.
+FORKLIFT_API forklift_status forklift_scan(forklift_pool* pool, uint64_t n);
+
+// Copy the outputs of lifts [first, first + count) into outputs[0..count).
+FORKLIFT_API forklift_status forklift_read_outputs(const forklift_pool* pool, uint32_t first, uint32_t count,
+                                                    forklift_outputs* outputs);
+
+#ifdef __cplusplus
+}
+#endif
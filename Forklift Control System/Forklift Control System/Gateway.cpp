@@ -0,0 +1,273 @@
+#include "Gateway.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+
+std::size_t roundUp(std::size_t n, std::size_t to) { return (n + to - 1) / to * to; }
+
+std::uint32_t roundUpPow2(std::uint32_t n) {
+    std::uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+struct Layout {
+    std::size_t statusOffset;
+    std::size_t slotStride;
+    std::size_t commandOffset;
+    std::size_t size;
+};
+
+Layout layoutFor(std::uint32_t lifts, std::uint32_t statusSlots, std::uint32_t commandSlots) {
+    Layout l{};
+    l.statusOffset = roundUp(sizeof(GatewayShmHeader), 64);
+    l.slotStride = roundUp(sizeof(GatewayStatusSlot) + std::size_t{ lifts } * sizeof(TraceRecord), 64);
+    l.commandOffset = l.statusOffset + std::size_t{ statusSlots } * l.slotStride;
+    l.size = l.commandOffset + std::size_t{ commandSlots } * sizeof(GatewayCommandRecord);
+    return l;
+}
+
+GatewayCommandRecord* commandRing(unsigned char* base, std::size_t commandOffset) {
+    return reinterpret_cast<GatewayCommandRecord*>(base + commandOffset);
+}
+
+} // namespace
+
+bool Gateway::open(const GatewayOptions& opt, std::uint32_t lifts, double dt, std::string& error) {
+    close();
+    opt_ = opt;
+    opt_.batchScans = std::max<std::uint32_t>(opt.batchScans, 1);
+    lifts_ = lifts;
+
+    // Without shared memory the ring only has to hold one UDP batch
+    const bool shared = !opt_.shmName.empty();
+    const std::uint32_t statusSlots = shared ? std::max(opt_.shmScans, opt_.batchScans) : opt_.batchScans;
+    const std::uint32_t commandSlots = shared ? roundUpPow2(std::max<std::uint32_t>(opt_.shmCommands, 1)) : 0;
+    const Layout layout = layoutFor(lifts, statusSlots, commandSlots);
+
+    if (shared) {
+        if (!shm_.create(opt_.shmName, layout.size, error)) return false;
+        base_ = shm_.data();
+    }
+    else {
+        heap_.assign((layout.size + sizeof(Block) - 1) / sizeof(Block), Block{});
+        base_ = heap_.front().bytes;
+    }
+
+    GatewayShmHeader& h = *new (base_) GatewayShmHeader();
+    std::memcpy(h.magic, kGatewayShmMagic, sizeof(h.magic));
+    h.version = kGatewayVersion;
+    h.recordSize = sizeof(TraceRecord);
+    h.liftCount = lifts;
+    h.dt = dt;
+    h.statusSlots = statusSlots;
+    h.slotStride = static_cast<std::uint32_t>(layout.slotStride);
+    h.commandSlots = commandSlots;
+    h.statusOffset = layout.statusOffset;
+    h.commandOffset = layout.commandOffset;
+    for (std::uint32_t i = 0; i < statusSlots; ++i) new (base_ + layout.statusOffset + i * layout.slotStride) GatewayStatusSlot();
+    statusOffset_ = layout.statusOffset;
+    slotStride_ = layout.slotStride;
+    commandOffset_ = layout.commandOffset;
+    statusSlots_ = statusSlots;
+    commandSlots_ = commandSlots;
+    commandHead_ = 0;
+
+    if (!opt_.statusAddress.empty()) {
+        UdpEndpoint ep{};
+        if (!parseUdpEndpoint(opt_.statusAddress, ep, error) || !statusSocket_.openSender(ep, error)) {
+            close();
+            return false;
+        }
+    }
+    if (opt_.commandPort != 0 && !commandSocket_.openReceiver(opt_.commandPort, nullptr, error)) {
+        close();
+        return false;
+    }
+
+    receiveBuffer_.resize(65536);
+    scan_ = 0;
+    batchFirst_ = 0;
+    stats_ = GatewayStats{};
+    return true;
+}
+
+void Gateway::close() {
+    if (base_ && statusSocket_.isOpen()) flushStatus();
+    statusSocket_.close();
+    commandSocket_.close();
+    shm_.close();
+    heap_.clear();
+    base_ = nullptr;
+}
+
+GatewayStatusSlot& Gateway::slot(std::uint64_t scan) const {
+    return *reinterpret_cast<GatewayStatusSlot*>(base_ + statusOffset_ + (scan % statusSlots_) * slotStride_);
+}
+
+void Gateway::acceptCommand(const GatewayCommandRecord& r, std::uint64_t& counter) {
+    GatewayCommand c{};
+    if (r.lift >= lifts_ || !commandFromWire(r, c.cmd)) {
+        stats_.commandsRejected++;
+        return;
+    }
+    c.lift = r.lift;
+    commands_.push_back(c);
+    counter++;
+}
+
+const std::vector<GatewayCommand>& Gateway::pollCommands() {
+    commands_.clear();
+
+    if (shm_.isOpen()) {
+        GatewayShmHeader& h = header();
+        const std::uint64_t tail = h.commandTail.load(std::memory_order_acquire);
+        if (tail - commandHead_ > commandSlots_) {
+            // More than the ring holds (or behind head): a broken client, skip to its tail
+            stats_.commandsRejected += tail - commandHead_;
+            commandHead_ = tail;
+        }
+        const GatewayCommandRecord* ring = commandRing(base_, commandOffset_);
+        for (; commandHead_ != tail; ++commandHead_) {
+            GatewayCommandRecord r{};
+            std::memcpy(&r, &ring[commandHead_ & (commandSlots_ - 1)], sizeof(r));
+            acceptCommand(r, stats_.shmCommands);
+        }
+        h.commandHead.store(commandHead_, std::memory_order_release);
+    }
+
+    for (;;) {
+        const long n = commandSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size());
+        if (n < 0) break;
+
+        GatewayFrameHeader f{};
+        if (static_cast<std::size_t>(n) < sizeof(f)) {
+            stats_.commandsRejected++;
+            continue;
+        }
+        std::memcpy(&f, receiveBuffer_.data(), sizeof(f));
+        if (std::memcmp(f.magic, kGatewayMagic, sizeof(f.magic)) != 0 || f.version != kGatewayVersion ||
+            f.kind != static_cast<std::uint8_t>(GatewayFrameKind::Command) || f.recordSize != sizeof(GatewayCommandRecord) ||
+            sizeof(f) + std::size_t{ f.recordCount } * sizeof(GatewayCommandRecord) != static_cast<std::size_t>(n)) {
+            stats_.commandsRejected++;
+            continue;
+        }
+        for (std::uint32_t i = 0; i < f.recordCount; ++i) {
+            GatewayCommandRecord r{};
+            std::memcpy(&r, receiveBuffer_.data() + sizeof(f) + i * sizeof(r), sizeof(r));
+            acceptCommand(r, stats_.udpCommands);
+        }
+    }
+    return commands_;
+}
+
+TraceRecord* Gateway::beginStatus(std::uint64_t scan) {
+    scan_ = scan;
+    // Odd sequence: readers of this slot retry or give up until publish()
+    slot(scan).seq.store(2 * scan + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return records(scan);
+}
+
+void Gateway::publish() {
+    slot(scan_).seq.store(2 * scan_ + 2, std::memory_order_release);
+    header().published.store(scan_ + 1, std::memory_order_release);
+    stats_.scansPublished++;
+
+    if (!statusSocket_.isOpen()) batchFirst_ = scan_ + 1;
+    else if (scan_ + 1 - batchFirst_ >= opt_.batchScans) flushStatus();
+}
+
+void Gateway::flushStatus() {
+    const std::uint64_t end = stats_.scansPublished;
+    if (end <= batchFirst_ || lifts_ == 0) return;
+
+    const std::uint64_t first = batchFirst_ * lifts_;
+    const std::uint64_t count = (end - batchFirst_) * lifts_;
+    const std::uint64_t perFrame =
+        std::max<std::uint64_t>((opt_.maxDatagram - std::min(opt_.maxDatagram, sizeof(GatewayFrameHeader))) / sizeof(TraceRecord), 1);
+    const std::size_t frames = static_cast<std::size_t>((count + perFrame - 1) / perFrame);
+
+    // Headers first, then the gather lists; pointers into the vectors are taken once they stop growing
+    frameHeaders_.resize(frames);
+    frameParts_.clear();
+    std::vector<std::size_t> partStart(frames + 1);
+    for (std::size_t d = 0; d < frames; ++d) {
+        const std::uint64_t a = first + d * perFrame;
+        const std::uint64_t b = std::min(a + perFrame, first + count);
+
+        GatewayFrameHeader& f = frameHeaders_[d];
+        std::memcpy(f.magic, kGatewayMagic, sizeof(f.magic));
+        f.version = kGatewayVersion;
+        f.kind = static_cast<std::uint8_t>(GatewayFrameKind::Status);
+        f.recordSize = sizeof(TraceRecord);
+        f.liftCount = lifts_;
+        f.recordCount = static_cast<std::uint32_t>(b - a);
+        f.firstRecord = a;
+
+        partStart[d] = frameParts_.size();
+        frameParts_.push_back({ &f, sizeof(f) });
+        for (std::uint64_t r = a; r < b;) {
+            const std::uint64_t lift = r % lifts_;
+            const std::uint64_t n = std::min<std::uint64_t>(b - r, lifts_ - lift);
+            frameParts_.push_back({ records(r / lifts_) + lift, static_cast<std::size_t>(n) * sizeof(TraceRecord) });
+            r += n;
+        }
+    }
+    partStart[frames] = frameParts_.size();
+
+    datagrams_.resize(frames);
+    for (std::size_t d = 0; d < frames; ++d) datagrams_[d] = { &frameParts_[partStart[d]], partStart[d + 1] - partStart[d] };
+
+    const std::uint64_t calls = statusSocket_.sendCalls();
+    const std::size_t sent = statusSocket_.sendBatch(datagrams_.data(), frames);
+    stats_.udpSendCalls += statusSocket_.sendCalls() - calls;
+    stats_.udpFrames += sent;
+    stats_.udpFramesDropped += frames - sent;
+    batchFirst_ = end;
+}
+
+bool GatewayShmClient::open(const std::string& name, std::string& error) {
+    if (!shm_.open(name, error)) return false;
+
+    if (shm_.size() < sizeof(GatewayShmHeader)) {
+        shm_.close();
+        error = "not a gateway block: " + name;
+        return false;
+    }
+    const GatewayShmHeader& h = header();
+    const Layout l = layoutFor(h.liftCount, h.statusSlots, h.commandSlots);
+    if (std::memcmp(h.magic, kGatewayShmMagic, sizeof(h.magic)) != 0 || h.version != kGatewayVersion ||
+        h.recordSize != sizeof(TraceRecord) || h.statusSlots == 0 || l.slotStride != h.slotStride ||
+        l.statusOffset != h.statusOffset || l.commandOffset != h.commandOffset || shm_.size() < l.size) {
+        shm_.close();
+        error = "not a gateway block: " + name;
+        return false;
+    }
+    return true;
+}
+
+bool GatewayShmClient::readScan(std::uint64_t scan, TraceRecord* out) const {
+    const GatewayShmHeader& h = header();
+    const auto& s = *reinterpret_cast<const GatewayStatusSlot*>(
+        shm_.data() + h.statusOffset + (scan % h.statusSlots) * h.slotStride);
+
+    const std::uint64_t before = s.seq.load(std::memory_order_acquire);
+    if (before != 2 * scan + 2) return false;
+    std::memcpy(out, &s + 1, std::size_t{ h.liftCount } * sizeof(TraceRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == before;
+}
+
+bool GatewayShmClient::sendCommand(const GatewayCommandRecord& r) {
+    GatewayShmHeader& h = header();
+    if (h.commandSlots == 0) return false;
+    const std::uint64_t tail = h.commandTail.load(std::memory_order_relaxed);
+    if (tail - h.commandHead.load(std::memory_order_acquire) == h.commandSlots) return false;
+    std::memcpy(&commandRing(shm_.data(), h.commandOffset)[tail & (h.commandSlots - 1)], &r, sizeof(r));
+    h.commandTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
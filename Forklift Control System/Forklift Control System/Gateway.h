@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Console.h"
+#include "GatewayProtocol.h"
+#include "SharedMemory.h"
+#include "TraceFormat.h"
+#include "UdpSocket.h"
+
+// Command and status gateway for warehouse systems and dashboards.
+//
+// Commands arrive as GatewayCommandRecords over UDP and/or a shared-memory
+// ring. The scan loop collects them with pollCommands() between scans and
+// applies them before the controller runs, exactly like keyboard commands,
+// so a scan always sees a fixed set of inputs.
+//
+// Status is one TraceRecord per lift per scan. beginStatus() hands out the
+// scan's slot, in the shared-memory ring when one is open, so the loop
+// writes the records once and readers map them without a copy or system
+// call. UDP status is batched: every batchScans scans the records are cut
+// into datagrams of up to maxDatagram bytes that span lifts and scans, and
+// all of them go out in one sendmmsg() call, gathered straight from the
+// status slots.
+//
+// Clients can write the whole shared-memory block, so the simulator keeps
+// the layout it created and its command head to itself, and trusts only the
+// client's command tail, bounded by the ring size.
+
+struct GatewayOptions {
+    std::string statusAddress;         // "a.b.c.d:port", unicast or multicast; empty = no UDP status
+    std::uint16_t commandPort = 0;     // UDP command port; 0 = none
+    std::string shmName;               // shared-memory block name; empty = none
+    std::uint32_t batchScans = 5;      // scans per UDP status flush
+    std::uint32_t shmScans = 256;      // depth of the shared-memory status ring
+    std::uint32_t shmCommands = 4096;  // command ring capacity (rounded up to a power of two)
+    std::size_t maxDatagram = 1472;    // Ethernet MTU less IP and UDP headers
+};
+
+struct GatewayStats {
+    std::uint64_t scansPublished = 0;
+    std::uint64_t shmCommands = 0;
+    std::uint64_t udpCommands = 0;
+    std::uint64_t commandsRejected = 0;    // malformed frame, unknown verb, lift out of range or tail past the ring
+    std::uint64_t udpFrames = 0;
+    std::uint64_t udpFramesDropped = 0;    // not accepted by the kernel
+    std::uint64_t udpSendCalls = 0;
+};
+
+struct GatewayCommand {
+    std::uint32_t lift = 0;
+    Command cmd;
+};
+
+class Gateway {
+public:
+    Gateway() = default;
+    ~Gateway() { close(); }
+
+    Gateway(const Gateway&) = delete;
+    Gateway& operator=(const Gateway&) = delete;
+
+    bool open(const GatewayOptions& opt, std::uint32_t lifts, double dt, std::string& error);
+    // Sends any partial UDP batch and removes the shared-memory block.
+    void close();
+
+    // Commands received since the last call: shared memory first, then UDP, each in arrival order.
+    // Call between scans; the vector is reused.
+    const std::vector<GatewayCommand>& pollCommands();
+
+    // liftCount records for this scan, to fill in before publish(). Scans are numbered 0, 1, 2, ...
+    TraceRecord* beginStatus(std::uint64_t scan);
+    void publish();
+
+    std::uint32_t liftCount() const { return lifts_; }
+    const GatewayStats& stats() const { return stats_; }
+
+private:
+    struct alignas(64) Block {
+        unsigned char bytes[64];
+    };
+
+    GatewayShmHeader& header() const { return *reinterpret_cast<GatewayShmHeader*>(base_); }
+    GatewayStatusSlot& slot(std::uint64_t scan) const;
+    TraceRecord* records(std::uint64_t scan) const { return reinterpret_cast<TraceRecord*>(&slot(scan) + 1); }
+    void acceptCommand(const GatewayCommandRecord& r, std::uint64_t& counter);
+    void flushStatus();
+
+    GatewayOptions opt_{};
+    std::uint32_t lifts_ = 0;
+    // Layout as open() created it; the copy in the block is for clients only
+    std::size_t statusOffset_ = 0;
+    std::size_t slotStride_ = 0;
+    std::size_t commandOffset_ = 0;
+    std::uint32_t statusSlots_ = 0;
+    std::uint32_t commandSlots_ = 0;
+    std::uint64_t commandHead_ = 0;
+    unsigned char* base_ = nullptr;    // shm_.data() or heap_
+    SharedMemory shm_;
+    std::vector<Block> heap_;
+    UdpSocket statusSocket_;
+    UdpSocket commandSocket_;
+
+    std::uint64_t scan_ = 0;           // scan between beginStatus() and publish()
+    std::uint64_t batchFirst_ = 0;     // first scan not yet sent over UDP
+    std::vector<GatewayCommand> commands_;
+    std::vector<unsigned char> receiveBuffer_;
+    std::vector<GatewayFrameHeader> frameHeaders_;
+    std::vector<UdpBuffer> frameParts_;
+    std::vector<UdpDatagram> datagrams_;
+    GatewayStats stats_{};
+};
+
+// Client side of the shared-memory block, for dashboards and the WMS
+// bridge. One process may send commands at a time (a single-producer ring);
+// any number may read status.
+class GatewayShmClient {
+public:
+    bool open(const std::string& name, std::string& error);
+    void close() { shm_.close(); }
+
+    std::uint32_t liftCount() const { return header().liftCount; }
+    double dt() const { return header().dt; }
+
+    // Scans published so far; the newest is published() - 1.
+    std::uint64_t published() const { return header().published.load(std::memory_order_acquire); }
+
+    // Copies one scan's liftCount() records. False if the scan is not published
+    // yet or was overwritten before or during the copy.
+    bool readScan(std::uint64_t scan, TraceRecord* out) const;
+
+    // False if the command ring is full.
+    bool sendCommand(const GatewayCommandRecord& r);
+
+private:
+    GatewayShmHeader& header() const { return *reinterpret_cast<GatewayShmHeader*>(shm_.data()); }
+
+    SharedMemory shm_;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Console.h"
+#include "TraceFormat.h"
+
+// Wire and shared-memory layout of the command/status gateway (Gateway.h).
+//
+// UDP datagrams are one GatewayFrameHeader followed by recordCount records:
+//
+//     kind Status:   TraceRecord * recordCount, numbered like a trace
+//                    (record r = lift r % liftCount of scan r / liftCount),
+//                    so one frame can span several lifts and scans
+//     kind Command:  GatewayCommandRecord * recordCount
+//
+// The shared-memory block is a GatewayShmHeader, a ring of statusSlots
+// scans (GatewayStatusSlot + liftCount TraceRecords each, slotStride bytes
+// apart) and a single-producer ring of commandSlots GatewayCommandRecords.
+// All fields are little-endian.
+
+#pragma pack(push, 1)
+
+struct GatewayFrameHeader {
+    char magic[4];                 // "FLGW"
+    std::uint16_t version;
+    std::uint8_t kind;             // GatewayFrameKind
+    std::uint8_t recordSize;       // sizeof(TraceRecord) or sizeof(GatewayCommandRecord)
+    std::uint32_t liftCount;       // status: lifts per scan; commands: 0
+    std::uint32_t recordCount;
+    std::uint64_t firstRecord;     // status: record number of the first record; commands: sender's sequence
+};
+
+// One operator command for one lift, applied at the start of the next scan.
+struct GatewayCommandRecord {
+    std::uint32_t lift;
+    std::uint8_t verb;             // console letter: 'u', 'd', 'h', 's', 'e', 'r', 'l' or 'g'
+    std::uint8_t reserved[3];
+    double value;                  // load kg for 'l', target position for 'g'
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(GatewayFrameHeader) == 24, "gateway frame header layout");
+static_assert(sizeof(GatewayCommandRecord) == 16, "gateway command record layout");
+
+enum class GatewayFrameKind : std::uint8_t {
+    Status = 1,
+    Command = 2,
+};
+
+inline constexpr char kGatewayMagic[4] = { 'F', 'L', 'G', 'W' };
+inline constexpr std::uint16_t kGatewayVersion = 1;
+
+struct GatewayShmHeader {
+    char magic[8];                 // "FLGWSHM\0"
+    std::uint16_t version;
+    std::uint16_t recordSize;      // sizeof(TraceRecord)
+    std::uint32_t liftCount;
+    double dt;
+    std::uint32_t statusSlots;
+    std::uint32_t slotStride;      // bytes from one GatewayStatusSlot to the next
+    std::uint32_t commandSlots;    // power of two
+    std::uint32_t reserved;
+    std::uint64_t statusOffset;    // from the start of the block
+    std::uint64_t commandOffset;
+
+    // Scans published so far; the newest complete scan is published - 1
+    alignas(64) std::atomic<std::uint64_t> published;
+    // Command ring: the client advances tail, the simulator advances head
+    alignas(64) std::atomic<std::uint64_t> commandTail;
+    alignas(64) std::atomic<std::uint64_t> commandHead;
+};
+
+// Scan s lives in slot s % statusSlots. seq is 2s + 1 while the simulator
+// writes it and 2s + 2 once complete; a reader copies the records and
+// accepts them only if seq read 2s + 2 before and after the copy.
+struct alignas(64) GatewayStatusSlot {
+    std::atomic<std::uint64_t> seq;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory counters must be lock-free");
+
+inline constexpr char kGatewayShmMagic[8] = { 'F', 'L', 'G', 'W', 'S', 'H', 'M', '\0' };
+
+// Wire verb to console command; false for anything else (t, p, q and help are console-only).
+inline bool commandFromWire(const GatewayCommandRecord& r, Command& cmd) {
+    cmd = Command{};
+    switch (r.verb) {
+    case 'u': cmd.verb = CommandVerb::Up; break;
+    case 'd': cmd.verb = CommandVerb::Down; break;
+    case 'h': cmd.verb = CommandVerb::Hold; break;
+    case 's': cmd.verb = CommandVerb::Stop; break;
+    case 'e': cmd.verb = CommandVerb::ToggleEstop; break;
+    case 'r': cmd.verb = CommandVerb::Reset; break;
+    case 'l': cmd.verb = CommandVerb::SetLoad; cmd.value = r.value; break;
+    case 'g': cmd.verb = CommandVerb::GoTo; cmd.value = r.value; break;
+    default: return false;
+    }
+    return true;
+}
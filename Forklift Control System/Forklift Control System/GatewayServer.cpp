@@ -0,0 +1,325 @@
+#include "GatewayServer.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "LiftFleet.h"
+#include "Rng.h"
+#include "TraceReader.h"
+#include "TraceRecorder.h"
+#include "TraceReplay.h"
+
+namespace {
+
+struct AppliedCommand {
+    std::uint64_t scan;
+    GatewayCommand command;
+};
+
+void fillStatus(const LiftFleet& fleet, TraceRecord* out) {
+    LiftPlant p{};
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        p.position = fleet.position[i];
+        p.velocity = fleet.velocity[i];
+        p.targetVel = fleet.targetVel[i];
+        out[i] = makeTraceRecord(fleet.inputs[i], fleet.outputs[i], p, fleet.state[i], fleet.latched[i]);
+    }
+}
+
+bool serve(const ServeOptions& opt, TraceRecorder* recorder, ServeResult& result, std::string& error,
+           const std::function<void()>& opened, std::vector<AppliedCommand>* log) {
+    LiftFleet fleet(opt.lifts);
+    Gateway gateway;
+    if (!gateway.open(opt.gateway, opt.lifts, opt.dt, error)) return false;
+    if (opened) opened();
+
+    const bool paced = opt.periodUs > 0;
+    DeadlineScheduler scheduler(std::chrono::microseconds(paced ? opt.periodUs : 1));
+    if (paced) scheduler.start();
+
+    std::uint64_t s = 0;
+    for (; opt.scans == 0 || s < opt.scans; ++s) {
+        if (opt.stop && opt.stop->load(std::memory_order_relaxed)) break;
+        if (paced) scheduler.beginScan();
+
+        // Reset is a pulse; commands from the gateway land on this scan boundary
+        for (Inputs& in : fleet.inputs) in.resetFault = false;
+        for (const GatewayCommand& c : gateway.pollCommands()) {
+            applyCommand(c.cmd, fleet.inputs[c.lift]);
+            if (log) log->push_back({ s, c });
+        }
+
+        fleet.scan(opt.dt);
+        fillStatus(fleet, gateway.beginStatus(s));
+        gateway.publish();
+        if (recorder) recorder->recordFleet(fleet);
+
+        if (paced) scheduler.waitNext();
+    }
+
+    gateway.close();
+    result.scans = s;
+    result.gateway = gateway.stats();
+    if (paced) result.timing = scheduler.timing();
+    return true;
+}
+
+// Check client: reads status over both paths and sends commands over both
+// until the server is close to its last scan.
+struct CheckClient {
+    std::uint32_t lifts = 0;
+    std::uint64_t scans = 0;
+    std::string shmName;
+    UdpSocket* statusReceiver = nullptr;
+    UdpSocket* commandSender = nullptr;
+    const std::atomic<bool>* opened = nullptr;
+    const std::atomic<bool>* done = nullptr;
+
+    std::vector<TraceRecord> udpRecords;       // by record number
+    std::vector<unsigned char> udpSeen;
+    std::vector<std::uint64_t> shmScans;
+    std::vector<TraceRecord> shmRecords;       // lifts per entry of shmScans
+    std::uint64_t shmSent = 0;
+    std::uint64_t udpSent = 0;
+    std::uint64_t badFrames = 0;
+    std::string error;
+
+    void drainUdp(std::vector<unsigned char>& buf) {
+        for (;;) {
+            const long n = statusReceiver->receive(buf.data(), buf.size());
+            if (n < 0) return;
+            GatewayFrameHeader f{};
+            if (static_cast<std::size_t>(n) < sizeof(f)) { badFrames++; continue; }
+            std::memcpy(&f, buf.data(), sizeof(f));
+            if (f.kind != static_cast<std::uint8_t>(GatewayFrameKind::Status) || f.liftCount != lifts ||
+                sizeof(f) + std::size_t{ f.recordCount } * sizeof(TraceRecord) != static_cast<std::size_t>(n) ||
+                f.firstRecord + f.recordCount > udpRecords.size()) {
+                badFrames++;
+                continue;
+            }
+            std::memcpy(&udpRecords[f.firstRecord], buf.data() + sizeof(f), std::size_t{ f.recordCount } * sizeof(TraceRecord));
+            std::memset(&udpSeen[f.firstRecord], 1, f.recordCount);
+        }
+    }
+
+    GatewayCommandRecord randomCommand(SplitMix64& rng) const {
+        static constexpr char kVerbs[] = "uuuddddhsssrrrll";
+        GatewayCommandRecord r{};
+        r.lift = static_cast<std::uint32_t>(rng.next() % lifts);
+        const std::uint64_t pick = rng.next() % 64;
+        r.verb = pick == 0 ? 'e' : static_cast<std::uint8_t>(kVerbs[pick % (sizeof(kVerbs) - 1)]);
+        r.value = static_cast<double>(rng.next() % 1500);
+        return r;
+    }
+
+    void run() {
+        udpRecords.resize(static_cast<std::size_t>(scans) * lifts);
+        udpSeen.assign(udpRecords.size(), 0);
+        std::vector<unsigned char> buf(65536);
+        std::vector<TraceRecord> scan(lifts);
+
+        while (!opened->load(std::memory_order_acquire)) std::this_thread::yield();
+        GatewayShmClient shm;
+        if (!shm.open(shmName, error)) return;
+
+        SplitMix64 rng{ 7 };
+        std::uint64_t lastRead = 0;
+        std::uint64_t sequence = 0;
+        while (!done->load(std::memory_order_acquire)) {
+            drainUdp(buf);
+
+            const std::uint64_t published = shm.published();
+            if (published > lastRead) {
+                if (shm.readScan(published - 1, scan.data())) {
+                    shmScans.push_back(published - 1);
+                    shmRecords.insert(shmRecords.end(), scan.begin(), scan.end());
+                }
+                lastRead = published;
+            }
+
+            // Stop well before the last poll so every shared-memory command is applied
+            if (published + 100 < scans) {
+                if (sequence % 2 == 0) {
+                    if (shm.sendCommand(randomCommand(rng))) shmSent++;
+                }
+                else {
+                    unsigned char frame[sizeof(GatewayFrameHeader) + 3 * sizeof(GatewayCommandRecord)];
+                    GatewayFrameHeader f{};
+                    std::memcpy(f.magic, kGatewayMagic, sizeof(f.magic));
+                    f.version = kGatewayVersion;
+                    f.kind = static_cast<std::uint8_t>(GatewayFrameKind::Command);
+                    f.recordSize = sizeof(GatewayCommandRecord);
+                    f.recordCount = 1 + static_cast<std::uint32_t>(rng.next() % 3);
+                    f.firstRecord = sequence;
+                    std::memcpy(frame, &f, sizeof(f));
+                    for (std::uint32_t i = 0; i < f.recordCount; ++i) {
+                        const GatewayCommandRecord r = randomCommand(rng);
+                        std::memcpy(frame + sizeof(f) + i * sizeof(r), &r, sizeof(r));
+                    }
+                    const UdpBuffer part{ frame, sizeof(f) + f.recordCount * sizeof(GatewayCommandRecord) };
+                    const UdpDatagram d{ &part, 1 };
+                    if (commandSender->sendBatch(&d, 1) == 1) udpSent += f.recordCount;
+                }
+                sequence++;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        drainUdp(buf); // the final partial batch went out when the gateway closed
+    }
+};
+
+// Command bits of the trace input byte (limits are the controller's, not the operator's)
+constexpr std::uint8_t kCommandBits = kInCmdUp | kInCmdDown | kInCmdHold | kInEstop | kInResetFault | kInCmdGoTo;
+
+} // namespace
+
+bool serveFleet(const ServeOptions& opt, TraceRecorder* recorder, ServeResult& result, std::string& error) {
+    return serve(opt, recorder, result, error, {}, nullptr);
+}
+
+void printServeResult(std::ostream& os, const ServeResult& r, const ServeOptions& opt) {
+    const GatewayStats& g = r.gateway;
+    os << "serve: lifts=" << opt.lifts << " scans=" << r.scans
+        << " commands shm=" << g.shmCommands << " udp=" << g.udpCommands << " rejected=" << g.commandsRejected
+        << " frames=" << g.udpFrames << " dropped=" << g.udpFramesDropped << " send-calls=" << g.udpSendCalls
+        << "\n";
+    if (opt.periodUs > 0) printScanTiming(os, r.timing);
+}
+
+GatewayCheckReport checkGateway(std::uint64_t scans, std::uint32_t lifts) {
+    GatewayCheckReport report{};
+    report.scans = scans;
+    report.lifts = lifts;
+    if (scans == 0 || lifts == 0) {
+        report.error = "scans and lifts must be positive";
+        return report;
+    }
+
+    const std::uint16_t statusPort = 47810;
+    const std::uint16_t commandPort = 47811;
+
+    ServeOptions opt{};
+    opt.lifts = lifts;
+    opt.scans = scans;
+    opt.periodUs = 500;
+    opt.gateway.statusAddress = "127.0.0.1:" + std::to_string(statusPort);
+    opt.gateway.commandPort = commandPort;
+    opt.gateway.shmName = "forklift-gateway-check";
+
+    UdpSocket statusReceiver;
+    UdpSocket commandSender;
+    UdpEndpoint commandTo{};
+    if (!statusReceiver.openReceiver(statusPort, nullptr, report.error) ||
+        !parseUdpEndpoint("127.0.0.1:" + std::to_string(commandPort), commandTo, report.error) ||
+        !commandSender.openSender(commandTo, report.error)) {
+        return report;
+    }
+
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "forklift-gateway-check.trace";
+    TraceRecorder recorder;
+    if (!recorder.open(tracePath.string(), lifts, opt.dt)) {
+        report.error = "cannot open " + tracePath.string();
+        return report;
+    }
+    recorder.reserve(scans * lifts);
+
+    std::atomic<bool> opened{ false };
+    std::atomic<bool> done{ false };
+    CheckClient client{};
+    client.lifts = lifts;
+    client.scans = scans;
+    client.shmName = opt.gateway.shmName;
+    client.statusReceiver = &statusReceiver;
+    client.commandSender = &commandSender;
+    client.opened = &opened;
+    client.done = &done;
+    std::thread clientThread([&client] { client.run(); });
+
+    std::vector<AppliedCommand> log;
+    ServeResult served{};
+    const bool ok = serve(opt, &recorder, served, report.error,
+                          [&opened] { opened.store(true, std::memory_order_release); }, &log);
+    opened.store(true, std::memory_order_release); // release the client if open failed
+    done.store(true, std::memory_order_release);
+    clientThread.join();
+    const bool closed = recorder.close();
+    if (!ok) return report;
+    if (!closed) {
+        report.error = "trace write failed";
+        return report;
+    }
+    if (!client.error.empty()) {
+        report.error = client.error;
+        return report;
+    }
+
+    report.gateway = served.gateway;
+    report.gateway.commandsRejected += client.badFrames; // bad status frames count against the check too
+    report.shmCommandsSent = client.shmSent;
+    report.udpCommandsSent = client.udpSent;
+
+    TraceReader trace;
+    if (!trace.open(tracePath.string(), report.error)) return report;
+    std::vector<TraceRecord> recorded;
+    recorded.reserve(static_cast<std::size_t>(trace.recordCount()));
+    for (const TraceChunk& c : trace.chunks()) recorded.insert(recorded.end(), c.records, c.records + c.recordCount);
+
+    // Commands: re-apply the log at the recorded scan boundaries and compare with the inputs the controller saw
+    std::vector<Inputs> inputs(lifts);
+    std::size_t next = 0;
+    for (std::uint64_t s = 0; s < scans; ++s) {
+        for (Inputs& in : inputs) in.resetFault = false;
+        for (; next < log.size() && log[next].scan == s; ++next) applyCommand(log[next].command.cmd, inputs[log[next].command.lift]);
+        for (std::uint32_t i = 0; i < lifts; ++i) {
+            const TraceRecord& r = recorded[static_cast<std::size_t>(s) * lifts + i];
+            if ((packInputBits(inputs[i]) & kCommandBits) != (r.inputBits & kCommandBits) ||
+                std::memcmp(&inputs[i].loadKg, &r.loadKg, sizeof(double)) != 0) {
+                report.commandMismatches++;
+            }
+        }
+    }
+
+    for (std::size_t k = 0; k < client.shmScans.size(); ++k) {
+        report.shmScansRead++;
+        if (std::memcmp(&client.shmRecords[k * lifts], &recorded[static_cast<std::size_t>(client.shmScans[k]) * lifts],
+                        lifts * sizeof(TraceRecord)) != 0) {
+            report.shmMismatches++;
+        }
+    }
+
+    for (std::size_t r = 0; r < recorded.size(); ++r) {
+        if (!client.udpSeen[r]) continue;
+        report.udpRecordsReceived++;
+        if (std::memcmp(&client.udpRecords[r], &recorded[r], sizeof(TraceRecord)) != 0) report.udpMismatches++;
+    }
+
+    const ReplayResult replay = replayTrace(trace, ReplayOptions{});
+    report.replayIdentical = replay.error.empty() && !replay.diverged;
+
+    std::error_code ec;
+    std::filesystem::remove(tracePath, ec);
+    return report;
+}
+
+void printGatewayCheckReport(std::ostream& os, const GatewayCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "gateway-check: " << r.error << "\n";
+        return;
+    }
+    const GatewayStats& g = r.gateway;
+    const std::uint64_t records = r.scans * r.lifts;
+    os << "gateway-check: lifts=" << r.lifts << " scans=" << r.scans << "\n"
+        << "  commands: shm sent=" << r.shmCommandsSent << " applied=" << g.shmCommands
+        << "  udp sent=" << r.udpCommandsSent << " applied=" << g.udpCommands
+        << "  rejected=" << g.commandsRejected << "  mismatches=" << r.commandMismatches << "\n"
+        << "  shm status: scans read=" << r.shmScansRead << " mismatches=" << r.shmMismatches << "\n"
+        << "  udp status: frames=" << g.udpFrames << " send-calls=" << g.udpSendCalls
+        << " records=" << r.udpRecordsReceived << "/" << records << " mismatches=" << r.udpMismatches << "\n"
+        << "  replay: " << (r.replayIdentical ? "identical" : "diverged") << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "Gateway.h"
+#include "ScanScheduler.h"
+
+class TraceRecorder;
+
+// Fleet scan loop driven through a Gateway instead of the keyboard.
+//
+// Each scan: clear the reset pulses, apply the commands the gateway
+// received since the previous scan, scan the fleet, publish its status.
+// Commands that arrive during a scan wait for the next one, so the trace
+// of a served run replays bit for bit like any other.
+
+struct ServeOptions {
+    GatewayOptions gateway{};
+    std::uint32_t lifts = 1;
+    std::uint64_t scans = 0;               // 0 = until stop is set
+    std::int64_t periodUs = 20000;         // absolute-deadline pacing; 0 = as fast as possible
+    double dt = 0.02;
+    const std::atomic<bool>* stop = nullptr;
+};
+
+struct ServeResult {
+    std::uint64_t scans = 0;
+    GatewayStats gateway{};
+    ScanTiming timing{};                   // paced runs only
+};
+
+bool serveFleet(const ServeOptions& opt, TraceRecorder* recorder, ServeResult& result, std::string& error);
+
+// "serve: scans=... commands shm=... udp=... rejected=... frames=... send-calls=..."
+void printServeResult(std::ostream& os, const ServeResult& r, const ServeOptions& opt);
+
+// Loopback check: serve a fleet with shared memory and UDP on 127.0.0.1
+// while a client thread sends commands over both and reads status over
+// both. Afterwards the recorded trace must replay identically, every
+// applied command must show up in the inputs of the scan it was applied
+// to, and every status record a client received must equal the trace.
+struct GatewayCheckReport {
+    std::uint64_t scans = 0;
+    std::uint32_t lifts = 0;
+    std::uint64_t shmCommandsSent = 0;
+    std::uint64_t udpCommandsSent = 0;
+    GatewayStats gateway{};
+    std::uint64_t commandMismatches = 0;   // trace inputs differ from the applied commands (must be 0)
+    std::uint64_t shmScansRead = 0;
+    std::uint64_t shmMismatches = 0;       // must be 0
+    std::uint64_t udpRecordsReceived = 0;
+    std::uint64_t udpMismatches = 0;       // must be 0
+    bool replayIdentical = false;
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && replayIdentical && commandMismatches == 0 && shmMismatches == 0 &&
+               udpMismatches == 0 && gateway.commandsRejected == 0 && gateway.shmCommands == shmCommandsSent;
+    }
+};
+
+GatewayCheckReport checkGateway(std::uint64_t scans, std::uint32_t lifts);
+
+void printGatewayCheckReport(std::ostream& os, const GatewayCheckReport& r);
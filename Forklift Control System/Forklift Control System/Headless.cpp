@@ -0,0 +1,72 @@
+#include "Headless.h"
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+
+#include "Console.h"
+
+std::int64_t headlessEndScan(const Script& script, const HeadlessOptions& opt) {
+    if (opt.durationScans >= 0) return opt.durationScans;
+    if (script.quitScan >= 0) return script.quitScan + 1;  // the quit scan still runs, as in the console
+    return script.events.empty() ? 0 : script.events.back().scan + 1;
+}
+
+void stepHeadless(HeadlessState& s, const Script& script, double dt) {
+    selectScanCounters(&s.counters, &s.dwell);
+
+    // ---- Reset is a pulse: default false each cycle ----
+    s.in.resetFault = false;
+
+    // ---- Scripted input for this scan ----
+    while (s.nextEvent < script.events.size() && script.events[s.nextEvent].scan <= s.scan) {
+        applyCommand(script.events[s.nextEvent].cmd, s.in);
+        ++s.nextEvent;
+    }
+
+    s.out = scanLift(dt, s.in, s.ctrl, s.plant);
+    ++s.scan;
+    selectScanCounters(nullptr, nullptr);
+}
+
+HeadlessResult runHeadless(const Script& script, const HeadlessOptions& opt, TelemetrySink* sink,
+                           TraceRecorder* recorder) {
+    HeadlessState s{};
+    const std::int64_t scans = headlessEndScan(script, opt);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    while (s.scan < scans) {
+        stepHeadless(s, script, opt.dt);
+        if (recorder) recorder->record(s.in, s.out, s.plant, s.ctrl.state, s.ctrl.faults.latched);
+
+        const std::int64_t scan = s.scan - 1;
+        if (sink && opt.printEvery > 0 && scan % opt.printEvery == 0) {
+            sink->submit(makeStatusSample(static_cast<std::uint64_t>(scan), 0, s.plant,
+                                          s.ctrl.state, s.ctrl.faults.latched, s.in));
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    HeadlessResult r{};
+    r.scans = scans;
+    r.wallSeconds = std::chrono::duration<double>(t1 - t0).count();
+    r.plant = s.plant;
+    r.state = s.ctrl.state;
+    r.fault = s.ctrl.faults.latched;
+    r.in = s.in;
+    r.counters = s.counters;
+    return r;
+}
+
+void printHeadlessResult(std::ostream& os, const HeadlessResult& r, double dt) {
+    const double simSeconds = r.scans * dt;
+    os << std::fixed << std::setprecision(3)
+        << "scans=" << r.scans
+        << " sim=" << simSeconds << "s"
+        << " wall=" << r.wallSeconds << "s"
+        << " scans/s=" << r.scansPerSecond()
+        << " realtime=" << (r.wallSeconds > 0.0 ? simSeconds / r.wallSeconds : 0.0) << "x"
+        << "\n";
+    printStatus(os, r.plant, r.state, r.fault, r.in);
+    if (kCountersEnabled) printCounters(os, r.counters, dt);
+}
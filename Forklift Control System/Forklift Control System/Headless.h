@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "LiftControl.h"
+#include "ScanCounters.h"
+#include "Script.h"
+#include "TelemetrySink.h"
+#include "TraceRecorder.h"
+
+// Headless, faster-than-real-time replay of a command script.
+//
+// Runs exactly the console scan sequence (reset pulse, operator input,
+// scanLift) but takes input from the script and never sleeps, so an 8-hour
+// shift replays in seconds.
+//
+// Everything the run carries from one scan to the next is a HeadlessState,
+// so a copy of one is a complete snapshot: assign it back (or to another
+// run of a script with the same events so far) and stepHeadless() goes on
+// exactly where the copy was taken.
+
+struct HeadlessOptions {
+    double dt = 0.02;                  // scan period being simulated
+    std::int64_t durationScans = -1;   // -1: until 'q', else until the last event
+    std::int64_t printEvery = 0;       // status sample every N scans, 0 = none
+};
+
+struct HeadlessState {
+    std::int64_t scan = 0;             // scans run so far
+    std::size_t nextEvent = 0;         // first script event not yet applied
+    Inputs in{};
+    Outputs out{};                     // of the last scan
+    LiftPlant plant{};
+    LiftController ctrl{};             // state, FaultManager, input key
+    LiftCounters counters{};           // FORKLIFT_COUNTERS builds
+    std::uint32_t dwell = 0;
+};
+
+// Scans the run stops after: opt.durationScans, else the quit scan, else the last event
+std::int64_t headlessEndScan(const Script& script, const HeadlessOptions& opt);
+
+// One scan: reset pulse, the script events due, scanLift. Counts into s.counters.
+void stepHeadless(HeadlessState& s, const Script& script, double dt);
+
+struct HeadlessResult {
+    std::int64_t scans = 0;
+    double wallSeconds = 0.0;
+
+    LiftPlant plant{};
+    LiftState state = LiftState::Holding;
+    FaultCode fault = FaultCode::None;
+    Inputs in{};
+
+    LiftCounters counters{};           // FORKLIFT_COUNTERS builds
+
+    double scansPerSecond() const { return wallSeconds > 0.0 ? scans / wallSeconds : 0.0; }
+};
+
+// Status samples go to sink (if not null) every opt.printEvery scans;
+// every scan goes to recorder (if not null).
+HeadlessResult runHeadless(const Script& script, const HeadlessOptions& opt, TelemetrySink* sink,
+                           TraceRecorder* recorder = nullptr);
+
+// "scans=... sim=...s wall=...s scans/s=... realtime=...x" plus the final status line
+// (and the counters in FORKLIFT_COUNTERS builds)
+void printHeadlessResult(std::ostream& os, const HeadlessResult& r, double dt);
@@ -0,0 +1,430 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "ScanCounters.h"
+
+// PLC-style "scan" data
+
+struct Inputs {
+    bool cmdUp = false;
+    bool cmdDown = false;
+    bool cmdHold = false;      // optional explicit hold command
+    bool cmdGoTo = false;      // drive to targetPosition and stop there
+    bool estop = false;
+    bool resetFault = false;
+
+    bool topLimit = false;
+    bool bottomLimit = true;   // start at bottom in this sim
+
+    double loadKg = 0.0;       // for overload detection
+    double targetPosition = 0.0;   // 0..1, used while cmdGoTo is set
+};
+
+struct Outputs {
+    bool motorEnable = false;
+    int motorDir = 0;          // +1 up, -1 down, 0 none
+    bool brakeEngaged = true;  // true = brake on
+    bool faultLamp = false;
+};
+
+
+// Faults with explicit priority (one byte, so per-lift state packs densely)
+
+enum class FaultCode : std::uint8_t {
+    None = 0,
+    LimitViolation = 10,
+    Overload = 20,
+    EmergencyStop = 30,
+};
+
+inline const char* faultToString(FaultCode f) {
+    switch (f) {
+    case FaultCode::None: return "None";
+    case FaultCode::LimitViolation: return "LimitViolation";
+    case FaultCode::Overload: return "Overload";
+    case FaultCode::EmergencyStop: return "EmergencyStop";
+    }
+    return "Unknown";
+}
+
+// Higher number = higher priority
+inline int faultPriority(FaultCode f) {
+    return static_cast<int>(f);
+}
+
+struct FaultManager {
+    FaultCode latched = FaultCode::None;
+
+    void clear() { latched = FaultCode::None; }
+
+    void latch(FaultCode f) {
+        FORKLIFT_COUNT(countLatch(f, latched));
+        if (faultPriority(f) > faultPriority(latched)) {
+            latched = f;
+        }
+    }
+
+    bool hasFault() const { return latched != FaultCode::None; }
+};
+
+// Lift model + PLC state machine
+
+enum class LiftState : std::uint8_t {
+    Holding,
+    Lifting,
+    Lowering,
+    Faulted,
+    Positioning,   // cmdGoTo: following the profile to targetPosition
+};
+
+inline constexpr int kLiftStates = 5;
+
+inline const char* stateToString(LiftState s) {
+    switch (s) {
+    case LiftState::Holding: return "Holding";
+    case LiftState::Lifting: return "Lifting";
+    case LiftState::Lowering: return "Lowering";
+    case LiftState::Faulted: return "Faulted";
+    case LiftState::Positioning: return "Positioning";
+    }
+    return "Unknown";
+}
+
+// Real is the plant's number type: double for the simulator, float or
+// Fixed16 (FixedPoint.h) for targets without a double-precision FPU.
+// It needs construction from double, + - * and comparisons.
+template <class Real>
+struct BasicLiftPlant {
+    // Simple physical-ish model (units arbitrary but consistent)
+    Real position = Real(0.0);     // 0 = bottom, 1 = top
+    Real velocity = Real(0.0);     // units per second
+
+    // "Actuators"
+    Real targetVel = Real(0.0);    // commanded velocity
+
+    // Smooth towards target velocity (a tiny bit of inertia)
+    static constexpr Real accel = Real(3.0); // units/s^2
+
+    // Update plant each tick
+    void step(Real dt) {
+        Real dv = targetVel - velocity;
+        Real maxDv = accel * dt;
+        dv = std::clamp(dv, -maxDv, maxDv);
+        velocity += dv;
+
+        position += velocity * dt;
+        position = std::clamp(position, Real(0.0), Real(1.0));
+
+        // If we hit the ends, clamp velocity
+        if (position <= Real(0.0) && velocity < Real(0.0)) velocity = Real(0.0);
+        if (position >= Real(1.0) && velocity > Real(0.0)) velocity = Real(0.0);
+    }
+};
+
+using LiftPlant = BasicLiftPlant<double>;
+
+// Mast tunables. A controller takes them as a policy base class:
+//   DefaultMast        constexpr, folded into update() at compile time
+//   RuntimeMastConfig  plain members, for fleets mixing mast models
+
+struct DefaultMast {
+    static constexpr double maxLoadKg = 1200.0;
+    static constexpr double liftSpeed = 0.35;
+    static constexpr double lowerSpeed = 0.30;
+    static constexpr double safeStopSpeedEps = 0.01;
+
+    // Go-to profile: braking deceleration, kept below the plant's so it can follow
+    static constexpr double positionAccelMargin = 0.8;
+    static constexpr double positionAccel = positionAccelMargin * LiftPlant::accel;
+    static constexpr double positionTolerance = 0.0005;   // arrived within this of the target
+};
+
+struct RuntimeMastConfig {
+    double maxLoadKg = DefaultMast::maxLoadKg;
+    double liftSpeed = DefaultMast::liftSpeed;
+    double lowerSpeed = DefaultMast::lowerSpeed;
+    double safeStopSpeedEps = DefaultMast::safeStopSpeedEps;
+    double positionAccel = DefaultMast::positionAccel;
+    double positionTolerance = DefaultMast::positionTolerance;
+};
+
+// Go-to targets stay clear of the limit switches (updateLimitSwitches())
+inline constexpr double kMinTargetPosition = 0.001;
+inline constexpr double kMaxTargetPosition = 0.999;
+
+inline double clampTargetPosition(double target) {
+    return std::clamp(target, kMinTargetPosition, kMaxTargetPosition);
+}
+
+// Everything phases 1 and 3 read, packed: the fault and state inputs, the
+// overload comparison, and the state and latched fault the scan starts from.
+// resetFault and the plant velocity are left out: phase 2 reads them, and
+// runs whenever a reset is pending on a latched fault; go-to scans, whose
+// keys are never kept, read the plant too.
+inline constexpr std::uint16_t kNoInputKey = 0xFFFF;
+
+static_assert(static_cast<int>(FaultCode::EmergencyStop) >> 3 == 3 && static_cast<int>(FaultCode::Overload) >> 3 == 2 &&
+              static_cast<int>(FaultCode::LimitViolation) >> 3 == 1, "FaultCode >> 3 is a 2-bit slot");
+static_assert(kLiftStates <= 8, "LiftState is a 3-bit slot");
+
+// Field by field: the limit switches were stored just before the scan reads
+// them, so one wide load of the bools would stall on store forwarding.
+inline std::uint16_t packInputKey(const Inputs& in, bool overload, LiftState state, FaultCode latched) {
+    const unsigned bits = unsigned(in.cmdUp) | unsigned(in.cmdDown) << 1 | unsigned(in.cmdHold) << 2 |
+                          unsigned(in.cmdGoTo) << 3 | unsigned(in.estop) << 4 | unsigned(in.topLimit) << 5 |
+                          unsigned(in.bottomLimit) << 6 | unsigned(overload) << 7;
+    return static_cast<std::uint16_t>(bits | (static_cast<unsigned>(state) << 8) |
+                                      ((static_cast<unsigned>(latched) >> 3) << 11));
+}
+
+template <class Config>
+struct BasicLiftController : Config {
+    LiftState state = LiftState::Holding;
+    FaultManager faults;
+
+    // Change detection: the input key of the last fully evaluated scan whose
+    // phases 1 and 3 changed nothing, or kNoInputKey. Phases 1 and 3 depend
+    // on nothing but the key, so a later scan with the same key would latch
+    // only faults already latched and pick the state it is already in: only
+    // phase 2 has to run. As the key holds the state and latched fault, a
+    // stale key is never wrong, only a miss; fleets keep one per lift.
+    std::uint16_t inputKey = kNoInputKey;
+
+    // The plant's number type carries through; tunables are converted to it.
+    template <class Real>
+    Outputs update(std::type_identity_t<Real> dt, const Inputs& in, BasicLiftPlant<Real>& plant) {
+        evaluate(in, plant);
+        return driveOutputs(dt, in, plant);
+    }
+
+    // Phases 1-3: latch faults, allow reset, pick the new state. While the
+    // input key matches inputKey phases 1 and 3 would change nothing, and
+    // phase 2 only can if a reset is pending on a latched fault, so the scan
+    // is done; with inputKey = kNoInputKey before every scan this is the
+    // full evaluation. Builds with FORKLIFT_COUNTERS count every latch
+    // attempt and every scan's transition, so they always evaluate in full.
+    template <class Real>
+    void evaluate(const Inputs& in, const BasicLiftPlant<Real>& plant) {
+        const std::uint16_t key = packInputKey(in, in.loadKg > this->maxLoadKg, state, faults.latched);
+        if (!kCountersEnabled && key == inputKey && !(in.resetFault && faults.hasFault())) return;
+
+        const LiftState before = state;
+        const FaultCode latchedBefore = faults.latched;
+        const bool cleared = evaluateAll(in, plant);
+
+        // The key is kept only if this scan settled: nothing latched or
+        // changed state, no reset hid a latch by clearing it again, and no
+        // go-to (whose arrival depends on the plant, not the key) is active.
+        const bool settled = !in.cmdGoTo && !cleared && state == before && faults.latched == latchedBefore;
+        inputKey = settled ? key : kNoInputKey;
+    }
+
+    // The full phases 1-3; true if phase 2 cleared a fault
+    template <class Real>
+    bool evaluateAll(const Inputs& in, const BasicLiftPlant<Real>& plant) {
+#if FORKLIFT_COUNTERS
+        const LiftState before = state;
+#endif
+
+        // ---- 1. Latch faults (priority-based) ----
+        if (in.estop) {
+            faults.latch(FaultCode::EmergencyStop);
+        }
+        if (in.loadKg > this->maxLoadKg) {
+            faults.latch(FaultCode::Overload);
+        }
+
+        // Limit/sensor consistency + "commanding into a limit"
+        if (in.topLimit && in.bottomLimit) {
+            faults.latch(FaultCode::LimitViolation);
+        }
+        else {
+            if (state == LiftState::Lifting && in.topLimit)    faults.latch(FaultCode::LimitViolation);
+            if (state == LiftState::Lowering && in.bottomLimit) faults.latch(FaultCode::LimitViolation);
+
+            if (in.cmdUp && in.topLimit)    faults.latch(FaultCode::LimitViolation);
+            if (in.cmdDown && in.bottomLimit) faults.latch(FaultCode::LimitViolation);
+
+            // Targets are clamped clear of the limits, so reaching one while positioning is a fault
+            if (state == LiftState::Positioning && plant.velocity > Real(0.0) && in.topLimit)    faults.latch(FaultCode::LimitViolation);
+            if (state == LiftState::Positioning && plant.velocity < Real(0.0) && in.bottomLimit) faults.latch(FaultCode::LimitViolation);
+        }
+
+        // ---- 2. Allow reset ----
+        // Only allow reset when E-stop is released and the lift is stationary-ish.
+        using std::abs;
+        FORKLIFT_COUNT(if (in.resetFault) countReset(in.estop, !(abs(plant.velocity) < Real(this->safeStopSpeedEps)), faults.hasFault()));
+        const bool cleared = faults.hasFault() && in.resetFault && !in.estop && abs(plant.velocity) < Real(this->safeStopSpeedEps);
+        if (cleared) {
+            faults.clear();
+        }
+
+        // ---- 3. State transitions ----
+        if (faults.hasFault()) {
+            state = LiftState::Faulted;
+        }
+        else {
+            const bool up = in.cmdUp;
+            const bool down = in.cmdDown;
+
+            if (up && !down && !in.topLimit) {
+                state = LiftState::Lifting;
+            }
+            else if (down && !up && !in.bottomLimit) {
+                state = LiftState::Lowering;
+            }
+            else if (in.cmdGoTo && !up && !down && !in.cmdHold && !arrived(in, plant)) {
+                state = LiftState::Positioning;
+            }
+            else {
+                state = LiftState::Holding;
+            }
+        }
+        FORKLIFT_COUNT(countScan(before, state));
+        return cleared;
+    }
+
+    // At the go-to target and at rest: positioning hands over to Holding
+    template <class Real>
+    bool arrived(const Inputs& in, const BasicLiftPlant<Real>& plant) const {
+        using std::abs;
+        const double error = clampTargetPosition(in.targetPosition) - static_cast<double>(plant.position);
+        return abs(error) <= this->positionTolerance && abs(plant.velocity) < Real(this->safeStopSpeedEps);
+    }
+
+    // Trapezoidal go-to profile: cruise at the lift / lower speed, then brake
+    // at positionAccel so the lift comes to rest exactly on the target. The
+    // braking speed is that of the discrete plant, which moves velocity * dt
+    // per scan: k scans of braking from k * a * dt cover a * dt^2 * k(k+1)/2.
+    // The last scan asks for the remaining distance in one step (error / dt),
+    // which is under a * dt, so the next scan stops dead on the target.
+    template <class Real>
+    Real profileVelocity(std::type_identity_t<Real> dt, const Inputs& in, const BasicLiftPlant<Real>& plant) const {
+        using std::abs;
+        const double error = clampTargetPosition(in.targetPosition) - static_cast<double>(plant.position);
+        const double cruise = error > 0.0 ? double(this->liftSpeed) : double(this->lowerSpeed);
+        const double step = double(this->positionAccel) * static_cast<double>(dt);   // a * dt
+        const double k = 0.5 * (std::sqrt(1.0 + 8.0 * abs(error) / (step * static_cast<double>(dt))) - 1.0);
+        const double speed = std::min({ cruise, k * step, abs(error) / static_cast<double>(dt) });
+        return Real(error > 0.0 ? speed : -speed);
+    }
+
+    // Phase 4: outputs + safe stopping for the current state.
+    // constexpr so alternative implementations can be checked against it at
+    // compile time (every state but Positioning, whose profile needs sqrt).
+    template <class Real>
+    constexpr Outputs driveOutputs(std::type_identity_t<Real> dt, const Inputs& in, BasicLiftPlant<Real>& plant) const {
+        Outputs out{};
+
+        // ---- 4. Outputs + safe stopping ----
+        switch (state) {
+        case LiftState::Faulted:
+            plant.targetVel = Real(0.0);
+            out.motorEnable = false;
+            out.motorDir = 0;
+            out.brakeEngaged = true;
+            out.faultLamp = true;
+            break;
+
+        case LiftState::Holding:
+            plant.targetVel = Real(0.0);
+            out.motorEnable = false;
+            out.motorDir = 0;
+            out.brakeEngaged = true;
+            out.faultLamp = false;
+            break;
+
+        case LiftState::Lifting:
+            if (in.topLimit) {
+                plant.targetVel = Real(0.0);
+                out.motorEnable = false;
+                out.motorDir = 0;
+                out.brakeEngaged = true;
+            }
+            else {
+                plant.targetVel = +Real(this->liftSpeed);
+                out.motorEnable = true;
+                out.motorDir = +1;
+                out.brakeEngaged = false;
+            }
+            out.faultLamp = false;
+            break;
+
+        case LiftState::Lowering:
+            if (in.bottomLimit) {
+                plant.targetVel = Real(0.0);
+                out.motorEnable = false;
+                out.motorDir = 0;
+                out.brakeEngaged = true;
+            }
+            else {
+                plant.targetVel = -Real(this->lowerSpeed);
+                out.motorEnable = true;
+                out.motorDir = -1;
+                out.brakeEngaged = false;
+            }
+            out.faultLamp = false;
+            break;
+
+        case LiftState::Positioning:
+            plant.targetVel = profileVelocity(dt, in, plant);
+            out.motorEnable = true;
+            out.motorDir = plant.targetVel > Real(0.0) ? +1 : plant.targetVel < Real(0.0) ? -1 : 0;
+            out.brakeEngaged = false;
+            out.faultLamp = false;
+            break;
+        }
+
+        return out;
+    }
+};
+
+using LiftController = BasicLiftController<DefaultMast>;
+using RuntimeLiftController = BasicLiftController<RuntimeMastConfig>;
+
+// Only the scan state is stored per controller, so controllers copy and
+// assign like plain values.
+static_assert(sizeof(LiftController) == 4, "LiftController should hold scan state only");
+static_assert(std::is_trivially_copyable_v<LiftController>, "LiftController should be a plain value");
+static_assert(std::is_copy_assignable_v<RuntimeLiftController>, "RuntimeLiftController should be assignable");
+
+// One complete PLC scan for a single lift
+
+// Derived inputs (limit switches) from plant position
+template <class Real>
+inline void updateLimitSwitches(Inputs& in, Real position) {
+    in.bottomLimit = (position <= Real(0.0001));
+    in.topLimit = (position >= Real(0.9999));
+}
+
+// Limits -> controller -> brake override; everything up to the plant step.
+// Works with any controller that has LiftController's update() signature.
+template <class Controller, class Real>
+inline Outputs controlScan(std::type_identity_t<Real> dt, Inputs& in, Controller& ctrl, BasicLiftPlant<Real>& plant) {
+    // ---- Update derived inputs (limit switches) from plant position ----
+    updateLimitSwitches(in, plant.position);
+
+    // ---- Controller scan ----
+    Outputs out = ctrl.update(dt, in, plant);
+
+    // ---- Brake wins over any commanded velocity ----
+    if (out.brakeEngaged) plant.targetVel = Real(0.0);
+
+    return out;
+}
+
+// Limits -> controller -> brake override -> plant.
+// Every run mode goes through here so they all behave the same.
+template <class Controller, class Real>
+inline Outputs scanLift(std::type_identity_t<Real> dt, Inputs& in, Controller& ctrl, BasicLiftPlant<Real>& plant) {
+    Outputs out = controlScan(dt, in, ctrl, plant);
+
+    // ---- Plant update ----
+    plant.step(dt);
+
+    return out;
+}
@@ -0,0 +1,62 @@
+#include "LiftFleet.h"
+
+#include "FleetPasses.h"
+#include "PlantKernels.h"
+
+void LiftFleet::resize(std::size_t count) {
+    const LiftPlant plantInit{};
+    const LiftController ctrlInit{};
+
+    position.resize(count, plantInit.position);
+    velocity.resize(count, plantInit.velocity);
+    targetVel.resize(count, plantInit.targetVel);
+    state.resize(count, ctrlInit.state);
+    latched.resize(count, ctrlInit.faults.latched);
+    inputKey.resize(count, ctrlInit.inputKey);
+    inputs.resize(count);
+    outputs.resize(count);
+    if (!mast.empty()) mast.resize(count);
+    if (kCountersEnabled) dwell.resize(count);
+    if (!liftCounters.empty()) liftCounters.resize(count);
+    if (!truckModel.empty()) truckModel.resize(count);
+    if (dynamics) {
+        accel.resize(count);
+        creep.resize(count);
+    }
+}
+
+void LiftFleet::setMast(std::size_t lift, const RuntimeMastConfig& config) {
+    if (mast.empty()) mast.resize(size());
+    mast[lift] = config;
+}
+
+void LiftFleet::setDynamics(const TruckDynamics* tables) {
+    dynamics = tables;
+    accel.assign(tables ? size() : 0, 0.0);
+    creep.assign(tables ? size() : 0, 0.0);
+}
+
+void LiftFleet::setTruckModel(std::size_t lift, std::uint8_t model) {
+    if (truckModel.empty()) truckModel.resize(size());
+    truckModel[lift] = model;
+}
+
+void LiftFleet::controlRange(std::size_t begin, std::size_t end, double dt) {
+    // ---- Pass 1: limits, controller, brake override (per lift) ----
+    if (dynamics) controlLoadedFleetRange(*this, begin, end, dt);
+    else controlFleetRange(*this, begin, end, dt);
+}
+
+void LiftFleet::stepRange(std::size_t begin, std::size_t end, double dt) {
+    if (begin >= end) return;
+
+    // ---- Pass 2: plant step, vectorized over the whole range ----
+    if (dynamics) {
+        stepLoadedPlants(position.data() + begin, velocity.data() + begin, targetVel.data() + begin,
+                         accel.data() + begin, creep.data() + begin, end - begin, dt);
+    }
+    else {
+        stepPlants(position.data() + begin, velocity.data() + begin, targetVel.data() + begin,
+                   end - begin, dt);
+    }
+}
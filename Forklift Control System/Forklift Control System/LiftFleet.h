@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LiftControl.h"
+#include "LoadDynamics.h"
+
+// Fleet of lifts stepped together, one PLC scan for every lift per call.
+//
+// Hot per-lift state is kept as structure-of-arrays so a scan walks
+// contiguous memory. Each scan runs controlScan() per lift and then steps
+// all plants with the batched kernel from PlantKernels.h, so lift i of a
+// fleet behaves bit-for-bit like a lone LiftController/LiftPlant fed the
+// same Inputs through scanLift().
+
+struct LiftFleet {
+    // Plant state
+    std::vector<double> position;
+    std::vector<double> velocity;
+    std::vector<double> targetVel;
+
+    // Controller state
+    std::vector<LiftState> state;
+    std::vector<FaultCode> latched;
+    std::vector<std::uint16_t> inputKey;   // BasicLiftController::inputKey
+
+    // Scan I/O (inputs are written by the caller before scan())
+    std::vector<Inputs> inputs;
+    std::vector<Outputs> outputs;
+
+    // Per-lift mast tunables for mixed fleets; empty = DefaultMast for every lift
+    std::vector<RuntimeMastConfig> mast;
+
+    // FORKLIFT_COUNTERS builds (ScanCounters.h): scans in the current state, per lift,
+    // and each lift's own counters once enablePerLiftCounters() is called; otherwise
+    // lifts count into the scanning thread's aggregate.
+    std::vector<std::uint32_t> dwell;
+    std::vector<LiftCounters> liftCounters;
+
+    // Use the table-driven phase 4 (TableController.h) instead of the reference switch
+    bool tableController = false;
+
+    // Load- and height-dependent dynamics (LoadDynamics.h), shared by the whole
+    // fleet; nullptr = the fixed DefaultMast/LiftPlant dynamics. truckModel[i]
+    // picks lift i's table (empty = table 0). accel and creep carry each lift's
+    // sample from the control pass to the plant pass.
+    const TruckDynamics* dynamics = nullptr;
+    std::vector<std::uint8_t> truckModel;
+    std::vector<double> accel;
+    std::vector<double> creep;
+
+    LiftFleet() = default;
+    explicit LiftFleet(std::size_t count) { resize(count); }
+
+    std::size_t size() const { return position.size(); }
+
+    // Resize the fleet; new lifts start in the same state as a fresh LiftPlant/LiftController.
+    void resize(std::size_t count);
+
+    // Give one lift its own tunables (the others keep DefaultMast's values).
+    void setMast(std::size_t lift, const RuntimeMastConfig& config);
+
+    void enablePerLiftCounters() { liftCounters.resize(size()); }
+
+    // Switch to table-driven dynamics; the tables must outlive the fleet's scans.
+    void setDynamics(const TruckDynamics* tables);
+    void setTruckModel(std::size_t lift, std::uint8_t model);
+
+    // One scan for every lift. inputs[] are left as the controller saw them
+    // (limits included), so the caller owns the resetFault pulse.
+    void scan(double dt) { scanRange(0, size(), dt); }
+    void scanRange(std::size_t begin, std::size_t end, double dt) {
+        controlRange(begin, end, dt);
+        stepRange(begin, end, dt);
+    }
+
+    // The two phases of scanRange(), for schedulers that put a barrier between them:
+    // limits, controller and brake override per lift, then the batched plant step.
+    void controlRange(std::size_t begin, std::size_t end, double dt);
+    void stepRange(std::size_t begin, std::size_t end, double dt);
+};
@@ -0,0 +1,142 @@
+#include "LiftSnapshot.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "Rng.h"
+
+namespace {
+
+// Keeps the baseline loop from being optimized away
+volatile std::uint64_t timingSink = 0;
+
+struct CheckedSnapshot {
+    LiftSnapshot s;
+    std::uint64_t sum;
+};
+
+std::uint64_t checksum(const LiftSnapshot& s) {
+    std::uint64_t words[(sizeof(LiftSnapshot) + 7) / 8] = {};
+    std::memcpy(words, &s, sizeof(LiftSnapshot));
+    std::uint64_t h = 0;
+    for (std::uint64_t w : words) h = splitMix64(h ^ w);
+    return h;
+}
+
+// The headless-style scan loop the check publishes from.
+struct CheckLift {
+    LiftPlant plant{};
+    LiftController ctrl{};
+    Inputs in{};
+
+    LiftSnapshot scan(std::uint64_t s) {
+        const std::uint64_t phase = s % 400;
+        in.resetFault = phase == 399;
+        in.cmdUp = phase < 120;
+        in.cmdDown = phase >= 200 && phase < 335;
+        in.loadKg = static_cast<double>(s % 1500);
+        const Outputs out = scanLift(0.02, in, ctrl, plant);
+        return makeLiftSnapshot(s, in, out, plant, ctrl.state, ctrl.faults.latched);
+    }
+};
+
+struct ReaderStats {
+    std::uint64_t reads = 0;
+    std::uint64_t distinct = 0;
+    std::uint64_t retries = 0;
+    std::uint64_t torn = 0;
+    std::uint64_t regressions = 0;
+};
+
+} // namespace
+
+SnapshotCheckReport checkSnapshots(std::uint64_t scans, unsigned readers) {
+    SnapshotCheckReport r{};
+    r.scans = scans;
+    r.readers = readers;
+
+    // Baseline: same loop and checksum, nothing published
+    {
+        CheckLift lift;
+        std::uint64_t sum = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (std::uint64_t s = 0; s < scans; ++s) sum += checksum(lift.scan(s));
+        const auto t1 = std::chrono::steady_clock::now();
+        r.baselineNsPerScan = std::chrono::duration<double, std::nano>(t1 - t0).count() / (scans ? scans : 1);
+        timingSink = sum;
+    }
+
+    SnapshotRing<CheckedSnapshot> ring;
+    std::atomic<bool> done{ false };
+    std::vector<ReaderStats> stats(readers);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < readers; ++t) {
+        threads.emplace_back([&ring, &done, &st = stats[t]] {
+            std::uint64_t last = 0;
+            CheckedSnapshot c{};
+            while (!done.load(std::memory_order_relaxed)) {
+                const std::uint64_t n = ring.read(c, &st.retries);
+                if (n == 0) continue;
+                st.reads++;
+                if (checksum(c.s) != c.sum) st.torn++;
+                if (n < last) st.regressions++;
+                else if (n > last) st.distinct++;
+                last = n;
+            }
+        });
+    }
+
+    CheckLift lift;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t s = 0; s < scans; ++s) {
+        const LiftSnapshot snap = lift.scan(s);
+        ring.publish(CheckedSnapshot{ snap, checksum(snap) });
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    done.store(true, std::memory_order_relaxed);
+    for (std::thread& t : threads) t.join();
+    r.publishNsPerScan = std::chrono::duration<double, std::nano>(t1 - t0).count() / (scans ? scans : 1);
+
+    for (const ReaderStats& st : stats) {
+        r.reads += st.reads;
+        r.distinct += st.distinct;
+        r.retries += st.retries;
+        r.torn += st.torn;
+        r.regressions += st.regressions;
+    }
+    return r;
+}
+
+void printLiftSnapshot(std::ostream& os, const LiftSnapshot& s) {
+    os << std::fixed << std::setprecision(3)
+        << "scan=" << s.scan
+        << " pos=" << s.plant.position
+        << " vel=" << s.plant.velocity
+        << " target=" << s.plant.targetVel
+        << " state=" << stateToString(s.state)
+        << " fault=" << faultToString(s.fault)
+        << "\n  in: up=" << s.in.cmdUp << " down=" << s.in.cmdDown << " hold=" << s.in.cmdHold
+        << " goto=" << s.in.cmdGoTo << " (" << s.in.targetPosition << ")"
+        << " estop=" << s.in.estop << " top=" << s.in.topLimit << " bot=" << s.in.bottomLimit
+        << " load=" << s.in.loadKg
+        << "\n  out: motor=" << s.out.motorEnable << " dir=" << s.out.motorDir
+        << " brake=" << s.out.brakeEngaged << " lamp=" << s.out.faultLamp
+        << "\n";
+}
+
+void printSnapshotCheckReport(std::ostream& os, const SnapshotCheckReport& r) {
+    os << std::fixed << std::setprecision(1)
+        << "snapshot-check: scans=" << r.scans << " readers=" << r.readers
+        << " sizeof(LiftSnapshot)=" << sizeof(LiftSnapshot) << "\n"
+        << "  writer: " << r.baselineNsPerScan << " ns/scan without publishing, "
+        << r.publishNsPerScan << " ns/scan publishing with readers running"
+        << " (wall time, " << std::thread::hardware_concurrency() << " hardware threads)\n"
+        << "  readers: reads=" << r.reads << " distinct=" << r.distinct << " retries=" << r.retries
+        << " torn=" << r.torn << " regressions=" << r.regressions
+        << (r.torn == 0 && r.regressions == 0 ? " result=consistent" : " result=INCONSISTENT") << "\n";
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+#include "LiftControl.h"
+#include "SnapshotRing.h"
+
+// What HMI, logger and metrics threads may see of a lift: one consistent
+// copy per scan, published by the scan loop through a SnapshotRing.
+// Readers use this instead of touching the scan thread's objects.
+
+struct LiftSnapshot {
+    std::uint64_t scan = 0;
+    Inputs in{};
+    Outputs out{};
+    LiftPlant plant{};
+    LiftState state = LiftState::Holding;
+    FaultCode fault = FaultCode::None;
+};
+
+using LiftSnapshotRing = SnapshotRing<LiftSnapshot>;
+
+inline LiftSnapshot makeLiftSnapshot(std::uint64_t scan, const Inputs& in, const Outputs& out,
+                                     const LiftPlant& plant, LiftState state, FaultCode fault) {
+    LiftSnapshot s{};
+    s.scan = scan;
+    s.in = in;
+    s.out = out;
+    s.plant = plant;
+    s.state = state;
+    s.fault = fault;
+    return s;
+}
+
+// "scan=... pos=... vel=... target=... state=... fault=..." then the inputs and outputs
+void printLiftSnapshot(std::ostream& os, const LiftSnapshot& s);
+
+// Stress check: a scan loop publishing every scan as fast as it can while
+// reader threads fetch continuously and verify that every snapshot they
+// get is whole (a checksum over the snapshot) and never older than the
+// previous one.
+struct SnapshotCheckReport {
+    std::uint64_t scans = 0;
+    unsigned readers = 0;
+    double baselineNsPerScan = 0.0;   // scan loop without publishing
+    double publishNsPerScan = 0.0;    // with publishing, with readers running
+    std::uint64_t reads = 0;
+    std::uint64_t distinct = 0;       // reads that returned a newer publication
+    std::uint64_t retries = 0;
+    std::uint64_t torn = 0;           // checksum mismatches (must be 0)
+    std::uint64_t regressions = 0;    // older publication than the last read (must be 0)
+};
+
+SnapshotCheckReport checkSnapshots(std::uint64_t scans, unsigned readers);
+
+void printSnapshotCheckReport(std::ostream& os, const SnapshotCheckReport& r);
@@ -0,0 +1,190 @@
+#include "LoadDynamics.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double kGravity = 9.81;
+
+// 0 below -0.5, 1 above +0.5, smooth in between
+double smoothStep(double x) {
+    const double t = std::clamp(x + 0.5, 0.0, 1.0);
+    return t * t * (3.0 - 2.0 * t);
+}
+
+} // namespace
+
+DynamicsSample DynamicsTable::evaluate(const TruckModel& m, double loadKg, double position) {
+    const double h = std::clamp(position, 0.0, 1.0);
+    const double mass = m.carriageKg + m.loadSensitivity * std::max(loadKg, 0.0);
+    const double ratedMass = m.carriageKg + m.loadSensitivity * m.ratedLoadKg;
+
+    DynamicsSample s;
+
+    // Lift: full pump flow less internal leakage, slower once the outer stage
+    // engages, and capped by pump power
+    const double pressure = ratedMass > 0.0 ? mass / ratedMass : 0.0;
+    s.liftSpeed = m.emptyLiftSpeed * (1.0 - m.volumetricLoss * pressure) *
+                  (1.0 + (m.stageSpeedFactor - 1.0) * smoothStep((h - m.freeLift) / 0.3));
+    if (m.pumpPowerW > 0.0 && mass > 0.0) {
+        const double powerLimited = m.pumpPowerW / (mass * kGravity) / m.mastHeightM;
+        s.liftSpeed = std::min(s.liftSpeed, powerLimited);
+    }
+
+    // Lower: orifice flow through the lowering valve, up to the regulated ceiling
+    s.lowerSpeed = m.carriageKg > 0.0 ? m.emptyLowerSpeed * std::pow(mass / m.carriageKg, m.valveExponent) : m.emptyLowerSpeed;
+    s.lowerSpeed = std::min(s.lowerSpeed, m.maxLowerSpeed);
+
+    // Acceleration: the same force moves more mass, and is derated with height for stability
+    const double massRatio = mass > 0.0 ? m.carriageKg / mass : 1.0;
+    s.accel = m.emptyAccel * massRatio * (1.0 + (m.highAccelFactor - 1.0) * h);
+
+    // Creep: leakage past the cylinder seals grows with pressure and with extension
+    s.creep = m.ratedCreep * std::pow(pressure, m.creepExponent) * (0.25 + 0.75 * h);
+    return s;
+}
+
+DynamicsTable::DynamicsTable(const TruckModel& model)
+    : maxLoadKg_(model.ratedLoadKg),
+      maxTableLoadKg_(kLoadRange * model.ratedLoadKg),
+      invLoadStep_(model.ratedLoadKg > 0.0 ? double(kLoadPoints - 1) / (kLoadRange * model.ratedLoadKg) : 0.0),
+      name_(model.name) {
+    for (std::size_t hi = 0; hi < kHeightPoints; ++hi) {
+        for (std::size_t li = 0; li < kLoadPoints; ++li) {
+            const double load = maxTableLoadKg_ * double(li) / double(kLoadPoints - 1);
+            const double h = double(hi) / double(kHeightPoints - 1);
+            cells_[hi * kLoadPoints + li] = evaluate(model, load, h);
+        }
+    }
+}
+
+bool TruckDynamics::add(const TruckModel& model) {
+    if (count >= kMaxModels) return false;
+    tables[count++] = DynamicsTable(model);
+    return true;
+}
+
+int TruckDynamics::find(const std::string& name) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (name == tables[i].name()) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const TruckModel& fixedTruckModel() {
+    static const TruckModel m = [] {
+        TruckModel t;
+        t.name = "fixed";
+        t.ratedLoadKg = DefaultMast::maxLoadKg;
+        t.carriageKg = 1.0;
+        t.emptyLiftSpeed = DefaultMast::liftSpeed;
+        t.emptyLowerSpeed = DefaultMast::lowerSpeed;
+        t.maxLowerSpeed = DefaultMast::lowerSpeed;
+        t.emptyAccel = LiftPlant::accel;
+        t.mastHeightM = 1.0;
+        t.loadSensitivity = 0.0;
+        return t;
+    }();
+    return m;
+}
+
+const TruckModel& counterbalanceTruckModel() {
+    static const TruckModel m = [] {
+        TruckModel t;
+        t.name = "counterbalance";
+        t.ratedLoadKg = 1200.0;
+        t.carriageKg = 250.0;
+        t.emptyLiftSpeed = 0.40;
+        t.pumpPowerW = 12000.0;
+        t.mastHeightM = 3.3;
+        t.emptyLowerSpeed = 0.25;
+        t.maxLowerSpeed = 0.40;
+        t.emptyAccel = 3.5;
+        t.highAccelFactor = 0.6;
+        t.freeLift = 0.35;
+        t.stageSpeedFactor = 0.8;
+        t.ratedCreep = 0.002;
+        t.volumetricLoss = 0.06;
+        t.creepExponent = 1.3;
+        return t;
+    }();
+    return m;
+}
+
+const TruckModel& heavyTruckModel() {
+    static const TruckModel m = [] {
+        TruckModel t;
+        t.name = "heavy";
+        t.ratedLoadKg = 2500.0;
+        t.carriageKg = 500.0;
+        t.emptyLiftSpeed = 0.30;
+        t.pumpPowerW = 15000.0;
+        t.mastHeightM = 3.0;
+        t.emptyLowerSpeed = 0.20;
+        t.maxLowerSpeed = 0.35;
+        t.emptyAccel = 2.5;
+        t.highAccelFactor = 0.7;
+        t.freeLift = 0.30;
+        t.stageSpeedFactor = 0.85;
+        t.ratedCreep = 0.003;
+        t.volumetricLoss = 0.08;
+        t.creepExponent = 1.3;
+        return t;
+    }();
+    return m;
+}
+
+const TruckModel& reachTruckModel() {
+    static const TruckModel m = [] {
+        TruckModel t;
+        t.name = "reach";
+        t.ratedLoadKg = 1400.0;
+        t.carriageKg = 300.0;
+        t.emptyLiftSpeed = 0.08;
+        t.pumpPowerW = 9000.0;
+        t.mastHeightM = 8.5;
+        t.emptyLowerSpeed = 0.07;
+        t.maxLowerSpeed = 0.09;
+        t.emptyAccel = 1.0;
+        t.highAccelFactor = 0.4;
+        t.freeLift = 0.20;
+        t.stageSpeedFactor = 0.7;
+        t.ratedCreep = 0.0008;
+        t.volumetricLoss = 0.05;
+        t.creepExponent = 1.2;
+        return t;
+    }();
+    return m;
+}
+
+TruckDynamics builtinTruckDynamics() {
+    TruckDynamics d;
+    d.add(fixedTruckModel());
+    d.add(counterbalanceTruckModel());
+    d.add(heavyTruckModel());
+    d.add(reachTruckModel());
+    return d;
+}
+
+void stepLoadedPlants(double* position, double* velocity, const double* targetVel, const double* accel,
+                      const double* creep, std::size_t n, double dt) {
+    // Branch-free form of stepLoadedPlant(), select for select
+    for (std::size_t i = 0; i < n; ++i) {
+        const double maxDv = accel[i] * dt;
+        double dv = targetVel[i] - velocity[i];
+        dv = dv < -maxDv ? -maxDv : dv;
+        dv = maxDv < dv ? maxDv : dv;
+        double v = velocity[i] + dv;
+
+        double p = position[i] + v * dt;
+        p = p - creep[i] * dt;
+        p = p < 0.0 ? 0.0 : p;
+        p = 1.0 < p ? 1.0 : p;
+
+        v = (p <= 0.0 && v < 0.0) ? 0.0 : v;
+        v = (p >= 1.0 && v > 0.0) ? 0.0 : v;
+        position[i] = p;
+        velocity[i] = v;
+    }
+}
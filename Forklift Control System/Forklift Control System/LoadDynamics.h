@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "LiftControl.h"
+
+// Load- and height-dependent lift dynamics from precomputed lookup tables.
+//
+// A TruckModel describes a truck type physically: rated load, carriage
+// mass, pump power, lowering valve, free-lift height and so on. Building a
+// DynamicsTable evaluates that model once on a load x height grid: lift
+// and lower speed, acceleration, and the creep of a holding mast. The scan
+// only interpolates bilinearly between four cells, so the physics (power
+// limits, valve flow, stage changes) costs nothing per scan, and a table
+// is a few KB, so every model a fleet uses stays in L1 together.
+//
+// With dynamics the truck model replaces the controller's maxLoadKg,
+// liftSpeed and lowerSpeed by the table's values at the lift's current load
+// and height, and scales the go-to braking rate by its acceleration. The
+// plant accelerates at the table's rate instead of LiftPlant::accel, and a
+// lift with its brake engaged creeps down at the table's creep rate. A
+// table whose cells all equal the fixed constants (fixedTruckModel())
+// reproduces scanLift() exactly.
+
+struct TruckModel {
+    const char* name = "";
+    double ratedLoadKg = 0.0;          // the controller's overload threshold
+    double carriageKg = 0.0;           // forks and carriage, moved with every load
+    double emptyLiftSpeed = 0.0;       // units/s, pump at full flow
+    double pumpPowerW = 0.0;           // caps lift speed once mass * g * speed exceeds it; 0 = no cap
+    double mastHeightM = 0.0;          // physical travel of position 0..1
+    double emptyLowerSpeed = 0.0;      // units/s, at carriage mass only
+    double maxLowerSpeed = 0.0;        // regulated ceiling of the lowering valve
+    double emptyAccel = 0.0;           // units/s^2 at carriage mass only
+    double highAccelFactor = 1.0;      // acceleration at full height relative to the bottom (stability)
+    double freeLift = 1.0;             // position where the outer mast stage engages
+    double stageSpeedFactor = 1.0;     // lift speed above freeLift relative to below
+    double ratedCreep = 0.0;           // units/s at rated load and full height; scales with pressure and height
+    double loadSensitivity = 1.0;      // share of the load the hydraulics feel; 0 = dynamics independent of load
+    double valveExponent = 0.5;        // lowering flow ~ pressure^valveExponent (0.5 = turbulent orifice)
+    double volumetricLoss = 0.0;       // pump flow lost to internal leakage at rated pressure, as a fraction
+    double creepExponent = 1.0;        // creep ~ pressure^creepExponent
+};
+
+// Dynamics at one (load, height) point
+struct DynamicsSample {
+    double liftSpeed = 0.0;
+    double lowerSpeed = 0.0;
+    double accel = 0.0;
+    double creep = 0.0;                // downward drift while the brake holds
+};
+
+class DynamicsTable {
+public:
+    static constexpr std::size_t kLoadPoints = 16;     // 0 .. kLoadRange * ratedLoadKg
+    static constexpr std::size_t kHeightPoints = 10;   // position 0 .. 1
+    static constexpr double kLoadRange = 1.25;         // past the rated load, so overloads interpolate too
+
+    DynamicsTable() = default;
+
+    // Evaluate the model at every grid point
+    explicit DynamicsTable(const TruckModel& model);
+
+    // The model evaluated directly at one point, without the table (slow; for building and checks)
+    static DynamicsSample evaluate(const TruckModel& model, double loadKg, double position);
+
+    // Bilinear interpolation; load and position are clamped to the grid.
+    DynamicsSample sample(double loadKg, double position) const {
+        const double lx = std::clamp(loadKg, 0.0, maxTableLoadKg_) * invLoadStep_;
+        const double hx = std::clamp(position, 0.0, 1.0) * double(kHeightPoints - 1);
+        const std::size_t li = std::min(static_cast<std::size_t>(lx), kLoadPoints - 2);
+        const std::size_t hi = std::min(static_cast<std::size_t>(hx), kHeightPoints - 2);
+        const double lf = lx - double(li);
+        const double hf = hx - double(hi);
+
+        const DynamicsSample& c00 = cells_[hi * kLoadPoints + li];
+        const DynamicsSample& c01 = cells_[hi * kLoadPoints + li + 1];
+        const DynamicsSample& c10 = cells_[(hi + 1) * kLoadPoints + li];
+        const DynamicsSample& c11 = cells_[(hi + 1) * kLoadPoints + li + 1];
+        DynamicsSample s;
+        s.liftSpeed = lerp2(c00.liftSpeed, c01.liftSpeed, c10.liftSpeed, c11.liftSpeed, lf, hf);
+        s.lowerSpeed = lerp2(c00.lowerSpeed, c01.lowerSpeed, c10.lowerSpeed, c11.lowerSpeed, lf, hf);
+        s.accel = lerp2(c00.accel, c01.accel, c10.accel, c11.accel, lf, hf);
+        s.creep = lerp2(c00.creep, c01.creep, c10.creep, c11.creep, lf, hf);
+        return s;
+    }
+
+    double maxLoadKg() const { return maxLoadKg_; }
+    const char* name() const { return name_; }
+
+private:
+    // Equal corners give back exactly that value, so a flat table is exact
+    static double lerp2(double v00, double v01, double v10, double v11, double lf, double hf) {
+        const double low = v00 + (v01 - v00) * lf;
+        const double high = v10 + (v11 - v10) * lf;
+        return low + (high - low) * hf;
+    }
+
+    std::array<DynamicsSample, kLoadPoints * kHeightPoints> cells_{};   // height-major
+    double maxLoadKg_ = 0.0;
+    double maxTableLoadKg_ = 0.0;
+    double invLoadStep_ = 0.0;
+    const char* name_ = "";
+};
+
+// The tables a fleet shares, built once at startup; lifts pick one by index.
+struct TruckDynamics {
+    static constexpr std::size_t kMaxModels = 4;
+
+    std::array<DynamicsTable, kMaxModels> tables{};
+    std::size_t count = 0;
+
+    // Returns false if all kMaxModels slots are taken.
+    bool add(const TruckModel& model);
+
+    // Index of the table named name, or -1
+    int find(const std::string& name) const;
+};
+
+// Every table a fleet can use fits in a 32 KB L1 data cache with room to spare
+static_assert(sizeof(TruckDynamics) <= 24 * 1024, "the fleet's dynamics tables should stay L1-resident");
+
+// Built-in truck models
+const TruckModel& fixedTruckModel();        // DefaultMast and LiftPlant constants at every load and height
+const TruckModel& counterbalanceTruckModel();
+const TruckModel& heavyTruckModel();
+const TruckModel& reachTruckModel();
+
+// fixed, counterbalance, heavy, reach
+TruckDynamics builtinTruckDynamics();
+
+// LiftPlant::step with the given acceleration and (downward) creep
+inline void stepLoadedPlant(LiftPlant& p, double accel, double creep, double dt) {
+    double dv = p.targetVel - p.velocity;
+    const double maxDv = accel * dt;
+    dv = std::clamp(dv, -maxDv, maxDv);
+    p.velocity += dv;
+
+    p.position += p.velocity * dt;
+    p.position -= creep * dt;
+    p.position = std::clamp(p.position, 0.0, 1.0);
+
+    if (p.position <= 0.0 && p.velocity < 0.0) p.velocity = 0.0;
+    if (p.position >= 1.0 && p.velocity > 0.0) p.velocity = 0.0;
+}
+
+// stepLoadedPlant() over structure-of-arrays state, written so the compiler vectorizes it
+void stepLoadedPlants(double* position, double* velocity, const double* targetVel, const double* accel,
+                      const double* creep, std::size_t n, double dt);
+
+// Limits -> table lookup -> controller -> brake override. The controller
+// needs RuntimeMastConfig tunables (RuntimeLiftController,
+// RuntimeTableLiftController); the sample it ran with is returned in d,
+// with creep zeroed unless the brake holds, for the plant step.
+template <class Controller>
+inline Outputs controlLoadedScan(double dt, Inputs& in, Controller& ctrl, LiftPlant& plant,
+                                 const DynamicsTable& table, DynamicsSample& d) {
+    updateLimitSwitches(in, plant.position);
+
+    d = table.sample(in.loadKg, plant.position);
+    ctrl.maxLoadKg = table.maxLoadKg();
+    ctrl.liftSpeed = d.liftSpeed;
+    ctrl.lowerSpeed = d.lowerSpeed;
+    ctrl.positionAccel = DefaultMast::positionAccelMargin * d.accel;
+    Outputs out = ctrl.update(dt, in, plant);
+
+    if (out.brakeEngaged) plant.targetVel = 0.0;
+    else d.creep = 0.0;
+    return out;
+}
+
+// scanLift() with load- and height-dependent dynamics
+template <class Controller>
+inline Outputs scanLoadedLift(double dt, Inputs& in, Controller& ctrl, LiftPlant& plant, const DynamicsTable& table) {
+    DynamicsSample d;
+    Outputs out = controlLoadedScan(dt, in, ctrl, plant, table, d);
+    stepLoadedPlant(plant, d.accel, d.creep, dt);
+    return out;
+}
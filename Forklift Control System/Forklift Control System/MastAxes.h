@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "LiftControl.h"
+
+// Multi-axis mast: the vertical lift plus tilt, side-shift and reach.
+//
+// Every axis is a LiftPlant: a normalized position 0..1 with a limit switch
+// at each end, driven towards its commanded velocity with the same inertia,
+// so a fleet steps every axis of every lift in one PlantKernels pass. The
+// lift axis runs LiftController unchanged; each auxiliary axis runs a small
+// plus / minus / stopped machine. All axes share the lift controller's
+// FaultManager, so a fault on any axis latches with the usual priority and
+// stops the whole mast, and a reset only clears it once every axis is at rest.
+//
+// Interlocks between axes inhibit a move instead of faulting. With more than
+// interlockLoadKg on the forks and the carriage above interlockHeight, the
+// reach cannot extend and the mast cannot tilt forward; with the reach out
+// under that load, the carriage cannot rise past interlockHeight: rising is
+// inhibited as soon as one more scan of it would leave the carriage unable
+// to stop at or below that height. Retracting, tilting back and lowering are
+// always allowed. With the auxiliary axes idle
+// and no interlock active the lift axis is bit-for-bit a plain lift.
+
+enum class MastAxis : std::uint8_t {
+    Lift,
+    Tilt,         // + back, - forward; rests level at 0.5
+    SideShift,    // + right, - left; rests centered at 0.5
+    Reach,        // + extend, - retract; rests retracted at 0
+};
+
+inline constexpr std::size_t kMastAxes = 4;
+inline constexpr std::size_t kAuxAxes = kMastAxes - 1;   // the axes after Lift
+
+inline const char* mastAxisToString(MastAxis a) {
+    switch (a) {
+    case MastAxis::Lift: return "Lift";
+    case MastAxis::Tilt: return "Tilt";
+    case MastAxis::SideShift: return "SideShift";
+    case MastAxis::Reach: return "Reach";
+    }
+    return "Unknown";
+}
+
+// Index of an auxiliary axis in the aux[] arrays below
+constexpr std::size_t auxIndex(MastAxis a) { return static_cast<std::size_t>(a) - 1; }
+
+struct MastAxesConfig {
+    // Per auxiliary axis, in MastAxis order from Tilt
+    static constexpr double speed[kAuxAxes] = { 0.25, 0.30, 0.20 };
+    static constexpr double restPosition[kAuxAxes] = { 0.5, 0.5, 0.0 };
+
+    static constexpr double interlockHeight = 0.5;     // lift position
+    static constexpr double interlockLoadKg = 600.0;
+    static constexpr double reachRetracted = 0.02;     // reach at or below this counts as retracted
+};
+
+struct AxisInputs {
+    bool cmdPlus = false;
+    bool cmdMinus = false;
+
+    bool maxLimit = false;     // derived from position, like the lift limits
+    bool minLimit = false;
+};
+
+struct AxisOutputs {
+    bool motorEnable = false;
+    int motorDir = 0;          // +1 plus, -1 minus, 0 none
+    bool brakeEngaged = true;  // holding valve closed
+    bool inhibited = false;    // a command was blocked by an interlock
+};
+
+enum class AxisMotion : std::uint8_t {
+    Stopped,
+    Plus,
+    Minus,
+};
+
+struct MastInputs {
+    Inputs lift;               // estop, resetFault and loadKg apply to the whole mast
+    AxisInputs aux[kAuxAxes];
+};
+
+struct MastOutputs {
+    Outputs lift;              // faultLamp covers every axis
+    bool liftInhibited = false;
+    AxisOutputs aux[kAuxAxes];
+};
+
+// Where the lift axis comes to rest if its target velocity is 0 from now on.
+// LiftPlant::step sheds accel * dt of velocity per step, in the same order.
+inline double liftStopPosition(const LiftPlant& p, double dt) {
+    const double dv = LiftPlant::accel * dt;
+    double position = p.position;
+    for (double v = p.velocity - dv; v > 0.0; v -= dv) position += v * dt;
+    return position;
+}
+
+// The same after one more step rising towards speed
+inline double liftStopPositionRising(const LiftPlant& p, double speed, double dt) {
+    LiftPlant next = p;
+    next.velocity = std::min(p.velocity + LiftPlant::accel * dt, std::max(p.velocity, speed));
+    next.position += next.velocity * dt;
+    return liftStopPosition(next, dt);
+}
+
+struct MastPlant {
+    LiftPlant axis[kMastAxes] = {
+        LiftPlant{},
+        LiftPlant{ MastAxesConfig::restPosition[0] },
+        LiftPlant{ MastAxesConfig::restPosition[1] },
+        LiftPlant{ MastAxesConfig::restPosition[2] },
+    };
+
+    void step(double dt) {
+        for (LiftPlant& p : axis) p.step(dt);
+    }
+};
+
+struct MastController {
+    LiftController lift;       // lift state machine, and the one FaultManager of the mast
+    AxisMotion aux[kAuxAxes] = {};
+
+    MastOutputs update(double dt, const MastInputs& in, MastPlant& plant) {
+        using C = MastAxesConfig;
+        MastOutputs out{};
+        const LiftPlant& liftAxis = plant.axis[0];
+        const LiftPlant& reachAxis = plant.axis[static_cast<std::size_t>(MastAxis::Reach)];
+
+        // ---- Interlocks: mask the blocked commands ----
+        const bool loaded = in.lift.loadKg > C::interlockLoadKg;
+        const bool high = liftAxis.position > C::interlockHeight;
+        const bool reachOut = reachAxis.position > C::reachRetracted;
+        bool cmdPlus[kAuxAxes];
+        bool cmdMinus[kAuxAxes];
+        for (std::size_t a = 0; a < kAuxAxes; ++a) {
+            cmdPlus[a] = in.aux[a].cmdPlus;
+            cmdMinus[a] = in.aux[a].cmdMinus;
+        }
+        if (loaded && high) {
+            out.aux[auxIndex(MastAxis::Reach)].inhibited = cmdPlus[auxIndex(MastAxis::Reach)];
+            out.aux[auxIndex(MastAxis::Tilt)].inhibited = cmdMinus[auxIndex(MastAxis::Tilt)];
+            cmdPlus[auxIndex(MastAxis::Reach)] = false;
+            cmdMinus[auxIndex(MastAxis::Tilt)] = false;
+        }
+        Inputs liftIn = in.lift;
+        if (loaded && reachOut && (liftIn.cmdUp || liftIn.cmdGoTo) &&
+            liftStopPositionRising(liftAxis, DefaultMast::liftSpeed, dt) > C::interlockHeight) {
+            if (liftIn.cmdUp) {
+                out.liftInhibited = true;
+                liftIn.cmdUp = false;
+            }
+            if (liftIn.cmdGoTo && clampTargetPosition(liftIn.targetPosition) > liftAxis.position) {
+                out.liftInhibited = true;
+                liftIn.cmdGoTo = false;
+            }
+        }
+
+        // ---- Auxiliary-axis faults, latched into the lift's FaultManager ----
+        bool auxMoving = false;
+        for (std::size_t a = 0; a < kAuxAxes; ++a) {
+            const AxisInputs& ai = in.aux[a];
+            if (ai.maxLimit && ai.minLimit) {
+                lift.faults.latch(FaultCode::LimitViolation);
+            }
+            else {
+                if (aux[a] == AxisMotion::Plus && ai.maxLimit)  lift.faults.latch(FaultCode::LimitViolation);
+                if (aux[a] == AxisMotion::Minus && ai.minLimit) lift.faults.latch(FaultCode::LimitViolation);
+
+                if (cmdPlus[a] && ai.maxLimit)  lift.faults.latch(FaultCode::LimitViolation);
+                if (cmdMinus[a] && ai.minLimit) lift.faults.latch(FaultCode::LimitViolation);
+            }
+            using std::abs;
+            auxMoving |= !(abs(plant.axis[a + 1].velocity) < DefaultMast::safeStopSpeedEps);
+        }
+
+        // ---- Lift axis; its reset gate also waits for the other axes ----
+        if (auxMoving) liftIn.resetFault = false;
+        out.lift = lift.update(dt, liftIn, plant.axis[0]);
+
+        // ---- Auxiliary-axis states and outputs ----
+        for (std::size_t a = 0; a < kAuxAxes; ++a) {
+            const AxisInputs& ai = in.aux[a];
+            if (lift.faults.hasFault()) aux[a] = AxisMotion::Stopped;
+            else if (cmdPlus[a] && !cmdMinus[a] && !ai.maxLimit) aux[a] = AxisMotion::Plus;
+            else if (cmdMinus[a] && !cmdPlus[a] && !ai.minLimit) aux[a] = AxisMotion::Minus;
+            else aux[a] = AxisMotion::Stopped;
+
+            AxisOutputs& ao = out.aux[a];
+            LiftPlant& p = plant.axis[a + 1];
+            switch (aux[a]) {
+            case AxisMotion::Stopped:
+                p.targetVel = 0.0;
+                ao.motorEnable = false;
+                ao.motorDir = 0;
+                ao.brakeEngaged = true;
+                break;
+
+            case AxisMotion::Plus:
+                p.targetVel = +C::speed[a];
+                ao.motorEnable = true;
+                ao.motorDir = +1;
+                ao.brakeEngaged = false;
+                break;
+
+            case AxisMotion::Minus:
+                p.targetVel = -C::speed[a];
+                ao.motorEnable = true;
+                ao.motorDir = -1;
+                ao.brakeEngaged = false;
+                break;
+            }
+        }
+
+        return out;
+    }
+};
+
+// One complete PLC scan for a multi-axis mast
+
+// Derived inputs (limit switches of every axis) from the plant positions
+inline void updateMastLimitSwitches(MastInputs& in, const MastPlant& plant) {
+    updateLimitSwitches(in.lift, plant.axis[0].position);
+    for (std::size_t a = 0; a < kAuxAxes; ++a) {
+        in.aux[a].minLimit = (plant.axis[a + 1].position <= 0.0001);
+        in.aux[a].maxLimit = (plant.axis[a + 1].position >= 0.9999);
+    }
+}
+
+// Limits -> controller -> brake override on every axis; everything up to the plant step.
+inline MastOutputs controlMastScan(double dt, MastInputs& in, MastController& ctrl, MastPlant& plant) {
+    updateMastLimitSwitches(in, plant);
+
+    MastOutputs out = ctrl.update(dt, in, plant);
+
+    if (out.lift.brakeEngaged) plant.axis[0].targetVel = 0.0;
+    for (std::size_t a = 0; a < kAuxAxes; ++a) {
+        if (out.aux[a].brakeEngaged) plant.axis[a + 1].targetVel = 0.0;
+    }
+    return out;
+}
+
+// Limits -> controller -> brake override -> every axis' plant.
+inline MastOutputs scanMast(double dt, MastInputs& in, MastController& ctrl, MastPlant& plant) {
+    MastOutputs out = controlMastScan(dt, in, ctrl, plant);
+    plant.step(dt);
+    return out;
+}
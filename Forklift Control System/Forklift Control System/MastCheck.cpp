@@ -0,0 +1,307 @@
+#include "MastCheck.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "LiftFleet.h"
+#include "MastAxes.h"
+#include "MastFleet.h"
+#include "Rng.h"
+
+namespace {
+
+const double kDt = 0.02;
+const std::uint64_t kSeed = 0x3A57u;
+
+const std::size_t kTilt = auxIndex(MastAxis::Tilt);
+const std::size_t kSideShift = auxIndex(MastAxis::SideShift);
+const std::size_t kReach = auxIndex(MastAxis::Reach);
+
+// Lift cycles like the fleet mode, alternately light and heavy (over the
+// interlock load), with random holds, E-stops, overloads and resets. With
+// auxAxes, every auxiliary axis also holds a random command for 25 scans.
+MastInputs operatorInputs(std::size_t lift, std::int64_t scan, bool auxAxes) {
+    SplitMix64 rng{ streamKey(kSeed, (std::uint64_t{ lift } << 32) ^ static_cast<std::uint64_t>(scan)) };
+    const std::uint64_t s = static_cast<std::uint64_t>(scan);
+    const std::uint64_t phase = (s + lift * 37) % 400;
+    const bool heavy = (s / 400 + lift) % 2 == 1;
+
+    MastInputs in{};
+    in.lift.cmdUp = phase < 120 || rng.chance(0.02);
+    in.lift.cmdDown = (phase >= 200 && phase < 335) || rng.chance(0.02);
+    in.lift.cmdHold = rng.chance(0.01);
+    in.lift.estop = rng.chance(0.002);
+    in.lift.resetFault = phase == 399 || rng.chance(0.01);
+    in.lift.loadKg = rng.chance(0.005) ? 1.1 * DefaultMast::maxLoadKg : heavy ? 900.0 : 300.0;
+    if (auxAxes) {
+        SplitMix64 window{ streamKey(kSeed + 1, (std::uint64_t{ lift } << 32) ^ (s / 25)) };
+        for (AxisInputs& a : in.aux) {
+            const std::uint64_t c = window.next() % 8;
+            a.cmdPlus = c == 1;
+            a.cmdMinus = c == 2;
+        }
+    }
+    return in;
+}
+
+bool sameDouble(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+bool samePlant(const LiftPlant& a, const LiftPlant& b) {
+    return sameDouble(a.position, b.position) && sameDouble(a.velocity, b.velocity) &&
+           sameDouble(a.targetVel, b.targetVel);
+}
+
+bool sameOutputs(const Outputs& a, const Outputs& b) {
+    return a.motorEnable == b.motorEnable && a.motorDir == b.motorDir && a.brakeEngaged == b.brakeEngaged &&
+           a.faultLamp == b.faultLamp;
+}
+
+bool sameOutputs(const MastOutputs& a, const MastOutputs& b) {
+    bool same = sameOutputs(a.lift, b.lift) && a.liftInhibited == b.liftInhibited;
+    for (std::size_t k = 0; k < kAuxAxes; ++k) {
+        same &= a.aux[k].motorEnable == b.aux[k].motorEnable && a.aux[k].motorDir == b.aux[k].motorDir &&
+                a.aux[k].brakeEngaged == b.aux[k].brakeEngaged && a.aux[k].inhibited == b.aux[k].inhibited;
+    }
+    return same;
+}
+
+bool anyInhibited(const MastOutputs& out) {
+    bool any = out.liftInhibited;
+    for (const AxisOutputs& a : out.aux) any |= a.inhibited;
+    return any;
+}
+
+// After the control pass (positions not yet stepped): is any axis driven against an interlock?
+bool violatesInterlock(const MastInputs& in, const MastPlant& p) {
+    using C = MastAxesConfig;
+    if (!(in.lift.loadKg > C::interlockLoadKg)) return false;
+    const LiftPlant& lift = p.axis[0];
+    const LiftPlant& tilt = p.axis[kTilt + 1];
+    const LiftPlant& reach = p.axis[kReach + 1];
+    if (lift.position > C::interlockHeight && (reach.targetVel > 0.0 || tilt.targetVel < 0.0)) return true;
+    return reach.position > C::reachRetracted && lift.position >= C::interlockHeight && lift.targetVel > 0.0;
+}
+
+// Before the control pass: the reach is out under load and the lift axis can still stop at or below
+// interlockHeight, so it must never end the scan above it
+bool liftMustStayBelow(const MastInputs& in, const MastPlant& p) {
+    using C = MastAxesConfig;
+    return in.lift.loadKg > C::interlockLoadKg && p.axis[kReach + 1].position > C::reachRetracted &&
+           liftStopPosition(p.axis[0], kDt) <= C::interlockHeight;
+}
+
+// One mast driven scan by scan, for the directed cases
+struct Rig {
+    MastController ctrl{};
+    MastPlant plant{};
+    MastInputs in{};
+    MastOutputs out{};
+
+    void run(int scans) {
+        for (int k = 0; k < scans; ++k) {
+            out = scanMast(kDt, in, ctrl, plant);
+            in.lift.resetFault = false;
+        }
+    }
+
+    FaultCode fault() const { return ctrl.lift.faults.latched; }
+
+    bool allStopped() const {
+        bool stopped = true;
+        for (const LiftPlant& p : plant.axis) stopped &= p.targetVel == 0.0;
+        for (AxisMotion m : ctrl.aux) stopped &= m == AxisMotion::Stopped;
+        return stopped;
+    }
+};
+
+std::uint64_t runDirectedCases() {
+    std::uint64_t failures = 0;
+    auto expect = [&](bool ok) { failures += !ok; };
+
+    // ---- Reach driven into its end stop faults the whole mast; E-stop outranks it ----
+    {
+        Rig r;
+        r.in.aux[kReach].cmdPlus = true;
+        r.run(400);
+        expect(r.plant.axis[kReach + 1].position >= 0.9999);
+        expect(r.fault() == FaultCode::LimitViolation);
+        expect(r.ctrl.lift.state == LiftState::Faulted && r.out.lift.faultLamp && r.allStopped());
+
+        r.in.lift.estop = true;
+        r.run(1);
+        expect(r.fault() == FaultCode::EmergencyStop);
+
+        r.in.lift.estop = false;
+        r.in.aux[kReach].cmdPlus = false;
+        r.in.lift.resetFault = true;
+        r.run(1);
+        expect(r.fault() == FaultCode::None && r.ctrl.lift.state == LiftState::Holding);
+    }
+
+    // ---- A reset waits until every axis is at rest, not just the lift ----
+    {
+        Rig r;
+        r.in.aux[kSideShift].cmdPlus = true;
+        r.run(10);
+        r.in.lift.estop = true;
+        r.run(1);
+        expect(r.fault() == FaultCode::EmergencyStop && r.allStopped());
+
+        r.in.lift.estop = false;
+        r.in.aux[kSideShift].cmdPlus = false;
+        r.in.lift.resetFault = true;
+        r.run(1);
+        expect(r.fault() == FaultCode::EmergencyStop);   // side-shift still coasting
+
+        r.run(20);
+        r.in.lift.resetFault = true;
+        r.run(1);
+        expect(r.fault() == FaultCode::None);
+    }
+
+    // ---- Loaded interlocks inhibit without faulting ----
+    {
+        Rig r;
+        r.in.lift.loadKg = 900.0;
+        r.in.lift.cmdUp = true;
+        for (int k = 0; k < 200 && r.plant.axis[0].position <= 0.6; ++k) r.run(1);
+        r.in.lift.cmdUp = false;
+        r.run(10);
+
+        r.in.aux[kReach].cmdPlus = true;
+        r.in.aux[kTilt].cmdMinus = true;
+        r.run(20);
+        expect(r.out.aux[kReach].inhibited && r.out.aux[kTilt].inhibited);
+        expect(r.plant.axis[kReach + 1].position == MastAxesConfig::restPosition[kReach]);
+        expect(r.plant.axis[kTilt + 1].position == MastAxesConfig::restPosition[kTilt]);
+        expect(r.fault() == FaultCode::None);
+        r.in.aux[kReach].cmdPlus = false;
+        r.in.aux[kTilt].cmdMinus = false;
+
+        r.in.lift.cmdDown = true;
+        for (int k = 0; k < 200 && r.plant.axis[0].position >= 0.45; ++k) r.run(1);
+        r.in.lift.cmdDown = false;
+        r.run(10);
+
+        r.in.aux[kReach].cmdPlus = true;
+        r.run(20);
+        expect(!r.out.aux[kReach].inhibited && r.plant.axis[kReach + 1].position > MastAxesConfig::reachRetracted);
+        r.in.aux[kReach].cmdPlus = false;
+        r.run(10);
+
+        r.in.lift.cmdUp = true;
+        r.run(300);
+        expect(r.out.liftInhibited && r.fault() == FaultCode::None);
+        // Stopped short of the interlock height, not carried past it
+        expect(r.plant.axis[0].position <= MastAxesConfig::interlockHeight &&
+               r.plant.axis[0].position > MastAxesConfig::interlockHeight - 0.05);
+
+        r.in.lift.loadKg = 300.0;
+        r.run(30);
+        expect(!r.out.liftInhibited && r.plant.axis[0].position > 0.6);
+    }
+
+    return failures;
+}
+
+} // namespace
+
+MastCheckReport checkMastAxes(std::size_t lifts, std::int64_t scans) {
+    MastCheckReport r;
+    r.lifts = lifts;
+    r.scans = scans;
+    if (lifts == 0 || scans <= 0) {
+        r.error = "lifts and scans must be > 0";
+        return r;
+    }
+
+    // ---- Idle auxiliary axes: the lift axis is a plain LiftFleet lift ----
+    {
+        LiftFleet plain(lifts);
+        MastFleet mast(lifts);
+        for (std::int64_t s = 0; s < scans; ++s) {
+            for (std::size_t i = 0; i < lifts; ++i) {
+                mast.inputs[i] = operatorInputs(i, s, false);
+                plain.inputs[i] = mast.inputs[i].lift;
+            }
+            plain.scan(kDt);
+            mast.scan(kDt);
+
+            for (std::size_t i = 0; i < lifts; ++i) {
+                const MastPlant p = mast.plant(i);
+                LiftPlant expected{};
+                expected.position = plain.position[i];
+                expected.velocity = plain.velocity[i];
+                expected.targetVel = plain.targetVel[i];
+                const bool same = samePlant(p.axis[0], expected) && mast.state[i] == plain.state[i] &&
+                                  mast.latched[i] == plain.latched[i] &&
+                                  sameOutputs(mast.outputs[i].lift, plain.outputs[i]) &&
+                                  !mast.outputs[i].liftInhibited;
+                r.liftMismatches += !same;
+                for (std::size_t a = 0; a < kAuxAxes; ++a) {
+                    r.idleAxesMoved += p.axis[a + 1].position != MastAxesConfig::restPosition[a] ||
+                                       p.axis[a + 1].velocity != 0.0;
+                }
+            }
+        }
+    }
+
+    // ---- Every axis commanded: fleet against lone masts, interlocks never crossed ----
+    MastFleet fleet(lifts);
+    std::vector<MastController> ctrls(lifts);
+    std::vector<MastPlant> plants(lifts);
+    std::vector<MastInputs> ins(lifts);
+    std::vector<MastOutputs> outs(lifts);
+    for (std::int64_t s = 0; s < scans; ++s) {
+        for (std::size_t i = 0; i < lifts; ++i) {
+            fleet.inputs[i] = ins[i] = operatorInputs(i, s, true);
+            const bool stayBelow = liftMustStayBelow(ins[i], plants[i]);
+            outs[i] = controlMastScan(kDt, ins[i], ctrls[i], plants[i]);
+            r.interlockViolations += violatesInterlock(ins[i], plants[i]);
+            r.inhibitedScans += anyInhibited(outs[i]);
+            r.faultedScans += ctrls[i].lift.state == LiftState::Faulted;
+            plants[i].step(kDt);
+            r.interlockViolations += stayBelow && plants[i].axis[0].position > MastAxesConfig::interlockHeight;
+        }
+        fleet.scan(kDt);
+
+        for (std::size_t i = 0; i < lifts; ++i) {
+            const MastPlant p = fleet.plant(i);
+            bool same = fleet.state[i] == ctrls[i].lift.state && fleet.latched[i] == ctrls[i].lift.faults.latched &&
+                        sameOutputs(fleet.outputs[i], outs[i]);
+            for (std::size_t a = 0; a < kMastAxes; ++a) same &= samePlant(p.axis[a], plants[i].axis[a]);
+            for (std::size_t a = 0; a < kAuxAxes; ++a) same &= fleet.motion[a * lifts + i] == ctrls[i].aux[a];
+            r.fleetMismatches += !same;
+        }
+    }
+
+    r.directedFailures = runDirectedCases();
+
+    // ---- Throughput with the last scan's commands held ----
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point t0 = Clock::now();
+    for (std::int64_t s = 0; s < scans; ++s) fleet.scan(kDt);
+    const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.mastScansPerSecond = secs > 0.0 ? static_cast<double>(lifts) * static_cast<double>(scans) / secs : 0.0;
+    return r;
+}
+
+void printMastCheckReport(std::ostream& os, const MastCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "mast-check: " << r.error << "\n";
+        return;
+    }
+    os << "mast-check: lifts=" << r.lifts << " scans=" << r.scans << " axes=" << kMastAxes << "\n"
+        << "  idle axes, lift vs LiftFleet: mismatches=" << r.liftMismatches << " idle axes moved=" << r.idleAxesMoved
+        << "\n"
+        << "  all axes, fleet vs scanMast: mismatches=" << r.fleetMismatches << "\n"
+        << "  interlocks: violations=" << r.interlockViolations << " inhibited lift-scans=" << r.inhibitedScans
+        << " faulted lift-scans=" << r.faultedScans << "\n"
+        << "  directed fault/interlock cases failed=" << r.directedFailures << "\n"
+        << std::fixed << std::setprecision(0)
+        << "  mast-scans/s: " << r.mastScansPerSecond << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Checks MastFleet against LiftFleet with the auxiliary axes idle and
+// against scanMast() with random commands on every axis, counting moves
+// made against an interlock or carried past its height. Directed cases
+// cover the shared fault latch, E-stop priority and reset at rest.
+
+struct MastCheckReport {
+    std::size_t lifts = 0;
+    std::int64_t scans = 0;
+    std::uint64_t liftMismatches = 0;       // idle auxiliary axes: lift axis differs from LiftFleet (must be 0)
+    std::uint64_t idleAxesMoved = 0;        // idle auxiliary axes left their rest position (must be 0)
+    std::uint64_t fleetMismatches = 0;      // MastFleet differs from scanMast() per lift (must be 0)
+    std::uint64_t interlockViolations = 0;  // an axis commanded against an active interlock (must be 0)
+    std::uint64_t inhibitedScans = 0;       // lift-scans with a command inhibited (must be > 0)
+    std::uint64_t faultedScans = 0;         // lift-scans Faulted with random commands (must be > 0)
+    std::uint64_t directedFailures = 0;     // directed fault and interlock cases (must be 0)
+    double mastScansPerSecond = 0.0;        // MastFleet, four axes per mast
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && liftMismatches == 0 && idleAxesMoved == 0 && fleetMismatches == 0 &&
+               interlockViolations == 0 && inhibitedScans > 0 && faultedScans > 0 && directedFailures == 0;
+    }
+};
+
+MastCheckReport checkMastAxes(std::size_t lifts, std::int64_t scans);
+
+void printMastCheckReport(std::ostream& os, const MastCheckReport& r);
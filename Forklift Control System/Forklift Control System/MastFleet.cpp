@@ -0,0 +1,70 @@
+#include "MastFleet.h"
+
+#include "PlantKernels.h"
+
+void MastFleet::resize(std::size_t count) {
+    const MastPlant plantInit{};
+    const MastController ctrlInit{};
+
+    position.assign(kMastAxes * count, 0.0);
+    velocity.assign(kMastAxes * count, 0.0);
+    targetVel.assign(kMastAxes * count, 0.0);
+    for (std::size_t a = 0; a < kMastAxes; ++a) {
+        for (std::size_t i = 0; i < count; ++i) {
+            position[a * count + i] = plantInit.axis[a].position;
+            velocity[a * count + i] = plantInit.axis[a].velocity;
+            targetVel[a * count + i] = plantInit.axis[a].targetVel;
+        }
+    }
+    state.assign(count, ctrlInit.lift.state);
+    latched.assign(count, ctrlInit.lift.faults.latched);
+    motion.assign(kAuxAxes * count, AxisMotion::Stopped);
+    inputs.assign(count, MastInputs{});
+    outputs.assign(count, MastOutputs{});
+    if (kCountersEnabled) dwell.assign(count, 0);
+}
+
+MastPlant MastFleet::plant(std::size_t lift) const {
+    MastPlant p;
+    for (std::size_t a = 0; a < kMastAxes; ++a) {
+        const std::size_t k = a * size() + lift;
+        p.axis[a].position = position[k];
+        p.axis[a].velocity = velocity[k];
+        p.axis[a].targetVel = targetVel[k];
+    }
+    return p;
+}
+
+void MastFleet::scan(double dt) {
+    const std::size_t n = size();
+    if (n == 0) return;
+
+    // ---- Pass 1: limits, controller, brake override (per lift, all axes) ----
+    // Same scratch-load/store scheme as LiftFleet; only targetVel changes
+    // before the plant step, so only it is written back.
+    MastController ctrl{};
+    MastPlant plant{};
+    LiftCounters* const aggregate = kCountersEnabled ? &threadCounters() : nullptr;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t a = 0; a < kMastAxes; ++a) {
+            plant.axis[a].position = position[a * n + i];
+            plant.axis[a].velocity = velocity[a * n + i];
+            plant.axis[a].targetVel = targetVel[a * n + i];
+        }
+        ctrl.lift.state = state[i];
+        ctrl.lift.faults.latched = latched[i];
+        for (std::size_t a = 0; a < kAuxAxes; ++a) ctrl.aux[a] = motion[a * n + i];
+        if constexpr (kCountersEnabled) selectScanCounters(aggregate, &dwell[i]);
+
+        outputs[i] = controlMastScan(dt, inputs[i], ctrl, plant);
+
+        for (std::size_t a = 0; a < kMastAxes; ++a) targetVel[a * n + i] = plant.axis[a].targetVel;
+        state[i] = ctrl.lift.state;
+        latched[i] = ctrl.lift.faults.latched;
+        for (std::size_t a = 0; a < kAuxAxes; ++a) motion[a * n + i] = ctrl.aux[a];
+    }
+    selectScanCounters(nullptr, nullptr);
+
+    // ---- Pass 2: every axis of every lift in one batched plant step ----
+    stepPlants(position.data(), velocity.data(), targetVel.data(), kMastAxes * n, dt);
+}
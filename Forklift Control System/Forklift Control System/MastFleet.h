@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MastAxes.h"
+
+// Fleet of multi-axis masts stepped together, one PLC scan for every mast per call.
+//
+// The plant state of all axes is kept axis-major in one array per field:
+// axis a of lift i sits at [a * size() + i], so the lift axes come first
+// and lay out exactly like LiftFleet's. Each scan runs controlMastScan()
+// per lift and then steps every axis of every lift in a single batched
+// PlantKernels pass, so lift i matches a lone MastController/MastPlant fed
+// the same MastInputs through scanMast() bit for bit.
+
+struct MastFleet {
+    // Plant state, axis-major (kMastAxes * size() values each)
+    std::vector<double> position;
+    std::vector<double> velocity;
+    std::vector<double> targetVel;
+
+    // Controller state: the lift state machine and latch, and the other axes' motion
+    // (auxiliary axis a of lift i at [a * size() + i])
+    std::vector<LiftState> state;
+    std::vector<FaultCode> latched;
+    std::vector<AxisMotion> motion;
+
+    // Scan I/O (inputs are written by the caller before scan())
+    std::vector<MastInputs> inputs;
+    std::vector<MastOutputs> outputs;
+
+    // FORKLIFT_COUNTERS builds: scans in the current lift state, per lift
+    std::vector<std::uint32_t> dwell;
+
+    MastFleet() = default;
+    explicit MastFleet(std::size_t count) { resize(count); }
+
+    std::size_t size() const { return state.size(); }
+
+    // Resize the fleet; every lift starts like a fresh MastPlant/MastController.
+    void resize(std::size_t count);
+
+    // Index of axis a of lift i in position/velocity/targetVel
+    std::size_t at(MastAxis a, std::size_t lift) const { return static_cast<std::size_t>(a) * size() + lift; }
+
+    // One scan for every lift. inputs[] are left as the controller saw them
+    // (limits included), so the caller owns the resetFault pulse.
+    void scan(double dt);
+
+    // Lift i's plant state as a MastPlant
+    MastPlant plant(std::size_t lift) const;
+};
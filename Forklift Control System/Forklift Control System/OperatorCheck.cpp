@@ -0,0 +1,304 @@
+#include "OperatorCheck.h"
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "Console.h"
+#include "LiftFleet.h"
+#include "OperatorScript.h"
+#include "Rng.h"
+
+namespace {
+
+const double kDt = 0.02;
+const int kCycles = 4;
+const double kFloor = 0.05;          // lowered to here, clear of the bottom limit
+const double kOverload = 1300.0;
+const std::int64_t kTailScans = 50;  // after the last script finished
+const std::uint64_t kSeed = 0x0915;
+
+struct Cycle {
+    double height;
+    double load;
+};
+
+Cycle drawCycle(SplitMix64& rng) {
+    const double height = 0.2 + 0.7 * static_cast<double>(rng.next() % 1000) / 1000.0;
+    const double load = static_cast<double>(rng.next() % 1400);   // over 1200 kg faults
+    return { height, load };
+}
+
+std::int64_t drawPause(SplitMix64& rng, std::uint64_t range) {
+    return 1 + static_cast<std::int64_t>(rng.next() % range);
+}
+
+OperatorTask palletCycles(Operator op, std::uint64_t seed) {
+    SplitMix64 rng{ streamKey(seed, op.lift()) };
+    co_await op.scans(drawPause(rng, 100));
+    for (int c = 0; c < kCycles; ++c) {
+        const Cycle cycle = drawCycle(rng);
+        op.goTo(cycle.height);
+        if (!co_await op.state(LiftState::Holding, 1500)) op.stop();
+
+        op.setLoad(cycle.load);
+        if (co_await op.fault(10)) {
+            op.setLoad(0.0);
+            op.stop();
+            op.reset();
+            co_await op.state(LiftState::Holding, 100);
+        }
+
+        if (c % 4 == 3) {
+            op.toggleEstop();
+            co_await op.stateChange(50);
+            co_await op.scans(10);
+            op.toggleEstop();
+            op.reset();
+            co_await op.state(LiftState::Holding, 100);
+        }
+
+        op.down();
+        co_await op.reach(kFloor, 2000);
+        op.stop();
+        co_await op.scans(drawPause(rng, 50));
+    }
+
+    // Last act: a reset pulse, which the executor must still drop
+    op.setLoad(kOverload);
+    co_await op.fault(10);
+    op.setLoad(0.0);
+    op.reset();
+}
+
+// ---- The same script as an explicit state machine ----
+
+enum class Step : std::uint8_t {
+    Start,      // initial pause
+    Cycle,      // next cycle, or the end
+    Arrived,    // waited for Holding after the go-to
+    Loaded,     // waited for a fault after the pallet went on
+    Cleared,    // past the overload reset
+    Estopped,   // waited for the emergency stop to show
+    Released,   // paused with the emergency stop in
+    Lower,
+    Lowered,    // waited to reach the floor
+    Paused,     // end of cycle
+    Overloaded, // waited for the final overload
+    Done,
+};
+
+enum class Until : std::uint8_t { Scans, State, StateChange, Fault, Floor };
+
+struct ReferenceLift {
+    SplitMix64 rng;
+    Cycle cycle{};
+    int c = 0;
+    Step step = Step::Start;
+    Until until = Until::Scans;
+    LiftState state = LiftState::Holding;
+    bool rising = false;
+    std::int64_t deadline = 0;
+};
+
+struct ReferenceFleet {
+    LiftFleet fleet;
+    std::vector<ReferenceLift> lifts;
+    std::int64_t now = 0;
+
+    explicit ReferenceFleet(std::size_t count) : fleet(count), lifts(count) {
+        for (std::size_t i = 0; i < count; ++i) lifts[i].rng.state = streamKey(kSeed, i);
+    }
+
+    void command(std::size_t i, CommandVerb verb, double value = 0.0) {
+        applyCommand(Command{ verb, value }, fleet.inputs[i]);
+    }
+
+    void wait(ReferenceLift& l, Step next, Until until, std::int64_t timeout, LiftState s = LiftState::Holding) {
+        l.step = next;
+        l.until = until;
+        l.state = s;
+        l.deadline = now + timeout;
+    }
+
+    bool met(const ReferenceLift& l, std::size_t i) const {
+        switch (l.until) {
+        case Until::Scans: return now >= l.deadline;
+        case Until::State: return fleet.state[i] == l.state;
+        case Until::StateChange: return fleet.state[i] != l.state;
+        case Until::Fault: return fleet.latched[i] != FaultCode::None;
+        case Until::Floor: return l.rising ? fleet.position[i] >= kFloor - 1e-3 : fleet.position[i] <= kFloor + 1e-3;
+        }
+        return false;
+    }
+
+    // Runs lift i from its last wait to its next one, or to the end
+    void advance(std::size_t i, bool ok) {
+        ReferenceLift& l = lifts[i];
+        for (;;) {
+            switch (l.step) {
+            case Step::Start:
+                wait(l, Step::Cycle, Until::Scans, drawPause(l.rng, 100));
+                return;
+            case Step::Cycle:
+                if (l.c == kCycles) {
+                    command(i, CommandVerb::SetLoad, kOverload);
+                    wait(l, Step::Overloaded, Until::Fault, 10);
+                    return;
+                }
+                l.cycle = drawCycle(l.rng);
+                command(i, CommandVerb::GoTo, l.cycle.height);
+                wait(l, Step::Arrived, Until::State, 1500);
+                return;
+            case Step::Arrived:
+                if (!ok) command(i, CommandVerb::Stop);
+                command(i, CommandVerb::SetLoad, l.cycle.load);
+                wait(l, Step::Loaded, Until::Fault, 10);
+                return;
+            case Step::Loaded:
+                l.step = Step::Cleared;
+                if (ok) {
+                    command(i, CommandVerb::SetLoad, 0.0);
+                    command(i, CommandVerb::Stop);
+                    command(i, CommandVerb::Reset);
+                    wait(l, Step::Cleared, Until::State, 100);
+                    return;
+                }
+                break;
+            case Step::Cleared:
+                l.step = Step::Lower;
+                if (l.c % 4 == 3) {
+                    command(i, CommandVerb::ToggleEstop);
+                    wait(l, Step::Estopped, Until::StateChange, 50, fleet.state[i]);
+                    return;
+                }
+                break;
+            case Step::Estopped:
+                wait(l, Step::Released, Until::Scans, 10);
+                return;
+            case Step::Released:
+                command(i, CommandVerb::ToggleEstop);
+                command(i, CommandVerb::Reset);
+                wait(l, Step::Lower, Until::State, 100);
+                return;
+            case Step::Lower:
+                command(i, CommandVerb::Down);
+                l.rising = fleet.position[i] <= kFloor;
+                wait(l, Step::Lowered, Until::Floor, 2000);
+                return;
+            case Step::Lowered:
+                command(i, CommandVerb::Stop);
+                wait(l, Step::Paused, Until::Scans, drawPause(l.rng, 50));
+                return;
+            case Step::Paused:
+                l.c++;
+                l.step = Step::Cycle;
+                break;
+            case Step::Overloaded:
+                command(i, CommandVerb::SetLoad, 0.0);
+                command(i, CommandVerb::Reset);
+                l.step = Step::Done;
+                return;
+            case Step::Done:
+                return;
+            }
+        }
+    }
+
+    void resume() {
+        for (Inputs& in : fleet.inputs) in.resetFault = false;
+        for (std::size_t i = 0; i < lifts.size(); ++i) {
+            ReferenceLift& l = lifts[i];
+            if (l.step == Step::Done) continue;
+            const bool ok = met(l, i);
+            if (!ok && now < l.deadline) continue;
+            advance(i, ok);
+        }
+    }
+};
+
+bool sameInputs(const Inputs& a, const Inputs& b) {
+    return a.cmdUp == b.cmdUp && a.cmdDown == b.cmdDown && a.cmdHold == b.cmdHold && a.cmdGoTo == b.cmdGoTo &&
+           a.estop == b.estop && a.resetFault == b.resetFault && a.topLimit == b.topLimit &&
+           a.bottomLimit == b.bottomLimit && a.loadKg == b.loadKg && a.targetPosition == b.targetPosition;
+}
+
+bool sameLift(const LiftFleet& a, const LiftFleet& b, std::size_t i) {
+    return a.position[i] == b.position[i] && a.velocity[i] == b.velocity[i] && a.targetVel[i] == b.targetVel[i] &&
+           a.state[i] == b.state[i] && a.latched[i] == b.latched[i] && sameInputs(a.inputs[i], b.inputs[i]);
+}
+
+} // namespace
+
+OperatorCheckReport checkOperatorScripts(std::size_t operators, std::int64_t scans) {
+    OperatorCheckReport r;
+    r.operators = operators;
+    r.scans = scans;
+    if (operators == 0 || scans <= 0) {
+        r.error = "operators and scans must be > 0";
+        return r;
+    }
+
+    LiftFleet fleet(operators);
+    OperatorExecutor executor(fleet);
+    for (std::size_t i = 0; i < operators; ++i) executor.spawn(i, palletCycles, kSeed);
+    r.frameBytes = executor.stats().frameBytes;
+    ReferenceFleet reference(operators);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::duration scripted{};
+    Clock::duration stepped{};
+    std::vector<FaultCode> last(operators, FaultCode::None);
+    std::int64_t tail = 0;
+    while (r.scansRun < scans && tail < kTailScans) {
+        tail += executor.done();
+        const Clock::time_point t0 = Clock::now();
+        executor.resume();
+        const Clock::time_point t1 = Clock::now();
+        reference.resume();
+        const Clock::time_point t2 = Clock::now();
+        scripted += t1 - t0;
+        stepped += t2 - t1;
+
+        fleet.scan(kDt);
+        executor.endScan();
+        reference.fleet.scan(kDt);
+        reference.now++;
+        r.scansRun++;
+
+        for (std::size_t i = 0; i < operators; ++i) {
+            r.mismatches += !sameLift(fleet, reference.fleet, i);
+            r.faults += fleet.latched[i] != FaultCode::None && last[i] == FaultCode::None;
+            last[i] = fleet.latched[i];
+        }
+    }
+
+    r.spawned = executor.stats().spawned;
+    r.finished = executor.stats().finished;
+    r.resumes = executor.stats().resumes;
+    r.scriptSeconds = std::chrono::duration<double>(scripted).count();
+    r.referenceSeconds = std::chrono::duration<double>(stepped).count();
+    for (const ReferenceLift& l : reference.lifts) r.mismatches += l.step != Step::Done;
+    for (const Inputs& in : fleet.inputs) r.stuckResets += in.resetFault;
+    return r;
+}
+
+void printOperatorCheckReport(std::ostream& os, const OperatorCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "operator-check: " << r.error << "\n";
+        return;
+    }
+    const double operators = r.operators > 0 ? static_cast<double>(r.operators) : 1.0;
+    const double liftScans = operators * static_cast<double>(r.scansRun > 0 ? r.scansRun : 1);
+    os << "operator-check: operators=" << r.operators << " scans=" << r.scansRun << " (limit " << r.scans << ")\n"
+        << "  scripts: spawned=" << r.spawned << " finished=" << r.finished << " resumes=" << r.resumes
+        << " faults=" << r.faults << "\n"
+        << "  vs state machines: mismatches=" << r.mismatches << " stuck resets=" << r.stuckResets << "\n"
+        << std::fixed << std::setprecision(1)
+        << "  bytes/operator: frame=" << static_cast<double>(r.frameBytes) / operators
+        << " wait record=" << sizeof(OperatorWaitRecord) << "\n"
+        << "  ns/operator-scan: scripts=" << r.scriptSeconds * 1e9 / liftScans
+        << " state machines=" << r.referenceSeconds * 1e9 / liftScans << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
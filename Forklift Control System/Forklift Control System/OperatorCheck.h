@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Runs the same pallet-cycle coroutine (OperatorScript.h) on every lift and
+// a hand-written state machine alongside it; the two fleets must match
+// after every scan, every script must finish, and no lift may keep its
+// reset input set afterwards.
+
+struct OperatorCheckReport {
+    std::size_t operators = 0;
+    std::int64_t scans = 0;              // limit
+    std::int64_t scansRun = 0;           // until every script finished
+    std::uint64_t mismatches = 0;        // lift-scans where the fleets differ (must be 0)
+    std::size_t spawned = 0;
+    std::size_t finished = 0;            // must be spawned
+    std::uint64_t resumes = 0;
+    std::uint64_t faults = 0;            // fault latches seen, overload and emergency stop
+    std::uint64_t stuckResets = 0;       // lifts with resetFault still set at the end (must be 0)
+    std::uint64_t frameBytes = 0;        // all frames, right after spawning
+    double scriptSeconds = 0.0;          // OperatorExecutor::resume()
+    double referenceSeconds = 0.0;       // the state machines
+    std::string error;
+
+    bool passed() const {
+        return error.empty() && mismatches == 0 && stuckResets == 0 && finished == spawned && spawned == operators;
+    }
+};
+
+OperatorCheckReport checkOperatorScripts(std::size_t operators, std::int64_t scans);
+
+void printOperatorCheckReport(std::ostream& os, const OperatorCheckReport& r);
@@ -0,0 +1,67 @@
+#include "OperatorInput.h"
+
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include <string>
+
+OperatorInput::OperatorInput(std::istream& is, std::ostream& os, const LiftSnapshotRing* snapshots)
+    : is_(is), os_(os), snapshots_(snapshots) {
+}
+
+OperatorInput::~OperatorInput() {
+    // The reader only stops after sending Quit (typed or end of input),
+    // which is also the only way the scan loop ends.
+    if (thread_.joinable()) thread_.join();
+}
+
+void OperatorInput::start() {
+    thread_ = std::thread([this] { run(); });
+}
+
+void OperatorInput::send(const Command& cmd) {
+    // Operator input is slow; a full ring means the scan loop is stalled, so just wait it out here.
+    while (!ring_.push(cmd)) {
+        retries_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void OperatorInput::run() {
+    std::string line;
+    for (;;) {
+        os_ << "> " << std::flush;
+        if (!std::getline(is_, line)) {
+            // End of input: nothing can ever arrive again, treat as quit.
+            Command quit{};
+            quit.verb = CommandVerb::Quit;
+            send(quit);
+            return;
+        }
+
+        Command cmd{};
+        const ParseStatus st = parseCommand(line, cmd);
+        if (st == ParseStatus::BadLoad) {
+            os_ << "Bad load value.\n";
+            continue;
+        }
+        if (st == ParseStatus::BadPosition) {
+            os_ << "Bad position value.\n";
+            continue;
+        }
+        if (st == ParseStatus::Unknown) {
+            os_ << "Unknown command. Type 'help'.\n";
+            continue;
+        }
+
+        if (cmd.verb == CommandVerb::Snapshot) {
+            LiftSnapshot s{};
+            if (snapshots_ && snapshots_->read(s) != 0) printLiftSnapshot(os_, s);
+            else os_ << "No snapshot yet.\n";
+            continue;
+        }
+
+        send(cmd);
+        if (cmd.verb == CommandVerb::Quit) return;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <thread>
+
+#include "Console.h"
+#include "LiftSnapshot.h"
+#include "SpscRing.h"
+
+// Operator console input on its own thread.
+//
+// The reader thread blocks on std::getline, parses each line with
+// parseCommand() and pushes the result through an SPSC ring. The scan
+// thread drains the ring with poll() at the top of every cycle, so it never
+// waits on I/O and an E-stop or reset is seen within one scan.
+// Parse errors are reported by the reader thread itself, and so is 'p': it
+// prints the newest LiftSnapshot the scan loop published, without a round
+// trip through the scan thread.
+
+class OperatorInput {
+public:
+    // snapshots may be null ('p' then reports that there are none)
+    OperatorInput(std::istream& is, std::ostream& os, const LiftSnapshotRing* snapshots = nullptr);
+    ~OperatorInput();
+
+    OperatorInput(const OperatorInput&) = delete;
+    OperatorInput& operator=(const OperatorInput&) = delete;
+
+    void start();
+
+    // Next pending command, if any. Scan thread only; never blocks.
+    bool poll(Command& cmd) { return ring_.pop(cmd); }
+
+    // Commands the reader had to retry because the ring was full
+    std::uint64_t retries() const { return retries_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void send(const Command& cmd);
+
+    std::istream& is_;
+    std::ostream& os_;
+    const LiftSnapshotRing* snapshots_;
+    std::thread thread_;
+    std::atomic<std::uint64_t> retries_{ 0 };
+    SpscRing<Command, 64> ring_;
+};
@@ -0,0 +1,122 @@
+#include "OperatorScript.h"
+
+#include <exception>
+#include <new>
+
+namespace {
+
+// Frame size of the coroutine being created: operator new runs just
+// before get_return_object(), on the same thread
+thread_local std::size_t lastFrameBytes = 0;
+
+} // namespace
+
+void* OperatorTask::promise_type::operator new(std::size_t bytes) {
+    lastFrameBytes = bytes;
+    return ::operator new(bytes);
+}
+
+void OperatorTask::promise_type::operator delete(void* p, std::size_t bytes) {
+    ::operator delete(p, bytes);
+}
+
+OperatorTask OperatorTask::promise_type::get_return_object() {
+    frameBytes = static_cast<std::uint32_t>(lastFrameBytes);
+    return OperatorTask(Handle::from_promise(*this));
+}
+
+void OperatorTask::promise_type::unhandled_exception() noexcept {
+    std::terminate();
+}
+
+OperatorWait Operator::wait(OperatorWaitKind kind, std::int64_t timeoutScans) const {
+    OperatorWaitRecord w;
+    w.kind = kind;
+    w.deadline = timeoutScans;
+    return OperatorWait(ex_, slot_, w);
+}
+
+OperatorWait Operator::scans(std::int64_t n) const {
+    return wait(OperatorWaitKind::Scans, n);
+}
+
+OperatorWait Operator::state(LiftState s, std::int64_t timeoutScans) const {
+    OperatorWait w = wait(OperatorWaitKind::State, timeoutScans);
+    w.wait_.state = static_cast<std::uint8_t>(s);
+    return w;
+}
+
+OperatorWait Operator::stateChange(std::int64_t timeoutScans) const {
+    OperatorWait w = wait(OperatorWaitKind::StateChange, timeoutScans);
+    w.wait_.state = static_cast<std::uint8_t>(state());
+    return w;
+}
+
+OperatorWait Operator::fault(std::int64_t timeoutScans) const {
+    return wait(OperatorWaitKind::Fault, timeoutScans);
+}
+
+OperatorWait Operator::reach(double target, std::int64_t timeoutScans, double tolerance) const {
+    // Met once direction * position >= direction * target - tolerance:
+    // within tolerance on the way there, or anywhere past it.
+    OperatorWait w = wait(OperatorWaitKind::Reach, timeoutScans);
+    w.wait_.direction = position() <= target ? 1 : -1;
+    w.wait_.threshold = w.wait_.direction * target - tolerance;
+    return w;
+}
+
+OperatorExecutor::~OperatorExecutor() {
+    for (OperatorWaitRecord& w : waits_) {
+        if (w.handle) w.handle.destroy();
+    }
+}
+
+std::uint32_t OperatorExecutor::addSlot(std::size_t lift) {
+    OperatorWaitRecord w;
+    w.lift = static_cast<std::uint32_t>(lift);
+    w.kind = OperatorWaitKind::Scans;
+    w.deadline = now_;   // first runs on the next resume()
+    waits_.push_back(w);
+    return static_cast<std::uint32_t>(waits_.size() - 1);
+}
+
+void OperatorExecutor::adopt(std::uint32_t slot, OperatorTask task) {
+    const OperatorTask::Handle h = task.release();
+    waits_[slot].handle = h;
+    stats_.spawned++;
+    stats_.frameBytes += h.promise().frameBytes;
+}
+
+void OperatorExecutor::resume() {
+    // The reset pulse is dropped first, so any script this scan can raise it;
+    // finished scripts too, in case their last act was a reset
+    for (const OperatorWaitRecord& w : waits_) fleet_.inputs[w.lift].resetFault = false;
+
+    // Scripts spawned from here on first run on the next scan
+    const std::size_t n = waits_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        OperatorWaitRecord& w = waits_[i];
+        bool met = false;
+        switch (w.kind) {
+        case OperatorWaitKind::Running: continue;
+        case OperatorWaitKind::Scans: met = now_ >= w.deadline; break;
+        case OperatorWaitKind::State: met = fleet_.state[w.lift] == static_cast<LiftState>(w.state); break;
+        case OperatorWaitKind::StateChange: met = fleet_.state[w.lift] != static_cast<LiftState>(w.state); break;
+        case OperatorWaitKind::Fault: met = fleet_.latched[w.lift] != FaultCode::None; break;
+        case OperatorWaitKind::Reach: met = w.direction * fleet_.position[w.lift] >= w.threshold; break;
+        }
+        if (!met && now_ < w.deadline) continue;
+
+        w.met = met;
+        w.kind = OperatorWaitKind::Running;
+        const OperatorTask::Handle h = w.handle;
+        h.resume();   // until the script's next co_await; it may spawn, so w is not used after this
+        stats_.resumes++;
+        if (h.done()) {
+            stats_.finished++;
+            stats_.frameBytes -= h.promise().frameBytes;
+            h.destroy();
+            waits_[i].handle = {};
+        }
+    }
+}
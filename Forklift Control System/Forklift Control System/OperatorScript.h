@@ -0,0 +1,239 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Console.h"
+#include "LiftControl.h"
+#include "LiftFleet.h"
+
+// Operator behavior as sequential C++20 coroutines, many per thread.
+//
+// A script is a coroutine returning OperatorTask that issues commands to
+// its lift and suspends until something happens:
+//
+//     OperatorTask palletRun(Operator op, double height) {
+//         op.goTo(height);
+//         co_await op.state(LiftState::Holding);   // arrived
+//         op.setLoad(900.0);
+//         op.down();
+//         co_await op.reach(0.0);
+//         op.stop();
+//     }
+//
+//     executor.spawn(lift, palletRun, 0.6);
+//
+// OperatorExecutor runs every script of a LiftFleet on the scan thread.
+// Each scan it drops the reset pulses, checks every suspended script's
+// wait against the fleet state of the last scan and resumes the ones that
+// are due (in spawn order), then scans the fleet, so commands a script
+// issues take effect on that scan. A waiting script costs its condition
+// check per scan and nothing else; its state is the coroutine frame plus
+// one 32-byte wait record.
+//
+// Waits on a condition always suspend: the condition is checked from the
+// next scan on, so a wait right after a command sees the command's effect
+// rather than the state before it. With a timeout, co_await gives false if
+// the condition did not hold by timeout scans later. Arguments are copied
+// into the coroutine frame; don't spawn a lambda with captures, they die
+// with the lambda.
+
+class OperatorExecutor;
+
+class OperatorTask {
+public:
+    struct promise_type {
+        std::uint32_t frameBytes = 0;
+
+        static void* operator new(std::size_t bytes);
+        static void operator delete(void* p, std::size_t bytes);
+
+        OperatorTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    OperatorTask() = default;
+    explicit OperatorTask(Handle h) : handle_(h) {}
+    OperatorTask(OperatorTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    OperatorTask& operator=(OperatorTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~OperatorTask() { if (handle_) handle_.destroy(); }
+
+    // Hands the frame over (to the executor)
+    Handle release() { return std::exchange(handle_, {}); }
+
+private:
+    Handle handle_{};
+};
+
+inline constexpr std::int64_t kNoTimeout = std::numeric_limits<std::int64_t>::max();
+
+enum class OperatorWaitKind : std::uint8_t {
+    Scans,        // until the deadline
+    State,        // state == value
+    StateChange,  // state != value (the state when the wait began)
+    Fault,        // a fault latched
+    Reach,        // position within tolerance of, or past, the target
+    Running,      // not waiting: resumed, or finished
+};
+
+// What a suspended script waits for, and until when
+struct OperatorWaitRecord {
+    double threshold = 0.0;                      // Reach: direction * position >= threshold
+    std::int64_t deadline = kNoTimeout;          // scan it resumes on at the latest
+    OperatorTask::Handle handle{};
+    std::uint32_t lift = 0;
+    OperatorWaitKind kind = OperatorWaitKind::Running;
+    std::uint8_t state = 0;                      // State, StateChange: LiftState
+    std::int8_t direction = 1;                   // Reach: +1 = rising to the target
+    bool met = false;                            // the last wait's result
+};
+static_assert(sizeof(OperatorWaitRecord) == 32, "one wait record per script");
+
+// The awaitable of every wait; co_await gives true if the condition held
+class OperatorWait {
+public:
+    OperatorWait(OperatorExecutor* ex, std::uint32_t slot, const OperatorWaitRecord& wait)
+        : ex_(ex), slot_(slot), wait_(wait) {}
+
+    bool await_ready() const noexcept { return wait_.kind == OperatorWaitKind::Scans && wait_.deadline <= 0; }
+    void await_suspend(std::coroutine_handle<>) const noexcept;
+    bool await_resume() const noexcept;
+
+private:
+    friend class Operator;
+
+    OperatorExecutor* ex_;
+    std::uint32_t slot_;
+    OperatorWaitRecord wait_;   // deadline relative to the current scan
+};
+
+// A script's handle on its lift; cheap to copy
+class Operator {
+public:
+    Operator(OperatorExecutor* ex, std::uint32_t slot) : ex_(ex), slot_(slot) {}
+
+    std::size_t lift() const;
+    std::int64_t scan() const;            // the scan about to run
+
+    // The lift after the last scan
+    double position() const;
+    LiftState state() const;
+    FaultCode fault() const;
+    const Inputs& inputs() const;
+
+    // Console commands (applyCommand()); they take effect on this scan
+    void command(CommandVerb verb, double value = 0.0);
+    void up() { command(CommandVerb::Up); }
+    void down() { command(CommandVerb::Down); }
+    void hold() { command(CommandVerb::Hold); }
+    void stop() { command(CommandVerb::Stop); }
+    void toggleEstop() { command(CommandVerb::ToggleEstop); }
+    void reset() { command(CommandVerb::Reset); }
+    void setLoad(double kg) { command(CommandVerb::SetLoad, kg); }
+    void goTo(double position) { command(CommandVerb::GoTo, position); }
+
+    // Awaitables
+    OperatorWait scans(std::int64_t n) const;    // resume n scans later; 0 = don't suspend
+    OperatorWait state(LiftState s, std::int64_t timeoutScans = kNoTimeout) const;
+    OperatorWait stateChange(std::int64_t timeoutScans = kNoTimeout) const;
+    OperatorWait fault(std::int64_t timeoutScans = kNoTimeout) const;
+    OperatorWait reach(double position, std::int64_t timeoutScans = kNoTimeout, double tolerance = 1e-3) const;
+
+private:
+    OperatorWait wait(OperatorWaitKind kind, std::int64_t timeoutScans) const;
+
+    OperatorExecutor* ex_;
+    std::uint32_t slot_;
+};
+
+struct OperatorExecutorStats {
+    std::size_t spawned = 0;
+    std::size_t finished = 0;
+    std::uint64_t resumes = 0;
+    std::uint64_t frameBytes = 0;         // coroutine frames still alive
+};
+
+class OperatorExecutor {
+public:
+    explicit OperatorExecutor(LiftFleet& fleet) : fleet_(fleet) {}
+    ~OperatorExecutor();
+
+    OperatorExecutor(const OperatorExecutor&) = delete;
+    OperatorExecutor& operator=(const OperatorExecutor&) = delete;
+
+    // Starts script(Operator, args...) for a lift; it first runs on the next resume().
+    template <class Script, class... Args>
+    std::uint32_t spawn(std::size_t lift, Script script, Args... args) {
+        const std::uint32_t slot = addSlot(lift);
+        adopt(slot, script(Operator(this, slot), args...));
+        return slot;
+    }
+
+    // Drops the reset pulses and resumes every script whose wait is over;
+    // call once per scan, before the fleet scans
+    void resume();
+
+    // After the fleet scanned (by scan() or any scheduler of its own)
+    void endScan() { ++now_; }
+
+    // resume(), one fleet scan, endScan()
+    void scan(double dt) {
+        resume();
+        fleet_.scan(dt);
+        endScan();
+    }
+
+    std::int64_t now() const { return now_; }
+    bool done() const { return stats_.finished == stats_.spawned; }
+    const OperatorExecutorStats& stats() const { return stats_; }
+    LiftFleet& fleet() { return fleet_; }
+
+private:
+    friend class Operator;
+    friend class OperatorWait;
+
+    std::uint32_t addSlot(std::size_t lift);
+    void adopt(std::uint32_t slot, OperatorTask task);
+
+    LiftFleet& fleet_;
+    std::vector<OperatorWaitRecord> waits_;   // per slot
+    std::int64_t now_ = 0;
+    OperatorExecutorStats stats_;
+};
+
+inline std::size_t Operator::lift() const { return ex_->waits_[slot_].lift; }
+inline std::int64_t Operator::scan() const { return ex_->now_; }
+inline double Operator::position() const { return ex_->fleet_.position[lift()]; }
+inline LiftState Operator::state() const { return ex_->fleet_.state[lift()]; }
+inline FaultCode Operator::fault() const { return ex_->fleet_.latched[lift()]; }
+inline const Inputs& Operator::inputs() const { return ex_->fleet_.inputs[lift()]; }
+inline void Operator::command(CommandVerb verb, double value) {
+    applyCommand(Command{ verb, value }, ex_->fleet_.inputs[lift()]);
+}
+
+inline void OperatorWait::await_suspend(std::coroutine_handle<>) const noexcept {
+    OperatorWaitRecord& w = ex_->waits_[slot_];
+    w.kind = wait_.kind;
+    w.deadline = wait_.deadline == kNoTimeout ? kNoTimeout : ex_->now_ + wait_.deadline;
+    w.threshold = wait_.threshold;
+    w.state = wait_.state;
+    w.direction = wait_.direction;
+}
+
+inline bool OperatorWait::await_resume() const noexcept {
+    return await_ready() || ex_->waits_[slot_].met;
+}
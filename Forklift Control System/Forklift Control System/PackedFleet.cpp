@@ -0,0 +1,94 @@
+#include "PackedFleet.h"
+
+#include <limits>
+
+#include "TableController.h"
+
+void PackedFleet::resize(std::size_t count) {
+    hot.resize(count);
+    cold.resize(count);
+    if (kCountersEnabled) dwell.resize(count);
+}
+
+void PackedFleet::setLoad(std::size_t lift, double loadKg) {
+    cold[lift].loadKg = loadKg;
+    PackedLift& h = hot[lift];
+    const bool overload = loadKg > masts[h.mast].maxLoadKg;
+    h.inputBits = static_cast<std::uint8_t>((h.inputBits & ~kInOverload) | (overload ? kInOverload : 0));
+}
+
+std::uint32_t PackedFleet::addMast(const RuntimeMastConfig& config) {
+    masts.push_back(config);
+    return static_cast<std::uint32_t>(masts.size() - 1);
+}
+
+void PackedFleet::setMast(std::size_t lift, std::uint32_t mast) {
+    hot[lift].mast = mast;
+    setLoad(lift, cold[lift].loadKg); // the overload bit depends on the mast
+}
+
+LiftPlant PackedFleet::plant(std::size_t lift) const {
+    LiftPlant p{};
+    p.position = hot[lift].position;
+    p.velocity = hot[lift].velocity;
+    p.targetVel = hot[lift].targetVel;
+    return p;
+}
+
+namespace {
+
+// The controller compares loadKg > maxLoadKg; +/-infinity reproduce the
+// precomputed overload bit exactly for any maxLoadKg (for +inf and NaN
+// limits the bit is never set, and -inf compares false).
+constexpr double kOverloadedLoad = std::numeric_limits<double>::infinity();
+constexpr double kNormalLoad = -std::numeric_limits<double>::infinity();
+
+template <class Controller>
+void scanPacked(PackedLift& h, Controller& ctrl, double dt) {
+    const std::uint8_t bits = static_cast<std::uint8_t>(h.inputBits & ~kInOverload);
+    Inputs in = unpackInputs(bits, (h.inputBits & kInOverload) ? kOverloadedLoad : kNormalLoad);
+    LiftPlant plant{};
+    plant.position = h.position;
+    plant.velocity = h.velocity;
+    plant.targetVel = h.targetVel;
+    ctrl.state = h.state;
+    ctrl.faults.latched = h.latched;
+
+    const Outputs out = scanLift(dt, in, ctrl, plant);
+
+    h.position = plant.position;
+    h.velocity = plant.velocity;
+    h.targetVel = plant.targetVel;
+    h.inputBits = static_cast<std::uint8_t>(packInputBits(in) | (h.inputBits & kInOverload));
+    h.outputBits = packOutputBits(out);
+    h.state = ctrl.state;
+    h.latched = ctrl.faults.latched;
+}
+
+template <class Fixed, class Runtime>
+void scanPackedRange(PackedFleet& f, std::size_t begin, std::size_t end, double dt) {
+    Fixed fixed{};
+    Runtime runtime{};
+    const bool mixed = f.masts.size() > 1;
+    LiftCounters* const counters = kCountersEnabled ? &threadCounters() : nullptr;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        PackedLift& h = f.hot[i];
+        if constexpr (kCountersEnabled) selectScanCounters(counters, &f.dwell[i]);
+        if (!mixed || h.mast == 0) {
+            scanPacked(h, fixed, dt);
+        }
+        else {
+            static_cast<RuntimeMastConfig&>(runtime) = f.masts[h.mast];
+            scanPacked(h, runtime, dt);
+        }
+    }
+    selectScanCounters(nullptr, nullptr);
+}
+
+} // namespace
+
+void PackedFleet::scanRange(std::size_t begin, std::size_t end, double dt) {
+    if (tableController) scanPackedRange<TableLiftController, RuntimeTableLiftController>(*this, begin, end, dt);
+    else scanPackedRange<LiftController, RuntimeLiftController>(*this, begin, end, dt);
+}
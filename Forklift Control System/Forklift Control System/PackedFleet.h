@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LiftControl.h"
+#include "TraceFormat.h"
+
+// Fleet of lifts with one packed 32-byte record per lift.
+//
+// Everything a scan reads or writes lives in PackedLift: plant doubles,
+// input and output bools as bit fields (TraceFormat.h's kIn*/kOut* bits),
+// one-byte state and latched fault, and the index of the lift's mast
+// config. Two lifts share a cache line, and a million lifts fit in 32 MB,
+// where LiftFleet's arrays take 60 bytes per lift (Inputs and Outputs are
+// padded structs).
+//
+// The load is cold: setLoad() stores it in PackedLiftCold and folds the
+// overload comparison into one bit of the hot record, so the scan never
+// touches the double. Tunables live in a small per-model table.
+//
+// scan() runs the same scanLift() as every other mode, so lift i behaves
+// bit-for-bit like LiftFleet lift i fed the same commands and load.
+
+// Input bit 7 of the hot record: loadKg > maxLoadKg for this lift's mast
+// (precomputed). Packed lifts take no go-to, so the bit that holds cmdGoTo
+// in trace records is free here; mask it out before unpackInputs().
+inline constexpr std::uint8_t kInOverload = 1 << 7;
+inline constexpr std::uint8_t kInCommandMask = kInCmdUp | kInCmdDown | kInCmdHold | kInEstop | kInResetFault;
+
+struct alignas(32) PackedLift {
+    double position = 0.0;
+    double velocity = 0.0;
+    double targetVel = 0.0;
+    std::uint8_t inputBits = kInBottomLimit;   // kIn* | kInOverload
+    std::uint8_t outputBits = kOutBrakeEngaged;
+    LiftState state = LiftState::Holding;
+    FaultCode latched = FaultCode::None;
+    std::uint32_t mast = 0;                    // index into PackedFleet::masts
+};
+
+static_assert(sizeof(PackedLift) == 32, "two packed lifts per cache line");
+
+// Read rarely: only when inputs change or for reporting.
+struct PackedLiftCold {
+    double loadKg = 0.0;
+};
+
+struct PackedFleet {
+    std::vector<PackedLift> hot;
+    std::vector<PackedLiftCold> cold;
+
+    // Mast models; masts[0] is DefaultMast. Lifts on model 0 scan with the constexpr controller.
+    std::vector<RuntimeMastConfig> masts{ RuntimeMastConfig{} };
+
+    // Use the table-driven phase 4 (TableController.h) instead of the reference switch
+    bool tableController = false;
+
+    // FORKLIFT_COUNTERS builds: scans in the current state, per lift; the
+    // counters go to the scanning thread's aggregate (ScanCounters.h)
+    std::vector<std::uint32_t> dwell;
+
+    PackedFleet() = default;
+    explicit PackedFleet(std::size_t count) { resize(count); }
+
+    std::size_t size() const { return hot.size(); }
+    void resize(std::size_t count);
+
+    // Operator commands (cmdUp, cmdDown, cmdHold, estop, resetFault); limits and load are ignored.
+    // The caller owns the reset pulse, as with LiftFleet.
+    void setCommands(std::size_t lift, const Inputs& in) {
+        PackedLift& h = hot[lift];
+        h.inputBits = static_cast<std::uint8_t>((h.inputBits & ~kInCommandMask) | (packInputBits(in) & kInCommandMask));
+    }
+
+    void setLoad(std::size_t lift, double loadKg);
+
+    // Add a mast model; returns its index for setMast().
+    std::uint32_t addMast(const RuntimeMastConfig& config);
+    void setMast(std::size_t lift, std::uint32_t mast);
+
+    // One scan for every lift.
+    void scan(double dt) { scanRange(0, size(), dt); }
+    void scanRange(std::size_t begin, std::size_t end, double dt);
+
+    // Unpacked views
+    Inputs inputs(std::size_t lift) const {
+        return unpackInputs(static_cast<std::uint8_t>(hot[lift].inputBits & ~kInOverload), cold[lift].loadKg);
+    }
+    Outputs outputs(std::size_t lift) const { return unpackOutputs(hot[lift].outputBits); }
+    LiftPlant plant(std::size_t lift) const;
+};
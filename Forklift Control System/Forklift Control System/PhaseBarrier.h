@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#endif
+
+// Reusable barrier for a fixed group of threads that meet several times per scan.
+//
+// Arrival is one atomic increment. Waiters spin briefly on the generation
+// counter, which is all a phase barrier needs when every thread has its own
+// core, and then sleep in atomic::wait() so idle workers between paced
+// scans don't burn their cores. The last thread to arrive only makes the
+// notify system call when someone is actually asleep.
+
+class PhaseBarrier {
+public:
+    explicit PhaseBarrier(unsigned parties) : parties_(parties) {}
+
+    PhaseBarrier(const PhaseBarrier&) = delete;
+    PhaseBarrier& operator=(const PhaseBarrier&) = delete;
+
+    void arriveAndWait() {
+        const std::uint32_t gen = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == parties_) {
+            arrived_.store(0, std::memory_order_relaxed);
+            generation_.store(gen + 1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0) generation_.notify_all();
+            return;
+        }
+
+        for (int i = 0; i < kSpins; ++i) {
+            if (generation_.load(std::memory_order_acquire) != gen) return;
+            cpuRelax();
+        }
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        while (generation_.load(std::memory_order_seq_cst) == gen) generation_.wait(gen, std::memory_order_acquire);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    unsigned parties() const { return parties_; }
+
+private:
+    static constexpr int kSpins = 4000;
+
+    static void cpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(_M_ARM64)
+        __yield();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    const unsigned parties_;
+    alignas(64) std::atomic<std::uint32_t> arrived_{ 0 };
+    alignas(64) std::atomic<std::uint32_t> generation_{ 0 };
+    std::atomic<std::uint32_t> sleepers_{ 0 };
+};
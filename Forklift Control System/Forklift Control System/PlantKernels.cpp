@@ -0,0 +1,280 @@
+#include "PlantKernels.h"
+
+#include <atomic>
+
+#include "LiftControl.h"
+
+// Bit-identity with LiftPlant::step needs separate multiply and add.
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FORKLIFT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FORKLIFT_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(FORKLIFT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FORKLIFT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FORKLIFT_TARGET(isa)
+#endif
+
+namespace {
+
+// Reference kernel: literally LiftPlant::step per lift.
+void stepScalar(double* position, double* velocity, const double* targetVel,
+                std::size_t n, double dt) {
+    for (std::size_t i = 0; i < n; ++i) {
+        LiftPlant p{};
+        p.position = position[i];
+        p.velocity = velocity[i];
+        p.targetVel = targetVel[i];
+        p.step(dt);
+        position[i] = p.position;
+        velocity[i] = p.velocity;
+    }
+}
+
+// Each SIMD kernel works with the same sequence as LiftPlant::step:
+//   dv  = clamp(target - v, -maxDv, maxDv)   (std::clamp: v < lo ? lo : hi < v ? hi : v)
+//   v  += dv
+//   p   = clamp(p + v*dt, 0, 1)
+//   v   = 0 where (p <= 0 && v < 0) or (p >= 1 && v > 0)
+// Comparisons are ordered/quiet, matching the C++ operators for NaN and signed zero.
+
+#if defined(FORKLIFT_X86)
+
+FORKLIFT_TARGET("avx2")
+void stepAvx2(double* position, double* velocity, const double* targetVel,
+              std::size_t n, double dt) {
+    const double maxDv = LiftPlant::accel * dt;
+
+    const __m256d vHi = _mm256_set1_pd(maxDv);
+    const __m256d vLo = _mm256_set1_pd(-maxDv);
+    const __m256d vDt = _mm256_set1_pd(dt);
+    const __m256d zero = _mm256_set1_pd(0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(position + i);
+        __m256d v = _mm256_loadu_pd(velocity + i);
+        const __m256d t = _mm256_loadu_pd(targetVel + i);
+
+        __m256d dv = _mm256_sub_pd(t, v);
+        __m256d r = _mm256_blendv_pd(dv, vHi, _mm256_cmp_pd(vHi, dv, _CMP_LT_OQ));
+        dv = _mm256_blendv_pd(r, vLo, _mm256_cmp_pd(dv, vLo, _CMP_LT_OQ));
+        v = _mm256_add_pd(v, dv);
+
+        p = _mm256_add_pd(p, _mm256_mul_pd(v, vDt));
+        r = _mm256_blendv_pd(p, one, _mm256_cmp_pd(one, p, _CMP_LT_OQ));
+        p = _mm256_blendv_pd(r, zero, _mm256_cmp_pd(p, zero, _CMP_LT_OQ));
+
+        const __m256d atBottom = _mm256_and_pd(_mm256_cmp_pd(p, zero, _CMP_LE_OQ),
+                                               _mm256_cmp_pd(v, zero, _CMP_LT_OQ));
+        v = _mm256_blendv_pd(v, zero, atBottom);
+        const __m256d atTop = _mm256_and_pd(_mm256_cmp_pd(p, one, _CMP_GE_OQ),
+                                            _mm256_cmp_pd(v, zero, _CMP_GT_OQ));
+        v = _mm256_blendv_pd(v, zero, atTop);
+
+        _mm256_storeu_pd(position + i, p);
+        _mm256_storeu_pd(velocity + i, v);
+    }
+    _mm256_zeroupper(); // the tail is SSE code; GCC drops vzeroupper before the tail call
+    stepScalar(position + i, velocity + i, targetVel + i, n - i, dt);
+}
+
+FORKLIFT_TARGET("avx512f")
+void stepAvx512(double* position, double* velocity, const double* targetVel,
+                std::size_t n, double dt) {
+    const double maxDv = LiftPlant::accel * dt;
+
+    const __m512d vHi = _mm512_set1_pd(maxDv);
+    const __m512d vLo = _mm512_set1_pd(-maxDv);
+    const __m512d vDt = _mm512_set1_pd(dt);
+    const __m512d zero = _mm512_set1_pd(0.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d p = _mm512_loadu_pd(position + i);
+        __m512d v = _mm512_loadu_pd(velocity + i);
+        const __m512d t = _mm512_loadu_pd(targetVel + i);
+
+        __m512d dv = _mm512_sub_pd(t, v);
+        __m512d r = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(vHi, dv, _CMP_LT_OQ), dv, vHi);
+        dv = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(dv, vLo, _CMP_LT_OQ), r, vLo);
+        v = _mm512_add_pd(v, dv);
+
+        p = _mm512_add_pd(p, _mm512_mul_pd(v, vDt));
+        r = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(one, p, _CMP_LT_OQ), p, one);
+        p = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(p, zero, _CMP_LT_OQ), r, zero);
+
+        const __mmask8 atBottom = _mm512_cmp_pd_mask(p, zero, _CMP_LE_OQ)
+                                & _mm512_cmp_pd_mask(v, zero, _CMP_LT_OQ);
+        v = _mm512_mask_blend_pd(atBottom, v, zero);
+        const __mmask8 atTop = _mm512_cmp_pd_mask(p, one, _CMP_GE_OQ)
+                             & _mm512_cmp_pd_mask(v, zero, _CMP_GT_OQ);
+        v = _mm512_mask_blend_pd(atTop, v, zero);
+
+        _mm512_storeu_pd(position + i, p);
+        _mm512_storeu_pd(velocity + i, v);
+    }
+    _mm256_zeroupper(); // the tail is SSE code; GCC drops vzeroupper before the tail call
+    stepScalar(position + i, velocity + i, targetVel + i, n - i, dt);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasAvx512() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0xE6) != 0xE6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+
+#endif // FORKLIFT_X86
+
+#if defined(FORKLIFT_NEON)
+
+void stepNeon(double* position, double* velocity, const double* targetVel,
+              std::size_t n, double dt) {
+    const double maxDv = LiftPlant::accel * dt;
+
+    const float64x2_t vHi = vdupq_n_f64(maxDv);
+    const float64x2_t vLo = vdupq_n_f64(-maxDv);
+    const float64x2_t vDt = vdupq_n_f64(dt);
+    const float64x2_t zero = vdupq_n_f64(0.0);
+    const float64x2_t one = vdupq_n_f64(1.0);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t p = vld1q_f64(position + i);
+        float64x2_t v = vld1q_f64(velocity + i);
+        const float64x2_t t = vld1q_f64(targetVel + i);
+
+        float64x2_t dv = vsubq_f64(t, v);
+        float64x2_t r = vbslq_f64(vcltq_f64(vHi, dv), vHi, dv);
+        dv = vbslq_f64(vcltq_f64(dv, vLo), vLo, r);
+        v = vaddq_f64(v, dv);
+
+        p = vaddq_f64(p, vmulq_f64(v, vDt));
+        r = vbslq_f64(vcltq_f64(one, p), one, p);
+        p = vbslq_f64(vcltq_f64(p, zero), zero, r);
+
+        const uint64x2_t atBottom = vandq_u64(vcleq_f64(p, zero), vcltq_f64(v, zero));
+        v = vbslq_f64(atBottom, zero, v);
+        const uint64x2_t atTop = vandq_u64(vcgeq_f64(p, one), vcgtq_f64(v, zero));
+        v = vbslq_f64(atTop, zero, v);
+
+        vst1q_f64(position + i, p);
+        vst1q_f64(velocity + i, v);
+    }
+    stepScalar(position + i, velocity + i, targetVel + i, n - i, dt);
+}
+
+#endif // FORKLIFT_NEON
+
+PlantKernel detectPlantKernel() {
+    if (plantKernelSupported(PlantKernel::Avx512)) return PlantKernel::Avx512;
+    if (plantKernelSupported(PlantKernel::Avx2)) return PlantKernel::Avx2;
+    if (plantKernelSupported(PlantKernel::Neon)) return PlantKernel::Neon;
+    return PlantKernel::Scalar;
+}
+
+std::atomic<PlantKernel>& activeKernel() {
+    static std::atomic<PlantKernel> k{ detectPlantKernel() };
+    return k;
+}
+
+} // namespace
+
+const char* plantKernelToString(PlantKernel k) {
+    switch (k) {
+    case PlantKernel::Scalar: return "Scalar";
+    case PlantKernel::Neon: return "Neon";
+    case PlantKernel::Avx2: return "Avx2";
+    case PlantKernel::Avx512: return "Avx512";
+    }
+    return "Unknown";
+}
+
+bool plantKernelSupported(PlantKernel k) {
+    switch (k) {
+    case PlantKernel::Scalar: return true;
+#if defined(FORKLIFT_X86)
+    case PlantKernel::Avx2: {
+        static const bool ok = cpuHasAvx2();
+        return ok;
+    }
+    case PlantKernel::Avx512: {
+        static const bool ok = cpuHasAvx512();
+        return ok;
+    }
+#endif
+#if defined(FORKLIFT_NEON)
+    case PlantKernel::Neon: return true;
+#endif
+    default: return false;
+    }
+}
+
+PlantKernel activePlantKernel() {
+    return activeKernel().load(std::memory_order_relaxed);
+}
+
+bool setPlantKernel(PlantKernel k) {
+    if (!plantKernelSupported(k)) return false;
+    activeKernel().store(k, std::memory_order_relaxed);
+    return true;
+}
+
+void stepPlants(double* position, double* velocity, const double* targetVel,
+                std::size_t n, double dt) {
+    stepPlantsWith(activePlantKernel(), position, velocity, targetVel, n, dt);
+}
+
+void stepPlantsWith(PlantKernel k, double* position, double* velocity, const double* targetVel,
+                    std::size_t n, double dt) {
+    switch (k) {
+#if defined(FORKLIFT_X86)
+    case PlantKernel::Avx2: stepAvx2(position, velocity, targetVel, n, dt); return;
+    case PlantKernel::Avx512: stepAvx512(position, velocity, targetVel, n, dt); return;
+#endif
+#if defined(FORKLIFT_NEON)
+    case PlantKernel::Neon: stepNeon(position, velocity, targetVel, n, dt); return;
+#endif
+    default: stepScalar(position, velocity, targetVel, n, dt); return;
+    }
+}
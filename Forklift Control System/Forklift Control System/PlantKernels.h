@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+// Batched LiftPlant::step over structure-of-arrays plant state.
+//
+// Every kernel reproduces LiftPlant::step exactly (same clamp order, same
+// comparisons, no fused multiply-add), so a SIMD-stepped fleet stays
+// bit-identical to the scalar single-lift path.
+
+enum class PlantKernel {
+    Scalar,
+    Neon,      // 2 plants per instruction (float64x2)
+    Avx2,      // 4 plants per instruction
+    Avx512,    // 8 plants per instruction
+};
+
+const char* plantKernelToString(PlantKernel k);
+
+// Can this CPU (and OS) run kernel k?
+bool plantKernelSupported(PlantKernel k);
+
+// Kernel used by stepPlants(); defaults to the widest supported one.
+PlantKernel activePlantKernel();
+
+// Force a kernel (e.g. for benchmarking). Returns false if unsupported.
+bool setPlantKernel(PlantKernel k);
+
+// Step n plants with the active kernel. targetVel is read-only.
+void stepPlants(double* position, double* velocity, const double* targetVel,
+                std::size_t n, double dt);
+
+// Step n plants with a specific kernel (must be supported).
+void stepPlantsWith(PlantKernel k, double* position, double* velocity, const double* targetVel,
+                    std::size_t n, double dt);
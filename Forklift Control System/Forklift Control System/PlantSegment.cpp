@@ -0,0 +1,287 @@
+#include "PlantSegment.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+#include "Rng.h"
+
+const char* plantEventToString(PlantEvent e) {
+    switch (e) {
+    case PlantEvent::TargetReached: return "TargetReached";
+    case PlantEvent::TopLimit: return "TopLimit";
+    case PlantEvent::BottomLimit: return "BottomLimit";
+    case PlantEvent::TopStop: return "TopStop";
+    case PlantEvent::BottomStop: return "BottomStop";
+    }
+    return "Unknown";
+}
+
+namespace {
+
+constexpr std::int64_t kNever = -1;
+constexpr std::int64_t kUnbounded = std::numeric_limits<std::int64_t>::max();
+
+} // namespace
+
+PlantSegment::PlantSegment(const LiftPlant& start, double dt)
+    : target_(start.targetVel), dt_(dt), dv_(LiftPlant::accel * dt) {
+    pieces_[0] = makePiece(0, start.position, start.velocity);
+    count_ = 1;
+
+    // A clamp at an end stop restarts the plant at rest there. The target
+    // keeps its sign, so after at most two clamps it is pinned.
+    while (count_ < 3 && !pieces_[count_ - 1].pinned) {
+        const Piece& p = pieces_[count_ - 1];
+        std::int64_t top = firstCrossing(p, 1.0, +1);
+        std::int64_t bottom = firstCrossing(p, 0.0, -1);
+        if (top != kNever && !(velocity(p, top) > 0.0)) top = kNever;          // resting on the stop
+        if (bottom != kNever && !(velocity(p, bottom) < 0.0)) bottom = kNever;
+        if (top == kNever && bottom == kNever) break;
+
+        const bool atTop = bottom == kNever || (top != kNever && top < bottom);
+        pieces_[count_] = makePiece(p.begin + (atTop ? top : bottom), atTop ? 1.0 : 0.0, 0.0);
+        ++count_;
+    }
+}
+
+PlantSegment::Piece PlantSegment::makePiece(std::int64_t begin, double x, double v) const {
+    Piece p{};
+    p.begin = begin;
+    p.x = x;
+    p.v = v;
+    p.dir = target_ > v ? 1 : target_ < v ? -1 : 0;
+    // step() applies the remaining difference on the first scan it is within accel*dt
+    p.rampScans = p.dir == 0 ? 0 : static_cast<std::int64_t>(std::ceil(std::abs(target_ - v) / dv_));
+    p.pinned = v == 0.0 && ((x >= 1.0 && target_ > 0.0) || (x <= 0.0 && target_ < 0.0));
+    return p;
+}
+
+double PlantSegment::velocity(const Piece& p, std::int64_t m) const {
+    if (p.pinned) return 0.0;
+    if (m == 0) return p.v;
+    if (m < p.rampScans) return p.v + p.dir * dv_ * static_cast<double>(m);
+    return target_;
+}
+
+// Unclamped position after m scans of the piece: x + dt * sum of velocities.
+double PlantSegment::position(const Piece& p, std::int64_t m) const {
+    if (p.pinned || m == 0) return p.x;
+    const double n = static_cast<double>(m);
+    const std::int64_t k = p.rampScans;
+    if (k == 0) return p.x + dt_ * (n * target_);
+    if (m < k) return p.x + dt_ * (n * p.v + p.dir * dv_ * n * (n + 1.0) * 0.5);
+    const double r = static_cast<double>(k - 1);
+    return p.x + dt_ * (r * p.v + p.dir * dv_ * r * (r + 1.0) * 0.5 + (n - r) * target_);
+}
+
+// Smallest m >= 1 with side * (position(m) - h) >= 0, or kNever.
+std::int64_t PlantSegment::firstCrossing(const Piece& p, double h, int side) const {
+    auto holds = [&](std::int64_t m) { return side * (position(p, m) - h) >= 0.0; };
+    if (holds(1)) return 1;
+    if (p.pinned) return kNever;
+
+    // Ramp, m in [2, k-1]: side*(x - h + dt*(m v + dir dv m(m+1)/2)) is quadratic in m.
+    // The first integer that holds sits just after a root; confirm the
+    // neighbours by direct evaluation.
+    const std::int64_t k = p.rampScans;
+    if (k > 2) {
+        const double a = side * dt_ * p.dir * dv_ * 0.5;
+        const double b = side * dt_ * (p.v + p.dir * dv_ * 0.5);
+        const double c = side * (p.x - h);
+        double roots[2];
+        int nroots = 0;
+        if (a == 0.0) {
+            if (b != 0.0) roots[nroots++] = -c / b;
+        }
+        else {
+            const double disc = b * b - 4.0 * a * c;
+            if (disc >= 0.0) {
+                const double sq = std::sqrt(disc);
+                roots[nroots++] = (-b - sq) / (2.0 * a);
+                roots[nroots++] = (-b + sq) / (2.0 * a);
+            }
+        }
+        std::int64_t best = kNever;
+        for (int i = 0; i < nroots; ++i) {
+            if (!(roots[i] < static_cast<double>(k) + 1.0) || !(roots[i] > 0.0)) continue;
+            const std::int64_t r = static_cast<std::int64_t>(roots[i]);
+            for (std::int64_t m = std::max<std::int64_t>(2, r - 1); m <= std::min(k - 1, r + 2); ++m) {
+                if (holds(m)) {
+                    if (best == kNever || m < best) best = m;
+                    break;
+                }
+            }
+        }
+        if (best != kNever) return best;
+    }
+
+    // Cruise, m >= m0: linear with slope dt * targetVel.
+    const std::int64_t m0 = std::max<std::int64_t>(k, 2);
+    if (holds(m0)) return m0;
+    const double slope = side * target_ * dt_;
+    if (!(slope > 0.0)) return kNever;
+    const double gap = -side * (position(p, m0) - h);
+    const double steps = std::ceil(gap / slope);
+    if (!(steps < 9.0e18)) return kNever;
+    const std::int64_t guess = m0 + static_cast<std::int64_t>(steps);
+    for (std::int64_t m = std::max(m0 + 1, guess - 2); m <= guess + 2; ++m) {
+        if (holds(m)) return m;
+    }
+    return guess;
+}
+
+LiftPlant PlantSegment::at(std::int64_t scans) const {
+    int j = 0;
+    while (j + 1 < count_ && pieces_[j + 1].begin <= scans) ++j;
+    const Piece& p = pieces_[j];
+    const std::int64_t m = std::max<std::int64_t>(0, scans - p.begin);
+
+    LiftPlant out{};
+    out.position = std::clamp(position(p, m), 0.0, 1.0);
+    out.velocity = velocity(p, m);
+    out.targetVel = target_;
+    return out;
+}
+
+std::int64_t PlantSegment::firstScan(PlantEvent e) const {
+    for (int j = 0; j < count_; ++j) {
+        const Piece& p = pieces_[j];
+        const std::int64_t span = j + 1 < count_ ? pieces_[j + 1].begin - p.begin : kUnbounded;
+        std::int64_t m = kNever;
+
+        switch (e) {
+        case PlantEvent::TargetReached:
+            if (!p.pinned) m = std::max<std::int64_t>(p.rampScans, j == 0 ? 1 : 0);
+            break;
+        case PlantEvent::TopLimit:
+        case PlantEvent::BottomLimit:
+        case PlantEvent::TopStop:
+        case PlantEvent::BottomStop: {
+            const bool top = e == PlantEvent::TopLimit || e == PlantEvent::TopStop;
+            const double h = e == PlantEvent::TopLimit ? 0.9999 : e == PlantEvent::BottomLimit ? 0.0001
+                           : e == PlantEvent::TopStop ? 1.0 : 0.0;
+            const int side = top ? +1 : -1;
+            if (j > 0 && side * (p.x - h) >= 0.0) m = 0;
+            else m = firstCrossing(p, h, side);
+            break;
+        }
+        }
+        if (m != kNever && m < span) return p.begin + m;
+    }
+    return kNever;
+}
+
+std::uint64_t PlantSegmentCheckReport::totalMismatches() const {
+    std::uint64_t n = 0;
+    for (std::uint64_t m : eventMismatches) n += m;
+    return n;
+}
+
+namespace {
+
+constexpr PlantEvent kEvents[5] = { PlantEvent::TargetReached, PlantEvent::TopLimit, PlantEvent::BottomLimit,
+                                    PlantEvent::TopStop, PlantEvent::BottomStop };
+
+// Keeps the timed at() calls from being optimized away
+volatile double timingSink = 0.0;
+
+bool eventHolds(PlantEvent e, const LiftPlant& p) {
+    switch (e) {
+    case PlantEvent::TargetReached: return p.velocity == p.targetVel;
+    case PlantEvent::TopLimit: return p.position >= 0.9999;
+    case PlantEvent::BottomLimit: return p.position <= 0.0001;
+    case PlantEvent::TopStop: return p.position >= 1.0;
+    case PlantEvent::BottomStop: return p.position <= 0.0;
+    }
+    return false;
+}
+
+LiftPlant drawStart(SplitMix64& rng) {
+    LiftPlant p{};
+    const double where = rng.uniform();
+    p.position = where < 0.3 ? 0.0 : where < 0.4 ? 1.0 : rng.uniform();
+    p.velocity = rng.chance(0.4) ? 0.0 : rng.uniform(-0.4, 0.4);
+    const double target = rng.uniform();
+    p.targetVel = target < 0.2 ? 0.0 : target < 0.5 ? DefaultMast::liftSpeed
+                : target < 0.8 ? -DefaultMast::lowerSpeed : rng.uniform(-0.5, 0.5);
+    return p;
+}
+
+} // namespace
+
+PlantSegmentCheckReport checkPlantSegments(std::uint64_t seed, std::uint64_t segments) {
+    PlantSegmentCheckReport r{};
+    SplitMix64 rng{ seed };
+
+    for (std::uint64_t i = 0; i < segments; ++i) {
+        const LiftPlant start = drawStart(rng);
+        const double dt = rng.chance(0.8) ? 0.02 : rng.uniform(0.001, 0.05);
+        const std::int64_t scans = 1 + static_cast<std::int64_t>(rng.next() % 3000);
+        const PlantSegment seg(start, dt);
+
+        std::int64_t first[5] = { -1, -1, -1, -1, -1 };
+        LiftPlant p = start;
+        for (std::int64_t n = 1; n <= scans; ++n) {
+            p.step(dt);
+            const LiftPlant q = seg.at(n);
+            r.maxPositionError = std::max(r.maxPositionError, std::abs(p.position - q.position));
+            r.maxVelocityError = std::max(r.maxVelocityError, std::abs(p.velocity - q.velocity));
+            for (int e = 0; e < 5; ++e) {
+                if (first[e] < 0 && eventHolds(kEvents[e], p)) first[e] = n;
+            }
+        }
+        r.scansCompared += static_cast<std::uint64_t>(scans);
+
+        for (int e = 0; e < 5; ++e) {
+            const std::int64_t got = seg.firstScan(kEvents[e]);
+            const bool agree = first[e] >= 0 ? got == first[e] : (got < 0 || got > scans);
+            if (!agree) r.eventMismatches[e]++;
+            r.eventChecks++;
+        }
+        r.segments++;
+    }
+
+    // Long horizon: a slow creep over 10M scans (about 55 h) is one segment.
+    LiftPlant slow{};
+    slow.targetVel = 1.0e-8;
+    r.horizonScans = 10000000;
+    const PlantSegment seg(slow, 0.02);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    LiftPlant p = slow;
+    for (std::int64_t n = 0; n < r.horizonScans; ++n) p.step(0.02);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    constexpr int kCalls = 1000000;
+    double sum = 0.0;
+    for (int c = 0; c < kCalls; ++c) sum += seg.at(r.horizonScans - (c & 1)).position;
+    const auto t2 = std::chrono::steady_clock::now();
+    timingSink = sum;
+
+    r.horizonPositionError = std::abs(p.position - seg.at(r.horizonScans).position);
+    r.stepNsPerScan = std::chrono::duration<double, std::nano>(t1 - t0).count() / r.horizonScans;
+    r.closedFormNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kCalls;
+    return r;
+}
+
+void printPlantSegmentCheckReport(std::ostream& os, const PlantSegmentCheckReport& r) {
+    os << "segment-check: segments=" << r.segments << " scans compared=" << r.scansCompared << "\n";
+    os << std::scientific << std::setprecision(3)
+        << "  max |position error|=" << r.maxPositionError << " max |velocity error|=" << r.maxVelocityError << "\n"
+        << std::defaultfloat;
+    os << "  event scans: checks=" << r.eventChecks << " mismatches=" << r.totalMismatches();
+    for (int e = 0; e < 5; ++e) {
+        if (r.eventMismatches[e] > 0) os << " " << plantEventToString(kEvents[e]) << "=" << r.eventMismatches[e];
+    }
+    os << "\n";
+    os << std::scientific << std::setprecision(3)
+        << "  horizon: scans=" << r.horizonScans << " |position error|=" << r.horizonPositionError
+        << std::fixed << std::setprecision(3)
+        << " step()=" << r.stepNsPerScan * r.horizonScans / 1.0e6 << "ms"
+        << " closed form=" << r.closedFormNs << "ns"
+        << " speedup=" << (r.closedFormNs > 0.0 ? r.stepNsPerScan * r.horizonScans / r.closedFormNs : 0.0) << "x\n";
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+#include "LiftControl.h"
+
+// Closed-form integration of a LiftPlant across a segment of constant
+// targetVel.
+//
+// LiftPlant::step() is a rate-limited semi-implicit Euler step: velocity
+// moves toward targetVel by at most accel*dt per scan, position adds
+// velocity*dt and is clamped at the end stops, which zero any velocity into
+// the stop. With targetVel fixed, the trajectory after n scans is made of
+// at most three pieces, each closed-form in n:
+//   ramp     velocity v0 + n*accel*dt (position quadratic in n)
+//   cruise   velocity == targetVel (position linear in n)
+//   pinned   held at an end stop by a target pushing into it
+// A clamp at an end stop starts a new piece at rest. at(n) and the event
+// queries cost O(1) whatever n is.
+//
+// Results are equal to n calls of step() up to floating-point rounding of
+// the sums (about n ulps); event scans match exactly unless a position
+// lands within that rounding of a threshold.
+
+enum class PlantEvent : std::uint8_t {
+    TargetReached,   // velocity == targetVel
+    TopLimit,        // position >= 0.9999 (top limit switch)
+    BottomLimit,     // position <= 0.0001 (bottom limit switch)
+    TopStop,         // clamped at 1
+    BottomStop,      // clamped at 0
+};
+
+const char* plantEventToString(PlantEvent e);
+
+class PlantSegment {
+public:
+    // start.targetVel is held for the whole segment.
+    PlantSegment(const LiftPlant& start, double dt);
+
+    // The plant after `scans` calls of step(dt)
+    LiftPlant at(std::int64_t scans) const;
+
+    // First scan n >= 1 after whose step the event condition holds; -1 if never.
+    std::int64_t firstScan(PlantEvent e) const;
+
+private:
+    struct Piece {
+        std::int64_t begin = 0;   // absolute scan of the piece's initial state
+        double x = 0.0;
+        double v = 0.0;
+        int dir = 0;              // sign of targetVel - v
+        std::int64_t rampScans = 0; // scans until velocity == targetVel
+        bool pinned = false;
+    };
+
+    double position(const Piece& p, std::int64_t m) const;
+    double velocity(const Piece& p, std::int64_t m) const;
+    std::int64_t firstCrossing(const Piece& p, double h, int side) const;
+    Piece makePiece(std::int64_t begin, double x, double v) const;
+
+    double target_;
+    double dt_;
+    double dv_;                   // accel * dt
+    Piece pieces_[3];
+    int count_ = 0;
+};
+
+// Random segments scanned with step() and compared with PlantSegment at
+// every scan boundary, plus a timing comparison over a long horizon.
+struct PlantSegmentCheckReport {
+    std::uint64_t segments = 0;
+    std::uint64_t scansCompared = 0;
+    double maxPositionError = 0.0;
+    double maxVelocityError = 0.0;
+    std::uint64_t eventChecks = 0;
+    std::uint64_t eventMismatches[5] = {};    // per PlantEvent
+    std::int64_t horizonScans = 0;
+    double horizonPositionError = 0.0;        // at(horizon) against horizon step() calls
+    double stepNsPerScan = 0.0;               // step() over the horizon, per scan
+    double closedFormNs = 0.0;                // at(horizon), per call
+
+    std::uint64_t totalMismatches() const;
+};
+
+PlantSegmentCheckReport checkPlantSegments(std::uint64_t seed, std::uint64_t segments);
+
+void printPlantSegmentCheckReport(std::ostream& os, const PlantSegmentCheckReport& r);
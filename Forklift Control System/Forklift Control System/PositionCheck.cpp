@@ -0,0 +1,307 @@
+#include "PositionCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "LiftFleet.h"
+#include "LoadDynamics.h"
+#include "Rng.h"
+#include "TableController.h"
+#include "TraceFormat.h"
+#include "TraceReader.h"
+#include "TraceRecorder.h"
+#include "TraceReplay.h"
+
+namespace {
+
+const double kDt = 0.02;
+const std::uint64_t kSeed = 0x607Du;
+const std::int64_t kMaxMoveScans = 10000;
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) { return std::memcmp(&a, &b, sizeof(TraceRecord)) == 0; }
+
+TraceRecord fleetRecord(const LiftFleet& f, std::size_t i) {
+    LiftPlant p{};
+    p.position = f.position[i];
+    p.velocity = f.velocity[i];
+    p.targetVel = f.targetVel[i];
+    return makeTraceRecord(f.inputs[i], f.outputs[i], p, f.state[i], f.latched[i]);
+}
+
+struct Move {
+    std::int64_t scans = 0;        // until back in Holding, at rest
+    double error = 0.0;
+    double overshoot = 0.0;
+    bool faulted = false;
+    bool arrived = false;
+};
+
+// Go-to from the plant's current position; scan is scanLift() or scanLoadedLift() bound to a table
+template <class Controller, class Scan>
+Move goTo(Controller& ctrl, LiftPlant& plant, double target, double loadKg, Scan scan) {
+    Move m;
+    Inputs in{};
+    in.cmdGoTo = true;
+    in.targetPosition = target;
+    in.loadKg = loadKg;
+    const double direction = target >= plant.position ? 1.0 : -1.0;
+    while (m.scans < kMaxMoveScans) {
+        scan(in, ctrl, plant);
+        ++m.scans;
+        m.overshoot = std::max(m.overshoot, direction * (plant.position - target));
+        m.faulted |= ctrl.faults.hasFault();
+        if (ctrl.state == LiftState::Holding && plant.velocity == 0.0) {
+            m.arrived = true;
+            break;
+        }
+    }
+    m.error = std::abs(plant.position - target);
+    return m;
+}
+
+// Up / down held until the target is reached, then released; done once the plant is at rest
+Move manualMove(LiftPlant& plant, double target) {
+    Move m;
+    LiftController ctrl{};
+    Inputs in{};
+    const bool up = target >= plant.position;
+    while (m.scans < kMaxMoveScans) {
+        const bool reached = up ? plant.position >= target : plant.position <= target;
+        in.cmdUp = up && !reached;
+        in.cmdDown = !up && !reached;
+        scanLift(kDt, in, ctrl, plant);
+        ++m.scans;
+        if (reached && plant.velocity == 0.0) {
+            m.arrived = true;
+            break;
+        }
+    }
+    m.error = std::abs(plant.position - target);
+    return m;
+}
+
+// Bottom to the top by hand: up until the top limit latches LimitViolation, release, reset once at rest
+std::int64_t manualTopPick() {
+    LiftController ctrl{};
+    LiftPlant plant{};
+    Inputs in{};
+    in.cmdUp = true;
+    std::int64_t scans = 0;
+    while (scans < kMaxMoveScans) {
+        const bool faulted = ctrl.faults.hasFault();
+        in.cmdUp = !faulted && plant.position < 1.0;
+        in.resetFault = faulted;
+        scanLift(kDt, in, ctrl, plant);
+        ++scans;
+        if (!ctrl.faults.hasFault() && ctrl.state == LiftState::Holding && plant.position >= 0.9999) break;
+    }
+    return scans;
+}
+
+// Fleet-mode cycles of 400 scans: mostly go-to moves to random targets (the
+// extremes included, so clamping is exercised), every third cycle a manual
+// up / down, random loads up to an overload, rare E-stops and a reset at
+// the end of every cycle.
+Inputs operatorInputs(std::size_t lift, std::int64_t scan, double maxLoadKg) {
+    const std::uint64_t s = static_cast<std::uint64_t>(scan) + lift * 53;
+    const std::uint64_t cycle = s / 400;
+    const std::uint64_t phase = s % 400;
+    SplitMix64 rng{ streamKey(kSeed, (std::uint64_t{ lift } << 32) ^ static_cast<std::uint64_t>(scan)) };
+    SplitMix64 plan{ streamKey(kSeed + 1, (std::uint64_t{ lift } << 32) ^ cycle) };
+    Inputs in{};
+    in.loadKg = plan.uniform(0.0, 1.1) * maxLoadKg;
+    if (cycle % 3 == 2) {
+        in.cmdUp = phase < 120;
+        in.cmdDown = phase >= 200 && phase < 335;
+    }
+    else {
+        in.cmdGoTo = phase < 380;
+        in.targetPosition = plan.uniform(-0.05, 1.05);
+        in.cmdHold = phase >= 150 && phase < 160 && plan.chance(0.2);
+    }
+    in.estop = rng.chance(0.0005);
+    in.resetFault = phase == 399 || rng.chance(0.002);
+    return in;
+}
+
+// The reference fleet is recorded with small chunks, so scans and target
+// changes straddle chunk boundaries, and replayed.
+void compareFleets(PositionCheckReport& r) {
+    const TruckDynamics dynamics = builtinTruckDynamics();
+    LiftFleet fleet(r.lifts);
+    LiftFleet table(r.lifts);
+    LiftFleet loaded(r.lifts);
+    table.tableController = true;
+    loaded.setDynamics(&dynamics);
+    for (std::size_t i = 0; i < r.lifts; ++i) loaded.setTruckModel(i, static_cast<std::uint8_t>(i % dynamics.count));
+
+    std::vector<LiftController> ctrls(r.lifts);
+    std::vector<LiftPlant> plants(r.lifts);
+    std::vector<Inputs> ins(r.lifts);
+    std::vector<Outputs> outs(r.lifts);
+    std::vector<RuntimeLiftController> loadedCtrls(r.lifts);
+    std::vector<LiftPlant> loadedPlants(r.lifts);
+    std::vector<Inputs> loadedIns(r.lifts);
+    std::vector<Outputs> loadedOuts(r.lifts);
+
+    const std::string tracePath = (std::filesystem::temp_directory_path() / "forklift-position-check.trace").string();
+    TraceRecorder recorder;
+    if (!recorder.open(tracePath, static_cast<std::uint32_t>(r.lifts), kDt, 1000)) {
+        r.error = "cannot open " + tracePath;
+        return;
+    }
+    recorder.reserve(static_cast<std::uint64_t>(r.scans) * r.lifts);
+
+    for (std::int64_t s = 0; s < r.scans; ++s) {
+        for (std::size_t i = 0; i < r.lifts; ++i) {
+            ins[i] = fleet.inputs[i] = table.inputs[i] = operatorInputs(i, s, DefaultMast::maxLoadKg);
+            outs[i] = scanLift(kDt, ins[i], ctrls[i], plants[i]);
+
+            const DynamicsTable& t = dynamics.tables[i % dynamics.count];
+            loadedIns[i] = loaded.inputs[i] = operatorInputs(i, s, t.maxLoadKg());
+            loadedOuts[i] = scanLoadedLift(kDt, loadedIns[i], loadedCtrls[i], loadedPlants[i], t);
+        }
+        fleet.scan(kDt);
+        table.scan(kDt);
+        loaded.scan(kDt);
+        recorder.recordFleet(fleet);
+        for (std::size_t i = 0; i < r.lifts; ++i) {
+            const TraceRecord lone = makeTraceRecord(ins[i], outs[i], plants[i], ctrls[i].state, ctrls[i].faults.latched);
+            r.fleetMismatches += !sameRecord(fleetRecord(fleet, i), lone);
+            r.tableMismatches += !sameRecord(fleetRecord(table, i), lone);
+            const TraceRecord loadedLone = makeTraceRecord(loadedIns[i], loadedOuts[i], loadedPlants[i],
+                                                           loadedCtrls[i].state, loadedCtrls[i].faults.latched);
+            r.dynamicsMismatches += !sameRecord(fleetRecord(loaded, i), loadedLone);
+            r.positioningScans += (ctrls[i].state == LiftState::Positioning) + (loadedCtrls[i].state == LiftState::Positioning);
+        }
+    }
+
+    TraceReader trace;
+    if (!recorder.close()) r.error = "trace write failed";
+    else if (trace.open(tracePath, r.error)) {
+        const ReplayResult replay = replayTrace(trace, ReplayOptions{});
+        r.replayedScans = replay.scans;
+        r.replayDiverged = replay.diverged;
+    }
+    std::error_code ec;
+    std::filesystem::remove(tracePath, ec);
+}
+
+} // namespace
+
+bool PositionCheckReport::passed() const {
+    return error.empty() && maxError <= kExact && maxOvershoot <= kExact && limitFaults == 0 && timeouts == 0 &&
+           dynamicsMaxError <= DefaultMast::positionTolerance &&
+           dynamicsMaxOvershoot <= DefaultMast::positionTolerance && dynamicsFaults == 0 &&
+           fleetMismatches == 0 && tableMismatches == 0 && dynamicsMismatches == 0 && positioningScans > 0 &&
+           !replayDiverged && replayedScans == static_cast<std::uint64_t>(scans);
+}
+
+PositionCheckReport checkGoToPosition(std::size_t moves, std::size_t lifts, std::int64_t scans) {
+    PositionCheckReport r;
+    r.moves = moves;
+    r.lifts = lifts;
+    r.scans = scans;
+    if (moves == 0 || lifts == 0 || scans <= 0) {
+        r.error = "moves, lifts and scans must be > 0";
+        return r;
+    }
+
+    const auto fixedScan = [](Inputs& in, LiftController& c, LiftPlant& p) { scanLift(kDt, in, c, p); };
+
+    // ---- Random moves on the fixed plant, by go-to and by hand ----
+    SplitMix64 rng{ streamKey(kSeed + 2, 0) };
+    double scansTotal = 0.0;
+    double manualErrorTotal = 0.0;
+    double manualScansTotal = 0.0;
+    for (std::size_t k = 0; k < moves; ++k) {
+        // Targets within positionTolerance of the start are already reached
+        const double start = rng.uniform(kMinTargetPosition, kMaxTargetPosition);
+        double target = start;
+        while (std::abs(target - start) <= DefaultMast::positionTolerance) {
+            target = rng.uniform(kMinTargetPosition, kMaxTargetPosition);
+        }
+
+        LiftController ctrl{};
+        LiftPlant plant{};
+        plant.position = start;
+        const Move m = goTo(ctrl, plant, target, 0.0, fixedScan);
+        r.timeouts += !m.arrived;
+        r.limitFaults += m.faulted;
+        r.maxError = std::max(r.maxError, m.error);
+        r.maxOvershoot = std::max(r.maxOvershoot, m.overshoot);
+        scansTotal += static_cast<double>(m.scans);
+
+        LiftPlant manualPlant{};
+        manualPlant.position = start;
+        const Move h = manualMove(manualPlant, target);
+        r.timeouts += !h.arrived;
+        manualErrorTotal += h.error;
+        r.manualMaxError = std::max(r.manualMaxError, h.error);
+        manualScansTotal += static_cast<double>(h.scans);
+    }
+    r.meanScans = scansTotal / double(moves);
+    r.manualMeanError = manualErrorTotal / double(moves);
+    r.manualMeanScans = manualScansTotal / double(moves);
+
+    {
+        LiftController ctrl{};
+        LiftPlant plant{};
+        const Move top = goTo(ctrl, plant, kMaxTargetPosition, 0.0, fixedScan);
+        r.timeouts += !top.arrived;
+        r.limitFaults += top.faulted;
+        r.topGoToScans = top.scans;
+        r.topManualScans = manualTopPick();
+    }
+
+    // ---- Truck models: up and down, empty and at rated load ----
+    const TruckDynamics dynamics = builtinTruckDynamics();
+    for (std::size_t t = 0; t < dynamics.count; ++t) {
+        const DynamicsTable& table = dynamics.tables[t];
+        const auto loadedScan = [&table](Inputs& in, RuntimeLiftController& c, LiftPlant& p) {
+            scanLoadedLift(kDt, in, c, p, table);
+        };
+        for (const double load : { 0.0, table.maxLoadKg() }) {
+            RuntimeLiftController ctrl{};
+            LiftPlant plant{};
+            for (const double target : { 0.7, 0.05, 0.999, 0.001 }) {
+                const Move m = goTo(ctrl, plant, target, load, loadedScan);
+                r.dynamicsFaults += m.faulted || !m.arrived;
+                r.dynamicsMaxError = std::max(r.dynamicsMaxError, m.error);
+                r.dynamicsMaxOvershoot = std::max(r.dynamicsMaxOvershoot, m.overshoot);
+            }
+        }
+    }
+
+    // ---- Fleets against lone lifts ----
+    compareFleets(r);
+    return r;
+}
+
+void printPositionCheckReport(std::ostream& os, const PositionCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "position-check: " << r.error << "\n";
+        return;
+    }
+    os << "position-check: moves=" << r.moves << " lifts=" << r.lifts << " scans=" << r.scans << "\n"
+        << std::scientific << std::setprecision(2)
+        << "  go-to: max error=" << r.maxError << " max overshoot=" << r.maxOvershoot
+        << std::fixed << std::setprecision(1) << " mean scans=" << r.meanScans
+        << " faults=" << r.limitFaults << " timeouts=" << r.timeouts << "\n"
+        << std::setprecision(4)
+        << "  by hand: mean error=" << r.manualMeanError << " max error=" << r.manualMaxError
+        << std::setprecision(1) << " mean scans=" << r.manualMeanScans << "\n"
+        << "  top pick: go-to=" << r.topGoToScans << " scans, up into the limit + reset=" << r.topManualScans << " scans\n"
+        << std::scientific << std::setprecision(2)
+        << "  truck models: max error=" << r.dynamicsMaxError << " max overshoot=" << r.dynamicsMaxOvershoot
+        << " faults=" << r.dynamicsFaults << "\n"
+        << "  fleets vs lone lifts: mismatches=" << r.fleetMismatches << " table=" << r.tableMismatches
+        << " dynamics=" << r.dynamicsMismatches << " positioning lift-scans=" << r.positioningScans << "\n"
+        << "  trace replay: scans=" << r.replayedScans << (r.replayDiverged ? " DIVERGED" : " identical") << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
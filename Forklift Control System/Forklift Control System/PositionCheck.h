@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Checks go-to-position moves: exact arrival with no overshoot on the fixed
+// plant, within positionTolerance on every truck model, faster than a
+// manual pick at the top, and identical across fleets and trace replay.
+
+struct PositionCheckReport {
+    std::size_t moves = 0;
+    std::size_t lifts = 0;
+    std::int64_t scans = 0;
+
+    // Go-to moves on the fixed plant
+    double maxError = 0.0;                 // |position - target| at rest
+    double maxOvershoot = 0.0;             // furthest past the target on the way
+    std::uint64_t limitFaults = 0;         // moves that latched a fault (must be 0)
+    std::uint64_t timeouts = 0;            // moves that never arrived (must be 0)
+    double meanScans = 0.0;
+
+    // The same moves by hand, releasing the command at the target
+    double manualMeanError = 0.0;
+    double manualMaxError = 0.0;
+    double manualMeanScans = 0.0;
+
+    // Bottom to the top: go-to 0.999 (counted in the faults and timeouts
+    // above) against up into the limit, which latches LimitViolation, + reset
+    std::int64_t topGoToScans = 0;
+    std::int64_t topManualScans = 0;
+
+    // Go-to moves on the built-in truck models, empty and at rated load
+    double dynamicsMaxError = 0.0;
+    double dynamicsMaxOvershoot = 0.0;
+    std::uint64_t dynamicsFaults = 0;
+
+    std::uint64_t fleetMismatches = 0;     // LiftFleet vs lone scanLift() (must be 0)
+    std::uint64_t tableMismatches = 0;     // table-controller fleet vs the same (must be 0)
+    std::uint64_t dynamicsMismatches = 0;  // mixed-model fleet vs scanLoadedLift() (must be 0)
+    std::uint64_t positioningScans = 0;    // lift-scans the fleets spent in Positioning
+    std::uint64_t replayedScans = 0;       // of the reference fleet's trace (must be scans)
+    bool replayDiverged = false;           // (must be false)
+    std::string error;
+
+    static constexpr double kExact = 1e-9;
+
+    bool passed() const;
+};
+
+PositionCheckReport checkGoToPosition(std::size_t moves, std::size_t lifts, std::int64_t scans);
+
+void printPositionCheckReport(std::ostream& os, const PositionCheckReport& r);
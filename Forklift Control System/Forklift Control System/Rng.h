@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Small deterministic RNG for simulation harnesses (SplitMix64).
+// Same seed -> same sequence on every platform and compiler.
+//
+// SplitMix64 is counter-based: draw k is splitMix64(state0 + k * gamma), a
+// pure function of the starting state. Seeding a generator per independent
+// stream with streamKey() therefore makes each stream's values depend only
+// on (seed, stream, k), never on which thread runs it or in what order.
+
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Starting state for stream `stream` of a run seeded with `seed`.
+inline std::uint64_t streamKey(std::uint64_t seed, std::uint64_t stream) {
+    return splitMix64(seed ^ splitMix64(stream));
+}
+
+struct SplitMix64 {
+    std::uint64_t state = 0;
+
+    std::uint64_t next() {
+        const std::uint64_t r = splitMix64(state);
+        state += 0x9E3779B97F4A7C15ull;
+        return r;
+    }
+
+    // Uniform in [0, 1)
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Uniform in [lo, hi)
+    double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+
+    // true with probability p
+    bool chance(double p) { return uniform() < p; }
+};
@@ -0,0 +1,162 @@
+#include "ScanCounters.h"
+
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+#include "LiftControl.h"
+
+static_assert(static_cast<int>(FaultCode::LimitViolation) / 10 == 1 && static_cast<int>(FaultCode::Overload) / 10 == 2 &&
+              static_cast<int>(FaultCode::EmergencyStop) / 10 == 3, "faultSlot() follows the fault codes");
+static_assert(kLiftStates == LiftCounters::kStates, "one counter row per state");
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<const LiftCounters*> live;
+    LiftCounters exited{};
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+struct ThreadSlot {
+    LiftCounters counters{};
+
+    ThreadSlot() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(&counters);
+    }
+
+    ~ThreadSlot() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.exited.merge(counters);
+        std::erase(r.live, &counters);
+    }
+};
+
+const FaultCode kFaults[] = { FaultCode::EmergencyStop, FaultCode::Overload, FaultCode::LimitViolation };
+
+// Lower bound of dwell bin b in scans
+std::uint64_t binLow(int b) { return std::uint64_t{ 1 } << b; }
+
+void writeJson(std::ostream& os, const LiftCounters& c) {
+    os << "{\"scans\":" << c.scans << ",\"latch\":{";
+    for (int k = 0; k < 3; ++k) {
+        const FaultLatchCounters& f = c.faults[faultSlot(kFaults[k])];
+        os << (k ? "," : "") << "\"" << faultToString(kFaults[k]) << "\":{\"fired\":" << f.fired
+            << ",\"latched\":" << f.latched << ",\"suppressed\":" << f.suppressed << ",\"repeated\":" << f.repeated << "}";
+    }
+    os << "},\"reset\":{\"requests\":" << c.resetRequests << ",\"cleared\":" << c.resetsCleared
+        << ",\"idle\":" << c.resetsIdle << ",\"rejectedEstop\":" << c.resetRejectedEstop
+        << ",\"rejectedMoving\":" << c.resetRejectedMoving << "},\"transitions\":{";
+    bool first = true;
+    for (int a = 0; a < LiftCounters::kStates; ++a) {
+        for (int b = 0; b < LiftCounters::kStates; ++b) {
+            if (a == b) continue;
+            os << (first ? "" : ",") << "\"" << stateToString(static_cast<LiftState>(a)) << "->"
+                << stateToString(static_cast<LiftState>(b)) << "\":" << c.transitions[a][b];
+            first = false;
+        }
+    }
+    os << "},\"dwellBinLowScans\":[";
+    for (int b = 0; b < LiftCounters::kDwellBins; ++b) os << (b ? "," : "") << binLow(b);
+    os << "],\"dwell\":{";
+    for (int s = 0; s < LiftCounters::kStates; ++s) {
+        os << (s ? "," : "") << "\"" << stateToString(static_cast<LiftState>(s)) << "\":[";
+        for (int b = 0; b < LiftCounters::kDwellBins; ++b) os << (b ? "," : "") << c.dwell[s][b];
+        os << "]";
+    }
+    os << "}}";
+}
+
+} // namespace
+
+std::uint64_t LiftCounters::totalTransitions() const {
+    std::uint64_t n = 0;
+    for (const auto& row : transitions) {
+        for (std::uint64_t t : row) n += t;
+    }
+    return n;
+}
+
+void LiftCounters::merge(const LiftCounters& o) {
+    scans += o.scans;
+    for (int k = 0; k < kFaults; ++k) {
+        faults[k].fired += o.faults[k].fired;
+        faults[k].latched += o.faults[k].latched;
+        faults[k].suppressed += o.faults[k].suppressed;
+        faults[k].repeated += o.faults[k].repeated;
+    }
+    resetRequests += o.resetRequests;
+    resetsCleared += o.resetsCleared;
+    resetsIdle += o.resetsIdle;
+    resetRejectedEstop += o.resetRejectedEstop;
+    resetRejectedMoving += o.resetRejectedMoving;
+    for (int a = 0; a < kStates; ++a) {
+        for (int b = 0; b < kStates; ++b) transitions[a][b] += o.transitions[a][b];
+        for (int b = 0; b < kDwellBins; ++b) dwell[a][b] += o.dwell[a][b];
+    }
+}
+
+LiftCounters& threadCounters() {
+    thread_local ThreadSlot slot;
+    return slot.counters;
+}
+
+LiftCounters aggregateThreadCounters() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    LiftCounters total = r.exited;
+    for (const LiftCounters* c : r.live) total.merge(*c);
+    return total;
+}
+
+void printCounters(std::ostream& os, const LiftCounters& c, double dt) {
+    const std::uint64_t transitions = c.totalTransitions();
+    const double simSeconds = c.scans * dt;
+    os << std::fixed << std::setprecision(2)
+        << "counters: scans=" << c.scans << " transitions=" << transitions
+        << " (" << (simSeconds > 0.0 ? transitions / simSeconds : 0.0) << " per lift-second)\n";
+    for (FaultCode f : kFaults) {
+        const FaultLatchCounters& k = c.faults[faultSlot(f)];
+        os << "  latch " << faultToString(f) << ": fired=" << k.fired << " latched=" << k.latched
+            << " suppressed=" << k.suppressed << " repeated=" << k.repeated << "\n";
+    }
+    os << "  reset: requests=" << c.resetRequests << " cleared=" << c.resetsCleared << " idle=" << c.resetsIdle
+        << " rejected estop=" << c.resetRejectedEstop << " moving=" << c.resetRejectedMoving << "\n";
+    for (int a = 0; a < LiftCounters::kStates; ++a) {
+        for (int b = 0; b < LiftCounters::kStates; ++b) {
+            if (c.transitions[a][b] == 0) continue;
+            os << "  " << stateToString(static_cast<LiftState>(a)) << "->" << stateToString(static_cast<LiftState>(b))
+                << ": " << c.transitions[a][b] << "\n";
+        }
+    }
+    for (int s = 0; s < LiftCounters::kStates; ++s) {
+        os << "  dwell " << stateToString(static_cast<LiftState>(s)) << " (scans):";
+        for (int b = 0; b < LiftCounters::kDwellBins; ++b) {
+            if (c.dwell[s][b] == 0) continue;
+            os << " " << binLow(b);
+            if (b + 1 == LiftCounters::kDwellBins) os << "+";
+            else if (b > 0) os << "-" << binLow(b + 1) - 1;
+            os << "=" << c.dwell[s][b];
+        }
+        os << "\n";
+    }
+}
+
+void writeCountersJson(std::ostream& os, const LiftCounters& total, const std::vector<LiftCounters>& lifts, double dt) {
+    os << "{\"dt\":" << dt << ",\"total\":";
+    writeJson(os, total);
+    os << ",\"lifts\":[";
+    for (std::size_t i = 0; i < lifts.size(); ++i) {
+        if (i) os << ",";
+        writeJson(os, lifts[i]);
+    }
+    os << "]}\n";
+}
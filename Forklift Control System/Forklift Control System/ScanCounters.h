@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Hot-path counters around the controller, compiled in with FORKLIFT_COUNTERS=1.
+//
+// Per scan they count every fault-latch branch that fires and what became
+// of it (latched, suppressed by a higher-priority fault, or a repeat of the
+// fault already latched), every reset request and why the gate turned it
+// down, state transitions, and how long each state was held, as a log2
+// histogram of scans. Without the define the FORKLIFT_COUNT hooks in
+// LiftControl.h expand to nothing and the scan compiles as before.
+//
+// The hooks write to the LiftCounters the scanning thread selected with
+// selectScanCounters(): a lift's own counters, or the thread's aggregate
+// (threadCounters()) for large fleets. The selection also points at the
+// lift's running dwell count, which the caller keeps next to its state.
+
+#ifndef FORKLIFT_COUNTERS
+#define FORKLIFT_COUNTERS 0
+#endif
+
+#if FORKLIFT_COUNTERS
+#define FORKLIFT_COUNT(...) do { __VA_ARGS__; } while (false)
+#else
+#define FORKLIFT_COUNT(...) do {} while (false)
+#endif
+
+inline constexpr bool kCountersEnabled = FORKLIFT_COUNTERS != 0;
+
+// Defined in LiftControl.h, which includes this header
+enum class FaultCode : std::uint8_t;
+enum class LiftState : std::uint8_t;
+
+struct FaultLatchCounters {
+    std::uint64_t fired = 0;           // latch condition true
+    std::uint64_t latched = 0;         // became the latched fault
+    std::uint64_t suppressed = 0;      // a higher-priority fault was already latched
+    std::uint64_t repeated = 0;        // this fault was already latched
+};
+
+struct LiftCounters {
+    static constexpr int kFaults = 4;      // by faultSlot(); slot 0 (None) stays zero
+    static constexpr int kStates = 5;
+    static constexpr int kDwellBins = 16;  // bin b: held [2^b, 2^(b+1)) scans; the last bin is open-ended
+
+    std::uint64_t scans = 0;
+    FaultLatchCounters faults[kFaults] = {};
+    std::uint64_t resetRequests = 0;
+    std::uint64_t resetsCleared = 0;       // gate open with a fault latched
+    std::uint64_t resetsIdle = 0;          // gate open, nothing latched
+    std::uint64_t resetRejectedEstop = 0;
+    std::uint64_t resetRejectedMoving = 0; // |velocity| not below safeStopSpeedEps
+    std::uint64_t transitions[kStates][kStates] = {};
+    std::uint64_t dwell[kStates][kDwellBins] = {};
+
+    std::uint64_t totalTransitions() const;
+    void merge(const LiftCounters& o);
+};
+
+// Fault codes are 0, 10, 20, 30 in priority order (static_assert in ScanCounters.cpp)
+inline int faultSlot(FaultCode f) { return static_cast<std::uint8_t>(f) / 10; }
+
+inline int dwellBin(std::uint32_t scans) { return std::min(static_cast<int>(std::bit_width(scans)) - 1, LiftCounters::kDwellBins - 1); }
+
+struct ScanCounterContext {
+    LiftCounters* counters = nullptr;
+    std::uint32_t* dwell = nullptr;    // scans in the current state so far
+};
+
+inline thread_local ScanCounterContext scanCounterContext;
+
+// Counters for the lift this thread scans next; nullptr stops counting.
+inline void selectScanCounters(LiftCounters* counters, std::uint32_t* dwell) {
+    if constexpr (kCountersEnabled) scanCounterContext = { counters, dwell };
+    else (void)counters, (void)dwell;
+}
+
+// This thread's aggregate, kept until the thread exits and then folded into aggregateThreadCounters().
+LiftCounters& threadCounters();
+
+// Sum over every thread's aggregate, live or exited. Call while no scan is running.
+LiftCounters aggregateThreadCounters();
+
+// ---- Hooks (LiftControl.h) ----
+
+// FaultManager::latch(f) with `latched` the fault latched before it
+inline void countLatch(FaultCode f, FaultCode latched) {
+    LiftCounters* c = scanCounterContext.counters;
+    if (!c) return;
+    FaultLatchCounters& k = c->faults[faultSlot(f)];
+    k.fired++;
+    if (f == latched) k.repeated++;
+    else if (faultSlot(latched) > faultSlot(f)) k.suppressed++;
+    else k.latched++;
+}
+
+// Phase 2 with resetFault set
+inline void countReset(bool estop, bool moving, bool faultLatched) {
+    LiftCounters* c = scanCounterContext.counters;
+    if (!c) return;
+    c->resetRequests++;
+    if (estop) c->resetRejectedEstop++;
+    else if (moving) c->resetRejectedMoving++;
+    else if (faultLatched) c->resetsCleared++;
+    else c->resetsIdle++;
+}
+
+// End of phase 3: the state held since the last scan and the new one
+inline void countScan(LiftState before, LiftState after) {
+    LiftCounters* c = scanCounterContext.counters;
+    if (!c) return;
+    c->scans++;
+    std::uint32_t* dwell = scanCounterContext.dwell;
+    if (dwell) ++*dwell;
+    if (before == after) return;
+
+    const int from = static_cast<int>(before);
+    c->transitions[from][static_cast<int>(after)]++;
+    if (dwell) {
+        c->dwell[from][dwellBin(*dwell)]++;
+        *dwell = 0;
+    }
+}
+
+// ---- Reports ----
+
+// "counters: scans=... transitions=... (... per lift-second)" and one line per fault, reset, transition and dwell histogram
+void printCounters(std::ostream& os, const LiftCounters& c, double dt);
+
+// {"dt":..,"total":{..},"lifts":[{..},..]}; lifts may be empty
+void writeCountersJson(std::ostream& os, const LiftCounters& total, const std::vector<LiftCounters>& lifts, double dt);
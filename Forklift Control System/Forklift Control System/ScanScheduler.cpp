@@ -0,0 +1,109 @@
+#include "ScanScheduler.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+double ScanTiming::withinJitter(std::int64_t limitUs) const {
+    if (scans == 0) return 1.0;
+    std::uint64_t n = 0;
+    for (int b = 0; b < kBins && kBinUpperUs[b] <= limitUs; ++b) n += jitterBins[b];
+    return static_cast<double>(n) / scans;
+}
+
+DeadlineScheduler::DeadlineScheduler(std::chrono::microseconds period, std::chrono::microseconds spin)
+    : period_(period), spin_(spin) {
+}
+
+DeadlineScheduler::~DeadlineScheduler() {
+#if defined(_WIN32)
+    if (timerRaised_) timeEndPeriod(1);
+#endif
+}
+
+std::chrono::microseconds DeadlineScheduler::defaultSpin() {
+#if defined(_WIN32)
+    return std::chrono::microseconds(1500);  // even at 1 ms timer resolution sleeps overshoot
+#else
+    return std::chrono::microseconds(200);
+#endif
+}
+
+void DeadlineScheduler::start() {
+#if defined(_WIN32)
+    // Default Windows timer tick is 15.6 ms, longer than a scan.
+    if (!timerRaised_) timerRaised_ = timeBeginPeriod(1) == TIMERR_NOERROR;
+#endif
+    timing_ = ScanTiming{};
+    deadline_ = Clock::now();
+}
+
+void DeadlineScheduler::beginScan() {
+    scanStart_ = Clock::now();
+
+    const std::int64_t jitterUs = std::llabs(
+        std::chrono::duration_cast<std::chrono::microseconds>(scanStart_ - deadline_).count());
+    int b = 0;
+    while (jitterUs > ScanTiming::kBinUpperUs[b]) ++b;
+    timing_.jitterBins[b]++;
+    if (jitterUs > timing_.maxJitterUs) timing_.maxJitterUs = jitterUs;
+}
+
+void DeadlineScheduler::waitNext() {
+    const Clock::time_point end = Clock::now();
+    const std::int64_t latencyUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - scanStart_).count();
+    timing_.scans++;
+    timing_.lastLatencyUs = latencyUs;
+    timing_.sumLatencyUs += latencyUs;
+    if (latencyUs > timing_.maxLatencyUs) timing_.maxLatencyUs = latencyUs;
+
+    deadline_ += period_;
+    if (end > deadline_) {
+        // Overran: start the next scan immediately, but drop any whole periods
+        // we missed rather than bursting scans to catch up.
+        timing_.overruns++;
+        const auto behind = (end - deadline_) / period_;
+        timing_.skippedPeriods += static_cast<std::uint64_t>(behind);
+        deadline_ += behind * period_;
+        return;
+    }
+
+    // Coarse sleep, then spin for the final stretch.
+    const Clock::time_point wake = deadline_ - spin_;
+    if (Clock::now() < wake) std::this_thread::sleep_until(wake);
+    while (Clock::now() < deadline_) {
+    }
+}
+
+void printScanTiming(std::ostream& os, const ScanTiming& t) {
+    os << "scans=" << t.scans
+        << " overruns=" << t.overruns
+        << " skipped=" << t.skippedPeriods
+        << " latency_us(mean/max)=" << std::fixed << std::setprecision(1) << t.meanLatencyUs()
+        << "/" << t.maxLatencyUs
+        << " jitter_us(max)=" << t.maxJitterUs
+        << " within_200us=" << std::setprecision(2) << 100.0 * t.withinJitter(200) << "%\n";
+
+    std::int64_t lower = 0;
+    for (int b = 0; b < ScanTiming::kBins; ++b) {
+        os << "  jitter ";
+        if (ScanTiming::kBinUpperUs[b] == INT64_MAX) os << ">" << lower << "us";
+        else os << lower << "-" << ScanTiming::kBinUpperUs[b] << "us";
+        os << ": " << t.jitterBins[b] << "\n";
+        lower = ScanTiming::kBinUpperUs[b];
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+// Absolute-deadline scheduler for the real-time scan loop.
+//
+// Deadlines are k * period from start() on the steady clock, so time spent
+// in the scan (and console I/O) doesn't accumulate into the period the way
+// sleep_for(20ms) after the work does. The scheduler sleeps until shortly
+// before each deadline and spin-waits the last few microseconds.
+
+// Per-scan timing telemetry
+struct ScanTiming {
+    // Wake-up jitter histogram: |scan start - deadline| in microseconds
+    static constexpr int kBins = 9;
+    static constexpr std::int64_t kBinUpperUs[kBins] = { 10, 25, 50, 100, 200, 500, 1000, 5000, INT64_MAX };
+
+    std::uint64_t scans = 0;
+    std::uint64_t overruns = 0;        // scans whose work ran past the next deadline
+    std::uint64_t skippedPeriods = 0;  // whole periods dropped to re-align after an overrun
+    std::uint64_t jitterBins[kBins] = {};
+
+    std::int64_t maxJitterUs = 0;
+    std::int64_t lastLatencyUs = 0;    // work time of the last scan
+    std::int64_t maxLatencyUs = 0;
+    std::int64_t sumLatencyUs = 0;
+
+    double meanLatencyUs() const { return scans > 0 ? static_cast<double>(sumLatencyUs) / scans : 0.0; }
+
+    // Fraction of scans that started within +-limitUs of their deadline (bin resolution)
+    double withinJitter(std::int64_t limitUs) const;
+};
+
+class DeadlineScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit DeadlineScheduler(std::chrono::microseconds period,
+                               std::chrono::microseconds spin = defaultSpin());
+    ~DeadlineScheduler();
+
+    DeadlineScheduler(const DeadlineScheduler&) = delete;
+    DeadlineScheduler& operator=(const DeadlineScheduler&) = delete;
+
+    // First scan starts now.
+    void start();
+
+    // Call at the top of each scan; records wake-up jitter.
+    void beginScan();
+
+    // Call at the end of each scan; records latency and blocks until the next deadline.
+    void waitNext();
+
+    const ScanTiming& timing() const { return timing_; }
+
+    // Sleep granularity differs a lot between platforms.
+    static std::chrono::microseconds defaultSpin();
+
+private:
+    std::chrono::microseconds period_;
+    std::chrono::microseconds spin_;
+    Clock::time_point deadline_{};
+    Clock::time_point scanStart_{};
+    bool timerRaised_ = false;
+    ScanTiming timing_{};
+};
+
+// Multi-line report: scans, overruns, latency, jitter histogram
+void printScanTiming(std::ostream& os, const ScanTiming& t);
@@ -0,0 +1,83 @@
+#include "Script.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <istream>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    const std::size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const std::size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+} // namespace
+
+bool loadScript(std::istream& is, double dt, Script& script, std::string& error) {
+    script = Script{};
+
+    std::string raw;
+    int lineNo = 0;
+    while (std::getline(is, raw)) {
+        ++lineNo;
+        const std::string line = trim(raw.substr(0, raw.find('#')));
+        if (line.empty()) continue;
+
+        const std::size_t split = line.find_first_of(" \t");
+        if (split == std::string::npos) {
+            error = "line " + std::to_string(lineNo) + ": expected '<time_s> <command>'";
+            return false;
+        }
+
+        double t = 0.0;
+        try { t = std::stod(line.substr(0, split)); }
+        catch (...) {
+            error = "line " + std::to_string(lineNo) + ": bad time";
+            return false;
+        }
+        if (!(t >= 0.0)) {
+            error = "line " + std::to_string(lineNo) + ": time must be >= 0";
+            return false;
+        }
+
+        ScriptEvent ev{};
+        ev.scan = static_cast<std::int64_t>(std::llround(t / dt));
+        const ParseStatus st = parseCommand(trim(line.substr(split)), ev.cmd);
+        if (st == ParseStatus::BadLoad) {
+            error = "line " + std::to_string(lineNo) + ": bad load value";
+            return false;
+        }
+        if (st == ParseStatus::BadPosition) {
+            error = "line " + std::to_string(lineNo) + ": bad position value";
+            return false;
+        }
+        if (st == ParseStatus::Unknown) {
+            error = "line " + std::to_string(lineNo) + ": unknown command";
+            return false;
+        }
+        script.events.push_back(ev);
+    }
+
+    std::stable_sort(script.events.begin(), script.events.end(),
+        [](const ScriptEvent& a, const ScriptEvent& b) { return a.scan < b.scan; });
+
+    for (const ScriptEvent& ev : script.events) {
+        if (ev.cmd.verb == CommandVerb::Quit) {
+            script.quitScan = ev.scan;
+            break;
+        }
+    }
+    return true;
+}
+
+bool loadScriptFile(const std::string& path, double dt, Script& script, std::string& error) {
+    std::ifstream f(path);
+    if (!f) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return loadScript(f, dt, script, error);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Console.h"
+
+// Timestamped operator command script.
+//
+// One command per line, "<time_s> <command>", using the console verbs:
+//
+//     # raise, wait, drop the load
+//     0.0   l 900
+//     0.5   u
+//     3.0   s
+//     10.0  q
+//
+// Blank lines and '#' comments are ignored. Each time is rounded to the
+// nearest scan; events on the same scan apply in file order.
+
+struct ScriptEvent {
+    std::int64_t scan = 0;
+    Command cmd;
+};
+
+struct Script {
+    std::vector<ScriptEvent> events;   // sorted by scan
+    std::int64_t quitScan = -1;        // scan of the first 'q', -1 if none
+};
+
+// Returns false and sets error ("line N: ...") on a malformed line.
+bool loadScript(std::istream& is, double dt, Script& script, std::string& error);
+bool loadScriptFile(const std::string& path, double dt, Script& script, std::string& error);
@@ -0,0 +1,150 @@
+#include "SharedMemory.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+bool SharedMemory::create(const std::string& name, std::size_t size, std::string& error) {
+    close();
+
+    const std::string path = "Local\\" + name;
+    const unsigned long long size64 = size;
+    HANDLE m = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), path.c_str());
+    if (!m || GetLastError() == ERROR_ALREADY_EXISTS) {
+        if (m) CloseHandle(m);
+        error = "cannot create shared memory " + name + (m ? " (already exists)" : "");
+        return false;
+    }
+    void* p = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!p) {
+        CloseHandle(m);
+        error = "cannot map shared memory " + name;
+        return false;
+    }
+
+    mapping_ = m;
+    data_ = static_cast<unsigned char*>(p);
+    size_ = size;
+    owner_ = true;
+    name_ = name;
+    return true;
+}
+
+bool SharedMemory::open(const std::string& name, std::string& error) {
+    close();
+
+    const std::string path = "Local\\" + name;
+    HANDLE m = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+    void* p = m ? MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, 0) : nullptr;
+    MEMORY_BASIC_INFORMATION info{};
+    if (!p || VirtualQuery(p, &info, sizeof(info)) == 0) {
+        if (p) UnmapViewOfFile(p);
+        if (m) CloseHandle(m);
+        error = "cannot open shared memory " + name;
+        return false;
+    }
+
+    mapping_ = m;
+    data_ = static_cast<unsigned char*>(p);
+    size_ = info.RegionSize; // rounded up to whole pages
+    name_ = name;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_); // the mapping goes away with its last handle
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+    name_.clear();
+}
+
+#else
+
+bool SharedMemory::create(const std::string& name, std::size_t size, std::string& error) {
+    close();
+
+    const std::string path = "/" + name;
+    ::shm_unlink(path.c_str()); // a block left behind by a killed run
+    const int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0) {
+        error = "cannot create shared memory " + name;
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(path.c_str());
+        error = "cannot size shared memory " + name;
+        return false;
+    }
+
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        ::shm_unlink(path.c_str());
+        error = "cannot map shared memory " + name;
+        return false;
+    }
+
+    data_ = static_cast<unsigned char*>(p);
+    size_ = size;
+    owner_ = true;
+    name_ = name;
+    return true;
+}
+
+bool SharedMemory::open(const std::string& name, std::string& error) {
+    close();
+
+    const std::string path = "/" + name;
+    const int fd = ::shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        error = "cannot open shared memory " + name;
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        error = "cannot map shared memory " + name + " (empty)";
+        return false;
+    }
+
+    void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = "cannot map shared memory " + name;
+        return false;
+    }
+
+    data_ = static_cast<unsigned char*>(p);
+    size_ = static_cast<std::size_t>(st.st_size);
+    name_ = name;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (data_) ::munmap(data_, size_);
+    if (owner_) ::shm_unlink(("/" + name_).c_str());
+    data_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+    name_.clear();
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Named shared-memory block mapped read-write (POSIX shm_open, Windows
+// named file mapping in the Local\ namespace).
+//
+// create() makes a new zero-filled block and owns the name: close() (or
+// the destructor) removes it on POSIX. open() maps an existing block at its
+// full size.
+
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { close(); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    bool create(const std::string& name, std::size_t size, std::string& error);
+    bool open(const std::string& name, std::string& error);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    unsigned char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool owner_ = false;
+    std::string name_;
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
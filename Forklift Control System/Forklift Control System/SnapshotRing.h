@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, many-reader publication of the latest value (seqlock ring).
+//
+// publish() writes into the next of Slots slots, each guarded by its own
+// sequence number (odd while being written), then advances `latest`. A
+// reader copies the latest complete slot and checks that its sequence
+// didn't move during the copy. The writer never waits on readers, and
+// readers never write shared memory, so any number of them can read
+// without slowing the writer. A writer preempted mid-publish leaves the
+// previous slot intact, so a read only retries if the writer completes
+// Slots-1 further publications during that one copy.
+//
+// T must be trivially copyable; it is moved through relaxed atomic words,
+// so concurrent reads and writes are not a data race.
+
+template <class T, std::size_t Slots = 4>
+class SnapshotRing {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshots are copied as raw words");
+    static_assert(Slots >= 2, "readers need a slot the writer isn't in");
+
+public:
+    // Writer thread only.
+    void publish(const T& v) {
+        const std::uint64_t n = published_ + 1;
+        Slot& s = slots_[n % Slots];
+
+        std::uint64_t words[kWords] = {};
+        std::memcpy(words, &v, sizeof(T));
+
+        s.seq.store(2 * n - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i) s.words[i].store(words[i], std::memory_order_relaxed);
+        s.seq.store(2 * n, std::memory_order_release);
+
+        published_ = n;
+        latest_.store(n, std::memory_order_release);
+    }
+
+    // Any thread. Copies the latest snapshot into out and returns its
+    // publication number (1, 2, ...), or 0 if nothing was published yet.
+    std::uint64_t read(T& out, std::uint64_t* retries = nullptr) const {
+        for (;;) {
+            const std::uint64_t n = latest_.load(std::memory_order_acquire);
+            if (n == 0) return 0;
+            const Slot& s = slots_[n % Slots];
+
+            const std::uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before == 2 * n) {
+                std::uint64_t words[kWords];
+                for (std::size_t i = 0; i < kWords; ++i) words[i] = s.words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == before) {
+                    std::memcpy(&out, words, sizeof(T));
+                    return n;
+                }
+            }
+            // The writer lapped the ring into this slot; take the newer one.
+            if (retries) ++*retries;
+        }
+    }
+
+    // Publications so far (approximate when called concurrently)
+    std::uint64_t published() const { return latest_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + 7) / 8;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> seq{ 0 };
+        std::atomic<std::uint64_t> words[kWords];
+    };
+
+    // latest_ is read by every reader; published_ is the writer's own copy
+    alignas(64) std::atomic<std::uint64_t> latest_{ 0 };
+    std::uint64_t published_ = 0;
+    Slot slots_[Slots];
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "LiftControl.h"
+
+// Table-driven alternative to LiftController's phase 4.
+//
+// The (state, topLimit, bottomLimit) -> outputs mapping of the reference
+// switch in LiftController::driveOutputs() is written out as a truth table
+// and looked up by index, so a fleet of lifts in mixed states doesn't hit
+// a mispredicted branch per lift. Phases 1-3 are shared with LiftController.
+// Positioning has no row: its target velocity is a profile, not a tunable,
+// so those lifts run the reference switch.
+
+// Which tunable a row commands as target velocity
+enum class SpeedSelect : std::uint8_t {
+    Stop = 0,     // 0.0
+    Lift = 1,     // +liftSpeed
+    Lower = 2,    // -lowerSpeed
+};
+
+struct StateOutputRow {
+    SpeedSelect speed;
+    Outputs out;
+};
+
+constexpr int stateOutputIndex(LiftState s, bool topLimit, bool bottomLimit) {
+    return static_cast<int>(s) * 4 + (static_cast<int>(topLimit) << 1) + static_cast<int>(bottomLimit);
+}
+
+// .out = { motorEnable, motorDir, brakeEngaged, faultLamp }
+inline constexpr std::array<StateOutputRow, 16> kStateOutputTable = { {
+    // Holding (top, bottom) = 00, 01, 10, 11
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    // Lifting: stop at the top limit
+    { SpeedSelect::Lift,  { true,  +1, false, false } },
+    { SpeedSelect::Lift,  { true,  +1, false, false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    // Lowering: stop at the bottom limit
+    { SpeedSelect::Lower, { true,  -1, false, false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    { SpeedSelect::Lower, { true,  -1, false, false } },
+    { SpeedSelect::Stop,  { false,  0, true,  false } },
+    // Faulted
+    { SpeedSelect::Stop,  { false,  0, true,  true  } },
+    { SpeedSelect::Stop,  { false,  0, true,  true  } },
+    { SpeedSelect::Stop,  { false,  0, true,  true  } },
+    { SpeedSelect::Stop,  { false,  0, true,  true  } },
+} };
+
+template <class Config>
+struct BasicTableLiftController : BasicLiftController<Config> {
+    Outputs update(double dt, const Inputs& in, LiftPlant& plant) {
+        this->evaluate(in, plant);
+        return driveOutputs(dt, in, plant);
+    }
+
+    // Phase 4 by table lookup; same contract as BasicLiftController::driveOutputs().
+    constexpr Outputs driveOutputs(double dt, const Inputs& in, LiftPlant& plant) const {
+        if (this->state == LiftState::Positioning) return BasicLiftController<Config>::driveOutputs(dt, in, plant);
+        const StateOutputRow& row = kStateOutputTable[stateOutputIndex(this->state, in.topLimit, in.bottomLimit)];
+        const double speeds[3] = { 0.0, +this->liftSpeed, -this->lowerSpeed };
+        plant.targetVel = speeds[static_cast<int>(row.speed)];
+        return row.out;
+    }
+};
+
+using TableLiftController = BasicTableLiftController<DefaultMast>;
+using RuntimeTableLiftController = BasicTableLiftController<RuntimeMastConfig>;
+
+// Compile-time proof that the table reproduces the reference switch for
+// every (state, topLimit, bottomLimit) combination it has rows for.
+constexpr bool stateOutputTableMatchesReference() {
+    for (int s = 0; s < static_cast<int>(kStateOutputTable.size()) / 4; ++s) {
+        for (int limits = 0; limits < 4; ++limits) {
+            Inputs in{};
+            in.topLimit = (limits & 2) != 0;
+            in.bottomLimit = (limits & 1) != 0;
+
+            LiftController ref{};
+            ref.state = static_cast<LiftState>(s);
+            TableLiftController table{};
+            table.state = static_cast<LiftState>(s);
+
+            LiftPlant refPlant{};
+            LiftPlant tablePlant{};
+            refPlant.targetVel = tablePlant.targetVel = 123.0; // must be overwritten by both
+
+            const Outputs a = ref.driveOutputs(0.02, in, refPlant);
+            const Outputs b = table.driveOutputs(0.02, in, tablePlant);
+
+            if (a.motorEnable != b.motorEnable || a.motorDir != b.motorDir ||
+                a.brakeEngaged != b.brakeEngaged || a.faultLamp != b.faultLamp ||
+                refPlant.targetVel != tablePlant.targetVel) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(stateOutputTableMatchesReference(),
+              "kStateOutputTable disagrees with LiftController::driveOutputs()");
@@ -0,0 +1,124 @@
+#include "TelemetryCheck.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "Console.h"
+#include "TelemetrySink.h"
+
+namespace {
+
+std::vector<StatusSample> extremeSamples() {
+    using L = std::numeric_limits<double>;
+    const double values[] = {
+        0.0, -0.0, 0.5, -0.25, 900.0, 1e300, -1e300, L::max(), -L::max(), L::min(), L::denorm_min(),
+        L::infinity(), -L::infinity(), L::quiet_NaN(), -L::quiet_NaN(),
+    };
+    const std::size_t n = sizeof(values) / sizeof(values[0]);
+    std::vector<StatusSample> samples;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < 5; ++k) {
+            StatusSample s{};
+            s.scan = i * 5 + k;
+            s.lift = k == 0 ? std::numeric_limits<std::uint32_t>::max() : static_cast<std::uint32_t>(i);
+            s.position = values[(i + k) % n];
+            s.velocity = values[(i + 2 * k) % n];
+            s.loadKg = values[i];
+            s.state = static_cast<LiftState>(k % kLiftStates);
+            s.fault = k % 2 == 0 ? FaultCode::None : FaultCode::EmergencyStop;
+            s.topLimit = k & 1;
+            s.bottomLimit = k & 2;
+            s.estop = k & 4 || i & 1;
+            samples.push_back(s);
+        }
+    }
+    return samples;
+}
+
+// printStatus() with the lift prefix formatStatusLine() adds
+std::string referenceLine(const StatusSample& s) {
+    LiftPlant plant{};
+    plant.position = s.position;
+    plant.velocity = s.velocity;
+    Inputs in{};
+    in.topLimit = s.topLimit;
+    in.bottomLimit = s.bottomLimit;
+    in.loadKg = s.loadKg;
+    in.estop = s.estop;
+    std::ostringstream os;
+    os << "lift=" << s.lift << " ";
+    printStatus(os, plant, s.state, s.fault, in);
+    return os.str();
+}
+
+} // namespace
+
+bool TelemetryCheckReport::passed() const {
+    return error.empty() && lineMismatches == 0 && longestLine <= kMaxStatusLine && written == submitted &&
+           sinkOutputMatches;
+}
+
+TelemetryCheckReport checkTelemetry(std::uint64_t submissions) {
+    TelemetryCheckReport r;
+    const std::vector<StatusSample> samples = extremeSamples();
+    r.samples = samples.size();
+    if (submissions == 0) {
+        r.error = "submissions must be > 0";
+        return r;
+    }
+
+    std::vector<char> line(kMaxStatusLine);
+    for (const StatusSample& s : samples) {
+        const std::size_t len = formatStatusLine(line.data(), s, true);
+        r.longestLine = std::max(r.longestLine, len);
+        r.lineMismatches += std::string(line.data(), len) != referenceLine(s);
+    }
+
+    std::FILE* out = std::tmpfile();
+    if (!out) {
+        r.error = "cannot open a temporary file";
+        return r;
+    }
+    std::string expected;
+    {
+        TelemetrySink::Options opt{};
+        opt.decimation = 1;
+        opt.overflow = TelemetrySink::Overflow::Wait;
+        opt.withLift = true;
+        TelemetrySink sink(out, opt);
+        sink.start();
+        for (std::uint64_t i = 0; i < submissions; ++i) {
+            const StatusSample& s = samples[i % samples.size()];
+            sink.submit(s);
+            expected += referenceLine(s);
+        }
+        sink.stop();
+        r.submitted = submissions;
+        r.written = sink.written();
+    }
+
+    std::string actual;
+    std::rewind(out);
+    char chunk[4096];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), out)) > 0) actual.append(chunk, n);
+    std::fclose(out);
+    r.sinkOutputMatches = actual == expected;
+    return r;
+}
+
+void printTelemetryCheckReport(std::ostream& os, const TelemetryCheckReport& r) {
+    if (!r.error.empty()) {
+        os << "telemetry-check: " << r.error << "\n";
+        return;
+    }
+    os << "telemetry-check: samples=" << r.samples << " submitted=" << r.submitted << "\n"
+        << "  lines vs printStatus: mismatches=" << r.lineMismatches << " longest=" << r.longestLine
+        << " (limit " << kMaxStatusLine << ")\n"
+        << "  sink: written=" << r.written << " output " << (r.sinkOutputMatches ? "matches" : "DIFFERS") << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Formats extreme samples with formatStatusLine(), which must read like
+// printStatus() and fit kMaxStatusLine, then pushes them through a
+// TelemetrySink until the buffer fills; the file must hold them in order.
+
+struct TelemetryCheckReport {
+    std::size_t samples = 0;               // distinct samples
+    std::uint64_t submitted = 0;           // through the sink
+    std::uint64_t lineMismatches = 0;      // formatStatusLine() vs printStatus() (must be 0)
+    std::size_t longestLine = 0;           // must be <= kMaxStatusLine
+    std::uint64_t written = 0;             // by the sink (must be submitted)
+    bool sinkOutputMatches = false;
+    std::string error;
+
+    bool passed() const;
+};
+
+TelemetryCheckReport checkTelemetry(std::uint64_t submissions);
+
+void printTelemetryCheckReport(std::ostream& os, const TelemetryCheckReport& r);
@@ -0,0 +1,116 @@
+#include "TelemetrySink.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+StatusSample makeStatusSample(std::uint64_t scan, std::uint32_t lift, const LiftPlant& plant,
+                              LiftState state, FaultCode fault, const Inputs& in) {
+    StatusSample s{};
+    s.scan = scan;
+    s.lift = lift;
+    s.position = plant.position;
+    s.velocity = plant.velocity;
+    s.loadKg = in.loadKg;
+    s.state = state;
+    s.fault = fault;
+    s.topLimit = in.topLimit;
+    s.bottomLimit = in.bottomLimit;
+    s.estop = in.estop;
+    return s;
+}
+
+namespace {
+
+// Bounded writes: a field that doesn't fit is cut short, never written past end
+struct LineWriter {
+    char* p;
+    char* end;
+
+    void text(const char* s) {
+        const std::size_t n = std::min(std::strlen(s), static_cast<std::size_t>(end - p));
+        std::memcpy(p, s, n);
+        p += n;
+    }
+    void fixed3(double v) {
+        std::to_chars_result r = std::to_chars(p, end, v, std::chars_format::fixed, 3);
+        if (r.ec != std::errc()) r = std::to_chars(p, end, v, std::chars_format::scientific, 3);
+        if (r.ec == std::errc()) p = r.ptr;
+    }
+    void integer(std::uint64_t v) {
+        const std::to_chars_result r = std::to_chars(p, end, v);
+        if (r.ec == std::errc()) p = r.ptr;
+    }
+    void flag(bool b) {
+        if (p != end) *p++ = b ? '1' : '0';
+    }
+};
+
+} // namespace
+
+std::size_t formatStatusLine(char* buf, const StatusSample& s, bool withLift) {
+    // Same layout as printStatus(): std::fixed, precision 3, bools as 0/1.
+    LineWriter w{ buf, buf + kMaxStatusLine - 1 };   // the '\n' always fits
+    if (withLift) { w.text("lift="); w.integer(s.lift); w.text(" "); }
+    w.text("pos=");     w.fixed3(s.position);
+    w.text(" vel=");    w.fixed3(s.velocity);
+    w.text(" state=");  w.text(stateToString(s.state));
+    w.text(" fault=");  w.text(faultToString(s.fault));
+    w.text(" top=");    w.flag(s.topLimit);
+    w.text(" bot=");    w.flag(s.bottomLimit);
+    w.text(" load=");   w.fixed3(s.loadKg);
+    w.text(" estop=");  w.flag(s.estop);
+    *w.p++ = '\n';
+    return static_cast<std::size_t>(w.p - buf);
+}
+
+TelemetrySink::TelemetrySink(std::FILE* out, const Options& opt)
+    : out_(out), opt_(opt) {
+    if (opt_.decimation == 0) opt_.decimation = 1;
+}
+
+TelemetrySink::~TelemetrySink() {
+    stop();
+}
+
+void TelemetrySink::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this] { run(); });
+}
+
+void TelemetrySink::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+}
+
+std::size_t TelemetrySink::drain(char* buf, std::size_t cap) {
+    std::size_t len = 0;
+    StatusSample s{};
+    while (len + kMaxStatusLine <= cap && ring_.pop(s)) {
+        len += formatStatusLine(buf + len, s, opt_.withLift);
+        written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return len;
+}
+
+void TelemetrySink::run() {
+    std::vector<char> buf(64 * 1024);
+    for (;;) {
+        // Read the flag before draining so nothing submitted before stop() is missed.
+        const bool keepRunning = running_.load(std::memory_order_acquire);
+
+        std::size_t len;
+        bool wrote = false;
+        while ((len = drain(buf.data(), buf.size())) > 0) {
+            std::fwrite(buf.data(), 1, len, out_);
+            wrote = true;
+        }
+        if (wrote) std::fflush(out_);
+
+        if (!keepRunning) return;
+        if (!wrote) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
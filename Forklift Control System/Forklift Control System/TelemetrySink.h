@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "LiftControl.h"
+#include "SpscRing.h"
+
+// Status output off the control thread.
+//
+// The scan loop only copies a StatusSample into a preallocated SPSC ring;
+// a background thread formats the samples with std::to_chars and writes
+// them in batches. The text is the same status line printStatus() produces.
+
+struct StatusSample {
+    std::uint64_t scan = 0;
+    std::uint32_t lift = 0;
+    double position = 0.0;
+    double velocity = 0.0;
+    double loadKg = 0.0;
+    LiftState state = LiftState::Holding;
+    FaultCode fault = FaultCode::None;
+    bool topLimit = false;
+    bool bottomLimit = false;
+    bool estop = false;
+};
+
+StatusSample makeStatusSample(std::uint64_t scan, std::uint32_t lift, const LiftPlant& plant,
+                              LiftState state, FaultCode fault, const Inputs& in);
+
+// Format one status line (with trailing '\n') into buf. Returns the length;
+// buf needs kMaxStatusLine bytes. Every double is printed in full, like
+// std::fixed does, so the bound is three of the longest (-DBL_MAX: sign, 309
+// digits, point, 3 decimals) plus the labels, names and lift id.
+constexpr std::size_t kMaxFixed3 = 1 + 309 + 1 + 3;
+constexpr std::size_t kMaxStatusLine = 128 + 3 * kMaxFixed3;
+std::size_t formatStatusLine(char* buf, const StatusSample& s, bool withLift);
+
+class TelemetrySink {
+public:
+    enum class Overflow {
+        Drop,   // real-time: never stall the scan, count the sample as dropped
+        Wait,   // batch runs: wait for the writer, lose nothing
+    };
+
+    struct Options {
+        std::uint64_t decimation = 10;  // keep samples whose scan % decimation == 0
+        Overflow overflow = Overflow::Drop;
+        bool withLift = false;          // prefix lines with "lift=N"
+    };
+
+    TelemetrySink(std::FILE* out, const Options& opt);
+    ~TelemetrySink();
+
+    TelemetrySink(const TelemetrySink&) = delete;
+    TelemetrySink& operator=(const TelemetrySink&) = delete;
+
+    void start();
+
+    // Writes out everything queued, then stops the writer thread.
+    void stop();
+
+    // Producer side (one thread). Cheap: a decimation check and a copy.
+    void submit(const StatusSample& s) {
+        if (s.scan % opt_.decimation != 0) return;
+        if (ring_.push(s)) return;
+        if (opt_.overflow == Overflow::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        while (!ring_.push(s)) std::this_thread::yield();
+    }
+
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    std::size_t drain(char* buf, std::size_t cap);
+
+    std::FILE* out_;
+    Options opt_;
+    std::thread thread_;
+    std::atomic<bool> running_{ false };
+    std::atomic<std::uint64_t> written_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
+    SpscRing<StatusSample, 4096> ring_;
+};
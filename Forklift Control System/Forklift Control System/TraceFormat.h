@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LiftControl.h"
+
+// On-disk layout of a binary scan trace.
+//
+//     TraceFileHeader
+//     uint8 truck model * liftCount, zero-padded to 8 bytes (version 3)
+//     TraceChunkHeader, TraceRecord * recordCount,
+//                       TraceTargetEntry * targetCount  (repeated)
+//     TraceIndexEntry * chunkCount                      (written on close)
+//
+// Records are fixed width and stored scan-major, lift-minor: record number
+// r holds lift (r % liftCount) of scan (r / liftCount), so neither needs to
+// be stored. The truck model table holds each lift's index into
+// builtinTruckDynamics() (LoadDynamics.h), or kTraceNoTruckModel for a
+// fleet on the fixed dynamics, so a replay scans with the same tables. The
+// go-to target rarely changes and has no room in a record,
+// so each chunk lists the records whose target differs from the lift's
+// previous record (every lift starts at 0.0, the Inputs default). The
+// header's indexOffset stays 0 until the recorder is closed; a reader can
+// still walk the chunk headers of a trace that was cut short. All fields
+// are little-endian.
+//
+// Version 2 traces have no truck model table (every lift on the fixed
+// dynamics). Version 1 traces also have 16-byte chunk headers (no
+// targetCount/reserved), no target entries and input bit 7 unused. Readers
+// still accept both.
+
+#pragma pack(push, 1)
+
+struct TraceFileHeader {
+    char magic[8];                 // "FLTRACE\0"
+    std::uint16_t version;
+    std::uint16_t recordSize;      // sizeof(TraceRecord)
+    std::uint32_t liftCount;
+    double dt;
+    std::uint32_t recordsPerChunk;
+    std::uint32_t chunkCount;      // patched on close
+    std::uint64_t indexOffset;     // patched on close, 0 = no index
+};
+
+struct TraceChunkHeader {
+    std::uint32_t magic;           // kTraceChunkMagic
+    std::uint32_t recordCount;
+    std::uint64_t firstRecord;
+    std::uint32_t targetCount;     // TraceTargetEntry after the records (version 2)
+    std::uint32_t reserved;
+};
+
+// Inputs::targetPosition from record `record` on, for that record's lift
+struct TraceTargetEntry {
+    std::uint64_t record;
+    double targetPosition;
+};
+
+struct TraceIndexEntry {
+    std::uint64_t offset;          // of the TraceChunkHeader
+    std::uint64_t firstRecord;
+    std::uint32_t recordCount;
+    std::uint32_t reserved;
+};
+
+// One lift, one scan: the Inputs the controller saw, its Outputs and the
+// plant after the step. Doubles are stored exactly so replays can diff bit for bit.
+struct TraceRecord {
+    double position;
+    double velocity;
+    double targetVel;
+    double loadKg;
+    std::uint8_t inputBits;        // kIn*
+    std::uint8_t outputBits;       // kOut*
+    std::uint8_t state;            // LiftState
+    std::uint8_t fault;            // FaultCode
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(TraceFileHeader) == 40, "trace header layout");
+static_assert(sizeof(TraceChunkHeader) == 24, "trace chunk header layout");
+static_assert(sizeof(TraceTargetEntry) == 16, "trace target entry layout");
+static_assert(sizeof(TraceIndexEntry) == 24, "trace index layout");
+static_assert(sizeof(TraceRecord) == 36, "trace record layout");
+
+inline constexpr char kTraceMagic[8] = { 'F', 'L', 'T', 'R', 'A', 'C', 'E', '\0' };
+inline constexpr std::uint16_t kTraceVersion = 3;
+inline constexpr std::uint16_t kTraceVersionNoTrucks = 2;
+inline constexpr std::uint16_t kTraceVersionNoTargets = 1;
+inline constexpr std::size_t kTraceChunkHeaderV1Size = 16;
+inline constexpr std::uint32_t kTraceChunkMagic = 0x4B4E4843u; // "CHNK"
+inline constexpr std::uint8_t kTraceNoTruckModel = 0xFF;
+
+// Bytes of the truck model table that follows the file header (version 3)
+inline constexpr std::uint64_t traceTruckTableSize(std::uint32_t liftCount) {
+    return (std::uint64_t{ liftCount } + 7) & ~std::uint64_t{ 7 };
+}
+
+// Input bits
+inline constexpr std::uint8_t kInCmdUp = 1 << 0;
+inline constexpr std::uint8_t kInCmdDown = 1 << 1;
+inline constexpr std::uint8_t kInCmdHold = 1 << 2;
+inline constexpr std::uint8_t kInEstop = 1 << 3;
+inline constexpr std::uint8_t kInResetFault = 1 << 4;
+inline constexpr std::uint8_t kInTopLimit = 1 << 5;
+inline constexpr std::uint8_t kInBottomLimit = 1 << 6;
+inline constexpr std::uint8_t kInCmdGoTo = 1 << 7;      // the target is in the chunk's target entries
+
+// Output bits (motorDir is two bits: up / down)
+inline constexpr std::uint8_t kOutMotorEnable = 1 << 0;
+inline constexpr std::uint8_t kOutBrakeEngaged = 1 << 1;
+inline constexpr std::uint8_t kOutFaultLamp = 1 << 2;
+inline constexpr std::uint8_t kOutDirUp = 1 << 3;
+inline constexpr std::uint8_t kOutDirDown = 1 << 4;
+
+inline std::uint8_t packInputBits(const Inputs& in) {
+    return static_cast<std::uint8_t>(
+        (in.cmdUp ? kInCmdUp : 0) | (in.cmdDown ? kInCmdDown : 0) | (in.cmdHold ? kInCmdHold : 0) |
+        (in.estop ? kInEstop : 0) | (in.resetFault ? kInResetFault : 0) |
+        (in.topLimit ? kInTopLimit : 0) | (in.bottomLimit ? kInBottomLimit : 0) | (in.cmdGoTo ? kInCmdGoTo : 0));
+}
+
+// targetPosition is left at 0.0; the caller takes it from the target entries
+inline Inputs unpackInputs(std::uint8_t bits, double loadKg) {
+    Inputs in{};
+    in.cmdUp = (bits & kInCmdUp) != 0;
+    in.cmdDown = (bits & kInCmdDown) != 0;
+    in.cmdHold = (bits & kInCmdHold) != 0;
+    in.estop = (bits & kInEstop) != 0;
+    in.resetFault = (bits & kInResetFault) != 0;
+    in.topLimit = (bits & kInTopLimit) != 0;
+    in.bottomLimit = (bits & kInBottomLimit) != 0;
+    in.cmdGoTo = (bits & kInCmdGoTo) != 0;
+    in.loadKg = loadKg;
+    return in;
+}
+
+inline std::uint8_t packOutputBits(const Outputs& out) {
+    return static_cast<std::uint8_t>(
+        (out.motorEnable ? kOutMotorEnable : 0) | (out.brakeEngaged ? kOutBrakeEngaged : 0) |
+        (out.faultLamp ? kOutFaultLamp : 0) |
+        (out.motorDir > 0 ? kOutDirUp : 0) | (out.motorDir < 0 ? kOutDirDown : 0));
+}
+
+inline Outputs unpackOutputs(std::uint8_t bits) {
+    Outputs out{};
+    out.motorEnable = (bits & kOutMotorEnable) != 0;
+    out.brakeEngaged = (bits & kOutBrakeEngaged) != 0;
+    out.faultLamp = (bits & kOutFaultLamp) != 0;
+    out.motorDir = (bits & kOutDirUp) ? +1 : (bits & kOutDirDown) ? -1 : 0;
+    return out;
+}
+
+inline TraceRecord makeTraceRecord(const Inputs& in, const Outputs& out, const LiftPlant& plant,
+                                   LiftState state, FaultCode fault) {
+    TraceRecord r{};
+    r.position = plant.position;
+    r.velocity = plant.velocity;
+    r.targetVel = plant.targetVel;
+    r.loadKg = in.loadKg;
+    r.inputBits = packInputBits(in);
+    r.outputBits = packOutputBits(out);
+    r.state = static_cast<std::uint8_t>(state);
+    r.fault = static_cast<std::uint8_t>(fault);
+    return r;
+}
@@ -0,0 +1,120 @@
+#include "TraceReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool TraceReader::open(const std::string& path, std::string& error) {
+    chunks_.clear();
+    truckModels_.clear();
+    recordCount_ = 0;
+    if (!file_.open(path, error)) return false;
+
+    if (file_.size() < sizeof(TraceFileHeader)) {
+        error = "not a trace file (too short)";
+        return false;
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+    if (std::memcmp(header_.magic, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+        error = "not a trace file (bad magic)";
+        return false;
+    }
+    const bool known = header_.version == kTraceVersion || header_.version == kTraceVersionNoTrucks ||
+                       header_.version == kTraceVersionNoTargets;
+    if (!known || header_.recordSize != sizeof(TraceRecord)) {
+        error = "unsupported trace version";
+        return false;
+    }
+    if (header_.liftCount == 0) {
+        error = "corrupt trace header";
+        return false;
+    }
+
+    truckModels_.assign(header_.liftCount, kTraceNoTruckModel);
+    if (header_.version == kTraceVersion) {
+        if (firstChunkOffset() > file_.size()) {
+            error = "truck model table past end of file";
+            return false;
+        }
+        std::memcpy(truckModels_.data(), file_.data() + sizeof(TraceFileHeader), truckModels_.size());
+        // The fleet shares one set of tables: either every lift has a model or none does
+        const std::size_t fixed = static_cast<std::size_t>(
+            std::count(truckModels_.begin(), truckModels_.end(), kTraceNoTruckModel));
+        if (fixed != 0 && fixed != truckModels_.size()) {
+            error = "corrupt truck model table";
+            return false;
+        }
+    }
+
+    return indexed() ? loadIndex(error) : walkChunks(error);
+}
+
+std::uint64_t TraceReader::firstChunkOffset() const {
+    const std::uint64_t table = header_.version == kTraceVersion ? traceTruckTableSize(header_.liftCount) : 0;
+    return sizeof(TraceFileHeader) + table;
+}
+
+std::uint64_t TraceReader::chunkHeaderSize() const {
+    return header_.version == kTraceVersionNoTargets ? kTraceChunkHeaderV1Size : sizeof(TraceChunkHeader);
+}
+
+bool TraceReader::addChunk(std::uint64_t offset, std::string& error) {
+    const std::uint64_t headerSize = chunkHeaderSize();
+    if (offset + headerSize > file_.size()) {
+        error = "chunk header past end of file";
+        return false;
+    }
+    TraceChunkHeader ch{};   // a version 1 header leaves targetCount 0
+    std::memcpy(&ch, file_.data() + offset, static_cast<std::size_t>(headerSize));
+    if (ch.magic != kTraceChunkMagic || ch.firstRecord != recordCount_) {
+        error = "corrupt chunk at offset " + std::to_string(offset);
+        return false;
+    }
+    const std::uint64_t bodyOffset = offset + headerSize;
+    const std::uint64_t targetOffset = bodyOffset + std::uint64_t{ ch.recordCount } * sizeof(TraceRecord);
+    if (targetOffset + std::uint64_t{ ch.targetCount } * sizeof(TraceTargetEntry) > file_.size()) {
+        error = "chunk at offset " + std::to_string(offset) + " is truncated";
+        return false;
+    }
+
+    TraceChunk c{};
+    c.records = reinterpret_cast<const TraceRecord*>(file_.data() + bodyOffset);
+    c.firstRecord = ch.firstRecord;
+    c.recordCount = ch.recordCount;
+    c.targetCount = ch.targetCount;
+    c.targets = reinterpret_cast<const TraceTargetEntry*>(file_.data() + targetOffset);
+    chunks_.push_back(c);
+    recordCount_ += ch.recordCount;
+    return true;
+}
+
+bool TraceReader::loadIndex(std::string& error) {
+    const std::uint64_t end = header_.indexOffset + std::uint64_t{ header_.chunkCount } * sizeof(TraceIndexEntry);
+    if (end > file_.size()) {
+        error = "chunk index past end of file";
+        return false;
+    }
+    chunks_.reserve(header_.chunkCount);
+    for (std::uint32_t i = 0; i < header_.chunkCount; ++i) {
+        TraceIndexEntry e{};
+        std::memcpy(&e, file_.data() + header_.indexOffset + i * sizeof(TraceIndexEntry), sizeof(e));
+        if (!addChunk(e.offset, error)) return false;
+    }
+    return true;
+}
+
+bool TraceReader::walkChunks(std::string& error) {
+    // No index (recorder didn't close): follow chunk headers, keep every complete chunk.
+    std::uint64_t offset = firstChunkOffset();
+    std::string ignored;
+    while (offset + chunkHeaderSize() <= file_.size()) {
+        if (!addChunk(offset, ignored)) break;
+        const TraceChunk& c = chunks_.back();
+        offset += chunkHeaderSize() + std::uint64_t{ c.recordCount } * sizeof(TraceRecord) +
+                  std::uint64_t{ c.targetCount } * sizeof(TraceTargetEntry);
+    }
+    if (chunks_.empty()) {
+        error = "trace has no complete chunk";
+        return false;
+    }
+    return true;
+}
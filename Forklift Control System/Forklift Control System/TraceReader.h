@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TraceFormat.h"
+
+// Zero-copy reader for traces written by TraceRecorder.
+//
+// The file is memory-mapped; chunks() hands out pointers to the records
+// in place. Uses the chunk index when the trace was closed cleanly and
+// walks the chunk headers otherwise. Reads version 1 and 2 traces too (no
+// target entries, no truck models).
+
+struct TraceChunk {
+    const TraceRecord* records = nullptr;   // points into the mapping
+    std::uint64_t firstRecord = 0;
+    std::uint32_t recordCount = 0;
+    std::uint32_t targetCount = 0;
+    const TraceTargetEntry* targets = nullptr;   // go-to target changes, by record
+};
+
+class TraceReader {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    const TraceFileHeader& header() const { return header_; }
+    const std::vector<TraceChunk>& chunks() const { return chunks_; }
+    // Per lift, kTraceNoTruckModel for every lift of a fleet on the fixed dynamics
+    const std::vector<std::uint8_t>& truckModels() const { return truckModels_; }
+    std::uint64_t recordCount() const { return recordCount_; }
+    std::uint64_t scanCount() const { return recordCount_ / header_.liftCount; }
+    std::size_t fileSize() const { return file_.size(); }
+    bool indexed() const { return header_.indexOffset != 0; }
+
+private:
+    bool loadIndex(std::string& error);
+    bool walkChunks(std::string& error);
+    bool addChunk(std::uint64_t offset, std::string& error);
+    std::uint64_t chunkHeaderSize() const;
+    std::uint64_t firstChunkOffset() const;
+
+    MappedFile file_;
+    TraceFileHeader header_{};
+    std::vector<TraceChunk> chunks_;
+    std::vector<std::uint8_t> truckModels_;
+    std::uint64_t recordCount_ = 0;
+};
@@ -0,0 +1,133 @@
+#include "TraceRecorder.h"
+
+#include <cstring>
+
+#include "LiftFleet.h"
+#include "PackedFleet.h"
+
+bool TraceRecorder::open(const std::string& path, std::uint32_t liftCount, double dt,
+                         std::uint32_t recordsPerChunk) {
+    return openFile(path, liftCount, dt, recordsPerChunk, nullptr);
+}
+
+bool TraceRecorder::open(const std::string& path, const LiftFleet& fleet, double dt,
+                         std::uint32_t recordsPerChunk) {
+    return openFile(path, static_cast<std::uint32_t>(fleet.size()), dt, recordsPerChunk, &fleet);
+}
+
+bool TraceRecorder::openFile(const std::string& path, std::uint32_t liftCount, double dt,
+                             std::uint32_t recordsPerChunk, const LiftFleet* fleet) {
+    close();
+    if (liftCount == 0 || recordsPerChunk == 0) return false;
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+
+    header_ = TraceFileHeader{};
+    std::memcpy(header_.magic, kTraceMagic, sizeof(header_.magic));
+    header_.version = kTraceVersion;
+    header_.recordSize = sizeof(TraceRecord);
+    header_.liftCount = liftCount;
+    header_.dt = dt;
+    header_.recordsPerChunk = recordsPerChunk;
+
+    chunk_.assign(recordsPerChunk, TraceRecord{});
+    chunkFill_ = 0;
+    targets_.assign(recordsPerChunk, TraceTargetEntry{});
+    targetFill_ = 0;
+    target_.assign(liftCount, Inputs{}.targetPosition);
+    index_.clear();
+    index_.reserve(1024);
+    records_ = 0;
+    ok_ = std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+    bytes_ = sizeof(header_);
+
+    // Truck model table; empty truckModel means table 0 for every lift
+    std::vector<std::uint8_t> models(static_cast<std::size_t>(traceTruckTableSize(liftCount)), 0);
+    for (std::uint32_t i = 0; i < liftCount; ++i) {
+        if (!fleet || !fleet->dynamics) models[i] = kTraceNoTruckModel;
+        else if (i < fleet->truckModel.size()) models[i] = fleet->truckModel[i];
+    }
+    ok_ = ok_ && std::fwrite(models.data(), 1, models.size(), file_) == models.size();
+    bytes_ += models.size();
+    return ok_;
+}
+
+void TraceRecorder::reserve(std::uint64_t records) {
+    if (!file_) return;
+    const std::uint64_t chunks = (records + header_.recordsPerChunk - 1) / header_.recordsPerChunk;
+    index_.reserve(static_cast<std::size_t>(chunks));
+}
+
+void TraceRecorder::recordFleet(const LiftFleet& fleet) {
+    LiftPlant p{};
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        p.position = fleet.position[i];
+        p.velocity = fleet.velocity[i];
+        p.targetVel = fleet.targetVel[i];
+        record(makeTraceRecord(fleet.inputs[i], fleet.outputs[i], p, fleet.state[i], fleet.latched[i]), i,
+               fleet.inputs[i].targetPosition);
+    }
+}
+
+void TraceRecorder::recordFleet(const PackedFleet& fleet) {
+    // The hot record already holds the trace bit fields.
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        const PackedLift& h = fleet.hot[i];
+        TraceRecord r{};
+        r.position = h.position;
+        r.velocity = h.velocity;
+        r.targetVel = h.targetVel;
+        r.loadKg = fleet.cold[i].loadKg;
+        r.inputBits = static_cast<std::uint8_t>(h.inputBits & ~kInOverload);
+        r.outputBits = h.outputBits;
+        r.state = static_cast<std::uint8_t>(h.state);
+        r.fault = static_cast<std::uint8_t>(h.latched);
+        record(r);
+    }
+}
+
+void TraceRecorder::flushChunk() {
+    if (chunkFill_ == 0 || !file_) return;
+
+    TraceIndexEntry entry{};
+    entry.offset = bytes_;
+    entry.firstRecord = records_;
+    entry.recordCount = static_cast<std::uint32_t>(chunkFill_);
+    index_.push_back(entry);
+
+    TraceChunkHeader ch{};
+    ch.magic = kTraceChunkMagic;
+    ch.recordCount = entry.recordCount;
+    ch.firstRecord = records_;
+    ch.targetCount = static_cast<std::uint32_t>(targetFill_);
+    ok_ = ok_ && std::fwrite(&ch, sizeof(ch), 1, file_) == 1;
+    ok_ = ok_ && std::fwrite(chunk_.data(), sizeof(TraceRecord), chunkFill_, file_) == chunkFill_;
+    if (targetFill_ > 0) {
+        ok_ = ok_ && std::fwrite(targets_.data(), sizeof(TraceTargetEntry), targetFill_, file_) == targetFill_;
+    }
+
+    bytes_ += sizeof(ch) + sizeof(TraceRecord) * chunkFill_ + sizeof(TraceTargetEntry) * targetFill_;
+    records_ += chunkFill_;
+    chunkFill_ = 0;
+    targetFill_ = 0;
+}
+
+bool TraceRecorder::close() {
+    if (!file_) return ok_;
+
+    flushChunk();
+
+    header_.chunkCount = static_cast<std::uint32_t>(index_.size());
+    header_.indexOffset = bytes_;
+    if (!index_.empty()) {
+        ok_ = ok_ && std::fwrite(index_.data(), sizeof(TraceIndexEntry), index_.size(), file_) == index_.size();
+        bytes_ += sizeof(TraceIndexEntry) * index_.size();
+    }
+
+    ok_ = ok_ && std::fseek(file_, 0, SEEK_SET) == 0;
+    ok_ = ok_ && std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+    ok_ = (std::fclose(file_) == 0) && ok_;
+    file_ = nullptr;
+    return ok_;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LiftControl.h"
+#include "TraceFormat.h"
+
+struct LiftFleet;
+struct PackedFleet;
+
+// Appends one TraceRecord per lift per scan to a chunked binary trace
+// (layout in TraceFormat.h).
+//
+// Records collect in a chunk buffer allocated by open(); a full chunk is
+// written with a single fwrite. Go-to target changes collect next to them
+// (at most one per record) and follow the chunk's records. close() writes
+// the chunk index and patches the header.
+//
+// The index gains one entry per chunk. reserve() sizes it for a run of
+// known length, and then record() never allocates; past the reserved
+// records (or without reserve()) the index can grow, but only in the
+// flush at a chunk boundary.
+
+class TraceRecorder {
+public:
+    TraceRecorder() = default;
+    ~TraceRecorder() { close(); }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Every lift on the fixed dynamics
+    bool open(const std::string& path, std::uint32_t liftCount, double dt,
+              std::uint32_t recordsPerChunk = 16384);
+    // Sized to the fleet, with its lifts' truck models (LiftFleet::setDynamics
+    // with builtinTruckDynamics()) so a replay scans with the same tables
+    bool open(const std::string& path, const LiftFleet& fleet, double dt,
+              std::uint32_t recordsPerChunk = 16384);
+    bool isOpen() const { return file_ != nullptr; }
+
+    // Index room for `records` records in all, after open()
+    void reserve(std::uint64_t records);
+
+    // Next record (lifts of a scan in order, then the next scan); the lift's
+    // go-to target stays what it was, as for packed fleets (no go-to there)
+    void record(const TraceRecord& r) {
+        chunk_[chunkFill_++] = r;
+        if (chunkFill_ == chunk_.size()) flushChunk();
+    }
+
+    // Next record, for lift `lift`, with the go-to target the lift saw
+    void record(const TraceRecord& r, std::size_t lift, double targetPosition) {
+        if (std::bit_cast<std::uint64_t>(targetPosition) != std::bit_cast<std::uint64_t>(target_[lift])) {
+            targets_[targetFill_++] = TraceTargetEntry{ records(), targetPosition };
+            target_[lift] = targetPosition;
+        }
+        record(r);
+    }
+
+    void record(const Inputs& in, const Outputs& out, const LiftPlant& plant, LiftState state, FaultCode fault) {
+        record(makeTraceRecord(in, out, plant, state, fault), records() % header_.liftCount, in.targetPosition);
+    }
+
+    // Every lift of a fleet after LiftFleet::scan() / PackedFleet::scan()
+    void recordFleet(const LiftFleet& fleet);
+    void recordFleet(const PackedFleet& fleet);
+
+    // Flush, write the index, patch the header. Returns false on any write error.
+    bool close();
+
+    std::uint64_t records() const { return records_ + chunkFill_; }
+    std::uint64_t bytesWritten() const { return bytes_; }
+
+private:
+    bool openFile(const std::string& path, std::uint32_t liftCount, double dt, std::uint32_t recordsPerChunk,
+                  const LiftFleet* fleet);
+    void flushChunk();
+
+    std::FILE* file_ = nullptr;
+    TraceFileHeader header_{};
+    std::vector<TraceRecord> chunk_;
+    std::size_t chunkFill_ = 0;
+    std::vector<TraceTargetEntry> targets_;   // of the current chunk, one slot per record
+    std::size_t targetFill_ = 0;
+    std::vector<double> target_;              // per lift, as of the last record
+    std::vector<TraceIndexEntry> index_;
+    std::uint64_t records_ = 0;       // records in flushed chunks
+    std::uint64_t bytes_ = 0;
+    bool ok_ = true;
+};
@@ -0,0 +1,160 @@
+#include "TraceReplay.h"
+
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "LiftFleet.h"
+#include "LoadDynamics.h"
+
+namespace {
+
+bool sameBits(double a, double b) {
+    return std::bit_cast<std::uint64_t>(a) == std::bit_cast<std::uint64_t>(b);
+}
+
+// First field of the regenerated record that differs from the recorded one
+ReplayField firstDifference(const TraceRecord& rec, const TraceRecord& got) {
+    if (rec.inputBits != got.inputBits) return ReplayField::Limits; // commands are copied, so only limits can differ
+    if (rec.outputBits != got.outputBits) return ReplayField::Outputs;
+    if (rec.state != got.state) return ReplayField::State;
+    if (rec.fault != got.fault) return ReplayField::Fault;
+    if (!sameBits(rec.position, got.position)) return ReplayField::Position;
+    if (!sameBits(rec.velocity, got.velocity)) return ReplayField::Velocity;
+    if (!sameBits(rec.targetVel, got.targetVel)) return ReplayField::TargetVel;
+    return ReplayField::None;
+}
+
+void printRecord(std::ostream& os, const char* label, const TraceRecord& r) {
+    const Inputs in = unpackInputs(r.inputBits, r.loadKg);
+    const Outputs out = unpackOutputs(r.outputBits);
+    os << "  " << label
+        << std::defaultfloat << std::setprecision(17)   // round-trips the exact bits
+        << " pos=" << r.position << " vel=" << r.velocity << " target=" << r.targetVel
+        << std::fixed << std::setprecision(3)
+        << " load=" << r.loadKg
+        << " state=" << stateToString(static_cast<LiftState>(r.state))
+        << " fault=" << faultToString(static_cast<FaultCode>(r.fault))
+        << " top=" << in.topLimit << " bottom=" << in.bottomLimit
+        << " motor=" << out.motorEnable << " dir=" << out.motorDir
+        << " brake=" << out.brakeEngaged << " lamp=" << out.faultLamp
+        << "\n";
+}
+
+} // namespace
+
+const char* replayFieldToString(ReplayField f) {
+    switch (f) {
+    case ReplayField::None:      return "none";
+    case ReplayField::Limits:    return "limits";
+    case ReplayField::Outputs:   return "outputs";
+    case ReplayField::State:     return "state";
+    case ReplayField::Fault:     return "fault";
+    case ReplayField::Position:  return "position";
+    case ReplayField::Velocity:  return "velocity";
+    case ReplayField::TargetVel: return "targetVel";
+    default:                     return "UNKNOWN";
+    }
+}
+
+ReplayResult replayTrace(const TraceReader& trace, const ReplayOptions& opt) {
+    const std::uint32_t lifts = trace.header().liftCount;
+    const double dt = trace.header().dt;
+
+    LiftFleet fleet(lifts);
+    fleet.tableController = opt.tableController;
+
+    ReplayResult r{};
+    r.partialRecords = trace.recordCount() % lifts;
+
+    // The recorder's fleet shared builtinTruckDynamics(), or ran every lift on the fixed dynamics
+    static const TruckDynamics trucks = builtinTruckDynamics();
+    const std::vector<std::uint8_t>& models = trace.truckModels();
+    if (models[0] != kTraceNoTruckModel) {
+        fleet.setDynamics(&trucks);
+        for (std::uint32_t i = 0; i < lifts; ++i) {
+            if (models[i] >= trucks.count) {
+                r.error = "lift " + std::to_string(i) + " has unknown truck model " + std::to_string(models[i]);
+                return r;
+            }
+            fleet.setTruckModel(i, models[i]);
+        }
+    }
+
+    // Records of the scan being assembled; a scan may straddle two chunks.
+    std::vector<const TraceRecord*> scanRecords(lifts);
+    std::vector<double> target(lifts, Inputs{}.targetPosition);   // go-to target per lift
+
+    std::uint32_t lift = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const TraceChunk& chunk : trace.chunks()) {
+        std::uint32_t t = 0;
+        for (std::uint32_t k = 0; k < chunk.recordCount && !r.diverged; ++k) {
+            const TraceRecord& rec = chunk.records[k];
+            if (t < chunk.targetCount && chunk.targets[t].record == chunk.firstRecord + k) {
+                target[lift] = chunk.targets[t++].targetPosition;
+            }
+            scanRecords[lift] = &rec;
+            fleet.inputs[lift] = unpackInputs(rec.inputBits, rec.loadKg);
+            fleet.inputs[lift].targetPosition = target[lift];
+            if (++lift < lifts) continue;
+            lift = 0;
+
+            fleet.scan(dt);
+
+            LiftPlant p{};
+            for (std::uint32_t i = 0; i < lifts; ++i) {
+                p.position = fleet.position[i];
+                p.velocity = fleet.velocity[i];
+                p.targetVel = fleet.targetVel[i];
+                const TraceRecord got = makeTraceRecord(fleet.inputs[i], fleet.outputs[i], p,
+                                                        fleet.state[i], fleet.latched[i]);
+                const ReplayField f = firstDifference(*scanRecords[i], got);
+                if (f == ReplayField::None) continue;
+
+                r.diverged = true;
+                r.divergence.scan = r.scans;
+                r.divergence.lift = i;
+                r.divergence.field = f;
+                r.divergence.recorded = *scanRecords[i];
+                r.divergence.replayed = got;
+                break;
+            }
+            if (!r.diverged) ++r.scans;
+        }
+        if (r.diverged) break;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    r.records = r.scans * lifts;
+    r.wallSeconds = std::chrono::duration<double>(t1 - t0).count();
+    return r;
+}
+
+void printReplayResult(std::ostream& os, const ReplayResult& r, double dt) {
+    if (!r.error.empty()) {
+        os << "replay: " << r.error << "\n";
+        return;
+    }
+    const double mb = r.records * sizeof(TraceRecord) / (1024.0 * 1024.0);
+    os << std::fixed << std::setprecision(3)
+        << "replay: scans=" << r.scans
+        << " records=" << r.records
+        << " time=" << r.wallSeconds << "s"
+        << " records/s=" << (r.wallSeconds > 0.0 ? r.records / r.wallSeconds : 0.0)
+        << " MB/s=" << (r.wallSeconds > 0.0 ? mb / r.wallSeconds : 0.0)
+        << " result=" << (r.diverged ? "DIVERGED" : "identical")
+        << "\n";
+    if (r.partialRecords > 0) {
+        os << "  ignored " << r.partialRecords << " records of an incomplete last scan\n";
+    }
+    if (!r.diverged) return;
+
+    const ReplayDivergence& d = r.divergence;
+    os << "  first divergence: scan=" << d.scan << " (t=" << d.scan * dt << "s)"
+        << " lift=" << d.lift << " field=" << replayFieldToString(d.field) << "\n";
+    printRecord(os, "recorded:", d.recorded);
+    printRecord(os, "replayed:", d.replayed);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "LiftControl.h"
+#include "TraceReader.h"
+
+// Deterministic replay of a recorded trace.
+//
+// The recorded commands, go-to targets and load of every lift are fed back
+// through the controller and plant (a LiftFleet sized to the trace, so
+// single-lift and fleet traces replay the same way, on the recorded truck
+// models' tables if it has any) straight out of the mapped file. After each scan the regenerated limits, outputs, state,
+// latched fault and plant doubles are compared bit for bit with the
+// recording; the replay stops at the first divergence.
+
+enum class ReplayField { None, Limits, Outputs, State, Fault, Position, Velocity, TargetVel };
+
+const char* replayFieldToString(ReplayField f);
+
+struct ReplayDivergence {
+    std::uint64_t scan = 0;
+    std::uint32_t lift = 0;
+    ReplayField field = ReplayField::None;
+    TraceRecord recorded{};
+    TraceRecord replayed{};
+};
+
+struct ReplayOptions {
+    bool tableController = false;   // replay with TableLiftController
+};
+
+struct ReplayResult {
+    std::uint64_t scans = 0;            // scans replayed and matched
+    std::uint64_t records = 0;
+    std::uint64_t partialRecords = 0;   // trailing records of an incomplete scan (not replayed)
+    double wallSeconds = 0.0;
+    bool diverged = false;
+    ReplayDivergence divergence{};      // valid if diverged
+    std::string error;                  // nothing replayed (a truck model this build doesn't have)
+};
+
+ReplayResult replayTrace(const TraceReader& trace, const ReplayOptions& opt);
+
+// "replay: scans=... records=... time=...s MB/s=... result=identical" plus
+// the recorded and regenerated record on divergence
+void printReplayResult(std::ostream& os, const ReplayResult& r, double dt);
@@ -0,0 +1,235 @@
+#include "UdpSocket.h"
+
+#include <cstdlib>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+using NativeSocket = SOCKET;
+
+bool startSockets() {
+    static const bool started = [] {
+        WSADATA data{};
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+void closeNative(NativeSocket s) { closesocket(s); }
+#else
+using NativeSocket = int;
+
+bool startSockets() { return true; }
+
+void closeNative(NativeSocket s) { ::close(s); }
+#endif
+
+NativeSocket native(std::intptr_t fd) { return static_cast<NativeSocket>(fd); }
+
+sockaddr_in toSockaddr(const UdpEndpoint& ep) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(ep.address);
+    a.sin_port = htons(ep.port);
+    return a;
+}
+
+// Socket buffers sized for bursts of batched frames
+constexpr int kSocketBuffer = 4 << 20;
+
+} // namespace
+
+bool parseUdpEndpoint(const std::string& text, UdpEndpoint& ep, std::string& error) {
+    const std::size_t colon = text.rfind(':');
+    in_addr a{};
+    if (colon == std::string::npos || inet_pton(AF_INET, text.substr(0, colon).c_str(), &a) != 1) {
+        error = "expected a.b.c.d:port, got " + text;
+        return false;
+    }
+    char* end = nullptr;
+    const unsigned long port = std::strtoul(text.c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || port == 0 || port > 65535) {
+        error = "bad port in " + text;
+        return false;
+    }
+    ep.address = ntohl(a.s_addr);
+    ep.port = static_cast<std::uint16_t>(port);
+    return true;
+}
+
+bool UdpSocket::openSender(const UdpEndpoint& destination, std::string& error) {
+    close();
+    if (!startSockets()) {
+        error = "cannot initialize sockets";
+        return false;
+    }
+
+    const NativeSocket s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == native(kInvalid)) {
+        error = "cannot create UDP socket";
+        return false;
+    }
+    ::setsockopt(s, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&kSocketBuffer), sizeof(kSocketBuffer));
+    if (destination.multicast()) {
+        const unsigned char ttl = 1;
+        const unsigned char loop = 1;
+        ::setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char*>(&ttl), sizeof(ttl));
+        ::setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, reinterpret_cast<const char*>(&loop), sizeof(loop));
+    }
+
+    fd_ = static_cast<std::intptr_t>(s);
+    destination_ = destination;
+    return true;
+}
+
+bool UdpSocket::openReceiver(std::uint16_t port, const UdpEndpoint* group, std::string& error) {
+    close();
+    if (!startSockets()) {
+        error = "cannot initialize sockets";
+        return false;
+    }
+
+    const NativeSocket s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == native(kInvalid)) {
+        error = "cannot create UDP socket";
+        return false;
+    }
+    const int on = 1;
+    ::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+    ::setsockopt(s, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&kSocketBuffer), sizeof(kSocketBuffer));
+
+    UdpEndpoint local{};
+    local.port = port;
+    const sockaddr_in a = toSockaddr(local);
+    if (::bind(s, reinterpret_cast<const sockaddr*>(&a), sizeof(a)) != 0) {
+        closeNative(s);
+        error = "cannot bind UDP port " + std::to_string(port);
+        return false;
+    }
+    if (group && group->multicast()) {
+        ip_mreq m{};
+        m.imr_multiaddr.s_addr = htonl(group->address);
+        m.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (::setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char*>(&m), sizeof(m)) != 0) {
+            closeNative(s);
+            error = "cannot join multicast group";
+            return false;
+        }
+    }
+
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    ::fcntl(s, F_SETFL, ::fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    fd_ = static_cast<std::intptr_t>(s);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (fd_ != kInvalid) closeNative(native(fd_));
+    fd_ = kInvalid;
+}
+
+#if defined(__linux__)
+
+std::size_t UdpSocket::sendBatch(const UdpDatagram* datagrams, std::size_t count) {
+    if (fd_ == kInvalid || count == 0) return 0;
+
+    sockaddr_in to = toSockaddr(destination_);
+    std::size_t parts = 0;
+    for (std::size_t i = 0; i < count; ++i) parts += datagrams[i].partCount;
+
+    std::vector<iovec> iov(parts);
+    std::vector<mmsghdr> msgs(count);
+    std::size_t p = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        msghdr& h = msgs[i].msg_hdr;
+        h.msg_name = &to;
+        h.msg_namelen = sizeof(to);
+        h.msg_iov = &iov[p];
+        h.msg_iovlen = datagrams[i].partCount;
+        for (std::size_t k = 0; k < datagrams[i].partCount; ++k, ++p) {
+            iov[p].iov_base = const_cast<void*>(datagrams[i].parts[k].data);
+            iov[p].iov_len = datagrams[i].parts[k].size;
+        }
+    }
+
+    // sendmmsg may stop early (full buffer, interrupt); retry the rest once per call
+    std::size_t sent = 0;
+    while (sent < count) {
+        ++sendCalls_;
+        const int n = ::sendmmsg(native(fd_), &msgs[sent], static_cast<unsigned>(count - sent), 0);
+        if (n <= 0) break;
+        sent += static_cast<std::size_t>(n);
+    }
+    return sent;
+}
+
+#else
+
+std::size_t UdpSocket::sendBatch(const UdpDatagram* datagrams, std::size_t count) {
+    if (fd_ == kInvalid) return 0;
+
+    const sockaddr_in to = toSockaddr(destination_);
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        ++sendCalls_;
+#if defined(_WIN32)
+        std::vector<WSABUF> bufs(datagrams[i].partCount);
+        for (std::size_t k = 0; k < bufs.size(); ++k) {
+            bufs[k].buf = static_cast<char*>(const_cast<void*>(datagrams[i].parts[k].data));
+            bufs[k].len = static_cast<ULONG>(datagrams[i].parts[k].size);
+        }
+        DWORD bytes = 0;
+        if (WSASendTo(native(fd_), bufs.data(), static_cast<DWORD>(bufs.size()), &bytes, 0,
+                      reinterpret_cast<const sockaddr*>(&to), sizeof(to), nullptr, nullptr) == 0) ++sent;
+#else
+        std::vector<iovec> iov(datagrams[i].partCount);
+        for (std::size_t k = 0; k < iov.size(); ++k) {
+            iov[k].iov_base = const_cast<void*>(datagrams[i].parts[k].data);
+            iov[k].iov_len = datagrams[i].parts[k].size;
+        }
+        msghdr h{};
+        h.msg_name = const_cast<sockaddr_in*>(&to);
+        h.msg_namelen = sizeof(to);
+        h.msg_iov = iov.data();
+        h.msg_iovlen = iov.size();
+        if (::sendmsg(native(fd_), &h, 0) >= 0) ++sent;
+#endif
+    }
+    return sent;
+}
+
+#endif
+
+long UdpSocket::receive(void* buffer, std::size_t size) {
+    if (fd_ == kInvalid) return -1;
+#if defined(_WIN32)
+    const int n = ::recv(native(fd_), static_cast<char*>(buffer), static_cast<int>(size), 0);
+#else
+    const ssize_t n = ::recv(native(fd_), buffer, size, 0);
+#endif
+    return n < 0 ? -1 : static_cast<long>(n);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// IPv4 UDP socket for the gateway: a sender bound to one destination
+// (unicast or multicast) or a non-blocking receiver on a port.
+//
+// sendBatch() hands all datagrams to the kernel in one sendmmsg() call on
+// Linux and one WSASendTo() per datagram elsewhere. Each datagram is a
+// gather list, so headers and payload records need not be contiguous.
+
+struct UdpEndpoint {
+    std::uint32_t address = 0;     // host byte order
+    std::uint16_t port = 0;
+
+    bool multicast() const { return (address >> 28) == 0xE; } // 224.0.0.0/4
+};
+
+// "a.b.c.d:port"
+bool parseUdpEndpoint(const std::string& text, UdpEndpoint& ep, std::string& error);
+
+struct UdpBuffer {
+    const void* data;
+    std::size_t size;
+};
+
+struct UdpDatagram {
+    const UdpBuffer* parts;
+    std::size_t partCount;
+};
+
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket() { close(); }
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Multicast destinations get TTL 1 and loopback, so local dashboards see the frames.
+    bool openSender(const UdpEndpoint& destination, std::string& error);
+    // Binds INADDR_ANY:port; joins group if it is a multicast address.
+    bool openReceiver(std::uint16_t port, const UdpEndpoint* group, std::string& error);
+    void close();
+
+    bool isOpen() const { return fd_ != kInvalid; }
+
+    // Returns the number of datagrams the kernel accepted.
+    std::size_t sendBatch(const UdpDatagram* datagrams, std::size_t count);
+
+    // One datagram into buffer, without waiting; its size, or -1 if none is queued.
+    long receive(void* buffer, std::size_t size);
+
+    std::uint64_t sendCalls() const { return sendCalls_; }
+
+private:
+    static constexpr std::intptr_t kInvalid = -1;
+
+    std::intptr_t fd_ = kInvalid;
+    UdpEndpoint destination_{};
+    std::uint64_t sendCalls_ = 0;
+};
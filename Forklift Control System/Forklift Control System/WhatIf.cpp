@@ -0,0 +1,493 @@
+#include "WhatIf.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+#include "Rng.h"
+#include "WorkStealingPool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string trim(const std::string& s) {
+    const std::size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const std::size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+// A console verb on its own ("e", "l", "g", ...)
+bool parseVerb(const std::string& token, CommandVerb& verb) {
+    Command cmd{};
+    switch (parseCommand(token, cmd)) {
+    case ParseStatus::Ok: verb = cmd.verb; return true;
+    case ParseStatus::BadLoad: verb = CommandVerb::SetLoad; return true;
+    case ParseStatus::BadPosition: verb = CommandVerb::GoTo; return true;
+    case ParseStatus::Unknown: break;
+    }
+    return false;
+}
+
+bool parseSeconds(const std::string& token, double& t) {
+    try {
+        std::size_t used = 0;
+        t = std::stod(token, &used);
+        return used == token.size();
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+std::int64_t toScan(double t, double dt) { return static_cast<std::int64_t>(std::llround(t / dt)); }
+
+bool sameEvent(const ScriptEvent& a, const ScriptEvent& b) {
+    return a.scan == b.scan && a.cmd.verb == b.cmd.verb &&
+           std::memcmp(&a.cmd.value, &b.cmd.value, sizeof(double)) == 0;
+}
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) { return std::memcmp(&a, &b, sizeof(TraceRecord)) == 0; }
+
+TraceRecord recordOf(const HeadlessState& s) {
+    return makeTraceRecord(s.in, s.out, s.plant, s.ctrl.state, s.ctrl.faults.latched);
+}
+
+// Bit for bit, except the counters (empty outside FORKLIFT_COUNTERS builds)
+bool sameState(const HeadlessState& a, const HeadlessState& b) {
+    const auto same = [](const auto& x, const auto& y) { return std::memcmp(&x, &y, sizeof(x)) == 0; };
+    return a.scan == b.scan && a.nextEvent == b.nextEvent && same(a.plant.position, b.plant.position) &&
+           same(a.plant.velocity, b.plant.velocity) && same(a.plant.targetVel, b.plant.targetVel) &&
+           a.ctrl.state == b.ctrl.state && a.ctrl.faults.latched == b.ctrl.faults.latched &&
+           a.ctrl.inputKey == b.ctrl.inputKey && sameRecord(recordOf(a), recordOf(b)) &&
+           a.in.cmdGoTo == b.in.cmdGoTo && same(a.in.targetPosition, b.in.targetPosition);
+}
+
+// First fault, and where the branch's records leave the base's, from scan `from` on
+void summarize(WhatIfBranch& b, const WhatIfBranch* base, std::int64_t from) {
+    if (base && base->firstFaultScan >= 0 && base->firstFaultScan < from) {
+        b.firstFaultScan = base->firstFaultScan;
+        b.firstFault = base->firstFault;
+    }
+    for (std::int64_t s = from; s < b.history.size(); ++s) {
+        const TraceRecord& r = b.history[s];
+        if (b.firstFaultScan < 0 && r.fault != static_cast<std::uint8_t>(FaultCode::None)) {
+            b.firstFaultScan = s;
+            b.firstFault = static_cast<FaultCode>(r.fault);
+        }
+        if (base && b.divergeScan < 0 && (s >= base->history.size() || !sameRecord(r, base->history[s]))) {
+            b.divergeScan = s;
+        }
+        if (b.firstFaultScan >= 0 && (!base || b.divergeScan >= 0)) break;
+    }
+}
+
+// A shift-long operator script: a command every 10-80 scans
+Script randomScript(SplitMix64& rng, std::int64_t scans) {
+    Script sc{};
+    for (std::int64_t at = 0; at < scans; at += 10 + static_cast<std::int64_t>(rng.uniform() * 70.0)) {
+        ScriptEvent ev{};
+        ev.scan = at;
+        const double u = rng.uniform();
+        if (u < 0.25) ev.cmd.verb = CommandVerb::Up;
+        else if (u < 0.45) ev.cmd.verb = CommandVerb::Down;
+        else if (u < 0.55) ev.cmd.verb = CommandVerb::Stop;
+        else if (u < 0.60) ev.cmd.verb = CommandVerb::Hold;
+        else if (u < 0.66) ev.cmd.verb = CommandVerb::ToggleEstop;
+        else if (u < 0.78) ev.cmd.verb = CommandVerb::Reset;
+        else if (u < 0.88) {
+            ev.cmd.verb = CommandVerb::SetLoad;
+            ev.cmd.value = rng.uniform(200.0, 1400.0);
+        }
+        else {
+            ev.cmd.verb = CommandVerb::GoTo;
+            ev.cmd.value = rng.uniform(0.0, 1.0);
+        }
+        sc.events.push_back(ev);
+    }
+    return sc;
+}
+
+WhatIfVariant randomVariant(SplitMix64& rng, const Script& base, std::int64_t scans, std::size_t index) {
+    static constexpr CommandVerb kVerbs[] = { CommandVerb::Up, CommandVerb::Down, CommandVerb::Stop,
+                                              CommandVerb::ToggleEstop, CommandVerb::Reset, CommandVerb::SetLoad };
+    WhatIfVariant v{};
+    v.name = "v";
+    v.name += std::to_string(index);
+    const int edits = 1 + static_cast<int>(rng.uniform() * 3.0);
+    for (int k = 0; k < edits; ++k) {
+        WhatIfEdit e{};
+        const double u = rng.uniform();
+        e.kind = u < 0.4 ? WhatIfEditKind::Insert : u < 0.8 ? WhatIfEditKind::Shift : WhatIfEditKind::Drop;
+        e.verb = kVerbs[static_cast<std::size_t>(rng.uniform() * 6.0)];
+        e.fromScan = static_cast<std::int64_t>(rng.uniform() * static_cast<double>(scans));
+        e.shiftScans = static_cast<std::int64_t>(rng.uniform(-50.0, 50.0));
+        if (e.kind == WhatIfEditKind::Insert) {
+            // Mostly the same command as a base event, a little off its scan
+            if (!base.events.empty() && rng.chance(0.5)) {
+                e.event = base.events[static_cast<std::size_t>(rng.uniform() * static_cast<double>(base.events.size()))];
+                e.event.scan = std::max<std::int64_t>(0, e.event.scan + static_cast<std::int64_t>(rng.uniform(-20.0, 20.0)));
+            }
+            else {
+                e.event.scan = e.fromScan;
+                e.event.cmd.verb = rng.chance(0.1) ? CommandVerb::Quit : e.verb;   // a quit ends the branch early
+                e.event.cmd.value = rng.uniform(200.0, 1400.0);
+            }
+        }
+        v.edits.push_back(e);
+    }
+    return v;
+}
+
+} // namespace
+
+bool loadWhatIfVariants(std::istream& is, double dt, std::vector<WhatIfVariant>& variants, std::string& error) {
+    variants.clear();
+
+    std::string raw;
+    int lineNo = 0;
+    while (std::getline(is, raw)) {
+        ++lineNo;
+        const std::string line = trim(raw.substr(0, raw.find('#')));
+        if (line.empty()) continue;
+        const std::string where = "line " + std::to_string(lineNo) + ": ";
+
+        if (line.front() == '[') {
+            if (line.back() != ']' || line.size() < 3) {
+                error = where + "expected '[name]'";
+                return false;
+            }
+            variants.push_back(WhatIfVariant{ trim(line.substr(1, line.size() - 2)), {} });
+            continue;
+        }
+        if (variants.empty()) {
+            error = where + "edit before the first '[name]'";
+            return false;
+        }
+
+        std::istringstream words(line);
+        std::string op;
+        words >> op;
+        WhatIfEdit e{};
+        if (op == "at") {
+            std::string time;
+            words >> time;
+            double t = 0.0;
+            if (!parseSeconds(time, t) || !(t >= 0.0)) {
+                error = where + "bad time";
+                return false;
+            }
+            std::string rest;
+            std::getline(words, rest);
+            e.kind = WhatIfEditKind::Insert;
+            e.event.scan = toScan(t, dt);
+            const ParseStatus st = parseCommand(trim(rest), e.event.cmd);
+            if (st != ParseStatus::Ok) {
+                error = where + (st == ParseStatus::BadLoad ? "bad load value"
+                                 : st == ParseStatus::BadPosition ? "bad position value" : "unknown command");
+                return false;
+            }
+        }
+        else if (op == "shift" || op == "drop") {
+            e.kind = op == "shift" ? WhatIfEditKind::Shift : WhatIfEditKind::Drop;
+            std::string verb;
+            words >> verb;
+            if (!parseVerb(verb, e.verb)) {
+                error = where + "unknown command '" + verb + "'";
+                return false;
+            }
+            if (e.kind == WhatIfEditKind::Shift) {
+                std::string by;
+                words >> by;
+                double t = 0.0;
+                if (!parseSeconds(by, t)) {
+                    error = where + "bad shift";
+                    return false;
+                }
+                e.shiftScans = toScan(t, dt);
+            }
+            std::string from;
+            if (words >> from) {
+                std::string time;
+                double t = 0.0;
+                if (from != "from" || !(words >> time) || !parseSeconds(time, t) || !(t >= 0.0)) {
+                    error = where + "expected 'from <time_s>'";
+                    return false;
+                }
+                e.fromScan = toScan(t, dt);
+            }
+            std::string extra;
+            if (words >> extra) {
+                error = where + "unexpected '" + extra + "'";
+                return false;
+            }
+        }
+        else {
+            error = where + "expected at, shift or drop";
+            return false;
+        }
+        variants.back().edits.push_back(e);
+    }
+    return true;
+}
+
+bool loadWhatIfFile(const std::string& path, double dt, std::vector<WhatIfVariant>& variants, std::string& error) {
+    std::ifstream f(path);
+    if (!f) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return loadWhatIfVariants(f, dt, variants, error);
+}
+
+Script applyWhatIfEdits(const Script& base, const std::vector<WhatIfEdit>& edits) {
+    Script sc = base;
+    std::vector<ScriptEvent>& ev = sc.events;
+    for (const WhatIfEdit& e : edits) {
+        const auto applies = [&e](const ScriptEvent& x) { return x.cmd.verb == e.verb && x.scan >= e.fromScan; };
+        switch (e.kind) {
+        case WhatIfEditKind::Insert:
+            ev.push_back(e.event);
+            break;
+        case WhatIfEditKind::Shift:
+            for (ScriptEvent& x : ev) {
+                if (applies(x)) x.scan = std::max<std::int64_t>(0, x.scan + e.shiftScans);
+            }
+            break;
+        case WhatIfEditKind::Drop:
+            ev.erase(std::remove_if(ev.begin(), ev.end(), applies), ev.end());
+            break;
+        }
+        std::stable_sort(ev.begin(), ev.end(), [](const ScriptEvent& a, const ScriptEvent& b) { return a.scan < b.scan; });
+    }
+
+    sc.quitScan = -1;
+    for (const ScriptEvent& x : ev) {
+        if (x.cmd.verb == CommandVerb::Quit) {
+            sc.quitScan = x.scan;
+            break;
+        }
+    }
+    return sc;
+}
+
+std::int64_t firstDifferentScan(const Script& a, const Script& b) {
+    // Events before index i are equal and all earlier than both a[i] and b[i],
+    // so the two scripts apply the same events up to the earlier of those scans.
+    std::size_t i = 0;
+    while (i < a.events.size() && i < b.events.size() && sameEvent(a.events[i], b.events[i])) ++i;
+    if (i == a.events.size() && i == b.events.size()) return -1;
+    if (i == a.events.size()) return b.events[i].scan;
+    if (i == b.events.size()) return a.events[i].scan;
+    return std::min(a.events[i].scan, b.events[i].scan);
+}
+
+WhatIfReport runWhatIf(const Script& base, const std::vector<WhatIfVariant>& variants, const WhatIfOptions& opt) {
+    HeadlessOptions headless{};
+    headless.dt = opt.dt;
+    headless.durationScans = opt.durationScans;
+    const std::int64_t end = headlessEndScan(base, headless);
+
+    // A branch runs to its own script's end, like the same script headless. Up to its
+    // fork, or its end if that comes first, it is the base run (continued past the
+    // base's end if need be); start = -1 for a branch that is the base run throughout.
+    WhatIfReport r{};
+    r.base.name = "base";
+    r.branches.resize(variants.size());
+    std::vector<Script> scripts(variants.size());
+    std::vector<std::int64_t> ends(variants.size());
+    std::vector<std::int64_t> starts(variants.size(), -1);
+    std::vector<std::int64_t> forks;
+    for (std::size_t v = 0; v < variants.size(); ++v) {
+        scripts[v] = applyWhatIfEdits(base, variants[v].edits);
+        ends[v] = headlessEndScan(scripts[v], headless);
+        const std::int64_t d = firstDifferentScan(base, scripts[v]);
+        r.branches[v].name = variants[v].name;
+        r.branches[v].forkScan = d >= 0 && d < ends[v] ? d : -1;
+        if (r.branches[v].forkScan >= 0) starts[v] = d;
+        else if (ends[v] != end) starts[v] = ends[v];
+        if (starts[v] >= 0) forks.push_back(starts[v]);
+    }
+    std::sort(forks.begin(), forks.end());
+    forks.erase(std::unique(forks.begin(), forks.end()), forks.end());
+    const std::int64_t runEnd = forks.empty() ? end : std::max(end, forks.back());
+
+    // ---- Base run, stopping at every fork scan for a snapshot ----
+    const Clock::time_point t0 = Clock::now();
+    std::vector<HeadlessState> snapshots(forks.size());
+    auto records = std::make_shared<std::vector<TraceRecord>>();
+    records->reserve(static_cast<std::size_t>(runEnd));
+    HeadlessState s{};
+    for (std::size_t k = 0;;) {
+        if (k < forks.size() && forks[k] == s.scan) snapshots[k++] = s;
+        if (s.scan == end) r.base.final = s;
+        if (s.scan >= runEnd) break;
+        stepHeadless(s, base, opt.dt);
+        records->push_back(recordOf(s));
+    }
+    r.base.history = BranchHistory(records, end);
+    summarize(r.base, nullptr, 0);
+    const Clock::time_point t1 = Clock::now();
+
+    // ---- Branches in parallel, each from its fork's snapshot ----
+    WorkStealingPool pool(opt.threads);
+    pool.parallelFor(variants.size(), 1, [&](unsigned, std::uint64_t begin, std::uint64_t stop) {
+        for (std::uint64_t v = begin; v < stop; ++v) {
+            WhatIfBranch& b = r.branches[v];
+            if (starts[v] < 0) {
+                b.final = r.base.final;
+                b.history = r.base.history;
+                b.firstFaultScan = r.base.firstFaultScan;
+                b.firstFault = r.base.firstFault;
+                continue;
+            }
+            HeadlessState st = snapshots[static_cast<std::size_t>(
+                std::lower_bound(forks.begin(), forks.end(), starts[v]) - forks.begin())];
+            b.history = BranchHistory(records, starts[v]);
+            b.history.reserve(static_cast<std::size_t>(ends[v] - starts[v]));
+            while (st.scan < ends[v]) {
+                stepHeadless(st, scripts[v], opt.dt);
+                b.history.push(recordOf(st));
+            }
+            b.final = st;
+            summarize(b, &r.base, starts[v]);
+        }
+    });
+    const Clock::time_point t2 = Clock::now();
+
+    r.snapshots = forks.size();
+    r.threads = pool.threads();
+    r.scansRun = static_cast<std::uint64_t>(runEnd);
+    for (std::size_t v = 0; v < variants.size(); ++v) {
+        if (starts[v] < 0) continue;
+        r.scansRun += static_cast<std::uint64_t>(ends[v] - starts[v]);
+        r.scansShared += static_cast<std::uint64_t>(starts[v]);
+    }
+    r.baseSeconds = std::chrono::duration<double>(t1 - t0).count();
+    r.branchSeconds = std::chrono::duration<double>(t2 - t1).count();
+    return r;
+}
+
+void printWhatIfReport(std::ostream& os, const WhatIfReport& r, double dt) {
+    const auto seconds = [dt](std::int64_t scan) {
+        std::ostringstream t;
+        t << std::fixed << std::setprecision(3) << static_cast<double>(scan) * dt << "s";
+        return t.str();
+    };
+    const auto line = [&](const WhatIfBranch& b, bool fork) {
+        os << std::left << std::setw(20) << b.name << std::right;
+        if (fork) {
+            if (b.forkScan < 0) os << " fork=-";
+            else os << " fork=" << seconds(b.forkScan);
+            if (b.divergeScan < 0) os << " diverge=-";
+            else os << " diverge=" << seconds(b.divergeScan);
+        }
+        if (b.firstFaultScan < 0) os << " first-fault=-";
+        else os << " first-fault=" << seconds(b.firstFaultScan) << " " << faultToString(b.firstFault);
+        os << " end=" << stateToString(b.final.ctrl.state) << "/" << faultToString(b.final.ctrl.faults.latched)
+            << std::fixed << std::setprecision(3) << " pos=" << b.final.plant.position << "\n";
+    };
+
+    os << "scans=" << r.base.history.size() << " variants=" << r.branches.size() << " snapshots=" << r.snapshots
+        << " threads=" << r.threads << "\n";
+    line(r.base, false);
+    for (const WhatIfBranch& b : r.branches) line(b, true);
+
+    const double total = static_cast<double>(r.scansRun + r.scansShared);
+    os << "scans run=" << r.scansRun << " shared=" << r.scansShared << std::fixed << std::setprecision(1)
+        << " (" << (total > 0.0 ? 100.0 * static_cast<double>(r.scansShared) / total : 0.0) << "% not re-run)"
+        << std::setprecision(3) << " base=" << r.baseSeconds * 1e3 << "ms branches=" << r.branchSeconds * 1e3
+        << "ms\n";
+}
+
+WhatIfCheckReport checkWhatIf(std::size_t variants, std::uint64_t seed) {
+    constexpr std::size_t kBases = 4;
+    constexpr std::int64_t kScans = 3000;   // 60 s at 20 ms
+    constexpr double kDt = 0.02;
+
+    WhatIfCheckReport r{};
+    r.bases = kBases;
+    r.variants = variants;
+    r.scans = kScans;
+
+    for (std::size_t b = 0; b < kBases; ++b) {
+        SplitMix64 rng{ streamKey(seed, b) };
+        const Script base = randomScript(rng, kScans);
+        std::vector<WhatIfVariant> vs;
+        vs.push_back(WhatIfVariant{ "unchanged", {} });
+        for (std::size_t v = 1; v < variants; ++v) vs.push_back(randomVariant(rng, base, kScans, v));
+
+        // Every other base without a duration: each branch then ends with its own script
+        WhatIfOptions opt{};
+        opt.dt = kDt;
+        opt.durationScans = b % 2 == 0 ? kScans : -1;
+        HeadlessOptions headless{};
+        headless.dt = kDt;
+        headless.durationScans = opt.durationScans;
+        const std::int64_t baseEnd = headlessEndScan(base, headless);
+        const Clock::time_point t0 = Clock::now();
+        const WhatIfReport w = runWhatIf(base, vs, opt);
+        const Clock::time_point t1 = Clock::now();
+        r.forkSeconds += std::chrono::duration<double>(t1 - t0).count();
+        r.scansRun += w.scansRun;
+        r.scansShared += w.scansShared;
+
+        // ---- Every branch against its variant replayed from scan 0 ----
+        for (std::size_t v = 0; v < vs.size(); ++v) {
+            const WhatIfBranch& br = w.branches[v];
+            r.forked += br.forkScan >= 0;
+            const Script sc = applyWhatIfEdits(base, vs[v].edits);
+            const std::int64_t scans = headlessEndScan(sc, headless);
+            HeadlessState s{};
+            while (s.scan < scans) {
+                const std::int64_t scan = s.scan;
+                stepHeadless(s, sc, kDt);
+                r.recordMismatches += scan >= br.history.size() || !sameRecord(recordOf(s), br.history[scan]);
+            }
+            r.finalMismatches += !sameState(s, br.final) || br.history.size() != scans;
+        }
+        r.replaySeconds += std::chrono::duration<double>(Clock::now() - t1).count();
+
+        // ---- Snapshot, run on, restore, run on again ----
+        for (int k = 0; k < 8; ++k) {
+            const std::int64_t at = static_cast<std::int64_t>(rng.uniform() * static_cast<double>(baseEnd));
+            HeadlessState s{};
+            while (s.scan < at) stepHeadless(s, base, kDt);
+            const HeadlessState snap = s;
+            std::vector<TraceRecord> first;
+            while (s.scan < baseEnd) {
+                stepHeadless(s, base, kDt);
+                first.push_back(recordOf(s));
+            }
+            const HeadlessState end = s;
+            s = snap;
+            for (std::size_t i = 0; s.scan < baseEnd; ++i) {
+                stepHeadless(s, base, kDt);
+                r.restoreMismatches += !sameRecord(recordOf(s), first[i]);
+            }
+            r.restoreMismatches += !sameState(s, end) || !sameState(end, w.base.final);
+        }
+    }
+    return r;
+}
+
+void printWhatIfCheckReport(std::ostream& os, const WhatIfCheckReport& r) {
+    const double total = static_cast<double>(r.scansRun + r.scansShared);
+    os << "what-if-check: bases=" << r.bases << " variants=" << r.variants << " scans=" << r.scans
+        << " forked=" << r.forked << "\n"
+        << "  branches vs replay from scan 0: record mismatches=" << r.recordMismatches
+        << " final-state mismatches=" << r.finalMismatches << "\n"
+        << "  snapshot restore: mismatches=" << r.restoreMismatches << "\n"
+        << "  scans run=" << r.scansRun << " shared=" << r.scansShared << std::fixed << std::setprecision(1)
+        << " (" << (total > 0.0 ? 100.0 * static_cast<double>(r.scansShared) / total : 0.0) << "% not re-run)\n"
+        << std::setprecision(2) << "  ms: forked=" << r.forkSeconds * 1e3 << " replayed from 0=" << r.replaySeconds * 1e3
+        << "\n"
+        << "  result: " << (r.passed() ? "pass" : "FAIL") << "\n";
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Console.h"
+#include "Headless.h"
+#include "Script.h"
+#include "TraceFormat.h"
+
+// What-if forking of a headless run, for incident reviews.
+//
+// The base run replays a script; each variant is that script with a few
+// edits ("the E-stop 100 ms earlier", "a 1300 kg load at 12 s"). Up to the
+// first scan its events differ, a variant runs exactly like the base, so
+// the base run stops at every such scan once and keeps a HeadlessState
+// snapshot there. The variants then run in parallel on a WorkStealingPool,
+// each from its snapshot, instead of re-simulating from scan 0. Their
+// histories share the base's trace records before the fork copy-on-write:
+// a branch holds a reference to the base's records and stores only the
+// scans it ran itself.
+//
+// Variants file: "[name]" starts a variant, each line after it is an edit,
+// times in seconds, verbs as on the console:
+//
+//     [estop-100ms-early]
+//     shift e -0.1 from 9.5     # move every 'e' at or after 9.5 s
+//     [heavy-pallet]
+//     at 12.0 l 1300            # one more event
+//     [no-reset]
+//     drop r                    # remove every 'r' (from 0 s)
+
+enum class WhatIfEditKind {
+    Insert,   // at <time_s> <command>
+    Shift,    // shift <verb> <seconds> [from <time_s>]
+    Drop,     // drop <verb> [from <time_s>]
+};
+
+struct WhatIfEdit {
+    WhatIfEditKind kind = WhatIfEditKind::Insert;
+    ScriptEvent event{};                       // Insert
+    CommandVerb verb = CommandVerb::Stop;      // Shift, Drop: the events they apply to
+    std::int64_t fromScan = 0;                 // Shift, Drop: only events at or after this scan
+    std::int64_t shiftScans = 0;               // Shift; events are not moved before scan 0
+};
+
+struct WhatIfVariant {
+    std::string name;
+    std::vector<WhatIfEdit> edits;
+};
+
+// Returns false and sets error ("line N: ...") on a malformed line.
+bool loadWhatIfVariants(std::istream& is, double dt, std::vector<WhatIfVariant>& variants, std::string& error);
+bool loadWhatIfFile(const std::string& path, double dt, std::vector<WhatIfVariant>& variants, std::string& error);
+
+// The base script with the edits applied in order; events stay sorted by
+// scan, inserted ones after the existing events of their scan.
+Script applyWhatIfEdits(const Script& base, const std::vector<WhatIfEdit>& edits);
+
+// First scan whose events differ between a and b, or -1 if they have the same events
+std::int64_t firstDifferentScan(const Script& a, const Script& b);
+
+// Trace record of every scan of a branch: the shared records of the run it
+// forked from up to the fork, then its own.
+class BranchHistory {
+public:
+    BranchHistory() = default;
+    BranchHistory(std::shared_ptr<const std::vector<TraceRecord>> prefix, std::int64_t prefixScans)
+        : prefix_(std::move(prefix)), prefixScans_(prefixScans) {}
+
+    void push(const TraceRecord& r) { own_.push_back(r); }
+    void reserve(std::size_t scans) { own_.reserve(scans); }
+
+    std::int64_t size() const { return prefixScans_ + static_cast<std::int64_t>(own_.size()); }
+    std::int64_t sharedScans() const { return prefixScans_; }
+
+    const TraceRecord& operator[](std::int64_t scan) const {
+        return scan < prefixScans_ ? (*prefix_)[static_cast<std::size_t>(scan)]
+                                   : own_[static_cast<std::size_t>(scan - prefixScans_)];
+    }
+
+private:
+    std::shared_ptr<const std::vector<TraceRecord>> prefix_;
+    std::int64_t prefixScans_ = 0;
+    std::vector<TraceRecord> own_;
+};
+
+struct WhatIfBranch {
+    std::string name;
+    std::int64_t forkScan = -1;        // scan it left the base run on; -1 = the same events as the base
+    std::int64_t divergeScan = -1;     // first scan whose record differs from the base's; -1 = none
+    std::int64_t firstFaultScan = -1;  // first scan that ended with a fault latched; -1 = none
+    FaultCode firstFault = FaultCode::None;
+    HeadlessState final{};             // after the last scan
+    BranchHistory history;
+};
+
+struct WhatIfOptions {
+    double dt = 0.02;
+    std::int64_t durationScans = -1;   // -1: each branch ends with its own script (headlessEndScan())
+    unsigned threads = 0;              // 0 = one per hardware thread
+};
+
+struct WhatIfReport {
+    WhatIfBranch base;
+    std::vector<WhatIfBranch> branches;   // in variant order
+    std::size_t snapshots = 0;            // distinct fork scans
+    unsigned threads = 0;
+    std::uint64_t scansRun = 0;           // base plus every branch after its fork
+    std::uint64_t scansShared = 0;        // branch scans taken from the base instead of re-run
+    double baseSeconds = 0.0;
+    double branchSeconds = 0.0;
+};
+
+WhatIfReport runWhatIf(const Script& base, const std::vector<WhatIfVariant>& variants, const WhatIfOptions& opt);
+
+// The base run, one line per branch, then the sharing and timing
+void printWhatIfReport(std::ostream& os, const WhatIfReport& r, double dt);
+
+// Self-check: random base scripts and variants, some inserting a quit.
+// Every branch must match its variant script run headless from scan 0 to
+// that script's own end, record for record and in its final state, and a
+// run restored from a snapshot must continue exactly like the one it was
+// taken from.
+struct WhatIfCheckReport {
+    std::size_t bases = 0;
+    std::size_t variants = 0;             // per base
+    std::int64_t scans = 0;               // per run with a duration; the others end with their scripts
+    std::uint64_t forked = 0;             // branches that left their base
+    std::uint64_t recordMismatches = 0;   // branch history vs replay from scan 0 (must be 0)
+    std::uint64_t finalMismatches = 0;    // branch final state vs the same (must be 0)
+    std::uint64_t restoreMismatches = 0;  // restored snapshot vs uninterrupted run (must be 0)
+    std::uint64_t scansRun = 0;
+    std::uint64_t scansShared = 0;
+    double forkSeconds = 0.0;             // runWhatIf(), every base
+    double replaySeconds = 0.0;           // the same variants from scan 0, one thread
+
+    bool passed() const {
+        return recordMismatches == 0 && finalMismatches == 0 && restoreMismatches == 0 && scansShared > 0;
+    }
+};
+
+WhatIfCheckReport checkWhatIf(std::size_t variants, std::uint64_t seed);
+
+void printWhatIfCheckReport(std::ostream& os, const WhatIfCheckReport& r);
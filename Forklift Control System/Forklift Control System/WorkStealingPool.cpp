@@ -0,0 +1,81 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Block {
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+struct alignas(64) WorkQueue {
+    std::mutex m;
+    std::deque<Block> blocks;
+
+    bool popBack(Block& b) {
+        std::lock_guard<std::mutex> lock(m);
+        if (blocks.empty()) return false;
+        b = blocks.back();
+        blocks.pop_back();
+        return true;
+    }
+
+    bool stealFront(Block& b) {
+        std::lock_guard<std::mutex> lock(m);
+        if (blocks.empty()) return false;
+        b = blocks.front();
+        blocks.pop_front();
+        return true;
+    }
+};
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+    : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+void WorkStealingPool::parallelFor(std::uint64_t count, std::uint64_t grain, const Body& body) {
+    if (count == 0) return;
+    grain = std::max<std::uint64_t>(grain, 1);
+
+    const std::uint64_t blockCount = (count + grain - 1) / grain;
+    const unsigned workers = static_cast<unsigned>(std::min<std::uint64_t>(threads_, blockCount));
+
+    // Deal contiguous runs of blocks so each worker starts on its own stretch.
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (unsigned w = 0; w < workers; ++w) queues.push_back(std::make_unique<WorkQueue>());
+    for (std::uint64_t b = 0; b < blockCount; ++b) {
+        const unsigned w = static_cast<unsigned>(b * workers / blockCount);
+        queues[w]->blocks.push_back({ b * grain, std::min(count, (b + 1) * grain) });
+    }
+
+    auto run = [&](unsigned self) {
+        Block b{};
+        for (;;) {
+            if (queues[self]->popBack(b)) {
+                body(self, b.begin, b.end);
+                continue;
+            }
+            bool stole = false;
+            for (unsigned k = 1; k < workers && !stole; ++k) {
+                stole = queues[(self + k) % workers]->stealFront(b);
+            }
+            if (!stole) return;
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            body(self, b.begin, b.end);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) pool.emplace_back(run, w);
+    run(0);
+    for (std::thread& t : pool) t.join();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Minimal work-stealing parallel-for.
+//
+// [0, count) is cut into blocks of `grain` items. Each worker starts with a
+// contiguous run of blocks in its own deque and pops from the back; a
+// worker whose deque is empty steals from the front of the others. No new
+// work appears while a loop runs, so a worker that finds every deque empty
+// is done.
+//
+// Workers are started per call. Which worker runs which block depends on
+// timing, so anything the body accumulates must be merged in an
+// order-independent way (sums, minimums) to stay reproducible.
+
+class WorkStealingPool {
+public:
+    using Body = std::function<void(unsigned worker, std::uint64_t begin, std::uint64_t end)>;
+
+    explicit WorkStealingPool(unsigned threads);   // 0 = one per hardware thread
+
+    unsigned threads() const { return threads_; }
+
+    // body(worker, begin, end) for every block; returns when all are done.
+    void parallelFor(std::uint64_t count, std::uint64_t grain, const Body& body);
+
+    // Blocks taken from another worker's deque (all calls so far)
+    std::uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    unsigned threads_;
+    std::atomic<std::uint64_t> steals_{ 0 };
+};
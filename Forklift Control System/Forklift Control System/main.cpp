@@ -1,319 +1,911 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <csignal>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
-#include <thread>
-
-// PLC-style "scan" data
+#include <type_traits>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "ApiCheck.h"
+#include "ArenaCheck.h"
+#include "Campaign.h"
+#include "ColumnarExport.h"
+#include "Conformance.h"
+#include "Console.h"
+#include "ControllerDiff.h"
+#include "DynamicsCheck.h"
+#include "EventFleet.h"
+#include "ExportCheck.h"
+#include "FleetScheduler.h"
+#include "GatewayServer.h"
+#include "Headless.h"
+#include "LiftControl.h"
+#include "LiftFleet.h"
+#include "LiftSnapshot.h"
+#include "MastCheck.h"
+#include "OperatorCheck.h"
+#include "OperatorInput.h"
+#include "PackedFleet.h"
+#include "PlantKernels.h"
+#include "PlantSegment.h"
+#include "PositionCheck.h"
+#include "Rng.h"
+#include "ScanCounters.h"
+#include "ScanScheduler.h"
+#include "TelemetryCheck.h"
+#include "TelemetrySink.h"
+#include "TraceReader.h"
+#include "TraceRecorder.h"
+#include "TraceReplay.h"
+#include "WhatIf.h"
+
+// Fleet batch run
+
+// Deterministic operator pattern for fleet runs: each lift cycles
+// up / stop / down / stop (+ reset pulse), staggered so the fleet is never in lock-step.
+static void driveFleetOperator(Inputs& in, std::size_t lift, long scan) {
+    const long phase = (scan + static_cast<long>(lift) * 37) % 400;
+    in.cmdUp = phase < 120;
+    in.cmdDown = phase >= 200 && phase < 335;
+    in.cmdHold = false;
+    in.resetFault = phase == 399;
+}
 
-struct Inputs {
-    bool cmdUp = false;
-    bool cmdDown = false;
-    bool cmdHold = false;      // optional explicit hold command
-    bool estop = false;
-    bool resetFault = false;
+// With --truck: a new pallet every cycle, anywhere from empty to the truck's rated load
+static void driveFleetLoad(Inputs& in, std::size_t lift, long scan, double ratedLoadKg) {
+    const long cycle = (scan + static_cast<long>(lift) * 37) / 400;
+    const std::uint64_t pallet = splitMix64((static_cast<std::uint64_t>(lift) << 32) ^ static_cast<std::uint64_t>(cycle));
+    in.loadKg = ratedLoadKg * static_cast<double>(pallet % 101) / 100.0;
+}
 
-    bool topLimit = false;
-    bool bottomLimit = true;   // start at bottom in this sim
+// Close a trace (if one was opened) and report its size.
+static bool closeTrace(TraceRecorder& recorder) {
+    if (!recorder.isOpen()) return true;
+    const std::uint64_t records = recorder.records();
+    if (!recorder.close()) {
+        std::cout << "Trace write failed.\n";
+        return false;
+    }
+    std::cout << "trace: records=" << records << " bytes=" << recorder.bytesWritten() << "\n";
+    return true;
+}
 
-    double loadKg = 0.0;       // for overload detection
-};
+// Close a Parquet export (if one was opened) and report its size.
+static bool closeExport(ParquetTraceWriter& writer) {
+    if (!writer.isOpen()) return true;
+    if (!writer.close()) {
+        std::cout << "Export write failed.\n";
+        return false;
+    }
+    std::cout << "export: rows=" << writer.rows() << " row groups=" << writer.rowGroups()
+        << " bytes=" << writer.bytesWritten() << "\n";
+    return true;
+}
 
-struct Outputs {
-    bool motorEnable = false;
-    int motorDir = 0;          // +1 up, -1 down, 0 none
-    bool brakeEngaged = true;  // true = brake on
-    bool faultLamp = false;
+struct FleetRunOptions {
+    std::size_t lifts = 0;
+    long scans = 0;
+    bool tableController = false;
+    bool packed = false;
+    std::uint64_t printEvery = 0;
+    std::string recordPath;
+    std::string exportPath;            // Parquet file (ColumnarExport.h)
+    std::string countersPath;
+    bool perLiftCounters = false;
+    unsigned threads = 0;              // > 0: scan with a FleetScheduler (soa layout only)
+    std::string truck;                 // LoadDynamics truck model or "mixed"; empty = fixed dynamics (soa only)
+    FleetSchedulerOptions scheduler;
 };
 
+// Counters dump for --counters (ScanCounters.h)
+static bool writeCountersFile(const std::string& path, const LiftCounters& total,
+                              const std::vector<LiftCounters>& lifts, double dt) {
+    std::ofstream os(path);
+    if (os) writeCountersJson(os, total, lifts, dt);
+    if (!os) {
+        std::cout << "Cannot write counters file: " << path << "\n";
+        return false;
+    }
+    return true;
+}
 
-// Faults with explicit priority
+static void enablePerLiftCounters(LiftFleet& fleet) { fleet.enablePerLiftCounters(); }
+static void enablePerLiftCounters(PackedFleet&) {}
+static const std::vector<LiftCounters>& perLiftCounters(const LiftFleet& fleet) { return fleet.liftCounters; }
+static const std::vector<LiftCounters>& perLiftCounters(const PackedFleet&) {
+    static const std::vector<LiftCounters> none;
+    return none;
+}
 
-enum class FaultCode : int {
-    None = 0,
-    LimitViolation = 10,
-    Overload = 20,
-    EmergencyStop = 30,
-};
+// Per-lift access for runFleet, one overload set per fleet layout.
+static void driveFleet(LiftFleet& fleet, long scan) {
+    for (std::size_t i = 0; i < fleet.size(); ++i) driveFleetOperator(fleet.inputs[i], i, scan);
+}
 
-static const char* faultToString(FaultCode f) {
-    switch (f) {
-    case FaultCode::None: return "None";
-    case FaultCode::LimitViolation: return "LimitViolation";
-    case FaultCode::Overload: return "Overload";
-    case FaultCode::EmergencyStop: return "EmergencyStop";
+static void driveFleet(PackedFleet& fleet, long scan) {
+    Inputs in{};
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        driveFleetOperator(in, i, scan);
+        fleet.setCommands(i, in);
     }
-    return "Unknown";
 }
 
-// Higher number = higher priority
-static int faultPriority(FaultCode f) {
-    return static_cast<int>(f);
+static StatusSample fleetSample(const LiftFleet& fleet, std::size_t i, long scan) {
+    LiftPlant p{};
+    p.position = fleet.position[i];
+    p.velocity = fleet.velocity[i];
+    return makeStatusSample(static_cast<std::uint64_t>(scan), static_cast<std::uint32_t>(i),
+                            p, fleet.state[i], fleet.latched[i], fleet.inputs[i]);
+}
+
+static StatusSample fleetSample(const PackedFleet& fleet, std::size_t i, long scan) {
+    return makeStatusSample(static_cast<std::uint64_t>(scan), static_cast<std::uint32_t>(i),
+                            fleet.plant(i), fleet.hot[i].state, fleet.hot[i].latched, fleet.inputs(i));
 }
 
-struct FaultManager {
-    FaultCode latched = FaultCode::None;
+static LiftState fleetState(const LiftFleet& fleet, std::size_t i) { return fleet.state[i]; }
+static LiftState fleetState(const PackedFleet& fleet, std::size_t i) { return fleet.hot[i].state; }
+
+template <class Fleet>
+static int runFleet(const FleetRunOptions& opt) {
+    const double dt = 0.02;
+    const std::size_t lifts = opt.lifts;
+    const long scans = opt.scans;
+    const bool tableController = opt.tableController;
+    const std::uint64_t printEvery = opt.printEvery;
+
+    Fleet fleet(lifts);
+    fleet.tableController = tableController;
+    if (opt.perLiftCounters) enablePerLiftCounters(fleet);
+
+    // Built once, shared by every lift
+    static const TruckDynamics trucks = builtinTruckDynamics();
+    const TruckDynamics* dynamics = nullptr;
+    if constexpr (std::is_same_v<Fleet, LiftFleet>) {
+        if (!opt.truck.empty()) {
+            const int model = trucks.find(opt.truck);
+            if (model < 0 && opt.truck != "mixed") {
+                std::cout << "--truck: unknown model " << opt.truck << " (fixed, counterbalance, heavy, reach, mixed)\n";
+                return 1;
+            }
+            dynamics = &trucks;
+            fleet.setDynamics(dynamics);
+            for (std::size_t i = 0; i < lifts; ++i) {
+                fleet.setTruckModel(i, static_cast<std::uint8_t>(model >= 0 ? static_cast<std::size_t>(model) : i % trucks.count));
+            }
+        }
+    }
 
-    void clear() { latched = FaultCode::None; }
+    std::unique_ptr<FleetScheduler> scheduler;
+    if constexpr (std::is_same_v<Fleet, LiftFleet>) {
+        if (opt.threads > 0) scheduler = std::make_unique<FleetScheduler>(fleet, opt.scheduler);
+    }
 
-    void latch(FaultCode f) {
-        if (faultPriority(f) > faultPriority(latched)) {
-            latched = f;
+    // The trace carries the truck models, so --replay scans with the same tables
+    TraceRecorder recorder;
+    bool recording = !opt.recordPath.empty();
+    if constexpr (std::is_same_v<Fleet, LiftFleet>) {
+        if (recording) recording = recorder.open(opt.recordPath, fleet, dt);
+    }
+    else {
+        if (recording) recording = recorder.open(opt.recordPath, static_cast<std::uint32_t>(lifts), dt);
+    }
+    if (!opt.recordPath.empty() && !recording) {
+        std::cout << "Cannot open trace file: " << opt.recordPath << "\n";
+        return 1;
+    }
+    if (scans > 0) recorder.reserve(static_cast<std::uint64_t>(scans) * lifts);
+
+    // Rows are encoded and written on the sink's thread
+    ParquetTraceWriter exporter;
+    std::unique_ptr<ColumnarSink> columns;
+    if (!opt.exportPath.empty()) {
+        std::string error;
+        if (!exporter.open(opt.exportPath, static_cast<std::uint32_t>(lifts), dt, error)) {
+            std::cout << "Cannot open export file: " << error << "\n";
+            return 1;
         }
+        columns = std::make_unique<ColumnarSink>(exporter, ColumnarSink::Options{});
+        columns->start();
     }
 
-    bool hasFault() const { return latched != FaultCode::None; }
-};
+    TelemetrySink::Options sinkOpt{};
+    sinkOpt.decimation = printEvery;
+    sinkOpt.overflow = TelemetrySink::Overflow::Wait;
+    sinkOpt.withLift = true;
+    TelemetrySink sink(stdout, sinkOpt);
+    if (printEvery > 0) sink.start();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (long s = 0; s < scans; ++s) {
+        driveFleet(fleet, s);
+        if constexpr (std::is_same_v<Fleet, LiftFleet>) {
+            if (dynamics) {
+                for (std::size_t i = 0; i < lifts; ++i) {
+                    driveFleetLoad(fleet.inputs[i], i, s, trucks.tables[fleet.truckModel[i]].maxLoadKg());
+                }
+            }
+        }
+        if (scheduler) scheduler->scan(dt);
+        else fleet.scan(dt);
+        if (recorder.isOpen()) recorder.recordFleet(fleet);
+        if (columns) columns->submitFleet(static_cast<std::uint64_t>(s), fleet);
+
+        if (printEvery > 0 && s % static_cast<long>(printEvery) == 0) {
+            for (std::size_t i = 0; i < lifts; ++i) sink.submit(fleetSample(fleet, i, s));
+        }
+    }
+    sink.stop();
+    if (columns) columns->stop();
+    const auto t1 = std::chrono::steady_clock::now();
+    if (!closeTrace(recorder) || !closeExport(exporter)) return 1;
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    long perState[kLiftStates] = {};
+    for (std::size_t i = 0; i < lifts; ++i) perState[static_cast<int>(fleetState(fleet, i))]++;
+
+    std::cout << std::fixed << std::setprecision(3)
+        << "layout=" << (opt.packed ? "packed" : "soa")
+        << " kernel=" << (opt.packed ? "Scalar" : plantKernelToString(activePlantKernel()))
+        << " controller=" << (tableController ? "table" : "reference")
+        << (opt.truck.empty() ? "" : " truck=") << opt.truck
+        << " lifts=" << lifts << " scans=" << scans << " time=" << secs << "s"
+        << " scans/s=" << (secs > 0.0 ? scans / secs : 0.0)
+        << " lift-scans/s=" << (secs > 0.0 ? static_cast<double>(lifts) * scans / secs : 0.0)
+        << "\n";
+    for (int st = 0; st < kLiftStates; ++st) {
+        std::cout << "  " << stateToString(static_cast<LiftState>(st)) << "=" << perState[st] << "\n";
+    }
+    if (scheduler) printFleetSchedulerStats(std::cout, scheduler->stats());
+
+    if (kCountersEnabled) {
+        // Lifts with their own counters are not in the thread aggregate
+        LiftCounters total = aggregateThreadCounters();
+        for (const LiftCounters& c : perLiftCounters(fleet)) total.merge(c);
+        printCounters(std::cout, total, dt);
+        if (!opt.countersPath.empty() && !writeCountersFile(opt.countersPath, total, perLiftCounters(fleet), dt)) return 1;
+    }
+    return 0;
+}
 
-// Lift model + PLC state machine
+// Event-driven fleet of scripted shifts; with check, also the dense loop
+// and a lift-by-lift comparison at a few checkpoints.
+static int runEventFleet(std::size_t lifts, std::int64_t scans, std::uint64_t seed, bool check) {
+    const double dt = 0.02;
+    std::vector<Script> scripts;
+    scripts.reserve(lifts);
+    std::uint64_t events = 0;
+    for (std::size_t i = 0; i < lifts; ++i) {
+        scripts.push_back(makeShiftScript(seed, i, scans));
+        events += scripts.back().events.size();
+    }
 
-enum class LiftState {
-    Holding,
-    Lifting,
-    Lowering,
-    Faulted,
-};
+    EventFleet fleet(scripts, dt);
+    EventFleet dense(check ? scripts : std::vector<Script>{}, dt);
+    dense.parking = false;
+
+    const int checkpoints = check ? 8 : 1;
+    double secs = 0.0, denseSecs = 0.0;
+    for (int c = 1; c <= checkpoints; ++c) {
+        const std::int64_t upTo = scans * c / checkpoints;
+
+        auto t0 = std::chrono::steady_clock::now();
+        fleet.advanceTo(upTo);
+        secs += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (!check) continue;
+
+        t0 = std::chrono::steady_clock::now();
+        dense.advanceTo(upTo);
+        denseSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        for (std::size_t i = 0; i < lifts; ++i) {
+            const TraceRecord a = fleet.record(i);
+            const TraceRecord b = dense.record(i);
+            if (std::memcmp(&a, &b, sizeof(TraceRecord)) != 0) {
+                std::cout << "event-fleet: lift " << i << " differs from the dense loop after scan " << upTo << "\n";
+                return 1;
+            }
+        }
+    }
+
+    const EventFleetStats& st = fleet.stats;
+    const double total = static_cast<double>(lifts) * scans;
+    std::cout << std::fixed << std::setprecision(3)
+        << "event-fleet: lifts=" << lifts << " scans=" << scans << " events=" << events
+        << " simulated=" << st.simulatedScans << " trials=" << st.trialScans
+        << " parked=" << st.parkedScans << " parks=" << st.parks
+        << " activity=" << (total > 0.0 ? 100.0 * st.simulatedScans / total : 0.0) << "%"
+        << " time=" << secs << "s"
+        << " lift-scans/s=" << (secs > 0.0 ? total / secs : 0.0) << "\n";
+    if (check) {
+        std::cout << "dense: time=" << denseSecs << "s lift-scans/s=" << (denseSecs > 0.0 ? total / denseSecs : 0.0)
+            << " speedup=" << (secs > 0.0 ? denseSecs / secs : 0.0) << "x"
+            << " result=identical at " << checkpoints << " checkpoints\n";
+    }
 
-static const char* stateToString(LiftState s) {
-    switch (s) {
-    case LiftState::Holding: return "Holding";
-    case LiftState::Lifting: return "Lifting";
-    case LiftState::Lowering: return "Lowering";
-    case LiftState::Faulted: return "Faulted";
+    long perState[kLiftStates] = {};
+    for (std::size_t i = 0; i < lifts; ++i) perState[static_cast<int>(fleet.lifts[i].ctrl.state)]++;
+    for (int st = 0; st < kLiftStates; ++st) {
+        std::cout << "  " << stateToString(static_cast<LiftState>(st)) << "=" << perState[st] << "\n";
     }
-    return "Unknown";
+    return 0;
 }
 
-struct LiftPlant {
-    // Simple physical-ish model (units arbitrary but consistent)
-    double position = 0.0;     // 0 = bottom, 1 = top
-    double velocity = 0.0;     // units per second
+// Offline conversion of a binary trace to a Parquet export
+static int runExportTrace(const std::string& tracePath, const std::string& exportPath) {
+    TraceReader trace;
+    std::string error;
+    if (!trace.open(tracePath, error)) {
+        std::cout << "Trace error: " << error << "\n";
+        return 1;
+    }
+    const std::uint32_t lifts = trace.header().liftCount;
+    ParquetTraceWriter writer;
+    if (!writer.open(exportPath, lifts, trace.header().dt, error)) {
+        std::cout << "Cannot open export file: " << error << "\n";
+        return 1;
+    }
+
+    const std::size_t groupRows = ColumnarSink::Options{}.rowGroupRows;
+    std::vector<ExportRow> group;
+    group.reserve(groupRows);
+    bool ok = true;
+    for (const TraceChunk& c : trace.chunks()) {
+        for (std::uint32_t k = 0; k < c.recordCount && ok; ++k) {
+            const std::uint64_t n = c.firstRecord + k;
+            group.push_back(ExportRow{ n / lifts, static_cast<std::uint32_t>(n % lifts), c.records[k] });
+            if (group.size() == groupRows) {
+                ok = writer.writeRowGroup(group);
+                group.clear();
+            }
+        }
+    }
+    if (ok) ok = writer.writeRowGroup(group);
+    if (!ok) {
+        writer.close();
+        std::cout << "Export write failed: cannot write " << exportPath << "\n";
+        return 1;
+    }
+    return closeExport(writer) ? 0 : 1;
+}
 
-    // "Actuators"
-    double targetVel = 0.0;    // commanded velocity
+static std::optional<PlantKernel> parsePlantKernel(const std::string& name) {
+    if (name == "scalar") return PlantKernel::Scalar;
+    if (name == "neon") return PlantKernel::Neon;
+    if (name == "avx2") return PlantKernel::Avx2;
+    if (name == "avx512") return PlantKernel::Avx512;
+    return std::nullopt;
+}
 
-    // Update plant each tick
-    void step(double dt) {
-        // Smooth towards target velocity (a tiny bit of inertia)
-        const double accel = 3.0; // units/s^2
-        double dv = targetVel - velocity;
-        double maxDv = accel * dt;
-        dv = std::clamp(dv, -maxDv, maxDv);
-        velocity += dv;
+// "--name value" option lookup in the argument list
+static std::optional<std::string> optionValue(const std::vector<std::string>& args, const std::string& name) {
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == name) return args[i + 1];
+    }
+    return std::nullopt;
+}
 
-        position += velocity * dt;
-        position = std::clamp(position, 0.0, 1.0);
+static bool hasFlag(const std::vector<std::string>& args, const std::string& name) {
+    return std::find(args.begin(), args.end(), name) != args.end();
+}
 
-        // If we hit the ends, clamp velocity
-        if (position <= 0.0 && velocity < 0.0) velocity = 0.0;
-        if (position >= 1.0 && velocity > 0.0) velocity = 0.0;
+// Apply "--kernel k" if given; false (after a message) if k is unknown or unsupported.
+static bool applyKernelOption(const std::vector<std::string>& args) {
+    const std::optional<std::string> name = optionValue(args, "--kernel");
+    if (!name) return true;
+    const std::optional<PlantKernel> k = parsePlantKernel(*name);
+    if (!k || !setPlantKernel(*k)) {
+        std::cout << "Plant kernel not available: " << *name << "\n";
+        return false;
     }
-};
+    return true;
+}
+
+static void printUsage() {
+    std::cout <<
+        "Usage:\n"
+        "  Forklift Control System [--record <trace>]  interactive console\n"
+        "  Forklift Control System --fleet <n> <scans> [--kernel k] [--table] [--packed]\n"
+        "                                              [--print-every <scans>] [--record <trace>]\n"
+        "                                              [--counters <json> [--per-lift]]\n"
+        "                                              [--threads <n> [--chunk <lifts>] [--no-pin]]\n"
+        "                                              [--truck <model>] [--export <parquet>]\n"
+        "                                              batch-run a fleet of n lifts\n"
+        "                                              (k: scalar, neon, avx2, avx512;\n"
+        "                                               --table: table-driven controller;\n"
+        "                                               --packed: 32-byte packed lift records;\n"
+        "                                               --threads: scan on n pinned worker threads;\n"
+        "                                               --truck: load-dependent dynamics of fixed,\n"
+        "                                               counterbalance, heavy, reach or mixed;\n"
+        "                                               --export: every scan as Parquet columns)\n"
+        "  Forklift Control System --event-fleet <n> <scans> [seed] [--check]\n"
+        "                                              event-driven fleet of n scripted shifts\n"
+        "                                              that parks idle lifts (--check: compare\n"
+        "                                              with the dense loop)\n"
+        "  Forklift Control System --serve <n> [--status addr:port] [--commands port] [--shm name]\n"
+        "                                              [--batch <scans>] [--scans <n>] [--record <trace>]\n"
+        "                                              real-time fleet of n lifts driven by\n"
+        "                                              UDP / shared-memory command frames\n"
+        "  Forklift Control System --api-check [lifts] [scans]\n"
+        "                                              C library API against the fleet loop,\n"
+        "                                              with a heap allocation count\n"
+        "  Forklift Control System --arena-check [runs] [lifts] [scans]\n"
+        "                                              rewind and rerun scenarios in one\n"
+        "                                              arena against the dense event fleet\n"
+        "  Forklift Control System --dynamics-check [lifts] [scans]\n"
+        "                                              load-dependent dynamics tables against\n"
+        "                                              lone lifts, with cycle times per truck\n"
+        "  Forklift Control System --mast-check [lifts] [scans]\n"
+        "                                              multi-axis masts (tilt, side-shift,\n"
+        "                                              reach) against the lift loop, with\n"
+        "                                              interlock and fault-latch cases\n"
+        "  Forklift Control System --position-check [moves] [lifts] [scans]\n"
+        "                                              go-to-position moves against manual\n"
+        "                                              ones, and fleets against lone lifts\n"
+        "  Forklift Control System --what-if-check [variants] [seed]\n"
+        "                                              forked what-if branches against their\n"
+        "                                              scripts replayed from scan 0\n"
+        "  Forklift Control System --export-check [lifts] [scans]\n"
+        "                                              Parquet export read back against the\n"
+        "                                              binary trace, with sizes per row\n"
+        "  Forklift Control System --operator-check [operators] [scans]\n"
+        "                                              coroutine operator scripts against the\n"
+        "                                              same cycles as hand-written state machines\n"
+        "  Forklift Control System --gateway-check [scans] [lifts]\n"
+        "                                              gateway loopback round trip and replay\n"
+        "  Forklift Control System --headless <script> [--duration <s>] [--print-every <scans>]\n"
+        "                                              [--record <trace>] [--counters <json>]\n"
+        "                                              replay a timestamped command script\n"
+        "                                              as fast as possible\n"
+        "  Forklift Control System --what-if <script> <variants> [--duration <s>] [--threads n]\n"
+        "                                              replay a script once and fork every\n"
+        "                                              variant from it in parallel\n"
+        "  Forklift Control System --diff-check <scans> [seed]\n"
+        "                                              compare table-driven and reference\n"
+        "                                              controllers on random inputs\n"
+        "  Forklift Control System --snapshot-check [scans] [readers]\n"
+        "                                              stress the per-scan snapshot ring\n"
+        "                                              with concurrent readers\n"
+        "  Forklift Control System --telemetry-check [submissions]\n"
+        "                                              status lines of extreme values against\n"
+        "                                              printStatus, and through the sink\n"
+        "  Forklift Control System --segment-check [segments] [seed]\n"
+        "                                              closed-form plant segments against\n"
+        "                                              fixed-step integration\n"
+        "  Forklift Control System --conformance [scans] [seed]\n"
+        "                                              float and Q16.16 plant against the\n"
+        "                                              double reference\n"
+        "  Forklift Control System --campaign <scenarios> [seed] [--threads n] [--scans n]\n"
+        "                                              randomized fault-injection campaign\n"
+        "                                              checking the controller's safety rules\n"
+        "  Forklift Control System --replay <trace> [--kernel k] [--table]\n"
+        "                                              re-run a recorded trace and stop at\n"
+        "                                              the first divergence\n"
+        "  Forklift Control System --export-trace <trace> <parquet>\n"
+        "                                              convert a recorded trace to a Parquet\n"
+        "                                              file for analytics engines\n"
+        "--counters needs a build with FORKLIFT_COUNTERS=1.\n";
+}
+
+static int runInteractive(const std::string& recordPath) {
+    LiftPlant plant{};
+    LiftController ctrl{};
+    Inputs in{};
+    Outputs out{};
 
-struct LiftController {
-    // Tunables
-    const double maxLoadKg = 1200.0;
-    const double liftSpeed = 0.35;
-    const double lowerSpeed = 0.30;
-    const double safeStopSpeedEps = 0.01;
+    const double dt = 0.02; // 20ms fixed update loop
+    DeadlineScheduler scheduler(std::chrono::microseconds(20000));
 
-    LiftState state = LiftState::Holding;
-    FaultManager faults;
+    TraceRecorder recorder;
+    if (!recordPath.empty() && !recorder.open(recordPath, 1, dt)) {
+        std::cout << "Cannot open trace file: " << recordPath << "\n";
+        return 1;
+    }
 
-    // Debounce-like memory
-    bool lastTopLimit = false;
-    bool lastBottomLimit = true;
+    printHelp(std::cout);
 
-    Outputs update(double dt, const Inputs& in, LiftPlant& plant) {
-        Outputs out{};
-        out.brakeEngaged = true;
+    // Consistent per-scan view for threads other than this one; the input thread prints it for 'p'
+    LiftSnapshotRing snapshots;
 
-        // ---- 1. Latch faults (priority-based) ----
-        if (in.estop) {
-            faults.latch(FaultCode::EmergencyStop);
-        }
-        if (in.loadKg > maxLoadKg) {
-            faults.latch(FaultCode::Overload);
-        }
+    OperatorInput input(std::cin, std::cout, &snapshots);
+    input.start();
 
-        // Limit/sensor consistency + "commanding into a limit"
-        if (in.topLimit && in.bottomLimit) {
-            faults.latch(FaultCode::LimitViolation);
-        }
-        else {
-            if (state == LiftState::Lifting && in.topLimit)    faults.latch(FaultCode::LimitViolation);
-            if (state == LiftState::Lowering && in.bottomLimit) faults.latch(FaultCode::LimitViolation);
+    // Status lines are formatted and written off the scan thread
+    TelemetrySink::Options sinkOpt{};
+    sinkOpt.decimation = 10; // every 200ms
+    TelemetrySink sink(stdout, sinkOpt);
+    sink.start();
+    std::uint64_t scan = 0;
 
-            if (in.cmdUp && in.topLimit)    faults.latch(FaultCode::LimitViolation);
-            if (in.cmdDown && in.bottomLimit) faults.latch(FaultCode::LimitViolation);
-        }
+    // FORKLIFT_COUNTERS builds: controller counters, shown with the timing stats
+    LiftCounters counters{};
+    std::uint32_t dwell = 0;
+    selectScanCounters(&counters, &dwell);
 
-        // ---- 2. Allow reset ----
-        // Only allow reset when E-stop is released and the lift is stationary-ish.
-        if (in.resetFault && !in.estop && std::abs(plant.velocity) < safeStopSpeedEps) {
-            faults.clear();
-        }
+    bool quit = false;
+    scheduler.start();
+    while (!quit) {
+        scheduler.beginScan();
 
-        // ---- 3. State transitions ----
-        if (faults.hasFault()) {
-            state = LiftState::Faulted;
-        }
-        else {
-            const bool up = in.cmdUp;
-            const bool down = in.cmdDown;
+        // ---- Reset is a pulse: default false each cycle ----
+        in.resetFault = false;
 
-            if (up && !down && !in.topLimit) {
-                state = LiftState::Lifting;
-            }
-            else if (down && !up && !in.bottomLimit) {
-                state = LiftState::Lowering;
-            }
-            else {
-                state = LiftState::Holding;
+        // ---- Operator input from the reader thread (do this BEFORE controller scan) ----
+        Command cmd{};
+        while (input.poll(cmd)) {
+            if (cmd.verb == CommandVerb::Quit) quit = true;
+            else if (cmd.verb == CommandVerb::Help) printHelp(std::cout);
+            else if (cmd.verb == CommandVerb::Timing) {
+                printScanTiming(std::cout, scheduler.timing());
+                if (kCountersEnabled) printCounters(std::cout, counters, dt);
             }
+            else applyCommand(cmd, in);
         }
 
-        // ---- 4. Outputs + safe stopping ----
-        switch (state) {
-        case LiftState::Faulted:
-            plant.targetVel = 0.0;
-            out.motorEnable = false;
-            out.motorDir = 0;
-            out.brakeEngaged = true;
-            out.faultLamp = true;
-            break;
-
-        case LiftState::Holding:
-            plant.targetVel = 0.0;
-            out.motorEnable = false;
-            out.motorDir = 0;
-            out.brakeEngaged = true;
-            out.faultLamp = false;
-            break;
-
-        case LiftState::Lifting:
-            if (in.topLimit) {
-                plant.targetVel = 0.0;
-                out.motorEnable = false;
-                out.motorDir = 0;
-                out.brakeEngaged = true;
-            }
-            else {
-                plant.targetVel = +liftSpeed;
-                out.motorEnable = true;
-                out.motorDir = +1;
-                out.brakeEngaged = false;
+        // ---- Limits, controller scan (NOW it can see resetFault), plant update ----
+        out = scanLift(dt, in, ctrl, plant);
+        if (recorder.isOpen()) recorder.record(in, out, plant, ctrl.state, ctrl.faults.latched);
+
+        snapshots.publish(makeLiftSnapshot(scan, in, out, plant, ctrl.state, ctrl.faults.latched));
+
+        // ---- Status print (every 200ms) ----
+        sink.submit(makeStatusSample(scan++, 0, plant, ctrl.state, ctrl.faults.latched, in));
+
+        scheduler.waitNext();
+    }
+
+    sink.stop();
+    selectScanCounters(nullptr, nullptr);
+    printScanTiming(std::cout, scheduler.timing());
+    if (kCountersEnabled) printCounters(std::cout, counters, dt);
+    if (sink.dropped() > 0) std::cout << "status lines dropped: " << sink.dropped() << "\n";
+    return closeTrace(recorder) ? 0 : 1;
+}
+
+// Set by Ctrl-C so --serve closes the gateway (and removes its shared memory) cleanly
+static std::atomic<bool> serveStop{ false };
+
+static void onServeSignal(int) { serveStop.store(true); }
+
+static int runServe(const std::vector<std::string>& args) {
+    ServeOptions opt{};
+    opt.lifts = static_cast<std::uint32_t>(std::strtoul(args[1].c_str(), nullptr, 10));
+    opt.gateway.statusAddress = optionValue(args, "--status").value_or("");
+    opt.gateway.shmName = optionValue(args, "--shm").value_or("");
+    if (const std::optional<std::string> port = optionValue(args, "--commands")) {
+        opt.gateway.commandPort = static_cast<std::uint16_t>(std::strtoul(port->c_str(), nullptr, 10));
+    }
+    if (const std::optional<std::string> n = optionValue(args, "--batch")) {
+        opt.gateway.batchScans = static_cast<std::uint32_t>(std::strtoul(n->c_str(), nullptr, 10));
+    }
+    if (const std::optional<std::string> n = optionValue(args, "--scans")) {
+        opt.scans = std::strtoull(n->c_str(), nullptr, 10);
+    }
+    if (opt.lifts == 0) {
+        printUsage();
+        return 1;
+    }
+
+    TraceRecorder recorder;
+    if (const std::optional<std::string> path = optionValue(args, "--record")) {
+        if (!recorder.open(*path, opt.lifts, opt.dt)) {
+            std::cout << "Cannot open trace file: " << *path << "\n";
+            return 1;
+        }
+        recorder.reserve(opt.scans * opt.lifts);
+    }
+
+    std::cout << "serving " << opt.lifts << " lifts"
+        << (opt.gateway.statusAddress.empty() ? "" : ", status to " + opt.gateway.statusAddress)
+        << (opt.gateway.commandPort ? ", commands on port " + std::to_string(opt.gateway.commandPort) : "")
+        << (opt.gateway.shmName.empty() ? "" : ", shared memory " + opt.gateway.shmName)
+        << " (Ctrl-C stops)\n";
+
+    serveStop.store(false);
+    opt.stop = &serveStop;
+    std::signal(SIGINT, onServeSignal);
+
+    ServeResult r{};
+    std::string error;
+    const bool ok = serveFleet(opt, recorder.isOpen() ? &recorder : nullptr, r, error);
+    std::signal(SIGINT, SIG_DFL);
+    if (!ok) {
+        std::cout << "Gateway error: " << error << "\n";
+        return 1;
+    }
+    printServeResult(std::cout, r, opt);
+    return closeTrace(recorder) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    if (!kCountersEnabled && hasFlag(args, "--counters")) {
+        std::cout << "--counters: this build has no counters (define FORKLIFT_COUNTERS=1)\n";
+        return 1;
+    }
+
+    if (args.empty()) return runInteractive({});
+    if (args[0] == "--record" && args.size() == 2) return runInteractive(args[1]);
+
+    if (args[0] == "--fleet" && args.size() >= 3) {
+        const long lifts = std::atol(args[1].c_str());
+        const long scans = std::atol(args[2].c_str());
+        if (!applyKernelOption(args)) return 1;
+        if (lifts > 0 && scans >= 0) {
+            FleetRunOptions opt{};
+            opt.lifts = static_cast<std::size_t>(lifts);
+            opt.scans = scans;
+            opt.tableController = hasFlag(args, "--table");
+            opt.packed = hasFlag(args, "--packed");
+            if (const std::optional<std::string> every = optionValue(args, "--print-every")) {
+                opt.printEvery = std::strtoull(every->c_str(), nullptr, 10);
             }
-            out.faultLamp = false;
-            break;
-
-        case LiftState::Lowering:
-            if (in.bottomLimit) {
-                plant.targetVel = 0.0;
-                out.motorEnable = false;
-                out.motorDir = 0;
-                out.brakeEngaged = true;
+            opt.recordPath = optionValue(args, "--record").value_or("");
+            opt.exportPath = optionValue(args, "--export").value_or("");
+            opt.countersPath = optionValue(args, "--counters").value_or("");
+            opt.perLiftCounters = hasFlag(args, "--per-lift");
+            opt.truck = optionValue(args, "--truck").value_or("");
+            if (!opt.truck.empty() && opt.packed) {
+                std::cout << "--truck: needs the soa layout (no --packed)\n";
+                return 1;
             }
-            else {
-                plant.targetVel = -lowerSpeed;
-                out.motorEnable = true;
-                out.motorDir = -1;
-                out.brakeEngaged = false;
+            if (const std::optional<std::string> threads = optionValue(args, "--threads")) {
+                opt.threads = static_cast<unsigned>(std::strtoul(threads->c_str(), nullptr, 10));
+                if (opt.threads == 0 || opt.packed) {
+                    std::cout << "--threads: needs a thread count > 0 and the soa layout (no --packed)\n";
+                    return 1;
+                }
+                opt.scheduler.threads = opt.threads;
+                if (const std::optional<std::string> chunk = optionValue(args, "--chunk")) {
+                    opt.scheduler.chunkLifts = std::strtoull(chunk->c_str(), nullptr, 10);
+                }
+                opt.scheduler.pin = !hasFlag(args, "--no-pin");
             }
-            out.faultLamp = false;
-            break;
+            return opt.packed ? runFleet<PackedFleet>(opt) : runFleet<LiftFleet>(opt);
         }
+    }
 
-        (void)dt;
-        lastTopLimit = in.topLimit;
-        lastBottomLimit = in.bottomLimit;
+    if (args[0] == "--event-fleet" && args.size() >= 3) {
+        const std::size_t lifts = std::strtoull(args[1].c_str(), nullptr, 10);
+        const std::int64_t scans = std::strtoll(args[2].c_str(), nullptr, 10);
+        const std::uint64_t seed = args.size() >= 4 && args[3][0] != '-' ? std::strtoull(args[3].c_str(), nullptr, 10) : 1;
+        return runEventFleet(lifts, scans, seed, hasFlag(args, "--check"));
+    }
 
-        return out;
+    if (args[0] == "--serve" && args.size() >= 2) return runServe(args);
 
-        }
-    
-};
+    if (args[0] == "--api-check" && args.size() <= 3) {
+        const std::uint32_t lifts = args.size() >= 2 ? static_cast<std::uint32_t>(std::strtoul(args[1].c_str(), nullptr, 10)) : 1000;
+        const std::uint64_t scans = args.size() == 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 2000;
+        const ApiCheckReport r = checkForkliftApi(lifts, scans, heapAllocationCount);
+        printApiCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-    // Console Simulation
-static void printHelp() {
-    std::cout <<
-        "Commands:\n"
-        "  u  = command up\n"
-        "  d  = command down\n"
-        "  h  = hold\n"
-        "  s  = stop commands (clear u/d/h)\n"
-        "  e  = toggle emergency stop\n"
-        "  r  = reset fault (only if stopped + estop released)\n"
-        "  l <kg> = set load kg (e.g. l 900)\n"
-        "  q  = quit\n";
-}
+    if (args[0] == "--arena-check" && args.size() <= 4) {
+        const std::size_t runs = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 12;
+        const std::size_t lifts = args.size() >= 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 500;
+        const std::int64_t scans = args.size() == 4 ? std::strtoll(args[3].c_str(), nullptr, 10) : 3000;
+        const ArenaCheckReport r = checkArenaFleet(runs, lifts, scans, heapAllocationCount);
+        printArenaCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-int main() {
-    LiftPlant plant{};
-    LiftController ctrl{};
-    Inputs in{};
-    Outputs out{};
+    if (args[0] == "--dynamics-check" && args.size() <= 3) {
+        const std::size_t lifts = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 400;
+        const std::int64_t scans = args.size() == 3 ? std::strtoll(args[2].c_str(), nullptr, 10) : 4000;
+        const DynamicsCheckReport r = checkLoadDynamics(lifts, scans);
+        printDynamicsCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-    const double dt = 0.02; // 20ms fixed update loop
+    if (args[0] == "--mast-check" && args.size() <= 3) {
+        const std::size_t lifts = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 500;
+        const std::int64_t scans = args.size() == 3 ? std::strtoll(args[2].c_str(), nullptr, 10) : 4000;
+        const MastCheckReport r = checkMastAxes(lifts, scans);
+        printMastCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-    printHelp();
+    if (args[0] == "--position-check" && args.size() <= 4) {
+        const std::size_t moves = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 2000;
+        const std::size_t lifts = args.size() >= 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 300;
+        const std::int64_t scans = args.size() == 4 ? std::strtoll(args[3].c_str(), nullptr, 10) : 4000;
+        const PositionCheckReport r = checkGoToPosition(moves, lifts, scans);
+        printPositionCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-    bool quit = false;
-    while (!quit) {
-        // ---- Reset is a pulse: default false each cycle ----
-        in.resetFault = false;
+    if (args[0] == "--what-if-check" && args.size() <= 3) {
+        const std::size_t variants = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 200;
+        const std::uint64_t seed = args.size() == 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 1;
+        const WhatIfCheckReport r = checkWhatIf(variants, seed);
+        printWhatIfCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-        // ---- Non-blocking-ish input (do this BEFORE controller scan) ----
-        static int inputPoll = 0;
-        if ((inputPoll++ % 25) == 0) { // every 0.5s
-            std::cout << "> " << std::flush;
-            std::string line;
-            if (std::getline(std::cin, line)) {
-                if (line == "q") quit = true;
-                else if (line == "u") { in.cmdUp = true;  in.cmdDown = false; in.cmdHold = false; }
-                else if (line == "d") { in.cmdDown = true; in.cmdUp = false;  in.cmdHold = false; }
-                else if (line == "h") { in.cmdHold = true; in.cmdUp = false;  in.cmdDown = false; }
-                else if (line == "s") { in.cmdUp = in.cmdDown = in.cmdHold = false; }
-                else if (line == "e") { in.estop = !in.estop; }
-                else if (line == "r") { in.resetFault = true; } // now ctrl.update will see it this cycle
-                else if (line.size() >= 2 && line[0] == 'l') {
-                    try { in.loadKg = std::stod(line.substr(1)); }
-                    catch (...) { std::cout << "Bad load value.\n"; }
-                }
-                else if (line == "help") printHelp();
-                else std::cout << "Unknown command. Type 'help'.\n";
+    if (args[0] == "--export-check" && args.size() <= 3) {
+        const std::size_t lifts = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 200;
+        const std::int64_t scans = args.size() == 3 ? std::strtoll(args[2].c_str(), nullptr, 10) : 3000;
+        const ExportCheckReport r = checkColumnarExport(lifts, scans);
+        printExportCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
+
+    if (args[0] == "--operator-check" && args.size() <= 3) {
+        const std::size_t operators = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 2000;
+        const std::int64_t scans = args.size() == 3 ? std::strtoll(args[2].c_str(), nullptr, 10) : 4000;
+        const OperatorCheckReport r = checkOperatorScripts(operators, scans);
+        printOperatorCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
+
+    if (args[0] == "--gateway-check" && args.size() <= 3) {
+        const std::uint64_t scans = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 4000;
+        const std::uint32_t lifts = args.size() == 3 ? static_cast<std::uint32_t>(std::strtoul(args[2].c_str(), nullptr, 10)) : 16;
+        const GatewayCheckReport r = checkGateway(scans, lifts);
+        printGatewayCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
+
+    if (args[0] == "--headless" && args.size() >= 2) {
+        HeadlessOptions opt{};
+        if (const std::optional<std::string> d = optionValue(args, "--duration")) {
+            opt.durationScans = static_cast<std::int64_t>(std::llround(std::atof(d->c_str()) / opt.dt));
+        }
+        if (const std::optional<std::string> n = optionValue(args, "--print-every")) {
+            opt.printEvery = std::atoll(n->c_str());
+        }
+
+        Script script{};
+        std::string error;
+        if (!loadScriptFile(args[1], opt.dt, script, error)) {
+            std::cout << "Script error: " << error << "\n";
+            return 1;
+        }
+
+        TelemetrySink::Options sinkOpt{};
+        sinkOpt.decimation = static_cast<std::uint64_t>(opt.printEvery);
+        sinkOpt.overflow = TelemetrySink::Overflow::Wait;
+        TelemetrySink sink(stdout, sinkOpt);
+        if (opt.printEvery > 0) sink.start();
+
+        TraceRecorder recorder;
+        if (const std::optional<std::string> path = optionValue(args, "--record")) {
+            if (!recorder.open(*path, 1, opt.dt)) {
+                std::cout << "Cannot open trace file: " << *path << "\n";
+                return 1;
             }
         }
 
-        // ---- Update derived inputs (limit switches) from plant position ----
-        in.bottomLimit = (plant.position <= 0.0001);
-        in.topLimit = (plant.position >= 0.9999);
+        const HeadlessResult r = runHeadless(script, opt, opt.printEvery > 0 ? &sink : nullptr,
+                                             recorder.isOpen() ? &recorder : nullptr);
+        sink.stop();
+        if (!closeTrace(recorder)) return 1;
+        printHeadlessResult(std::cout, r, opt.dt);
+        if (const std::optional<std::string> path = optionValue(args, "--counters")) {
+            if (!writeCountersFile(*path, r.counters, {}, opt.dt)) return 1;
+        }
+        return 0;
+    }
+
+    if (args[0] == "--what-if" && args.size() >= 3) {
+        WhatIfOptions opt{};
+        if (const std::optional<std::string> d = optionValue(args, "--duration")) {
+            opt.durationScans = static_cast<std::int64_t>(std::llround(std::atof(d->c_str()) / opt.dt));
+        }
+        if (const std::optional<std::string> n = optionValue(args, "--threads")) {
+            opt.threads = static_cast<unsigned>(std::strtoul(n->c_str(), nullptr, 10));
+        }
+
+        Script script{};
+        std::vector<WhatIfVariant> variants;
+        std::string error;
+        if (!loadScriptFile(args[1], opt.dt, script, error)) {
+            std::cout << "Script error: " << error << "\n";
+            return 1;
+        }
+        if (!loadWhatIfFile(args[2], opt.dt, variants, error)) {
+            std::cout << "Variants error: " << error << "\n";
+            return 1;
+        }
+        printWhatIfReport(std::cout, runWhatIf(script, variants, opt), opt.dt);
+        return 0;
+    }
+
+    if (args[0] == "--diff-check" && (args.size() == 2 || args.size() == 3)) {
+        const std::uint64_t scans = std::strtoull(args[1].c_str(), nullptr, 10);
+        const std::uint64_t seed = args.size() == 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 1;
+        const ControllerDiffReport r = diffControllers(seed, scans);
+        printControllerDiffReport(std::cout, r);
+        return r.mismatches == 0 ? 0 : 1;
+    }
 
-        // ---- Controller scan (NOW it can see resetFault) ----
-        out = ctrl.update(dt, in, plant);
+    if (args[0] == "--snapshot-check" && args.size() <= 3) {
+        const std::uint64_t scans = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 10000000;
+        const unsigned readers = args.size() == 3 ? static_cast<unsigned>(std::strtoul(args[2].c_str(), nullptr, 10)) : 3;
+        const SnapshotCheckReport r = checkSnapshots(scans, readers);
+        printSnapshotCheckReport(std::cout, r);
+        return r.torn == 0 && r.regressions == 0 ? 0 : 1;
+    }
 
-        // ---- Plant update ----
-        if (out.brakeEngaged) plant.targetVel = 0.0;
-        plant.step(dt);
+    if (args[0] == "--telemetry-check" && args.size() <= 2) {
+        const std::uint64_t submissions = args.size() == 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 20000;
+        const TelemetryCheckReport r = checkTelemetry(submissions);
+        printTelemetryCheckReport(std::cout, r);
+        return r.passed() ? 0 : 1;
+    }
 
-        // ---- Status print (every 200ms) ----
-        static int tick = 0;
-        if ((tick++ % 10) == 0) {
-            std::cout << std::fixed << std::setprecision(3)
-                << "pos=" << plant.position
-                << " vel=" << plant.velocity
-                << " state=" << stateToString(ctrl.state)
-                << " fault=" << faultToString(ctrl.faults.latched)
-                << " top=" << in.topLimit
-                << " bot=" << in.bottomLimit
-                << " load=" << in.loadKg
-                << " estop=" << in.estop
-                << "\n";
+    if (args[0] == "--segment-check" && args.size() <= 3) {
+        const std::uint64_t segments = args.size() >= 2 ? std::strtoull(args[1].c_str(), nullptr, 10) : 100000;
+        const std::uint64_t seed = args.size() == 3 ? std::strtoull(args[2].c_str(), nullptr, 10) : 1;
+        const PlantSegmentCheckReport r = checkPlantSegments(seed, segments);
+        printPlantSegmentCheckReport(std::cout, r);
+        return r.totalMismatches() == 0 && r.maxPositionError < 1.0e-9 ? 0 : 1;
+    }
+
+    if (args[0] == "--conformance" && args.size() <= 3) {
+        ConformanceOptions opt{};
+        if (args.size() >= 2) opt.scans = std::strtoull(args[1].c_str(), nullptr, 10);
+        if (args.size() == 3) opt.seed = std::strtoull(args[2].c_str(), nullptr, 10);
+        const std::vector<ConformanceResult> results = runConformance(opt);
+        printConformanceReport(std::cout, results, opt);
+        for (const ConformanceResult& r : results) {
+            if (!r.conforms()) return 1;
+        }
+        return 0;
+    }
+
+    if (args[0] == "--campaign" && args.size() >= 2) {
+        CampaignOptions opt{};
+        opt.scenarios = std::strtoull(args[1].c_str(), nullptr, 10);
+        if (args.size() >= 3 && args[2].rfind("--", 0) != 0) opt.seed = std::strtoull(args[2].c_str(), nullptr, 10);
+        if (const std::optional<std::string> n = optionValue(args, "--threads")) {
+            opt.threads = static_cast<unsigned>(std::strtoul(n->c_str(), nullptr, 10));
+        }
+        if (const std::optional<std::string> n = optionValue(args, "--scans")) {
+            opt.scansPerScenario = static_cast<std::uint32_t>(std::strtoul(n->c_str(), nullptr, 10));
         }
+        const CampaignReport r = runCampaign(opt);
+        printCampaignReport(std::cout, r, opt);
+        return r.stats.totalFailures() == 0 ? 0 : 1;
+    }
+
+    if (args[0] == "--replay" && args.size() >= 2) {
+        if (!applyKernelOption(args)) return 1;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        TraceReader trace;
+        std::string error;
+        if (!trace.open(args[1], error)) {
+            std::cout << "Trace error: " << error << "\n";
+            return 1;
+        }
+        std::cout << "trace: lifts=" << trace.header().liftCount
+            << " scans=" << trace.scanCount()
+            << " dt=" << trace.header().dt
+            << " chunks=" << trace.chunks().size()
+            << (trace.indexed() ? "" : " (no index, chunks walked)") << "\n";
+
+        ReplayOptions opt{};
+        opt.tableController = hasFlag(args, "--table");
+        const ReplayResult r = replayTrace(trace, opt);
+        printReplayResult(std::cout, r, trace.header().dt);
+        return r.diverged || !r.error.empty() ? 1 : 0;
     }
+
+    if (args[0] == "--export-trace" && args.size() == 3) return runExportTrace(args[1], args[2]);
+
+    printUsage();
+    return 1;
 }